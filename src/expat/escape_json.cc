@@ -19,28 +19,44 @@
 #include <string>
 
 #include "escape_json.h"
+#include "escape_scan.h"
 
 
-std::string escape_cstr(const std::string& s)
+void escape_cstr(const std::string& s, std::string& result)
 {
-  std::string result;
-  result.reserve(s.length()*2);
-  for (std::string::size_type i(0); i < s.size(); ++i)
+  const char* pos = s.data();
+  const char* end = pos + s.size();
+  while (true)
   {
-    if (s[i] == '\"')
+    const char* next = find_escape_char(pos, end, '\"', '\\', '\"', '\\');
+    result.append(pos, next);
+    if (next == end)
+      return;
+
+    if (*next == '\"')
       result += "\\\"";
-    else if (s[i] == '\\')
+    else if (*next == '\\')
       result += "\\\\";
-    else if (s[i] == '\n')
+    else if (*next == '\n')
       result += "\\n";
-    else if (s[i] == '\t')
+    else if (*next == '\t')
       result += "\\t";
-    else if (s[i] == '\r')
+    else if (*next == '\r')
       result += "\\r";
-    else if ((unsigned char)s[i] < 32)
-      result += '?';
     else
-      result += s[i];
+      result += '?';
+    pos = next + 1;
   }
+}
+
+
+std::string escape_cstr(const std::string& s)
+{
+  if (find_escape_char(s.data(), s.data() + s.size(), '\"', '\\', '\"', '\\') == s.data() + s.size())
+    return s;
+
+  std::string result;
+  result.reserve(s.length()*2);
+  escape_cstr(s, result);
   return result;
 }
@@ -24,5 +24,8 @@
 
 std::string escape_cstr(const std::string& s);
 
+// Appends s escaped like above to result
+void escape_cstr(const std::string& s, std::string& result);
+
 
 #endif
@@ -0,0 +1,61 @@
+/** Copyright 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018 Roland Olbricht et al.
+ *
+ * This file is part of Overpass_API.
+ *
+ * Overpass_API is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Overpass_API is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Overpass_API.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DE__OSM3S___EXPAT__ESCAPE_SCAN_H
+#define DE__OSM3S___EXPAT__ESCAPE_SCAN_H
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+/* Returns the first character in [begin, end) that is a control character (below 32)
+ * or equal to one of a, b, c, d. Most strings need no escaping at all,
+ * hence the scan runs on 16 bytes at once where SSE2 is available. */
+inline const char* find_escape_char(const char* begin, const char* end, char a, char b, char c, char d)
+{
+#ifdef __SSE2__
+  const __m128i a_16 = _mm_set1_epi8(a);
+  const __m128i b_16 = _mm_set1_epi8(b);
+  const __m128i c_16 = _mm_set1_epi8(c);
+  const __m128i d_16 = _mm_set1_epi8(d);
+  const __m128i control_16 = _mm_set1_epi8(31);
+  while (end - begin >= 16)
+  {
+    __m128i chars = _mm_loadu_si128((const __m128i*)begin);
+    __m128i found = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(chars, a_16), _mm_cmpeq_epi8(chars, b_16)),
+        _mm_or_si128(_mm_cmpeq_epi8(chars, c_16), _mm_cmpeq_epi8(chars, d_16)));
+    // min(x, 31) == x holds exactly for the unsigned values up to 31
+    found = _mm_or_si128(found, _mm_cmpeq_epi8(_mm_min_epu8(chars, control_16), chars));
+    int mask = _mm_movemask_epi8(found);
+    if (mask)
+      return begin + __builtin_ctz(mask);
+    begin += 16;
+  }
+#endif
+  for (; begin != end; ++begin)
+  {
+    if ((unsigned char)*begin < 32 || *begin == a || *begin == b || *begin == c || *begin == d)
+      return begin;
+  }
+  return end;
+}
+
+
+#endif
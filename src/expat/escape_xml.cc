@@ -18,34 +18,52 @@
 
 #include <string>
 
+#include "escape_scan.h"
 #include "escape_xml.h"
 
 
-std::string escape_xml(const std::string& s)
+void escape_xml(const std::string& s, std::string& result)
 {
   const char* digit = "0123456789abcdef";
 
-  std::string result;
-  result.reserve(s.length()*2);
-  for (std::string::size_type i(0); i < s.size(); ++i)
+  const char* pos = s.data();
+  const char* end = pos + s.size();
+  while (true)
   {
-    if (s[i] == '&')
+    const char* next = find_escape_char(pos, end, '&', '\"', '<', '>');
+    result.append(pos, next);
+    if (next == end)
+      return;
+
+    if (*next == '&')
       result += "&amp;";
-    else if (s[i] == '\"')
+    else if (*next == '\"')
       result += "&quot;";
-    else if (s[i] == '<')
+    else if (*next == '<')
       result += "&lt;";
-    else if (s[i] == '>')
+    else if (*next == '>')
       result += "&gt;";
-    else if ((unsigned char)s[i] < 32)
+    else if ((*next == '\n') || (*next == '\t') || (*next == '\r'))
     {
-      if ((s[i] == '\n') || (s[i] == '\t') || (s[i] == '\r'))
-	result += std::string("&#x") + digit[s[i] / 16] + digit[s[i] % 16] + ';';
-      else
-        result += '?';
+      result += "&#x";
+      result += digit[*next / 16];
+      result += digit[*next % 16];
+      result += ';';
     }
     else
-      result += s[i];
+      result += '?';
+    pos = next + 1;
   }
+}
+
+
+std::string escape_xml(const std::string& s)
+{
+  if (find_escape_char(s.data(), s.data() + s.size(), '&', '\"', '<', '>') == s.data() + s.size())
+    return s;
+
+  std::string result;
+  result.reserve(s.length()*2);
+  escape_xml(s, result);
   return result;
 }
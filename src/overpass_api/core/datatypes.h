@@ -255,6 +255,22 @@ private:
 };
 
 
+/* Tags as pairs of pointers to their key and value strings. The strings are owned elsewhere,
+ * e.g. by a Tag_String_Pool or by the tags of a Derived_Structure. */
+typedef std::vector< std::pair< const std::string*, const std::string* > > Interned_Tags;
+
+
+// Points to the strings of the given tags. The result stays valid as long as the tags are not changed.
+inline Interned_Tags refer_to_tags(const std::vector< std::pair< std::string, std::string > >& tags)
+{
+  Interned_Tags result;
+  result.reserve(tags.size());
+  for (std::vector< std::pair< std::string, std::string > >::const_iterator it = tags.begin(); it != tags.end(); ++it)
+    result.push_back(std::make_pair(&it->first, &it->second));
+  return result;
+}
+
+
 struct Derived_Skeleton
 {
   typedef Uint64 Id_Type;
@@ -777,6 +793,18 @@ struct Timestamp
   int minute() const { return minute(timestamp); }
   int second() const { return second(timestamp); }
 
+  // Seconds since 1970-01-01T00:00:00Z, see http://howardhinnant.github.io/date_algorithms.html#days_from_civil
+  int64 seconds_since_epoch() const
+  {
+    int y = year() - (month() <= 2 ? 1 : 0);
+    int era = (y >= 0 ? y : y - 399) / 400;
+    int64 year_of_era = y - era * 400;
+    int64 day_of_year = (153 * (month() + (month() > 2 ? -3 : 9)) + 2) / 5 + day() - 1;
+    int64 day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    int64 days = (int64)era * 146097 + day_of_era - 719468;
+    return days * 86400 + hour() * 3600 + minute() * 60 + second();
+  }
+
   // source: https://github.com/osmcode/libosmium/blob/master/include/osmium/osm/timestamp.hpp
 
   inline void add_2digit_int_to_string(int value, std::string& out) const {
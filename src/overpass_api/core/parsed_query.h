@@ -30,7 +30,7 @@
 class Parsed_Query
 {
 public:
-  Parsed_Query() : output_handler(0), global_bbox_limitation(Bbox_Double::invalid), last_dispensed_id(0ull), regexp_engine(""), use_nodes_tagged(true)  {
+  Parsed_Query() : output_handler(0), global_bbox_limitation(Bbox_Double::invalid), last_dispensed_id(0ull), regexp_engine(""), use_nodes_tagged(true), query_threads(1), print_chunk_size(0)  {
 
     default_regexp_engine = "POSIX";
     char const* default_regexp_engine_c = std::getenv("OVERPASS_REGEXP_ENGINE");
@@ -65,6 +65,20 @@ public:
       else if (std::strcmp(use_nodes_tagged_c, "0") == 0 || std::strcmp(use_nodes_tagged_c, "false") == 0)
         use_nodes_tagged = false;
     }
+
+    char const* query_threads_c = std::getenv("OVERPASS_QUERY_THREADS");
+    if (query_threads_c != nullptr) {
+      query_threads = atoi(query_threads_c);
+      if (query_threads < 1)
+        query_threads = 1;
+    }
+
+    char const* print_chunk_size_c = std::getenv("OVERPASS_PRINT_CHUNK_SIZE");
+    if (print_chunk_size_c != nullptr) {
+      print_chunk_size = atoi(print_chunk_size_c);
+      if (print_chunk_size < 0)
+        print_chunk_size = 0;
+    }
   }
 
   ~Parsed_Query() { delete output_handler; }
@@ -89,6 +103,8 @@ public:
   int32 get_max_timeout() { return max_timeout; }
   std::string get_default_element_limit() { return default_element_limit; }
   bool get_use_nodes_tagged() { return use_nodes_tagged; }
+  int get_query_threads() { return query_threads; }
+  int get_print_chunk_size() { return print_chunk_size; }
 
 private:
   // The class has ownership of objects - hence no assignment or copies are allowed
@@ -105,6 +121,8 @@ private:
   int32 max_timeout;
   std::string default_element_limit;
   bool use_nodes_tagged;     // tagged nodes prototype enabled?
+  int query_threads;         // threads a single statement may use for independent element types
+  int print_chunk_size;      // max. elements print buffers with tags and meta, 0 for the built-in defaults
 };
 
 
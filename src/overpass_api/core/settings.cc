@@ -50,6 +50,7 @@ struct OSM_File_Properties : public File_Properties
   const std::string& get_data_suffix() const { return basic_settings().DATA_SUFFIX; }
   const std::string& get_id_suffix() const { return basic_settings().ID_SUFFIX; }
   const std::string& get_shadow_suffix() const { return basic_settings().SHADOW_SUFFIX; }
+  std::string get_statistics_suffix() const { return basic_settings().STATISTICS_SUFFIX; }
 
   uint32 get_block_size() const { return block_size/8; }
   uint32 get_compression_factor() const { return 8; }
@@ -96,6 +97,7 @@ Basic_Settings::Basic_Settings()
   INDEX_SUFFIX(".idx"),
   ID_SUFFIX(".map"),
   SHADOW_SUFFIX(".shadow"),
+  STATISTICS_SUFFIX(".stats"),
 
   base_directory("./"),
   logfile_name("transactions.log"),
@@ -303,6 +305,12 @@ const Attic_Settings& attic_settings()
   return obj;
 }
 
+
+std::string tag_statistics_file_name(const std::string& db_dir, const File_Properties& tags_global)
+{
+  return db_dir + tags_global.get_file_name_trunk() + tags_global.get_statistics_suffix();
+}
+
 //-----------------------------------------------------------------------------
 
 void show_mem_status()
@@ -31,6 +31,7 @@ struct Basic_Settings
   std::string INDEX_SUFFIX;
   std::string ID_SUFFIX;
   std::string SHADOW_SUFFIX;
+  std::string STATISTICS_SUFFIX;
 
   std::string base_directory;
   std::string logfile_name;
@@ -157,6 +158,11 @@ const Area_Settings& area_settings();
 const Meta_Settings& meta_settings();
 const Attic_Settings& attic_settings();
 
+// The key and value statistics (see template_db/key_value_statistics.h) kept by the updaters
+// next to a global tag file. The counts per key are split by the coarse tiles of the element index.
+std::string tag_statistics_file_name(const std::string& db_dir, const File_Properties& tags_global);
+inline uint32 tag_statistics_tile(uint32 idx) { return (idx & 0x7fffffff)>>24; }
+
 void show_mem_status();
 
 
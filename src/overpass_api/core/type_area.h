@@ -474,12 +474,39 @@ struct Area_Block_Id_Functor {
 };
 
 
+/* Appends the coordinates of a raw Area_Block as ilat/ilon pairs like Area_Block::get_ilat_ilon_pairs(),
+ * but without constructing an Area_Block. */
+struct Area_Block_Ilat_Ilon_Functor {
+  Area_Block_Ilat_Ilon_Functor(std::vector< std::pair< uint32, int32 > >& ilat_ilon_pairs_)
+      : ilat_ilon_pairs(ilat_ilon_pairs_) {}
+
+  using reference_type = Area_Block;
+
+  void operator()(const void* data) const
+  {
+    uint16 size = *((const uint16*)data + 2);
+    for (uint16 i = 0; i < size; ++i)
+    {
+      uint64 coor = (*(const uint64*)((const uint8*)data + 6 + 5*i)) & (uint64)0xffffffffffull;
+      ilat_ilon_pairs.push_back(std::make_pair(
+          ::ilat((coor >> 32) & 0xff, coor & 0xffffffffull), ::ilon((coor >> 32) & 0xff, coor & 0xffffffffull)));
+    }
+  }
+
+  std::vector< std::pair< uint32, int32 > >& ilat_ilon_pairs;
+};
+
+
 template <class T, class Object>
 struct Area_Block_Handle_Methods
 {
   typename Object::Id_Type inline id() const {
      return (static_cast<const T*>(this)->apply_func(Area_Block_Id_Functor<typename Object::Id_Type>()));
   }
+
+  void inline append_ilat_ilon_pairs(std::vector< std::pair< uint32, int32 > >& ilat_ilon_pairs) const {
+     static_cast<const T*>(this)->apply_func(Area_Block_Ilat_Ilon_Functor(ilat_ilon_pairs));
+  }
 };
 
 #endif
@@ -552,19 +552,35 @@ struct Compare_By_Id
 };
 
 
+/* Both maps are sorted by index. Unless summand is much smaller than result, we walk them
+ * in lockstep and insert missing indexes with a hint. This keeps the union linear in the size
+ * of both maps instead of doing a logarithmic lookup in result for every index of summand. */
 template< class TIndex, class TObject >
 uint64 indexed_set_union(std::map< TIndex, std::vector< TObject > >& result,
 		       const std::map< TIndex, std::vector< TObject > >& summand)
 {
   uint64 result_size_increase = 0;
 
+  bool lockstep = summand.size() * 16 >= result.size();
+  typename std::map< TIndex, std::vector< TObject > >::iterator rit = result.begin();
   for (typename std::map< TIndex, std::vector< TObject > >::const_iterator
       it = summand.begin(); it != summand.end(); ++it)
   {
     if (it->second.empty())
       continue;
 
-    std::vector< TObject >& target = result[it->first];
+    if (!lockstep)
+      rit = result.lower_bound(it->first);
+    while (rit != result.end() && rit->first < it->first)
+      ++rit;
+    if (rit == result.end() || it->first < rit->first)
+    {
+      rit = result.insert(rit, std::make_pair(it->first, it->second));
+      result_size_increase += eval_map_index_size + it->second.size()*eval_elem<TObject>();
+      continue;
+    }
+
+    std::vector< TObject >& target = rit->second;
     if (target.empty())
     {
       target = it->second;
@@ -591,6 +607,7 @@ uint64 indexed_set_union(std::map< TIndex, std::vector< TObject > >& result,
     {
       std::vector< TObject > other;
       other.swap(target);
+      target.reserve(other.size() + it->second.size());
       std::set_union(it->second.begin(), it->second.end(), other.begin(), other.end(),
                 back_inserter(target), Compare_By_Id< TObject >());
 
@@ -603,18 +620,31 @@ uint64 indexed_set_union(std::map< TIndex, std::vector< TObject > >& result,
 
 //-----------------------------------------------------------------------------
 
+/* Like indexed_set_union, this walks both maps in lockstep if their sizes are similar.
+ * Indexes that are not present in result need no work at all. */
 template< class TIndex, class TObject >
 void indexed_set_difference(std::map< TIndex, std::vector< TObject > >& result,
                             const std::map< TIndex, std::vector< TObject > >& to_substract)
 {
+  bool lockstep = to_substract.size() * 16 >= result.size();
+  typename std::map< TIndex, std::vector< TObject > >::iterator rit = result.begin();
   for (typename std::map< TIndex, std::vector< TObject > >::const_iterator
-      it = to_substract.begin(); it != to_substract.end(); ++it)
+      it = to_substract.begin(); it != to_substract.end() && rit != result.end(); ++it)
   {
+    if (!lockstep)
+      rit = result.lower_bound(it->first);
+    while (rit != result.end() && rit->first < it->first)
+      ++rit;
+    if (rit == result.end() || it->first < rit->first)
+      continue;
+
     std::vector< TObject > other;
-    other.swap(result[it->first]);
-    std::sort(other.begin(), other.end());
+    other.swap(rit->second);
+    if (!std::is_sorted(other.begin(), other.end()))
+      std::sort(other.begin(), other.end());
+    rit->second.reserve(other.size());
     std::set_difference(other.begin(), other.end(), it->second.begin(), it->second.end(),
-                   back_inserter(result[it->first]));
+                   back_inserter(rit->second));
   }
 }
 
@@ -633,9 +663,7 @@ std::pair< std::vector< Index >, std::vector< Index > > get_indexes
 
   Random_File< typename Skeleton::Id_Type, Index > current(rman.get_transaction()->random_index
       (current_skeleton_file_properties< Skeleton >()));
-  for (typename std::vector< typename Skeleton::Id_Type >::const_iterator
-      it = ids.begin(); it != ids.end(); ++it)
-    result.first.push_back(current.get(it->val()));
+  current.get(ids.begin(), ids.end(), result.first);
 
   std::sort(result.first.begin(), result.first.end());
   result.first.erase(std::unique(result.first.begin(), result.first.end()), result.first.end());
@@ -644,16 +672,17 @@ std::pair< std::vector< Index >, std::vector< Index > > get_indexes
   {
     Random_File< typename Skeleton::Id_Type, Index > attic_random(rman.get_transaction()->random_index
         (attic_skeleton_file_properties< Skeleton >()));
+    std::vector< Index > attic_idxs;
+    attic_random.get(ids.begin(), ids.end(), attic_idxs);
     std::set< typename Skeleton::Id_Type > idx_list_ids;
-    for (typename std::vector< typename Skeleton::Id_Type >::const_iterator
-        it = ids.begin(); it != ids.end(); ++it)
+    for (uint i = 0; i < ids.size(); ++i)
     {
-      if (attic_random.get(it->val()).val() == 0)
+      if (attic_idxs[i].val() == 0)
         ;
-      else if (attic_random.get(it->val()) == 0xff)
-        idx_list_ids.insert(it->val());
+      else if (attic_idxs[i] == 0xff)
+        idx_list_ids.insert(ids[i]);
       else
-        result.second.push_back(attic_random.get(it->val()));
+        result.second.push_back(attic_idxs[i]);
     }
 
     Block_Backend< typename Skeleton::Id_Type, Index > idx_list_db
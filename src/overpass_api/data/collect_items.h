@@ -730,9 +730,7 @@ std::vector< Index > get_indexes_
 
   Random_File< typename Skeleton::Id_Type, Index > current(rman.get_transaction()->random_index
       (current_skeleton_file_properties< Skeleton >()));
-  for (typename std::vector< typename Skeleton::Id_Type >::const_iterator
-      it = ids.begin(); it != ids.end(); ++it)
-    result.push_back(current.get(it->val()));
+  current.get(ids.begin(), ids.end(), result);
 
   std::sort(result.begin(), result.end());
   result.erase(std::unique(result.begin(), result.end()), result.end());
@@ -741,16 +739,17 @@ std::vector< Index > get_indexes_
   {
     Random_File< typename Skeleton::Id_Type, Index > attic_random(rman.get_transaction()->random_index
         (attic_skeleton_file_properties< Skeleton >()));
+    std::vector< Index > attic_idxs;
+    attic_random.get(ids.begin(), ids.end(), attic_idxs);
     std::set< typename Skeleton::Id_Type > idx_list_ids;
-    for (typename std::vector< typename Skeleton::Id_Type >::const_iterator
-        it = ids.begin(); it != ids.end(); ++it)
+    for (uint i = 0; i < ids.size(); ++i)
     {
-      if (attic_random.get(it->val()).val() == 0)
+      if (attic_idxs[i].val() == 0)
         ;
-      else if (attic_random.get(it->val()) == 0xff)
-        idx_list_ids.insert(it->val());
+      else if (attic_idxs[i] == 0xff)
+        idx_list_ids.insert(ids[i]);
       else
-        result.push_back(attic_random.get(it->val()));
+        result.push_back(attic_idxs[i]);
     }
 
     Block_Backend< typename Skeleton::Id_Type, Index > idx_list_db
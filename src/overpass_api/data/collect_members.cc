@@ -216,9 +216,7 @@ std::vector< Uint31_Index > collect_relation_req
 
   Random_File< Relation_Skeleton::Id_Type, Uint31_Index > random
       (rman.get_transaction()->random_index(osm_base_settings().RELATIONS));
-  for (std::vector< Relation::Id_Type >::const_iterator
-      it(map_ids.begin()); it != map_ids.end(); ++it)
-    req.push_back(random.get(it->val()));
+  random.get(map_ids.begin(), map_ids.end(), req);
 
   rman.health_check(stmt);
   std::sort(req.begin(), req.end());
@@ -254,9 +252,7 @@ std::vector< Uint31_Index > collect_way_req
 
   Random_File< Way_Skeleton::Id_Type, Uint31_Index > random
       (rman.get_transaction()->random_index(osm_base_settings().WAYS));
-  for (std::vector< uint32 >::const_iterator
-      it(map_ids.begin()); it != map_ids.end(); ++it)
-    req.push_back(random.get(*it));
+  random.get(map_ids.begin(), map_ids.end(), req);
 
   for (std::vector< Uint31_Index >::const_iterator it = children_idxs.begin();
       it != children_idxs.end(); ++it)
@@ -281,12 +277,10 @@ std::set< std::pair< Uint32_Index, Uint32_Index > > collect_node_req
 
   Random_File< Node_Skeleton::Id_Type, Uint32_Index > random
       (rman.get_transaction()->random_index(osm_base_settings().NODES));
-  for (std::vector< Node::Id_Type >::const_iterator
-      it(map_ids.begin()); it != map_ids.end(); ++it)
-  {
-    Uint32_Index idx = random.get(it->val());
-    req.insert(std::make_pair(idx, idx.val() + 1));
-  }
+  std::vector< Uint32_Index > idxs;
+  random.get(map_ids.begin(), map_ids.end(), idxs);
+  for (std::vector< Uint32_Index >::const_iterator it(idxs.begin()); it != idxs.end(); ++it)
+    req.insert(std::make_pair(*it, it->val() + 1));
 
   if (stmt)
     rman.health_check(*stmt);
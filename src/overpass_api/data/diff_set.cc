@@ -133,6 +133,8 @@ void print_nodes(const std::vector< std::pair< Node_With_Context, Node_With_Cont
   for (std::vector< std::pair< Node_With_Context, Node_With_Context > >::const_iterator
       it = different_nodes.begin(); it != different_nodes.end(); ++it)
   {
+    Interned_Tags old_tags = refer_to_tags(it->first.tags);
+    Interned_Tags new_tags = refer_to_tags(it->second.tags);
     if ((it->second.idx.val() | 2) == 0xffu)
     {
       if (add_deletion_information)
@@ -141,7 +143,7 @@ void print_nodes(const std::vector< std::pair< Node_With_Context, Node_With_Cont
         output->print_item(it->first.elem,
             Point_Geometry(::lat(it->first.idx.val(), it->first.elem.ll_lower),
                 ::lon(it->first.idx.val(), it->first.elem.ll_lower)),
-            (output_mode & Output_Mode::TAGS) ? &it->first.tags : 0,
+            (output_mode & Output_Mode::TAGS) ? &old_tags : 0,
             (output_mode & Output_Mode::META) ? &it->first.meta : 0,
             &users, output_mode,
             it->second.idx.val() == 0xfdu ? Output_Handler::push_away : Output_Handler::erase,
@@ -151,7 +153,7 @@ void print_nodes(const std::vector< std::pair< Node_With_Context, Node_With_Cont
         output->print_item(it->first.elem,
             Point_Geometry(::lat(it->first.idx.val(), it->first.elem.ll_lower),
                 ::lon(it->first.idx.val(), it->first.elem.ll_lower)),
-            (output_mode & Output_Mode::TAGS) ? &it->first.tags : 0,
+            (output_mode & Output_Mode::TAGS) ? &old_tags : 0,
             (output_mode & Output_Mode::META) ? &it->first.meta : 0,
             &users, output_mode, Output_Handler::erase);
     }
@@ -167,11 +169,11 @@ void print_nodes(const std::vector< std::pair< Node_With_Context, Node_With_Cont
       if (it->first.idx.val() != 0xfdu)
         old_opaque = &old_geom;
       output->print_item(it->first.elem, *old_opaque,
-          (output_mode & Output_Mode::TAGS) ? &it->first.tags : 0,
+          (output_mode & Output_Mode::TAGS) ? &old_tags : 0,
           (output_mode & Output_Mode::META) ? &it->first.meta : 0,
           &users, output_mode, Output_Handler::modify,
           &it->second.elem, &new_geom,
-          (output_mode & Output_Mode::TAGS) ? &it->second.tags : 0,
+          (output_mode & Output_Mode::TAGS) ? &new_tags : 0,
           (output_mode & Output_Mode::META) ? &it->second.meta : 0);
     }
     else
@@ -179,7 +181,7 @@ void print_nodes(const std::vector< std::pair< Node_With_Context, Node_With_Cont
       output->print_item(it->second.elem,
           Point_Geometry(::lat(it->second.idx.val(), it->second.elem.ll_lower),
               ::lon(it->second.idx.val(), it->second.elem.ll_lower)),
-          (output_mode & Output_Mode::TAGS) ? &it->second.tags : 0,
+          (output_mode & Output_Mode::TAGS) ? &new_tags : 0,
           (output_mode & Output_Mode::META) ? &it->second.meta : 0,
           &users, output_mode, Output_Handler::create);
   }
@@ -193,6 +195,8 @@ void print_ways(const std::vector< std::pair< Way_With_Context, Way_With_Context
   for (std::vector< std::pair< Way_With_Context, Way_With_Context > >::const_iterator it = different_ways.begin();
       it != different_ways.end(); ++it)
   {
+    Interned_Tags old_tags = refer_to_tags(it->first.tags);
+    Interned_Tags new_tags = refer_to_tags(it->second.tags);
     if ((it->second.idx.val() | 2) == 0xffu)
     {
       Double_Coords double_coords(it->first.geometry);
@@ -203,7 +207,7 @@ void print_ways(const std::vector< std::pair< Way_With_Context, Way_With_Context
         output->print_item(it->first.elem,
             broker.make_way_geom((output_mode & Output_Mode::GEOMETRY) ? &it->first.geometry : 0,
                 bound_variant(double_coords, output_mode)),
-            (output_mode & Output_Mode::TAGS) ? &it->first.tags : 0,
+            (output_mode & Output_Mode::TAGS) ? &old_tags : 0,
             (output_mode & Output_Mode::META) ? &it->first.meta : 0,
             &users, output_mode,
             it->second.idx.val() == 0xfdu ? Output_Handler::push_away : Output_Handler::erase,
@@ -213,7 +217,7 @@ void print_ways(const std::vector< std::pair< Way_With_Context, Way_With_Context
         output->print_item(it->first.elem,
             broker.make_way_geom((output_mode & Output_Mode::GEOMETRY) ? &it->first.geometry : 0,
                 bound_variant(double_coords, output_mode)),
-            (output_mode & Output_Mode::TAGS) ? &it->first.tags : 0,
+            (output_mode & Output_Mode::TAGS) ? &old_tags : 0,
             (output_mode & Output_Mode::META) ? &it->first.meta : 0,
             &users, output_mode, Output_Handler::erase);
     }
@@ -227,13 +231,13 @@ void print_ways(const std::vector< std::pair< Way_With_Context, Way_With_Context
       output->print_item(it->first.elem,
           broker.make_way_geom((output_mode & Output_Mode::GEOMETRY) ? &it->first.geometry : 0,
               bound_variant(double_coords, output_mode)),
-          (output_mode & Output_Mode::TAGS) ? &it->first.tags : 0,
+          (output_mode & Output_Mode::TAGS) ? &old_tags : 0,
           (output_mode & Output_Mode::META) ? &it->first.meta : 0,
           &users, output_mode, Output_Handler::modify,
           &it->second.elem,
           &new_broker.make_way_geom((output_mode & Output_Mode::GEOMETRY) ? &it->second.geometry : 0,
               bound_variant(double_coords_new, output_mode)),
-          (output_mode & Output_Mode::TAGS) ? &it->second.tags : 0,
+          (output_mode & Output_Mode::TAGS) ? &new_tags : 0,
           (output_mode & Output_Mode::META) ? &it->second.meta : 0);
     }
     else
@@ -244,7 +248,7 @@ void print_ways(const std::vector< std::pair< Way_With_Context, Way_With_Context
       output->print_item(it->second.elem,
           broker.make_way_geom((output_mode & Output_Mode::GEOMETRY) ? &it->second.geometry : 0,
               bound_variant(double_coords, output_mode)),
-          (output_mode & Output_Mode::TAGS) ? &it->second.tags : 0,
+          (output_mode & Output_Mode::TAGS) ? &new_tags : 0,
           (output_mode & Output_Mode::META) ? &it->second.meta : 0,
           &users, output_mode, Output_Handler::create);
     }
@@ -261,6 +265,8 @@ void print_relations(
   for (std::vector< std::pair< Relation_With_Context, Relation_With_Context > >::const_iterator it = different_relations.begin();
       it != different_relations.end(); ++it)
   {
+    Interned_Tags old_tags = refer_to_tags(it->first.tags);
+    Interned_Tags new_tags = refer_to_tags(it->second.tags);
     if ((it->second.idx.val() | 2) == 0xffu)
     {
       Double_Coords double_coords(it->first.geometry);
@@ -271,7 +277,7 @@ void print_relations(
         output->print_item(it->first.elem,
             broker.make_relation_geom((output_mode & Output_Mode::GEOMETRY) ? &it->first.geometry : 0,
                 bound_variant(double_coords, output_mode)),
-            (output_mode & Output_Mode::TAGS) ? &it->first.tags : 0,
+            (output_mode & Output_Mode::TAGS) ? &old_tags : 0,
             (output_mode & Output_Mode::META) ? &it->first.meta : 0,
             &roles, &users, output_mode,
             it->second.idx.val() == 0xfdu ? Output_Handler::push_away : Output_Handler::erase,
@@ -281,7 +287,7 @@ void print_relations(
         output->print_item(it->first.elem,
             broker.make_relation_geom((output_mode & Output_Mode::GEOMETRY) ? &it->first.geometry : 0,
                 bound_variant(double_coords, output_mode)),
-            (output_mode & Output_Mode::TAGS) ? &it->first.tags : 0,
+            (output_mode & Output_Mode::TAGS) ? &old_tags : 0,
             (output_mode & Output_Mode::META) ? &it->first.meta : 0,
             &roles, &users, output_mode, Output_Handler::erase);
     }
@@ -295,13 +301,13 @@ void print_relations(
       output->print_item(it->first.elem,
           broker.make_relation_geom((output_mode & Output_Mode::GEOMETRY) ? &it->first.geometry : 0,
               bound_variant(double_coords, output_mode)),
-          (output_mode & Output_Mode::TAGS) ? &it->first.tags : 0,
+          (output_mode & Output_Mode::TAGS) ? &old_tags : 0,
           (output_mode & Output_Mode::META) ? &it->first.meta : 0,
           &roles, &users, output_mode, Output_Handler::modify,
           &it->second.elem,
           &new_broker.make_relation_geom((output_mode & Output_Mode::GEOMETRY) ? &it->second.geometry : 0,
               bound_variant(double_coords_new, output_mode)),
-          (output_mode & Output_Mode::TAGS) ? &it->second.tags : 0,
+          (output_mode & Output_Mode::TAGS) ? &new_tags : 0,
           (output_mode & Output_Mode::META) ? &it->second.meta : 0);
     }
     else
@@ -312,7 +318,7 @@ void print_relations(
       output->print_item(it->second.elem,
           broker.make_relation_geom((output_mode & Output_Mode::GEOMETRY) ? &it->second.geometry : 0,
               bound_variant(double_coords, output_mode)),
-          (output_mode & Output_Mode::TAGS) ? &it->second.tags : 0,
+          (output_mode & Output_Mode::TAGS) ? &new_tags : 0,
           (output_mode & Output_Mode::META) ? &it->second.meta : 0,
           &roles, &users, output_mode, Output_Handler::create);
     }
@@ -327,12 +333,18 @@ void print_deriveds(
   Null_Geometry null_geom;
 
   for (std::vector< Derived_Structure >::const_iterator it = lhs_deriveds.begin(); it != lhs_deriveds.end(); ++it)
-    output->print_item(*it, it->get_geometry() ? *it->get_geometry() : null_geom, &it->tags,
+  {
+    Interned_Tags tags = refer_to_tags(it->tags);
+    output->print_item(*it, it->get_geometry() ? *it->get_geometry() : null_geom, &tags,
         output_mode, Output_Handler::erase);
+  }
 
   for (std::vector< Derived_Structure >::const_iterator it = rhs_deriveds.begin(); it != rhs_deriveds.end(); ++it)
-    output->print_item(*it, it->get_geometry() ? *it->get_geometry() : null_geom, &it->tags,
+  {
+    Interned_Tags tags = refer_to_tags(it->tags);
+    output->print_item(*it, it->get_geometry() ? *it->get_geometry() : null_geom, &tags,
         output_mode, Output_Handler::create);
+  }
 }
 
 
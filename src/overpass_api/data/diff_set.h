@@ -31,6 +31,33 @@
 typedef std::vector< std::pair< std::string, std::string > > Tag_Container;
 
 
+// Copies the tags such that they outlive the store they have been read from
+inline Tag_Container copy_tags(const Interned_Tags* tags)
+{
+  Tag_Container result;
+  if (tags)
+  {
+    result.reserve(tags->size());
+    for (Interned_Tags::const_iterator it = tags->begin(); it != tags->end(); ++it)
+      result.push_back(std::make_pair(*it->first, *it->second));
+  }
+  return result;
+}
+
+
+inline bool same_tags(const Tag_Container& lhs, const Interned_Tags& rhs)
+{
+  if (lhs.size() != rhs.size())
+    return false;
+  for (Tag_Container::size_type i = 0; i < lhs.size(); ++i)
+  {
+    if (lhs[i].first != *rhs[i].first || lhs[i].second != *rhs[i].second)
+      return false;
+  }
+  return true;
+}
+
+
 struct Node_With_Context
 {
   Uint31_Index idx;
@@ -113,6 +113,39 @@ std::set< std::pair< Tag_Index_Global, Tag_Index_Global > > get_regk_req
 }
 
 
+// Restricts ranges of whole keys to the values starting with the prefix of the regular expression
+inline std::set< std::pair< Tag_Index_Global, Tag_Index_Global > > restrict_to_value_prefix
+    (const std::set< std::pair< Tag_Index_Global, Tag_Index_Global > >& key_ranges,
+     const Regular_Expression& value_regex)
+{
+  const std::string& prefix = value_regex.get_prefix();
+  if (prefix.empty())
+    return key_ranges;
+
+  // The smallest value greater than all values with the prefix, if any
+  std::string upper = prefix;
+  while (!upper.empty() && (unsigned char)upper[upper.size()-1] == 0xff)
+    upper.resize(upper.size()-1);
+  if (!upper.empty())
+    ++upper[upper.size()-1];
+
+  std::set< std::pair< Tag_Index_Global, Tag_Index_Global > > result;
+  for (std::set< std::pair< Tag_Index_Global, Tag_Index_Global > >::const_iterator it = key_ranges.begin();
+      it != key_ranges.end(); ++it)
+  {
+    std::pair< Tag_Index_Global, Tag_Index_Global > idx_pair = *it;
+    idx_pair.first.value = prefix;
+    if (!upper.empty())
+    {
+      idx_pair.second.key = idx_pair.first.key;
+      idx_pair.second.value = upper;
+    }
+    result.insert(idx_pair);
+  }
+  return result;
+}
+
+
 template< typename Id_Type >
 bool operator<(const std::pair< Id_Type, Uint31_Index >& lhs, const std::pair< Id_Type, Uint31_Index >& rhs)
 {
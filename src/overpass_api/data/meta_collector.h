@@ -51,6 +51,9 @@ public:
   Meta_Collector(const std::set< std::pair< Index, Index > >& used_ranges,
       Transaction& transaction, const File_Properties* meta_file_prop = 0);
 
+  Meta_Collector(const std::set< Index >& used_indices,
+      Transaction& transaction, const File_Properties* meta_file_prop = 0);
+
   template< typename Object >
   Meta_Collector(const std::map< Index, std::vector< Object > >& items,
       Transaction& transaction, Functor functor, const File_Properties* meta_file_prop = 0);
@@ -155,6 +158,22 @@ Meta_Collector< Index, Id_Type, Functor >::Meta_Collector
 }
 
 
+template< typename Index, typename Id_Type, class Functor >
+Meta_Collector< Index, Id_Type, Functor >::Meta_Collector
+    (const std::set< Index >& used_indices_,
+     Transaction& transaction, const File_Properties* meta_file_prop)
+  : used_indices(used_indices_), meta_db(0), db_it(0), range_it(0), current_index(0), last_index(0)
+{
+  if (!meta_file_prop)
+    return;
+
+  meta_db = new Block_Backend< Index, OSM_Element_Metadata_Skeleton< Id_Type > >
+      (transaction.data_index(meta_file_prop));
+
+  reset();
+}
+
+
 template< typename Index, typename Id_Type, class Functor >
 template< typename Object >
 Meta_Collector< Index, Id_Type, Functor >::Meta_Collector
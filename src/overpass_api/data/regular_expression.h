@@ -28,6 +28,8 @@
 #include "locale.h"
 #include "regex.h"
 
+#include <cctype>
+#include <cstring>
 #include <iostream>
 #include <string>
 
@@ -75,21 +77,121 @@ class Regular_Expression
       is_cache_available = false;
       prev_line = "";
       prev_result = false;
+
+      if (strategy == Strategy::call_library && case_sensitive)
+        extract_literals(regex);
     }
 
     virtual ~Regular_Expression() { };
 
     virtual bool matches(const std::string& line) const = 0;
 
+    // Every matching line starts with the prefix. Empty if there is no such prefix.
+    const std::string& get_prefix() const { return prefix; }
+    // Every matching line contains the literal. Empty if there is no such literal.
+    const std::string& get_literal() const { return literal; }
+
   private:
     Regular_Expression(const Regular_Expression&);
     const Regular_Expression& operator=(const Regular_Expression&);
 
+    std::string prefix;
+    std::string literal;
+
+    // Collects the literal characters up to the first construct whose syntax differs between
+    // the libraries: groups, bracket expressions, intervals, and escaped letters or digits.
+    // A character with a quantifier that allows zero repetitions is not required.
+    // The prefix is the first run of literals if the expression is anchored at the start,
+    // the literal is the longest run of literals.
+    void extract_literals(const std::string& regex)
+    {
+      if (regex.find('|') != std::string::npos)
+        return;
+
+      bool anchored = (!regex.empty() && regex[0] == '^');
+      bool first_run = true;
+      std::string run;
+      std::string::size_type last_unit = 0;
+
+      std::string::size_type i = anchored ? 1 : 0;
+      while (i < regex.size())
+      {
+        unsigned char c = regex[i];
+        if (c == '\\' && i+1 < regex.size() && (unsigned char)regex[i+1] < 0x80 && !isalnum(regex[i+1]))
+        {
+          last_unit = run.size();
+          run += regex[i+1];
+          i += 2;
+          continue;
+        }
+        else if (c == '+' || c == '?' || c == '*')
+        {
+          // A quantifier directly after a quantifier has different meanings in the libraries:
+          // "b+?" is "(b+)?" in POSIX but a lazy "b+" in PCRE. Hence the unit may be absent.
+          bool stacked = (i+1 < regex.size() && (regex[i+1] == '+' || regex[i+1] == '?'
+              || regex[i+1] == '*' || regex[i+1] == '{'));
+          if (c != '+' || stacked)
+            drop_last_unit(run, last_unit);
+          if (stacked)
+            break;
+          end_run(run, anchored && first_run);
+          first_run = false;
+        }
+        else if (c == '.' || c == '^' || c == '$')
+        {
+          end_run(run, anchored && first_run);
+          first_run = false;
+        }
+        else if (c == '{')
+        {
+          drop_last_unit(run, last_unit);
+          break;
+        }
+        else if (c == '\\' || c == '[' || c == ']' || c == '(' || c == ')' || c == '}')
+          break;
+        else
+        {
+          // Multibyte UTF-8 characters are a single unit for the quantifiers
+          last_unit = run.size();
+          run += regex[i];
+          while (i+1 < regex.size() && ((unsigned char)regex[i+1] & 0xc0) == 0x80 && c >= 0xc0)
+            run += regex[++i];
+        }
+        ++i;
+      }
+      end_run(run, anchored && first_run);
+    }
+
+    // The run is empty if the quantified unit has not been a literal, e.g. after a "."
+    static void drop_last_unit(std::string& run, std::string::size_type last_unit)
+    {
+      if (last_unit < run.size())
+        run.resize(last_unit);
+    }
+
+    void end_run(std::string& run, bool is_prefix)
+    {
+      if (is_prefix)
+        prefix = run;
+      if (run.size() > literal.size())
+        literal = run;
+      run.clear();
+    }
+
   protected:
     mutable bool is_cache_available;
     mutable std::string prev_line;
     mutable bool prev_result;
     Strategy strategy;
+
+    // Rejects lines that lack the prefix or the literal without calling the library
+    bool prefilter_rejects(const std::string& line) const
+    {
+      if (!prefix.empty() && line.compare(0, prefix.size(), prefix) != 0)
+        return true;
+      return (literal.size() > prefix.size()
+          && memmem(line.data(), line.size(), literal.data(), literal.size()) == 0);
+    }
 };
 
 
@@ -128,6 +230,9 @@ class Regular_Expression_POSIX : public Regular_Expression
       else if (strategy == Strategy::match_nonempty)
         return !line.empty();
 
+      if (prefilter_rejects(line))
+        return false;
+
       if (is_cache_available && line == prev_line)
         return prev_result;
 
@@ -194,6 +299,9 @@ class Regular_Expression_ICU : public Regular_Expression
       else if (strategy == Strategy::match_nonempty)
         return !line.empty();
 
+      if (prefilter_rejects(line))
+        return false;
+
       if (is_cache_available && line == prev_line)
         return prev_result;
 
@@ -316,6 +424,9 @@ class Regular_Expression_PCRE : public Regular_Expression
       else if (strategy == Strategy::match_nonempty)
         return !line.empty();
 
+      if (prefilter_rejects(line))
+        return false;
+
       if (is_cache_available && line == prev_line)
         return prev_result;
 
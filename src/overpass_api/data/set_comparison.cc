@@ -84,7 +84,7 @@ void Set_Comparison::set_target(bool target)
 
 
 void Set_Comparison::print_item(Extra_Data_For_Diff& extra_data, uint32 ll_upper, const Node_Skeleton& skel,
-                    const std::vector< std::pair< std::string, std::string > >* tags,
+                    const Interned_Tags* tags,
                     const OSM_Element_Metadata_Skeleton< Node_Skeleton::Id_Type >* meta,
                     const std::map< uint32, std::string >* users)
 {
@@ -96,7 +96,7 @@ void Set_Comparison::print_item(Extra_Data_For_Diff& extra_data, uint32 ll_upper
 
 
 void Set_Comparison::print_item(Extra_Data_For_Diff& extra_data, uint32 ll_upper, const Attic< Node_Skeleton >& skel,
-                    const std::vector< std::pair< std::string, std::string > >* tags,
+                    const Interned_Tags* tags,
                     const OSM_Element_Metadata_Skeleton< Node_Skeleton::Id_Type >* meta,
                     const std::map< uint32, std::string >* users)
 {
@@ -108,7 +108,7 @@ void Set_Comparison::print_item(Extra_Data_For_Diff& extra_data, uint32 ll_upper
 
 
 void Set_Comparison::print_item(Extra_Data_For_Diff& extra_data, uint32 ll_upper, const Way_Skeleton& skel,
-                    const std::vector< std::pair< std::string, std::string > >* tags,
+                    const Interned_Tags* tags,
                     const OSM_Element_Metadata_Skeleton< Way_Skeleton::Id_Type >* meta,
                     const std::map< uint32, std::string >* users)
 {
@@ -138,7 +138,7 @@ void Set_Comparison::print_item(Extra_Data_For_Diff& extra_data, uint32 ll_upper
 
 
 void Set_Comparison::print_item(Extra_Data_For_Diff& extra_data, uint32 ll_upper, const Attic< Way_Skeleton >& skel,
-                    const std::vector< std::pair< std::string, std::string > >* tags,
+                    const Interned_Tags* tags,
                     const OSM_Element_Metadata_Skeleton< Way_Skeleton::Id_Type >* meta,
                     const std::map< uint32, std::string >* users)
 {
@@ -168,7 +168,7 @@ void Set_Comparison::print_item(Extra_Data_For_Diff& extra_data, uint32 ll_upper
 
 
 void Set_Comparison::print_item(Extra_Data_For_Diff& extra_data, uint32 ll_upper, const Relation_Skeleton& skel,
-                    const std::vector< std::pair< std::string, std::string > >* tags,
+                    const Interned_Tags* tags,
                     const OSM_Element_Metadata_Skeleton< Relation_Skeleton::Id_Type >* meta,
                     const std::map< uint32, std::string >* users)
 {
@@ -198,7 +198,7 @@ void Set_Comparison::print_item(Extra_Data_For_Diff& extra_data, uint32 ll_upper
 
 
 void Set_Comparison::print_item(Extra_Data_For_Diff& extra_data, uint32 ll_upper, const Attic< Relation_Skeleton >& skel,
-                    const std::vector< std::pair< std::string, std::string > >* tags,
+                    const Interned_Tags* tags,
                     const OSM_Element_Metadata_Skeleton< Relation_Skeleton::Id_Type >* meta,
                     const std::map< uint32, std::string >* users)
 {
@@ -426,19 +426,19 @@ std::map< typename Skeleton::Id_Type, OSM_Element_Metadata_Skeleton< typename Sk
 
 
 void Set_Comparison::store_item(uint32 ll_upper, const Node_Skeleton& skel,
-                            const std::vector< std::pair< std::string, std::string > >* tags,
+                            const Interned_Tags* tags,
                             uint64 timestamp, const OSM_Element_Metadata_Skeleton< Node::Id_Type >* meta,
                             const std::map< uint32, std::string >* users, const Output_Handler::Feature_Action& action,
 			    const OSM_Element_Metadata_Skeleton< Node::Id_Type >* new_meta)
 {
   nodes.push_back(Node_With_Context(ll_upper, skel, timestamp,
       meta ? *meta : OSM_Element_Metadata_Skeleton< Node_Skeleton::Id_Type >(),
-      tags ? *tags : std::vector< std::pair< std::string, std::string > >()));
+      copy_tags(tags)));
 }
 
 
 void Set_Comparison::compare_item(uint32 ll_upper, const Node_Skeleton& skel,
-                            const std::vector< std::pair< std::string, std::string > >* tags,
+                            const Interned_Tags* tags,
                             uint64 timestamp, const OSM_Element_Metadata_Skeleton< Node::Id_Type >* meta,
                             const std::map< uint32, std::string >* users, const Output_Handler::Feature_Action& action,
 			    const OSM_Element_Metadata_Skeleton< Node::Id_Type >* new_meta)
@@ -453,14 +453,14 @@ void Set_Comparison::compare_item(uint32 ll_upper, const Node_Skeleton& skel,
 	      std::vector< std::pair< std::string, std::string > >()),
 	  Node_With_Context(ll_upper, skel, timestamp,
               meta ? *meta : OSM_Element_Metadata_Skeleton< Node_Skeleton::Id_Type >(),
-              tags ? *tags : std::vector< std::pair< std::string, std::string > >())));
+              copy_tags(tags))));
   else
   {
     if (!(nodes_it->idx.val() == ll_upper) || !(nodes_it->elem.ll_lower == skel.ll_lower) ||
-          (tags && !(nodes_it->tags == *tags)) || (meta && !(nodes_it->meta.timestamp == meta->timestamp)))
+          (tags && !same_tags(nodes_it->tags, *tags)) || (meta && !(nodes_it->meta.timestamp == meta->timestamp)))
       result.different_nodes.push_back(std::make_pair(*nodes_it, Node_With_Context(ll_upper, skel, timestamp,
                   meta ? *meta : OSM_Element_Metadata_Skeleton< Node_Skeleton::Id_Type >(),
-                  tags ? *tags : std::vector< std::pair< std::string, std::string > >())));
+                  copy_tags(tags))));
 
     nodes_it->idx = 0xffu;
   }
@@ -546,7 +546,7 @@ void Set_Comparison::clear_nodes(Resource_Manager& rman, bool add_deletion_infor
 
 
 void Set_Comparison::store_item(uint32 ll_upper, const Way_Skeleton& skel,
-                            const std::vector< std::pair< std::string, std::string > >* tags,
+                            const Interned_Tags* tags,
                             const std::pair< Quad_Coord, Quad_Coord* >* bounds,
                             const std::vector< Quad_Coord >* geometry,
                             uint64 timestamp, const OSM_Element_Metadata_Skeleton< Way::Id_Type >* meta,
@@ -556,12 +556,12 @@ void Set_Comparison::store_item(uint32 ll_upper, const Way_Skeleton& skel,
   ways.push_back(Way_With_Context(ll_upper, skel,
       geometry ? *geometry : std::vector< Quad_Coord >(),
       timestamp, meta ? *meta : OSM_Element_Metadata_Skeleton< Way_Skeleton::Id_Type >(),
-      tags ? *tags : std::vector< std::pair< std::string, std::string > >()));
+      copy_tags(tags)));
 }
 
 
 void Set_Comparison::compare_item(uint32 ll_upper, const Way_Skeleton& skel,
-                            const std::vector< std::pair< std::string, std::string > >* tags,
+                            const Interned_Tags* tags,
                             const std::pair< Quad_Coord, Quad_Coord* >* bounds,
                             const std::vector< Quad_Coord >* geometry,
                             uint64 timestamp, const OSM_Element_Metadata_Skeleton< Way::Id_Type >* meta,
@@ -581,16 +581,16 @@ void Set_Comparison::compare_item(uint32 ll_upper, const Way_Skeleton& skel,
 	  Way_With_Context(ll_upper, skel,
               geometry ? *geometry : std::vector< Quad_Coord >(),
               timestamp, meta ? *meta : OSM_Element_Metadata_Skeleton< Way_Skeleton::Id_Type >(),
-              tags ? *tags : std::vector< std::pair< std::string, std::string > >())));
+              copy_tags(tags))));
   else
   {
     if (!(ways_it->idx.val() == ll_upper) || !(ways_it->elem.nds() == skel.nds()) ||
           (geometry && !(ways_it->geometry == *geometry)) ||
-          (tags && !(ways_it->tags == *tags)) || (meta && !(ways_it->meta.timestamp == meta->timestamp)))
+          (tags && !same_tags(ways_it->tags, *tags)) || (meta && !(ways_it->meta.timestamp == meta->timestamp)))
       result.different_ways.push_back(std::make_pair(*ways_it, Way_With_Context(ll_upper, skel,
               geometry ? *geometry : std::vector< Quad_Coord >(),
               timestamp, meta ? *meta : OSM_Element_Metadata_Skeleton< Way_Skeleton::Id_Type >(),
-              tags ? *tags : std::vector< std::pair< std::string, std::string > >())));
+              copy_tags(tags))));
 
     ways_it->idx = 0xffu;
   }
@@ -678,7 +678,7 @@ void Set_Comparison::clear_ways(Resource_Manager& rman, bool add_deletion_inform
 
 
 void Set_Comparison::store_item(uint32 ll_upper, const Relation_Skeleton& skel,
-                            const std::vector< std::pair< std::string, std::string > >* tags,
+                            const Interned_Tags* tags,
                             const std::pair< Quad_Coord, Quad_Coord* >* bounds,
                             const std::vector< std::vector< Quad_Coord > >* geometry,
                             uint64 timestamp, const OSM_Element_Metadata_Skeleton< Relation::Id_Type >* meta,
@@ -688,12 +688,12 @@ void Set_Comparison::store_item(uint32 ll_upper, const Relation_Skeleton& skel,
   relations.push_back(Relation_With_Context(ll_upper, skel,
       geometry ? *geometry : std::vector< std::vector< Quad_Coord > >(),
       timestamp, meta ? *meta : OSM_Element_Metadata_Skeleton< Relation_Skeleton::Id_Type >(),
-      tags ? *tags : std::vector< std::pair< std::string, std::string > >()));
+      copy_tags(tags)));
 }
 
 
 void Set_Comparison::compare_item(uint32 ll_upper, const Relation_Skeleton& skel,
-                            const std::vector< std::pair< std::string, std::string > >* tags,
+                            const Interned_Tags* tags,
                             const std::pair< Quad_Coord, Quad_Coord* >* bounds,
                             const std::vector< std::vector< Quad_Coord > >* geometry,
                             uint64 timestamp, const OSM_Element_Metadata_Skeleton< Relation::Id_Type >* meta,
@@ -713,16 +713,16 @@ void Set_Comparison::compare_item(uint32 ll_upper, const Relation_Skeleton& skel
 	  Relation_With_Context(ll_upper, skel,
               geometry ? *geometry : std::vector< std::vector< Quad_Coord > >(),
               timestamp, meta ? *meta : OSM_Element_Metadata_Skeleton< Relation_Skeleton::Id_Type >(),
-              tags ? *tags : std::vector< std::pair< std::string, std::string > >())));
+              copy_tags(tags))));
   else
   {
     if (!(relations_it->idx.val() == ll_upper) || !(relations_it->elem.members() == skel.members()) ||
 	  (geometry && !(relations_it->geometry == *geometry)) ||
-	  (tags && !(relations_it->tags == *tags)) || (meta && !(relations_it->meta.timestamp == meta->timestamp)))
+	  (tags && !same_tags(relations_it->tags, *tags)) || (meta && !(relations_it->meta.timestamp == meta->timestamp)))
       result.different_relations.push_back(std::make_pair(*relations_it, Relation_With_Context(ll_upper, skel,
               geometry ? *geometry : std::vector< std::vector< Quad_Coord > >(),
               timestamp, meta ? *meta : OSM_Element_Metadata_Skeleton< Relation_Skeleton::Id_Type >(),
-              tags ? *tags : std::vector< std::pair< std::string, std::string > >())));
+              copy_tags(tags))));
 
     relations_it->idx = 0xffu;
   }
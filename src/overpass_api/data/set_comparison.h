@@ -69,36 +69,36 @@ public:
 
 private:
   void print_item(Extra_Data_For_Diff& extra_data, uint32 ll_upper, const Node_Skeleton& skel,
-                    const std::vector< std::pair< std::string, std::string > >* tags,
+                    const Interned_Tags* tags,
                     const OSM_Element_Metadata_Skeleton< Node_Skeleton::Id_Type >* meta,
                     const std::map< uint32, std::string >* users);
   void print_item(Extra_Data_For_Diff& extra_data, uint32 ll_upper, const Attic< Node_Skeleton >& skel,
-                    const std::vector< std::pair< std::string, std::string > >* tags,
+                    const Interned_Tags* tags,
                     const OSM_Element_Metadata_Skeleton< Node_Skeleton::Id_Type >* meta,
                     const std::map< uint32, std::string >* users);
   void store_item(uint32 ll_upper, const Node_Skeleton& skel,
-                            const std::vector< std::pair< std::string, std::string > >* tags,
+                            const Interned_Tags* tags,
                             uint64 timestamp, const OSM_Element_Metadata_Skeleton< Node::Id_Type >* meta = 0,
                             const std::map< uint32, std::string >* users = 0,
                             const Output_Handler::Feature_Action& action = Output_Handler::keep,
                             const OSM_Element_Metadata_Skeleton< Node::Id_Type >* new_meta = 0);
   void compare_item(uint32 ll_upper, const Node_Skeleton& skel,
-                            const std::vector< std::pair< std::string, std::string > >* tags,
+                            const Interned_Tags* tags,
                             uint64 timestamp, const OSM_Element_Metadata_Skeleton< Node::Id_Type >* meta = 0,
                             const std::map< uint32, std::string >* users = 0,
                             const Output_Handler::Feature_Action& action = Output_Handler::keep,
                             const OSM_Element_Metadata_Skeleton< Node::Id_Type >* new_meta = 0);
 
   void print_item(Extra_Data_For_Diff& extra_data, uint32 ll_upper, const Way_Skeleton& skel,
-                    const std::vector< std::pair< std::string, std::string > >* tags,
+                    const Interned_Tags* tags,
                     const OSM_Element_Metadata_Skeleton< Way_Skeleton::Id_Type >* meta,
                     const std::map< uint32, std::string >* users);
   void print_item(Extra_Data_For_Diff& extra_data, uint32 ll_upper, const Attic< Way_Skeleton >& skel,
-                    const std::vector< std::pair< std::string, std::string > >* tags,
+                    const Interned_Tags* tags,
                     const OSM_Element_Metadata_Skeleton< Way_Skeleton::Id_Type >* meta,
                     const std::map< uint32, std::string >* users);
   void store_item(uint32 ll_upper, const Way_Skeleton& skel,
-                            const std::vector< std::pair< std::string, std::string > >* tags,
+                            const Interned_Tags* tags,
                             const std::pair< Quad_Coord, Quad_Coord* >* bounds,
                             const std::vector< Quad_Coord >* geometry,
                             uint64 timestamp, const OSM_Element_Metadata_Skeleton< Way::Id_Type >* meta = 0,
@@ -106,7 +106,7 @@ private:
                             const Output_Handler::Feature_Action& action = Output_Handler::keep,
                             const OSM_Element_Metadata_Skeleton< Way::Id_Type >* new_meta = 0);
   void compare_item(uint32 ll_upper, const Way_Skeleton& skel,
-                            const std::vector< std::pair< std::string, std::string > >* tags,
+                            const Interned_Tags* tags,
                             const std::pair< Quad_Coord, Quad_Coord* >* bounds,
                             const std::vector< Quad_Coord >* geometry,
                             uint64 timestamp, const OSM_Element_Metadata_Skeleton< Way::Id_Type >* meta = 0,
@@ -115,15 +115,15 @@ private:
                             const OSM_Element_Metadata_Skeleton< Way::Id_Type >* new_meta = 0);
 
   void print_item(Extra_Data_For_Diff& extra_data, uint32 ll_upper, const Relation_Skeleton& skel,
-                    const std::vector< std::pair< std::string, std::string > >* tags,
+                    const Interned_Tags* tags,
                     const OSM_Element_Metadata_Skeleton< Relation_Skeleton::Id_Type >* meta,
                     const std::map< uint32, std::string >* users);
   void print_item(Extra_Data_For_Diff& extra_data, uint32 ll_upper, const Attic< Relation_Skeleton >& skel,
-                    const std::vector< std::pair< std::string, std::string > >* tags,
+                    const Interned_Tags* tags,
                     const OSM_Element_Metadata_Skeleton< Relation_Skeleton::Id_Type >* meta,
                     const std::map< uint32, std::string >* users);
   void store_item(uint32 ll_upper, const Relation_Skeleton& skel,
-                            const std::vector< std::pair< std::string, std::string > >* tags,
+                            const Interned_Tags* tags,
                             const std::pair< Quad_Coord, Quad_Coord* >* bounds,
                             const std::vector< std::vector< Quad_Coord > >* geometry,
                             uint64 timestamp, const OSM_Element_Metadata_Skeleton< Relation::Id_Type >* meta = 0,
@@ -131,7 +131,7 @@ private:
                             const Output_Handler::Feature_Action& action = Output_Handler::keep,
                             const OSM_Element_Metadata_Skeleton< Relation::Id_Type >* new_meta = 0);
   void compare_item(uint32 ll_upper, const Relation_Skeleton& skel,
-                            const std::vector< std::pair< std::string, std::string > >* tags,
+                            const Interned_Tags* tags,
                             const std::pair< Quad_Coord, Quad_Coord* >* bounds,
                             const std::vector< std::vector< Quad_Coord > >* geometry,
                             uint64 timestamp, const OSM_Element_Metadata_Skeleton< Relation::Id_Type >* meta = 0,
@@ -28,9 +28,26 @@
 
 #include <map>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 
+/* Holds each distinct key or value string only once. Tags are stored as pairs of pointers
+ * into the pool, so equal strings can be compared by their pointers.
+ * The pointers stay valid until clear() is called. */
+class Tag_String_Pool
+{
+public:
+  const std::string* intern(std::string&& s) { return &*strings.insert(std::move(s)).first; }
+  const std::string* intern(const std::string& s) { return &*strings.insert(s).first; }
+  void clear() { strings.clear(); }
+
+private:
+  std::unordered_set< std::string > strings;
+};
+
+
+
 template< typename Index, typename Object >
 class Tag_Store
 {
@@ -39,16 +56,22 @@ public:
   ~Tag_Store();
 
   void prefetch_all(const std::map< Index, std::vector< Object > >& elems);
-  void prefetch_chunk(const std::map< Index, std::vector< Object > >& elems,
+  // Loads the tags of the elements with ids in the given bounds. The ids by coarse index
+  // are computed once by the caller for all chunks, see generate_ids_by_coarse.
+  void prefetch_chunk(const std::map< uint32, std::vector< typename Object::Id_Type > >& all_ids_by_coarse,
       typename Object::Id_Type lower_id_bound, typename Object::Id_Type upper_id_bound);
   void prefetch_all(const std::map< Index, std::vector< Attic< Object > > >& elems);
-  void prefetch_chunk(const std::map< Index, std::vector< Attic< Object > > >& elems,
+  void prefetch_chunk(
+      const std::map< uint32, std::vector< Attic< typename Object::Id_Type > > >& all_attic_ids_by_coarse,
       typename Object::Id_Type lower_id_bound, typename Object::Id_Type upper_id_bound);
 
-  const std::vector< std::pair< std::string, std::string > >* get(const Index& index, const Object& elem);
+  // The returned tags point into the string pool. They stay valid until get() is called
+  // for an element with another coarse index or the next chunk is prefetched.
+  const Interned_Tags* get(const Index& index, const Object& elem);
 
 private:
-  std::map< typename Object::Id_Type, std::vector< std::pair< std::string, std::string > > > tags_by_id;
+  Tag_String_Pool pool;
+  std::map< typename Object::Id_Type, Interned_Tags > tags_by_id;
   Transaction* transaction;
   bool use_index;
   Index stored_index;
@@ -70,24 +93,33 @@ public:
   Tag_Store() {}
 
   void prefetch_all(const std::map< Uint31_Index, std::vector< Derived_Structure > >& elems) {}
-  void prefetch_chunk(const std::map< Uint31_Index, std::vector< Derived_Structure > >& elems,
-      Derived_Structure::Id_Type lower_id_bound, Derived_Structure::Id_Type upper_id_bound) {}
+  void prefetch_chunk(const std::map< uint32, std::vector< Derived_Structure::Id_Type > >&,
+      Derived_Structure::Id_Type, Derived_Structure::Id_Type) {}
 
-  const std::vector< std::pair< std::string, std::string > >* get(
-      const Uint31_Index& index, const Derived_Structure& elem) const { return &elem.tags; }
+  // The returned tags point to the strings of the element and stay valid for the lifetime of the store
+  const Interned_Tags* get(const Uint31_Index& index, const Derived_Structure& elem)
+  {
+    std::map< const Derived_Structure*, Interned_Tags >::iterator it = tags_by_elem.find(&elem);
+    if (it == tags_by_elem.end())
+      it = tags_by_elem.insert(std::make_pair(&elem, refer_to_tags(elem.tags))).first;
+    return &it->second;
+  }
+
+private:
+  std::map< const Derived_Structure*, Interned_Tags > tags_by_elem;
 };
 
 
 template< class Id_Type >
 void collect_attic_tags
-  (std::map< Id_Type, std::vector< std::pair< std::string, std::string > > >& tags_by_id,
+  (std::map< Id_Type, Interned_Tags >& tags_by_id, Tag_String_Pool& pool,
    const Block_Backend< Tag_Index_Local, Id_Type >& current_items_db,
    typename Block_Backend< Tag_Index_Local, Id_Type >::Range_Iterator& current_tag_it,
    const Block_Backend< Tag_Index_Local, Attic< Id_Type > >& attic_items_db,
    typename Block_Backend< Tag_Index_Local, Attic< Id_Type > >::Range_Iterator& attic_tag_it,
    const std::vector< Attic< Id_Type > >& id_vec, uint32 coarse_index)
 {
-  std::map< Attic< Id_Type >, std::vector< std::pair< std::string, std::string > > > found_tags;
+  std::map< Attic< Id_Type >, Interned_Tags > found_tags;
 
   // Collect all id-matched tag information from the current tags
   while ((!(current_tag_it == current_items_db.range_end())) &&
@@ -103,7 +135,7 @@ void collect_attic_tags
             (current_tag_it.handle().id(), 0xffffffffffffffffull));
     if (it_id != it_id_end)
       found_tags[Attic< Id_Type >(current_tag_it.handle().id(), 0xffffffffffffffffull)].push_back
-          (std::make_pair(current_tag_it.index().key, current_tag_it.index().value));
+          (std::make_pair(pool.intern(current_tag_it.index().key), pool.intern(current_tag_it.index().value)));
     ++current_tag_it;
   }
 
@@ -120,13 +152,12 @@ void collect_attic_tags
         = std::upper_bound(id_vec.begin(), id_vec.end(), attic_tag_it.object());
     if (it_id != it_id_end)
       found_tags[attic_tag_it.object()].push_back
-          (std::make_pair(attic_tag_it.index().key, attic_tag_it.index().value));
+          (std::make_pair(pool.intern(attic_tag_it.index().key), pool.intern(attic_tag_it.index().value)));
     ++attic_tag_it;
   }
 
   // Actually take for each object and key of the multiple versions only the oldest valid version
-  for (typename std::map< Attic< Id_Type >, std::vector< std::pair< std::string, std::string > > >
-          ::const_iterator
+  for (typename std::map< Attic< Id_Type >, Interned_Tags >::const_iterator
       it = found_tags.begin(); it != found_tags.end(); ++it)
   {
     typename std::vector< Attic< Id_Type > >::const_iterator it_id
@@ -135,9 +166,9 @@ void collect_attic_tags
         = std::upper_bound(id_vec.begin(), id_vec.end(), it->first);
     while (it_id != it_id_end)
     {
-      std::vector< std::pair< std::string, std::string > >& obj_vec = tags_by_id[*it_id];
-      std::vector< std::pair< std::string, std::string > >::const_iterator last_added_it = it->second.end();
-      for (std::vector< std::pair< std::string, std::string > >::const_iterator
+      Interned_Tags& obj_vec = tags_by_id[*it_id];
+      Interned_Tags::const_iterator last_added_it = it->second.end();
+      for (Interned_Tags::const_iterator
           it_source = it->second.begin(); it_source != it->second.end(); ++it_source)
       {
         if (last_added_it != it->second.end())
@@ -151,7 +182,7 @@ void collect_attic_tags
             last_added_it = it->second.end();
         }
 
-        std::vector< std::pair< std::string, std::string > >::const_iterator it_obj = obj_vec.begin();
+        Interned_Tags::const_iterator it_obj = obj_vec.begin();
         for (; it_obj != obj_vec.end(); ++it_obj)
         {
           if (it_obj->first == it_source->first)
@@ -168,14 +199,13 @@ void collect_attic_tags
   }
 
   // Remove empty tags. They are placeholders for tags added later than each timestamp in question.
-  for (typename std::map< Id_Type, std::vector< std::pair< std::string, std::string > > >
-          ::iterator
+  const std::string* void_value = pool.intern(void_tag_value());
+  for (typename std::map< Id_Type, Interned_Tags >::iterator
       it_obj = tags_by_id.begin(); it_obj != tags_by_id.end(); ++it_obj)
   {
-    for (typename std::vector< std::pair< std::string, std::string > >::size_type
-        i = 0; i < it_obj->second.size(); )
+    for (Interned_Tags::size_type i = 0; i < it_obj->second.size(); )
     {
-      if (it_obj->second[i].second == void_tag_value())
+      if (it_obj->second[i].second == void_value)
       {
         it_obj->second[i] = it_obj->second.back();
         it_obj->second.pop_back();
@@ -189,40 +219,36 @@ void collect_attic_tags
 
 template< class Id_Type >
 void collect_attic_tags
-  (std::map< Id_Type, std::vector< std::pair< std::string, std::string > > >& tags_by_id,
+  (std::map< Id_Type, Interned_Tags >& tags_by_id, Tag_String_Pool& pool,
    const Block_Backend< Tag_Index_Local, Id_Type >& current_items_db,
    typename Block_Backend< Tag_Index_Local, Id_Type >::Range_Iterator& current_tag_it,
    const Block_Backend< Tag_Index_Local, Attic< Id_Type > >& attic_items_db,
    typename Block_Backend< Tag_Index_Local, Attic< Id_Type > >::Range_Iterator& attic_tag_it,
-   std::map< uint32, std::vector< Attic< Id_Type > > >& ids_by_coarse,
+   const std::map< uint32, std::vector< Attic< Id_Type > > >& ids_by_coarse,
    uint32 coarse_index,
    Id_Type lower_id_bound, Id_Type upper_id_bound)
 {
-  std::vector< Attic< Id_Type > > id_vec = ids_by_coarse[coarse_index];
+  typename std::map< uint32, std::vector< Attic< Id_Type > > >::const_iterator
+      coarse_it = ids_by_coarse.find(coarse_index);
+  if (coarse_it == ids_by_coarse.end())
+    return;
 
+  typename std::vector< Attic< Id_Type > >::const_iterator begin_it = coarse_it->second.begin();
+  typename std::vector< Attic< Id_Type > >::const_iterator end_it = coarse_it->second.end();
   if (!(upper_id_bound == Id_Type()))
-  {
-    typename std::vector< Attic< Id_Type > >::iterator it_id
-        = std::lower_bound(id_vec.begin(), id_vec.end(),
-                           Attic< Id_Type >(upper_id_bound, 0ull));
-    id_vec.erase(it_id, id_vec.end());
-  }
+    end_it = std::lower_bound(begin_it, end_it, Attic< Id_Type >(upper_id_bound, 0ull));
   if (!(lower_id_bound == Id_Type()))
-  {
-    typename std::vector< Attic< Id_Type > >::iterator it_id
-        = std::lower_bound(id_vec.begin(), id_vec.end(),
-                           Attic< Id_Type >(lower_id_bound, 0ull));
-    id_vec.erase(id_vec.begin(), it_id);
-  }
+    begin_it = std::lower_bound(begin_it, end_it, Attic< Id_Type >(lower_id_bound, 0ull));
+  std::vector< Attic< Id_Type > > id_vec(begin_it, end_it);
 
-  collect_attic_tags< Id_Type >(tags_by_id, current_items_db, current_tag_it, attic_items_db, attic_tag_it,
+  collect_attic_tags< Id_Type >(tags_by_id, pool, current_items_db, current_tag_it, attic_items_db, attic_tag_it,
       id_vec, coarse_index);
 }
 
 
 template< class Id_Type >
 void collect_tags
-  (std::map< Id_Type, std::vector< std::pair< std::string, std::string > > >& tags_by_id,
+  (std::map< Id_Type, Interned_Tags >& tags_by_id, Tag_String_Pool& pool,
    const Block_Backend< Tag_Index_Local, Id_Type >& items_db,
    typename Block_Backend< Tag_Index_Local, Id_Type >::Range_Iterator& tag_it,
    const std::vector< Id_Type >& ids, uint32 coarse_index)
@@ -238,39 +264,7 @@ void collect_tags
     {
       auto elem = tag_it.index_handle().get_element();
       tags_by_id[current].push_back
-          (std::make_pair(std::move(elem.key), std::move(elem.value)));
-    }
-    ++tag_it;
-  }
-}
-
-
-template< class Id_Type >
-void collect_tags_framed
-  (std::map< Id_Type, std::vector< std::pair< std::string, std::string > > >& tags_by_id,
-   const Block_Backend< Tag_Index_Local, Id_Type >& items_db,
-   typename Block_Backend< Tag_Index_Local, Id_Type >::Range_Iterator& tag_it,
-   std::map< uint32, std::vector< Id_Type > >& ids_by_coarse,
-   uint32 coarse_index,
-   Id_Type lower_id_bound, Id_Type upper_id_bound)
-{
-  const std::vector< Id_Type > & ids_by_coarse_ref = ids_by_coarse[coarse_index];
-
-  while ((!(tag_it == items_db.range_end())) &&
-      (((tag_it.index_handle().get_index()) & 0x7fffff00) < coarse_index))
-    ++tag_it;
-  while ((!(tag_it == items_db.range_end())) &&
-      (((tag_it.index_handle().get_index()) & 0x7fffff00) == coarse_index))
-  {
-    Id_Type current(tag_it.handle().id());     // avoid creating a new object instance via object()
-
-    if (!(current < lower_id_bound) &&
-      (current < upper_id_bound) &&
-       binary_search(ids_by_coarse_ref.begin(), ids_by_coarse_ref.end(), current))
-    {
-      auto elem = tag_it.index_handle().get_element();
-      tags_by_id[current].push_back
-          (std::make_pair(std::move(elem.key), std::move(elem.value)));
+          (std::make_pair(pool.intern(std::move(elem.key)), pool.intern(std::move(elem.value))));
     }
     ++tag_it;
   }
@@ -279,7 +273,8 @@ void collect_tags_framed
 
 template< typename Index, typename Object >
 Tag_Store< Index, Object >::Tag_Store(Transaction& transaction_)
-    : transaction(&transaction_), use_index(false), items_db(0), tag_it(0), attic_items_db(0), attic_tag_it(0) {}
+    : transaction(&transaction_), use_index(false),
+      items_db(0), tag_it(0), attic_items_db(0), attic_tag_it(0) {}
 
 
 template< typename Index, typename Object >
@@ -305,25 +300,38 @@ void Tag_Store< Index, Object >::prefetch_all(const std::map< Index, std::vector
   if (!ids_by_coarse.empty())
   {
     tags_by_id.clear();
+    pool.clear();
     stored_index = ids_by_coarse.begin()->first;
-    collect_tags< typename Object::Id_Type >(tags_by_id, *items_db, *tag_it,
+    collect_tags< typename Object::Id_Type >(tags_by_id, pool, *items_db, *tag_it,
         ids_by_coarse[stored_index.val()], stored_index.val());
   }
 }
 
 
 template< typename Index, typename Object >
-void Tag_Store< Index, Object >::prefetch_chunk(const std::map< Index, std::vector< Object > >& elems,
+void Tag_Store< Index, Object >::prefetch_chunk(
+    const std::map< uint32, std::vector< typename Object::Id_Type > >& all_ids_by_coarse,
     typename Object::Id_Type lower_id_bound, typename Object::Id_Type upper_id_bound)
 {
   tags_by_id.clear();
+  pool.clear();
 
-  //generate std::set of relevant coarse indices
-  generate_ids_by_coarse(ids_by_coarse, elems);
+  //restrict the coarse indices to those with elements in this chunk
+  std::map< uint32, std::vector< typename Object::Id_Type > > chunk_ids_by_coarse;
+  for (typename std::map< uint32, std::vector< typename Object::Id_Type > >::const_iterator
+      it = all_ids_by_coarse.begin(); it != all_ids_by_coarse.end(); ++it)
+  {
+    typename std::vector< typename Object::Id_Type >::const_iterator lower_it
+        = std::lower_bound(it->second.begin(), it->second.end(), lower_id_bound);
+    typename std::vector< typename Object::Id_Type >::const_iterator upper_it
+        = std::lower_bound(lower_it, it->second.end(), upper_id_bound);
+    if (lower_it != upper_it)
+      chunk_ids_by_coarse[it->first].assign(lower_it, upper_it);
+  }
 
   //formulate range query
   std::set< std::pair< Tag_Index_Local, Tag_Index_Local > > range_set;
-  formulate_range_query(range_set, ids_by_coarse);
+  formulate_range_query(range_set, chunk_ids_by_coarse);
 
   Block_Backend< Tag_Index_Local, typename Object::Id_Type > items_db
       (transaction->data_index(current_local_tags_file_properties< Object >()));
@@ -333,9 +341,8 @@ void Tag_Store< Index, Object >::prefetch_chunk(const std::map< Index, std::vect
       (Default_Range_Iterator< Tag_Index_Local >(range_set.begin()),
        Default_Range_Iterator< Tag_Index_Local >(range_set.end())));
   for (typename std::map< uint32, std::vector< typename Object::Id_Type > >::const_iterator
-      it = ids_by_coarse.begin(); it != ids_by_coarse.end(); ++it)
-    collect_tags_framed< typename Object::Id_Type >(tags_by_id, items_db, tag_it, ids_by_coarse, it->first,
-		  lower_id_bound, upper_id_bound);
+      it = chunk_ids_by_coarse.begin(); it != chunk_ids_by_coarse.end(); ++it)
+    collect_tags< typename Object::Id_Type >(tags_by_id, pool, items_db, tag_it, it->second, it->first);
 }
 
 
@@ -372,23 +379,22 @@ void Tag_Store< Index, Object >::prefetch_all(const std::map< Index, std::vector
   if (!attic_ids_by_coarse.empty())
   {
     tags_by_id.clear();
+    pool.clear();
     stored_index = attic_ids_by_coarse.begin()->first;
-    collect_attic_tags< typename Object::Id_Type >(tags_by_id, *items_db, *tag_it, *attic_items_db, *attic_tag_it,
+    collect_attic_tags< typename Object::Id_Type >(tags_by_id, pool, *items_db, *tag_it, *attic_items_db, *attic_tag_it,
         attic_ids_by_coarse[stored_index.val()], stored_index.val());
   }
 }
 
 
 template< typename Index, typename Object >
-void Tag_Store< Index, Object >::prefetch_chunk(const std::map< Index, std::vector< Attic< Object > > >& attic_items,
+void Tag_Store< Index, Object >::prefetch_chunk(
+    const std::map< uint32, std::vector< Attic< typename Object::Id_Type > > >& all_attic_ids_by_coarse,
     typename Object::Id_Type lower_id_bound, typename Object::Id_Type upper_id_bound)
 {
-  //generate std::set of relevant coarse indices
-  generate_ids_by_coarse(attic_ids_by_coarse, attic_items);
-
   //formulate range query
   std::set< std::pair< Tag_Index_Local, Tag_Index_Local > > attic_range_set;
-  formulate_range_query(attic_range_set, attic_ids_by_coarse);
+  formulate_range_query(attic_range_set, all_attic_ids_by_coarse);
 
   Block_Backend< Tag_Index_Local, typename Object::Id_Type > current_tags_db
       (transaction->data_index(current_local_tags_file_properties< Object >()));
@@ -404,9 +410,9 @@ void Tag_Store< Index, Object >::prefetch_chunk(const std::map< Index, std::vect
       (Default_Range_Iterator< Tag_Index_Local >(attic_range_set.begin()),
        Default_Range_Iterator< Tag_Index_Local >(attic_range_set.end())));
   for (typename std::map< uint32, std::vector< Attic< typename Object::Id_Type > > >::const_iterator
-      it = attic_ids_by_coarse.begin(); it != attic_ids_by_coarse.end(); ++it)
-    collect_attic_tags(tags_by_id, current_tags_db, current_tag_it, attic_tags_db, attic_tag_it,
-               attic_ids_by_coarse, it->first, lower_id_bound, upper_id_bound);
+      it = all_attic_ids_by_coarse.begin(); it != all_attic_ids_by_coarse.end(); ++it)
+    collect_attic_tags(tags_by_id, pool, current_tags_db, current_tag_it, attic_tags_db, attic_tag_it,
+               all_attic_ids_by_coarse, it->first, lower_id_bound, upper_id_bound);
 }
 
 
@@ -421,18 +427,18 @@ Tag_Store< Index, Object >::~Tag_Store()
 
 
 template< typename Index, typename Object >
-const std::vector< std::pair< std::string, std::string > >*
-    Tag_Store< Index, Object >::get(const Index& index, const Object& elem)
+const Interned_Tags* Tag_Store< Index, Object >::get(const Index& index, const Object& elem)
 {
   if (use_index && stored_index < Index(index.val() & 0x7fffff00))
   {
     tags_by_id.clear();
+    pool.clear();
     stored_index = Index(index.val() & 0x7fffff00);
     if (attic_items_db)
-      collect_attic_tags< typename Object::Id_Type >(tags_by_id, *items_db, *tag_it, *attic_items_db, *attic_tag_it,
+      collect_attic_tags< typename Object::Id_Type >(tags_by_id, pool, *items_db, *tag_it, *attic_items_db, *attic_tag_it,
           attic_ids_by_coarse[stored_index.val()], stored_index.val());
     else
-      collect_tags< typename Object::Id_Type >(tags_by_id, *items_db, *tag_it,
+      collect_tags< typename Object::Id_Type >(tags_by_id, pool, *items_db, *tag_it,
           ids_by_coarse[stored_index.val()], stored_index.val());
   }
   else if (use_index && Index(index.val() & 0x7fffff00) < stored_index)
@@ -459,22 +465,22 @@ const std::vector< std::pair< std::string, std::string > >*
     }
 
     tags_by_id.clear();
+    pool.clear();
     stored_index = Index(index.val() & 0x7fffff00);
     if (attic_items_db)
-      collect_attic_tags< typename Object::Id_Type >(tags_by_id, *items_db, *tag_it, *attic_items_db, *attic_tag_it,
+      collect_attic_tags< typename Object::Id_Type >(tags_by_id, pool, *items_db, *tag_it, *attic_items_db, *attic_tag_it,
           attic_ids_by_coarse[stored_index.val()], stored_index.val());
     else
-      collect_tags< typename Object::Id_Type >(tags_by_id, *items_db, *tag_it,
+      collect_tags< typename Object::Id_Type >(tags_by_id, pool, *items_db, *tag_it,
           ids_by_coarse[stored_index.val()], stored_index.val());
   }
 
-  typename std::map< typename Object::Id_Type, std::vector< std::pair< std::string, std::string > > >::const_iterator
+  typename std::map< typename Object::Id_Type, Interned_Tags >::const_iterator
       it = tags_by_id.find(elem.id);
-
-  if (it != tags_by_id.end())
-    return &it->second;
-  else
+  if (it == tags_by_id.end())
     return 0;
+
+  return &it->second;
 }
 
 
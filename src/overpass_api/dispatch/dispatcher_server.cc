@@ -208,6 +208,8 @@ int main(int argc, char* argv[])
   uint64 max_allowed_space = 0;
   uint64 max_allowed_time_units = 0;
   int rate_limit = -1;
+  uint64 block_cache_size = 0;
+  bool use_mmap = false;
 
   int argpos(1);
   while (argpos < argc)
@@ -246,6 +248,10 @@ int main(int argc, char* argv[])
       max_allowed_time_units = atoll(((std::string)argv[argpos]).substr(7).c_str());
     else if (!(strncmp(argv[argpos], "--rate-limit=", 13)))
       rate_limit = atoll(((std::string)argv[argpos]).substr(13).c_str());
+    else if (!(strncmp(argv[argpos], "--block-cache=", 14)))
+      block_cache_size = atoll(((std::string)argv[argpos]).substr(14).c_str());
+    else if (std::string("--use-mmap") == argv[argpos])
+      use_mmap = true;
     else
     {
       std::cout<<"Unknown argument: "<<argv[argpos]<<"\n\n"
@@ -264,7 +270,9 @@ int main(int argc, char* argv[])
       "  --query_token: Returns the pid of a running query for the same client IP.\n"
       "  --space=number: Set the memory limit for the total of all running processes to this value in bytes.\n"
       "  --time=number: Set the time unit  limit for the total of all running processes to this value in bytes.\n"
-      "  --rate-limit=number: Set the maximum allowed number of concurrent accesses from a single IP.\n";
+      "  --rate-limit=number: Set the maximum allowed number of concurrent accesses from a single IP.\n"
+      "  --block-cache=number: Share this many bytes of decompressed blocks between all reading processes.\n"
+      "  --use-mmap: Let the reading processes map the data files into memory instead of reading them.\n";
 
       return 0;
     }
@@ -532,6 +540,10 @@ int main(int argc, char* argv[])
 	 files_to_manage, disp_logger.get());
     if (rate_limit > -1)
       dispatcher.set_rate_limit(rate_limit);
+    if (block_cache_size > 0)
+      dispatcher.enable_block_cache(block_cache_size);
+    if (use_mmap)
+      dispatcher.set_use_mmap(true);
     dispatcher.standby_loop(0);
 
     logger.annotated_log("Dispatcher process has terminated.");
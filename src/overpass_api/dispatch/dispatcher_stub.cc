@@ -68,6 +68,34 @@ std::string de_escape(std::string input)
 }
 
 
+std::string osm_base_generation(Dispatcher_Client& dispatcher_client)
+{
+  std::ifstream replicate_id_stream((dispatcher_client.get_db_dir() + "replicate_id").c_str());
+  std::string replicate_id;
+  getline(replicate_id_stream, replicate_id);
+  // The replicate_id file is written only after the update has been committed,
+  // hence the commit generation must be part of the key for cached indexes.
+  std::ostringstream generation;
+  generation<<replicate_id<<' '<<dispatcher_client.get_commit_generation();
+  return generation.str();
+}
+
+
+std::string area_generation(Dispatcher_Client& area_dispatcher_client, std::string& area_timestamp)
+{
+  {
+    std::ifstream version((area_dispatcher_client.get_db_dir() + "area_version").c_str());
+    getline(version, area_timestamp);
+    area_timestamp = de_escape(area_timestamp);
+  }
+  // The area database has no replicate_id, but its version and the commit generation
+  // identify the state of its indexes just as well.
+  std::ostringstream generation;
+  generation<<area_timestamp<<' '<<area_dispatcher_client.get_commit_generation();
+  return generation.str();
+}
+
+
 void set_limits(uint32 time, uint64 space)
 {
   rlimit limit;
@@ -134,7 +162,8 @@ Dispatcher_Stub::Dispatcher_Stub
 
 Dispatcher_Stub::Dispatcher_Stub
     (std::string db_dir_, Error_Output* error_output_, std::string xml_raw, meta_modes meta_, int area_level,
-     uint32 max_allowed_time, uint64 max_allowed_space, Parsed_Query& global_settings, Index_Cache* ic)
+     uint32 max_allowed_time, uint64 max_allowed_space, Parsed_Query& global_settings,
+     Index_Cache* ic, Index_Cache* area_ic)
     : db_dir(db_dir_), error_output(error_output_),
       dispatcher_client(0), area_dispatcher_client(0),
       transaction(0), area_transaction(0), rman(0), meta(meta_), client_token(0)
@@ -179,6 +208,9 @@ Dispatcher_Stub::Dispatcher_Stub
     else
       transaction = new Nonsynced_Transaction
           (false, false, dispatcher_client->get_db_dir(), "");
+    transaction->set_block_cache
+        (dispatcher_client->get_block_cache(), dispatcher_client->get_block_cache_generation());
+    transaction->set_use_mmap(dispatcher_client->get_use_mmap());
 
     {
       std::ifstream version((dispatcher_client->get_db_dir() + "osm_base_version").c_str());
@@ -186,12 +218,7 @@ Dispatcher_Stub::Dispatcher_Stub
       timestamp = de_escape(timestamp);
     }
 
-    {
-      std::ifstream replicate_id_stream((dispatcher_client->get_db_dir() + "replicate_id").c_str());
-      std::string replicate_id;
-      getline(replicate_id_stream, replicate_id);
-      transaction->set_replicate_id(replicate_id);
-    }
+    transaction->set_replicate_id(osm_base_generation(*dispatcher_client));
 
     transaction->flush_outdated_index_cache();
 
@@ -262,14 +289,17 @@ Dispatcher_Stub::Dispatcher_Stub
 	  logger.annotated_log(out.str());
 	  throw;
 	}
-	area_transaction = new Nonsynced_Transaction
-            (false, false, area_dispatcher_client->get_db_dir(), "");
-	{
-	  std::ifstream version((area_dispatcher_client->get_db_dir() +
-	      "area_version").c_str());
-	  getline(version, area_timestamp);
-	  area_timestamp = de_escape(area_timestamp);
-	}
+	if (area_ic != nullptr)
+	  area_transaction = new Nonsynced_Transaction
+              (false, false, area_dispatcher_client->get_db_dir(), "", area_ic);
+	else
+	  area_transaction = new Nonsynced_Transaction
+              (false, false, area_dispatcher_client->get_db_dir(), "");
+	area_transaction->set_block_cache(area_dispatcher_client->get_block_cache(),
+	    area_dispatcher_client->get_block_cache_generation());
+	area_transaction->set_use_mmap(area_dispatcher_client->get_use_mmap());
+	area_transaction->set_replicate_id(area_generation(*area_dispatcher_client, area_timestamp));
+	area_transaction->flush_outdated_index_cache();
       }
       else if (area_level == 2)
       {
@@ -56,7 +56,7 @@ class Dispatcher_Stub : public Watchdog_Callback
     Dispatcher_Stub(std::string db_dir_, Error_Output* error_output_, std::string xml_raw,
                     meta_modes meta_, int area_level,
                     uint32 max_allowed_time, uint64 max_allowed_space, Parsed_Query& global_settings_,
-                    Index_Cache* ic);
+                    Index_Cache* ic, Index_Cache* area_ic = nullptr);
 
     // Called once per minute from the resource manager
     virtual void ping() const;
@@ -88,4 +88,11 @@ class Dispatcher_Stub : public Watchdog_Callback
 };
 
 
+/* Identify the committed state of the main resp. the area database behind a dispatcher.
+ * They change with every commit of the respective dispatcher and are used as the replicate_id
+ * of the read transactions. They can be evaluated without registering a read operation. */
+std::string osm_base_generation(Dispatcher_Client& dispatcher_client);
+std::string area_generation(Dispatcher_Client& area_dispatcher_client, std::string& area_timestamp);
+
+
 #endif
@@ -0,0 +1,352 @@
+/** Copyright 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018 Roland Olbricht et al.
+ *
+ * This file is part of Overpass_API.
+ *
+ * Overpass_API is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Overpass_API is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Overpass_API.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "query_plan_cache.h"
+#include "../frontend/output_handler_parser.h"
+#include "../frontend/tokenizer_utils.h"
+
+#include <cctype>
+#include <set>
+#include <sstream>
+
+
+namespace
+{
+  // Stands for a literal in the query text. It cannot appear in a valid query.
+  const char LITERAL_MARK = '\x01';
+
+
+  bool is_timestamp(const std::string& s)
+  {
+    static const char pattern[] = "dddd-dd-ddTdd:dd:ddZ";
+    if (s.size() != sizeof(pattern) - 1)
+      return false;
+    for (std::string::size_type i = 0; i < s.size(); ++i)
+    {
+      if (pattern[i] == 'd' ? !isdigit(s[i]) : s[i] != pattern[i])
+        return false;
+    }
+    return true;
+  }
+
+
+  bool is_map_ql(const std::string& query)
+  {
+    std::string::size_type pos = 0;
+    while (pos < query.size() && isspace(query[pos]))
+      ++pos;
+    return pos < query.size() && query[pos] != '<';
+  }
+
+
+  // Statements that do not change their state when executed
+  bool is_reusable(const std::string& element)
+  {
+    static const std::set< std::string > reusable = {
+        "osm-script", "query", "bbox-query", "id-query", "has-kv", "union", "print", "recurse", "item" };
+    return reusable.find(element) != reusable.end();
+  }
+
+
+  std::string plan_key(const std::map< std::string, std::string >& input_params, std::vector< std::string >& literals)
+  {
+    std::string key;
+    std::map< std::string, std::string >::const_iterator data_it = input_params.find("data");
+    if (data_it != input_params.end())
+      split_query_literals(data_it->second, key, literals);
+
+    for (std::map< std::string, std::string >::const_iterator it = input_params.begin();
+        it != input_params.end(); ++it)
+    {
+      if (it != data_it)
+        key += '\0' + it->first + '=' + it->second;
+    }
+    return key;
+  }
+
+
+  bool fixed_literals_match(const Query_Plan& plan, const std::vector< std::string >& literals)
+  {
+    if (plan.literals.size() != literals.size())
+      return false;
+    for (uint32 i = 0; i < literals.size(); ++i)
+    {
+      if (!plan.is_slot[i] && plan.literals[i] != literals[i])
+        return false;
+    }
+    return true;
+  }
+}
+
+
+void split_query_literals(const std::string& query, std::string& shape, std::vector< std::string >& literals)
+{
+  shape.clear();
+  literals.clear();
+
+  char last = 0;
+  bool space_pending = false;
+  std::string::size_type pos = 0;
+  while (pos < query.size())
+  {
+    char c = query[pos];
+    if (isspace(c))
+    {
+      space_pending = !shape.empty();
+      ++pos;
+      continue;
+    }
+    if (space_pending)
+    {
+      shape += ' ';
+      space_pending = false;
+    }
+
+    if (c == '"' || c == '\'')
+    {
+      std::string::size_type end = pos + 1;
+      while (end < query.size() && query[end] != c)
+        end += (query[end] == '\\' ? 2 : 1);
+      end = std::min(end, query.size() - 1);
+
+      std::string content = query.substr(pos + 1, end - pos - 1);
+      if (is_timestamp(content))
+      {
+        shape += c;
+        shape += LITERAL_MARK;
+        shape += c;
+        literals.push_back(content);
+      }
+      else
+        shape.append(query, pos, end - pos + 1);
+      pos = end + 1;
+      last = c;
+      continue;
+    }
+
+    if (c == '/' && pos + 1 < query.size() && (query[pos + 1] == '/' || query[pos + 1] == '*'))
+    {
+      std::string::size_type end = (query[pos + 1] == '/' ? query.find('\n', pos) : query.find("*/", pos + 2));
+      end = (end == std::string::npos ? query.size() : end + (query[pos + 1] == '/' ? 0 : 2));
+      shape.append(query, pos, end - pos);
+      pos = end;
+      continue;
+    }
+
+    char prev = (pos > 0 ? query[pos - 1] : 0);
+    bool in_identifier = isalnum(prev) || prev == '_' || prev == '.';
+    bool negative = (c == '-' && pos + 1 < query.size() && isdigit(query[pos + 1])
+        && (last == '(' || last == ',' || last == ':'));
+    if ((isdigit(c) || negative) && !in_identifier)
+    {
+      std::string::size_type end = pos + 1;
+      while (end < query.size() && (isdigit(query[end]) || query[end] == '.'))
+        ++end;
+      literals.push_back(query.substr(pos, end - pos));
+      shape += LITERAL_MARK;
+      pos = end;
+      last = '0';
+      continue;
+    }
+
+    shape += c;
+    last = c;
+    ++pos;
+  }
+}
+
+
+void Query_Plan::statement_created(Statement* statement, const std::string& element,
+    const std::map< std::string, std::string >& attributes)
+{
+  created.push_back(Created_Statement(statement, element, attributes));
+}
+
+
+Query_Plan* Query_Plan_Cache::find(const std::map< std::string, std::string >& input_params)
+{
+  std::map< std::string, std::string >::const_iterator data_it = input_params.find("data");
+  if (max_size == 0 || data_it == input_params.end() || !is_map_ql(data_it->second))
+    return 0;
+
+  std::vector< std::string > literals;
+  std::map< std::string, std::vector< std::unique_ptr< Query_Plan > > >::iterator it
+      = plans.find(plan_key(input_params, literals));
+  if (it == plans.end())
+    return 0;
+
+  for (std::vector< std::unique_ptr< Query_Plan > >::iterator pit = it->second.begin(); pit != it->second.end(); ++pit)
+  {
+    Query_Plan& plan = **pit;
+    if (!fixed_literals_match(plan, literals))
+      continue;
+
+    for (std::vector< std::pair< Statement*, std::vector< Query_Plan::Slot > > >::const_iterator
+        sit = plan.slots.begin(); sit != plan.slots.end(); ++sit)
+    {
+      std::map< std::string, std::string > values;
+      for (std::vector< Query_Plan::Slot >::const_iterator vit = sit->second.begin(); vit != sit->second.end(); ++vit)
+        values[vit->attribute] = literals[vit->literal];
+      if (!sit->first->bind_parameters(values))
+        return 0;
+    }
+
+    Output_Handler_Parser* format_parser = Output_Handler_Parser::get_format_parser(plan.output_format);
+    if (!format_parser)
+      return 0;
+
+    plan.global_settings.set_input_params(input_params);
+    if (plan.output_config.empty())
+      plan.global_settings.set_output_handler(format_parser, 0, 0);
+    else
+    {
+      std::istringstream in(plan.output_config);
+      Tokenizer_Wrapper token(in);
+      plan.global_settings.set_output_handler(format_parser, &token, 0);
+    }
+    if (!plan.global_settings.get_output_handler())
+      return 0;
+
+    plan.last_used = ++use_counter;
+    return &plan;
+  }
+
+  return 0;
+}
+
+
+void Query_Plan_Cache::insert(std::unique_ptr< Query_Plan >& plan)
+{
+  const std::map< std::string, std::string >& input_params = plan->global_settings.get_input_params();
+  std::map< std::string, std::string >::const_iterator data_it = input_params.find("data");
+  if (max_size == 0 || plan->area_level > 0 || data_it == input_params.end() || !is_map_ql(data_it->second))
+    return;
+
+  // All statements must be known with their attributes
+  std::set< Statement* > recorded;
+  const Query_Plan::Created_Statement* osm_script = 0;
+  for (std::vector< Query_Plan::Created_Statement >::const_iterator it = plan->created.begin();
+      it != plan->created.end(); ++it)
+  {
+    if (!is_reusable(it->element))
+      return;
+    recorded.insert(it->statement);
+    if (it->element == "osm-script")
+      osm_script = &*it;
+  }
+  for (std::vector< Statement* >::const_iterator it = plan->stmt_factory.created_statements.begin();
+      it != plan->stmt_factory.created_statements.end(); ++it)
+  {
+    if (recorded.find(*it) == recorded.end())
+      return;
+  }
+  if (!osm_script)
+    return;
+
+  std::map< std::string, std::string >::const_iterator attr_it = osm_script->attributes.find("from");
+  if (attr_it != osm_script->attributes.end() && !attr_it->second.empty())
+    return;
+  attr_it = osm_script->attributes.find("output");
+  plan->output_format = (attr_it != osm_script->attributes.end() ? attr_it->second : "xml");
+  attr_it = osm_script->attributes.find("output-config");
+  plan->output_config = (attr_it != osm_script->attributes.end() ? attr_it->second : "");
+
+  std::string key = plan_key(input_params, plan->literals);
+
+  // A literal is a slot if its value appears exactly once in the query
+  // and exactly once as attribute value of a statement that accepts rebinding it
+  std::map< std::string, uint32 > literal_count;
+  for (std::vector< std::string >::const_iterator it = plan->literals.begin(); it != plan->literals.end(); ++it)
+    ++literal_count[*it];
+
+  std::map< std::string, std::vector< std::pair< const Query_Plan::Created_Statement*, std::string > > > used_by;
+  for (std::vector< Query_Plan::Created_Statement >::const_iterator it = plan->created.begin();
+      it != plan->created.end(); ++it)
+  {
+    for (std::map< std::string, std::string >::const_iterator ait = it->attributes.begin();
+        ait != it->attributes.end(); ++ait)
+    {
+      if (literal_count.find(ait->second) != literal_count.end())
+        used_by[ait->second].push_back(std::make_pair(&*it, ait->first));
+    }
+  }
+
+  plan->is_slot.assign(plan->literals.size(), false);
+  std::map< Statement*, std::vector< Query_Plan::Slot > > slots;
+  for (uint32 i = 0; i < plan->literals.size(); ++i)
+  {
+    const std::string& literal = plan->literals[i];
+    std::map< std::string, std::vector< std::pair< const Query_Plan::Created_Statement*, std::string > > >::const_iterator
+        uit = used_by.find(literal);
+    if (literal_count[literal] != 1 || uit == used_by.end() || uit->second.size() != 1)
+      continue;
+
+    std::map< std::string, std::string > values;
+    values[uit->second.front().second] = literal;
+    if (!uit->second.front().first->statement->bind_parameters(values))
+      continue;
+
+    plan->is_slot[i] = true;
+    slots[uit->second.front().first->statement].push_back(Query_Plan::Slot(uit->second.front().second, i));
+  }
+  plan->slots.assign(slots.begin(), slots.end());
+  plan->created.clear();
+  plan->last_used = ++use_counter;
+
+  std::vector< std::unique_ptr< Query_Plan > >& same_key = plans[key];
+  for (std::vector< std::unique_ptr< Query_Plan > >::iterator it = same_key.begin(); it != same_key.end(); ++it)
+  {
+    if (fixed_literals_match(**it, plan->literals))
+    {
+      it->swap(plan);
+      return;
+    }
+  }
+  same_key.push_back(std::move(plan));
+
+  if (++size > max_size)
+    evict_least_recently_used();
+}
+
+
+void Query_Plan_Cache::evict_least_recently_used()
+{
+  std::map< std::string, std::vector< std::unique_ptr< Query_Plan > > >::iterator oldest_key = plans.end();
+  std::vector< std::unique_ptr< Query_Plan > >::iterator oldest;
+  for (std::map< std::string, std::vector< std::unique_ptr< Query_Plan > > >::iterator it = plans.begin();
+      it != plans.end(); ++it)
+  {
+    for (std::vector< std::unique_ptr< Query_Plan > >::iterator pit = it->second.begin(); pit != it->second.end(); ++pit)
+    {
+      if (oldest_key == plans.end() || (*pit)->last_used < (*oldest)->last_used)
+      {
+        oldest_key = it;
+        oldest = pit;
+      }
+    }
+  }
+
+  if (oldest_key == plans.end())
+    return;
+
+  oldest_key->second.erase(oldest);
+  if (oldest_key->second.empty())
+    plans.erase(oldest_key);
+  --size;
+}
@@ -0,0 +1,119 @@
+/** Copyright 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018 Roland Olbricht et al.
+ *
+ * This file is part of Overpass_API.
+ *
+ * Overpass_API is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Overpass_API is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Overpass_API.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef DE__OSM3S___OVERPASS_API__DISPATCH__QUERY_PLAN_CACHE_H
+#define DE__OSM3S___OVERPASS_API__DISPATCH__QUERY_PLAN_CACHE_H
+
+#include "../core/parsed_query.h"
+#include "../statements/statement.h"
+#include "../../template_db/types.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+/* A parsed and validated query together with the objects its statements refer to.
+ *
+ * The numbers and timestamps in the query text are its literals. A literal is a slot
+ * if it is the value of exactly one statement attribute and the statement accepts new values
+ * for that attribute, see Statement::bind_parameters. A cached plan is reused for a query
+ * with the same text apart from the slots. */
+struct Query_Plan : public Statement::Attribute_Observer
+{
+  Query_Plan() : stmt_factory(global_settings), area_level(0), last_used(0) {}
+
+  virtual void statement_created(Statement* statement, const std::string& element,
+      const std::map< std::string, std::string >& attributes);
+
+  Parsed_Query global_settings;
+  Statement::Factory stmt_factory;
+  std::vector< Statement* > statements;
+  int area_level;
+
+  struct Created_Statement
+  {
+    Created_Statement(Statement* statement_, const std::string& element_,
+        const std::map< std::string, std::string >& attributes_)
+        : statement(statement_), element(element_), attributes(attributes_) {}
+
+    Statement* statement;
+    std::string element;
+    std::map< std::string, std::string > attributes;
+  };
+
+  struct Slot
+  {
+    Slot(const std::string& attribute_, uint32 literal_) : attribute(attribute_), literal(literal_) {}
+
+    std::string attribute;
+    uint32 literal;
+  };
+
+  std::vector< Created_Statement > created;
+  std::vector< std::pair< Statement*, std::vector< Slot > > > slots;
+  std::vector< std::string > literals;
+  std::vector< bool > is_slot;
+  std::string output_format;
+  std::string output_config;
+  uint64 last_used;
+};
+
+
+// Makes the plan record all statements that are created during the lifetime of this object
+class Query_Plan_Recording
+{
+public:
+  Query_Plan_Recording(Query_Plan& plan) { Statement::set_attribute_observer(&plan); }
+  ~Query_Plan_Recording() { Statement::set_attribute_observer(0); }
+};
+
+
+/* Keeps the plans of recently executed Map QL queries in a long-running interpreter.
+ *
+ * Plans with area statements or diffs are not kept, nor are plans with statements
+ * that may keep state between executions. */
+class Query_Plan_Cache
+{
+public:
+  Query_Plan_Cache(uint32 max_size_) : max_size(max_size_), size(0), use_counter(0) {}
+
+  // Returns a plan with the slots bound to the literals of the query or 0.
+  // The plan then has the input parameters and a new output handler.
+  Query_Plan* find(const std::map< std::string, std::string >& input_params);
+
+  // Takes over the plan if it can be reused. The plan must have been executed successfully.
+  void insert(std::unique_ptr< Query_Plan >& plan);
+
+private:
+  uint32 max_size;
+  uint32 size;
+  uint64 use_counter;
+  std::map< std::string, std::vector< std::unique_ptr< Query_Plan > > > plans;
+
+  void evict_least_recently_used();
+};
+
+
+// Replaces the literals in a Map QL query by placeholders and collapses whitespace
+void split_query_literals(const std::string& query, std::string& shape, std::vector< std::string >& literals);
+
+
+#endif
@@ -0,0 +1,256 @@
+/** Copyright 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018 Roland Olbricht et al.
+ *
+ * This file is part of Overpass_API.
+ *
+ * Overpass_API is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Overpass_API is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Overpass_API.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <sstream>
+#include "../frontend/console_output.h"
+#include "query_plan_cache.h"
+#include "resource_manager.h"
+#include "scripting_core.h"
+
+
+/**
+ * Tests the reuse of parsed queries by Query_Plan_Cache
+ */
+
+//-----------------------------------------------------------------------------
+
+void print_split(const std::string& query)
+{
+  std::string shape;
+  std::vector< std::string > literals;
+  split_query_literals(query, shape, literals);
+
+  for (std::string::iterator it = shape.begin(); it != shape.end(); ++it)
+  {
+    if (*it == '\x01')
+      *it = '#';
+  }
+  std::cout<<"Shape: "<<shape<<'\n';
+  std::cout<<"Literals:";
+  for (std::vector< std::string >::const_iterator it = literals.begin(); it != literals.end(); ++it)
+    std::cout<<' '<<*it;
+  std::cout<<'\n';
+}
+
+
+std::map< std::string, std::string > input_params(const std::string& query)
+{
+  std::map< std::string, std::string > result;
+  result["data"] = query;
+  return result;
+}
+
+
+// Parses the query into a new plan. Returns 0 if the query does not parse.
+Query_Plan* parse_plan(const std::string& query, Error_Output& error_output)
+{
+  initialize();
+  std::unique_ptr< Query_Plan > plan(new Query_Plan());
+  plan->global_settings.set_input_params(input_params(query));
+
+  Query_Plan_Recording recording(*plan);
+  if (!parse_and_validate(plan->stmt_factory, plan->global_settings, query, &error_output, parser_execute))
+    return 0;
+  plan->statements = *get_statement_stack();
+  return plan.release();
+}
+
+
+// Parses the query, hands the plan over to the cache and prints which literals have become slots
+void print_slots(Query_Plan_Cache& cache, const std::string& query, Error_Output& error_output)
+{
+  std::unique_ptr< Query_Plan > plan(parse_plan(query, error_output));
+  if (!plan)
+  {
+    std::cout<<"Query does not parse: "<<query<<'\n';
+    return;
+  }
+
+  Query_Plan* cached = plan.get();
+  cache.insert(plan);
+  if (plan)
+  {
+    std::cout<<"Not cached: "<<query<<'\n';
+    return;
+  }
+
+  std::cout<<"Slots of "<<query<<":";
+  for (uint32 i = 0; i < cached->literals.size(); ++i)
+    std::cout<<' '<<cached->literals[i]<<(cached->is_slot[i] ? "=slot" : "=fixed");
+  std::cout<<'\n';
+}
+
+
+void print_reuse(Query_Plan_Cache& cache, const std::string& query)
+{
+  std::cout<<(cache.find(input_params(query)) ? "Reused: " : "Parsed again: ")<<query<<'\n';
+}
+
+
+std::string execute_plan(Query_Plan& plan, const std::string& db_dir)
+{
+  std::ostringstream out;
+  std::streambuf* cout_buf = std::cout.rdbuf(out.rdbuf());
+  try
+  {
+    Nonsynced_Transaction transaction(false, false, db_dir, "");
+    Resource_Manager rman(transaction, &plan.global_settings);
+    for (std::vector< Statement* >::const_iterator it = plan.statements.begin(); it != plan.statements.end(); ++it)
+      (*it)->execute(rman);
+  }
+  catch (...)
+  {
+    std::cout.rdbuf(cout_buf);
+    throw;
+  }
+  std::cout.rdbuf(cout_buf);
+  return out.str();
+}
+
+
+/* Executes the first query, hands its plan over to the cache and executes the second query
+ * from the cached plan. The second query is also executed from a freshly parsed plan:
+ * both results must be equal, but differ from the result of the first query. */
+void compare_executions(const std::string& first_query, const std::string& second_query,
+    const std::string& db_dir, Error_Output& error_output)
+{
+  Query_Plan_Cache cache(16);
+
+  std::unique_ptr< Query_Plan > first_plan(parse_plan(first_query, error_output));
+  if (!first_plan)
+  {
+    std::cout<<"Query does not parse: "<<first_query<<'\n';
+    return;
+  }
+  std::string first_result = execute_plan(*first_plan, db_dir);
+  cache.insert(first_plan);
+
+  Query_Plan* cached_plan = cache.find(input_params(second_query));
+  if (!cached_plan)
+  {
+    std::cout<<"Plan not reused for: "<<second_query<<'\n';
+    return;
+  }
+  std::string cached_result = execute_plan(*cached_plan, db_dir);
+
+  std::unique_ptr< Query_Plan > fresh_plan(parse_plan(second_query, error_output));
+  if (!fresh_plan)
+  {
+    std::cout<<"Query does not parse: "<<second_query<<'\n';
+    return;
+  }
+  std::string fresh_result = execute_plan(*fresh_plan, db_dir);
+
+  std::cout<<first_query<<" then "<<second_query<<":\n";
+  std::cout<<"  first result is empty: "<<(first_result.empty() ? "yes" : "no")<<'\n';
+  std::cout<<"  second result differs from first result: "<<(cached_result != first_result ? "yes" : "no")<<'\n';
+  std::cout<<"  cached plan gives the same result as a fresh plan: "
+      <<(cached_result == fresh_result ? "yes" : "no")<<'\n';
+}
+
+
+int main(int argc, char* args[])
+{
+  if (argc < 2)
+  {
+    std::cout<<"Usage: "<<args[0]<<" test_to_execute [db_dir node_id_offset]\n";
+    return 0;
+  }
+  std::string test_to_execute = args[1];
+
+  Console_Output error_output(Error_Output::ASSISTING);
+  Statement::set_error_output(&error_output);
+
+  try
+  {
+    if ((test_to_execute == "") || (test_to_execute == "1"))
+    {
+      std::cout<<"** Split literals off the query text\n";
+      print_split("node(50.7,7.1,50.8,7.2);out;");
+      print_split("  node(-1.5, 2,3 ,\n4);\n\n out;  ");
+      print_split("node[name=\"A 12 \\\"quoted\\\" 34\"](1);out;");
+      print_split("node['it\\'s 5'](2);out;");
+      print_split("node[highway=primary2](3);.set_2 out;way.a1;out 5;");
+      print_split("[date:\"2012-09-14T07:00:00Z\"];node(4);out;");
+      print_split("[date:\"2012-09-14T07:00:00\"];node(4);out;");
+      print_split("// 5 nodes\nnode(5); /* 6 nodes */ out;");
+      print_split("node(6);out;\"unterminated 7");
+    }
+    if ((test_to_execute == "") || (test_to_execute == "2"))
+    {
+      std::cout<<"** Literals used by exactly one statement attribute are slots\n";
+      {
+        Query_Plan_Cache cache(16);
+        print_slots(cache, "node(50.7,7.1,50.8,7.2);out;", error_output);
+        print_reuse(cache, "node(51.7,8.1,51.8,8.2);out;");
+      }
+
+      std::cout<<"** A literal used twice is not a slot\n";
+      {
+        Query_Plan_Cache cache(16);
+        print_slots(cache, "node(10.5,20.25,10.5,21.25);out;", error_output);
+        print_reuse(cache, "node(10.5,22.25,10.5,23.25);out;");
+        print_reuse(cache, "node(10.5,20.25,10.75,21.25);out;");
+      }
+
+      std::cout<<"** The same literal in two statements is not a slot\n";
+      {
+        Query_Plan_Cache cache(16);
+        print_slots(cache, "node(3);out;way(3);out;", error_output);
+        print_reuse(cache, "node(3);out;way(3);out;");
+        print_reuse(cache, "node(4);out;way(4);out;");
+      }
+
+      std::cout<<"** Attributes that are not rebindable keep their literal\n";
+      {
+        Query_Plan_Cache cache(16);
+        print_slots(cache, "node(3);out 7;", error_output);
+        print_reuse(cache, "node(4);out 7;");
+        print_reuse(cache, "node(4);out 8;");
+      }
+    }
+    if ((test_to_execute == "") || (test_to_execute == "3"))
+    {
+      if (argc < 4)
+      {
+        std::cout<<"Usage: "<<args[0]<<" 3 db_dir node_id_offset\n";
+        return 0;
+      }
+      std::string db_dir = args[2];
+      std::string node_offset = args[3];
+      std::ostringstream first_id;
+      first_id<<atoll(node_offset.c_str()) + 1;
+      std::ostringstream second_id;
+      second_id<<atoll(node_offset.c_str()) + 2;
+
+      std::cout<<"** The same query with two sets of literals\n";
+      compare_executions("node(" + first_id.str() + ");out;", "node(" + second_id.str() + ");out;",
+          db_dir, error_output);
+      compare_executions("node(-10.0,-15.0,8.0,9.0);out;", "node(-10.0,-15.0,-1.0,-3.0);out;",
+          db_dir, error_output);
+    }
+  }
+  catch (File_Error e)
+  {
+    std::cout<<"File error caught: "
+        <<e.error_number<<' '<<e.filename<<' '<<e.origin<<'\n';
+  }
+
+  return 0;
+}
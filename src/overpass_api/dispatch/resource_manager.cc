@@ -407,7 +407,7 @@ void Runtime_Stack_Frame::move_all_inward_except(const std::string& set_name)
 
 uint64 Runtime_Stack_Frame::total_size()
 {
-  uint64 result = 0;
+  uint64 result = batch_size;
 
   for (std::map< std::string, uint64 >::const_iterator it = size_per_set.begin(); it != size_per_set.end(); ++it)
     result += it->second;
@@ -656,6 +656,13 @@ void Resource_Manager::count_loop()
 }
 
 
+void Resource_Manager::add_batch_size(uint64 size)
+{
+  if (!runtime_stack.empty())
+    runtime_stack.back()->add_batch_size(size);
+}
+
+
 void Resource_Manager::log_and_display_error(std::string message)
 {
   if (error_output)
@@ -668,6 +675,8 @@ void Resource_Manager::log_and_display_error(std::string message)
 
 bool Resource_Manager::health_check(const Statement& stmt, uint32 extra_time, uint64 extra_space)
 {
+  std::lock_guard< std::mutex > guard(health_check_mutex);
+
   bool extra_space_uses_half_empty = false;
 
   uint32 elapsed_time = 0;
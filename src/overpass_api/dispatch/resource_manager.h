@@ -20,6 +20,7 @@
 #define DE__OSM3S___OVERPASS_API__DISPATCH__RESOURCE_MANAGER_H
 
 #include <ctime>
+#include <mutex>
 #include "../../template_db/transaction.h"
 #include "../core/datatypes.h"
 #include "../core/parsed_query.h"
@@ -47,7 +48,7 @@ class Runtime_Stack_Frame
 {
 public:
   Runtime_Stack_Frame(Runtime_Stack_Frame* parent_ = 0)
-    : parent(parent_), loop_count(0), loop_size(0),
+    : parent(parent_), loop_count(0), loop_size(0), batch_size(0),
     desired_timestamp(parent_ ? parent_->desired_timestamp : NOW),
     desired_action(parent_ ? parent_->desired_action : Diff_Action::positive),
     diff_from_timestamp(parent_ ? parent_->diff_from_timestamp : NOW),
@@ -89,6 +90,7 @@ public:
   std::vector< std::pair< uint, uint > > stack_progress() const;
   void set_loop_size(uint loop_size_) { loop_size = loop_size_; }
   void count_loop() { ++loop_count; }
+  void add_batch_size(uint64 size) { batch_size += size; }
 
 private:
   Runtime_Stack_Frame* parent;
@@ -98,6 +100,8 @@ private:
   std::map< std::string, uint64 > size_per_set;
   uint loop_count;
   uint loop_size;
+  // Memory held by statements for the loop of this frame, see Statement::prepare_batch
+  uint64 batch_size;
 
   uint64 desired_timestamp;
   Diff_Action::_ desired_action;
@@ -149,6 +153,8 @@ public:
   void pop_stack_frame();
 
   void count_loop();
+  // Counts memory that a statement holds until the current stack frame is popped
+  void add_batch_size(uint64 size);
 
   Area_Usage_Listener* area_updater()
   {
@@ -159,6 +165,7 @@ public:
 
   void log_and_display_error(std::string message);
 
+  // May be called concurrently by the threads of a single statement
   bool health_check(const Statement& stmt, uint32 extra_time = 0, uint64 extra_space = 0);
 
   void set_limits(uint32 max_allowed_time_, uint64 max_allowed_space_)
@@ -203,6 +210,7 @@ private:
   uint32 last_report_time;
   uint32 max_allowed_time;
   uint64 max_allowed_space;
+  std::mutex health_check_mutex;
 
   std::vector< std::chrono::time_point<std::chrono::system_clock> > cpu_start_time;
   std::vector< std::chrono::milliseconds > cpu_runtime;
@@ -0,0 +1,193 @@
+/** Copyright 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018 Roland Olbricht et al.
+ *
+ * This file is part of Overpass_API.
+ *
+ * Overpass_API is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Overpass_API is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Overpass_API.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "dispatcher_stub.h"
+#include "query_plan_cache.h"
+#include "result_cache.h"
+#include "../core/settings.h"
+#include "../../template_db/dispatcher_client.h"
+
+#include <vector>
+
+
+const std::string* Result_Cache::find(const std::string& key)
+{
+  std::map< std::string, Entry >::iterator it = entries.find(key);
+  if (it == entries.end())
+    return 0;
+
+  Dispatcher_Client dispatcher_client(osm_base_settings().shared_name);
+  std::string generation = osm_base_generation(dispatcher_client);
+  invalidate_if_new_generation(generation);
+
+  it = entries.find(key);
+  if (it == entries.end())
+    return 0;
+
+  if (it->second.area_level > 0)
+  {
+    Dispatcher_Client area_dispatcher_client(area_settings().shared_name);
+    std::string area_timestamp;
+    generation += '\n' + area_generation(area_dispatcher_client, area_timestamp);
+  }
+  if (generation != it->second.generation)
+  {
+    erase(it);
+    return 0;
+  }
+
+  it->second.last_used = ++use_counter;
+  return &it->second.response;
+}
+
+
+void Result_Cache::insert(const std::string& key, const std::string& generation, int area_level,
+    const std::string& response)
+{
+  invalidate_if_new_generation(generation.substr(0, generation.find('\n')));
+
+  if (response.size() > max_size)
+    return;
+
+  std::map< std::string, Entry >::iterator it = entries.find(key);
+  if (it != entries.end())
+    erase(it);
+
+  while (size + response.size() > max_size)
+    evict_least_recently_used();
+
+  Entry& entry = entries[key];
+  entry.response = response;
+  entry.generation = generation;
+  entry.area_level = area_level;
+  entry.last_used = ++use_counter;
+  size += response.size();
+}
+
+
+void Result_Cache::invalidate_if_new_generation(const std::string& osm_base_generation)
+{
+  if (osm_base_generation == osm_base_generation_seen)
+    return;
+
+  entries.clear();
+  size = 0;
+  osm_base_generation_seen = osm_base_generation;
+}
+
+
+void Result_Cache::erase(std::map< std::string, Entry >::iterator it)
+{
+  size -= it->second.response.size();
+  entries.erase(it);
+}
+
+
+void Result_Cache::evict_least_recently_used()
+{
+  std::map< std::string, Entry >::iterator oldest = entries.begin();
+  for (std::map< std::string, Entry >::iterator it = entries.begin(); it != entries.end(); ++it)
+  {
+    if (it->second.last_used < oldest->second.last_used)
+      oldest = it;
+  }
+  if (oldest != entries.end())
+    erase(oldest);
+}
+
+
+std::string result_cache_key(const std::map< std::string, std::string >& input_params,
+    const Web_Output& web_output)
+{
+  std::string key;
+  std::vector< std::string > literals;
+  std::map< std::string, std::string >::const_iterator data_it = input_params.find("data");
+  if (data_it != input_params.end())
+    split_query_literals(data_it->second, key, literals);
+
+  for (std::vector< std::string >::const_iterator it = literals.begin(); it != literals.end(); ++it)
+    key += '\0' + *it;
+  for (std::map< std::string, std::string >::const_iterator it = input_params.begin();
+      it != input_params.end(); ++it)
+  {
+    if (it != data_it)
+      key += '\0' + it->first + '=' + it->second;
+  }
+
+  key += '\0';
+  key += (web_output.has_origin ? "origin" : "");
+  key += '\0' + web_output.allow_headers;
+  return key;
+}
+
+
+Response_Recorder::Response_Recorder(std::ostream& stream_, uint64 max_size_)
+    : stream(stream_), target(stream_.rdbuf()), max_size(max_size_), complete(true)
+{
+  stream.rdbuf(this);
+}
+
+
+Response_Recorder::~Response_Recorder()
+{
+  stream.rdbuf(target);
+}
+
+
+void Response_Recorder::record(const char* s, std::streamsize n)
+{
+  if (!complete)
+    return;
+
+  if (response.size() + n > max_size)
+  {
+    complete = false;
+    std::string().swap(response);
+  }
+  else
+    response.append(s, n);
+}
+
+
+Response_Recorder::int_type Response_Recorder::overflow(int_type c)
+{
+  if (traits_type::eq_int_type(c, traits_type::eof()))
+    return traits_type::not_eof(c);
+
+  char ch = traits_type::to_char_type(c);
+  if (traits_type::eq_int_type(target->sputc(ch), traits_type::eof()))
+    return traits_type::eof();
+  record(&ch, 1);
+  return c;
+}
+
+
+std::streamsize Response_Recorder::xsputn(const char* s, std::streamsize n)
+{
+  std::streamsize written = target->sputn(s, n);
+  if (written > 0)
+    record(s, written);
+  return written;
+}
+
+
+int Response_Recorder::sync()
+{
+  return target->pubsync();
+}
@@ -0,0 +1,110 @@
+/** Copyright 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018 Roland Olbricht et al.
+ *
+ * This file is part of Overpass_API.
+ *
+ * Overpass_API is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Overpass_API is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Overpass_API.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef DE__OSM3S___OVERPASS_API__DISPATCH__RESULT_CACHE_H
+#define DE__OSM3S___OVERPASS_API__DISPATCH__RESULT_CACHE_H
+
+#include "../frontend/web_output.h"
+#include "../../template_db/types.h"
+
+#include <iostream>
+#include <map>
+#include <streambuf>
+#include <string>
+
+
+/* Keeps the complete responses of recent queries in a long-running interpreter.
+ *
+ * A response is stored together with the generation of the databases it has been computed from,
+ * see osm_base_generation and area_generation. It is served only as long as the dispatchers
+ * still announce that generation. All responses are dropped once the main database
+ * has a new generation. Beyond max_size bytes, the least recently used responses are dropped. */
+class Result_Cache
+{
+public:
+  Result_Cache(uint64 max_size_) : max_size(max_size_), size(0), use_counter(0) {}
+
+  // Returns the stored response for the key if it is still valid or 0.
+  // This asks the dispatchers for their generation, but does not register a read operation.
+  const std::string* find(const std::string& key);
+
+  // The generation is that of the main database, followed by a newline and that of the
+  // area database if area_level is positive.
+  void insert(const std::string& key, const std::string& generation, int area_level,
+      const std::string& response);
+
+  uint64 get_max_size() const { return max_size; }
+
+private:
+  struct Entry
+  {
+    std::string response;
+    std::string generation;
+    int area_level;
+    uint64 last_used;
+  };
+
+  uint64 max_size;
+  uint64 size;
+  uint64 use_counter;
+  std::string osm_base_generation_seen;
+  std::map< std::string, Entry > entries;
+
+  void invalidate_if_new_generation(const std::string& osm_base_generation);
+  void erase(std::map< std::string, Entry >::iterator it);
+  void evict_least_recently_used();
+};
+
+
+// Identifies the response to a request: the query with collapsed whitespace,
+// the other input parameters and the request headers that show up in the response headers
+std::string result_cache_key(const std::map< std::string, std::string >& input_params,
+    const Web_Output& web_output);
+
+
+/* Passes everything written to a stream through to its stream buffer and keeps a copy,
+ * as long as the copy does not exceed max_size bytes. The stream gets its own stream buffer
+ * back when this object is destroyed. */
+class Response_Recorder : public std::streambuf
+{
+public:
+  Response_Recorder(std::ostream& stream_, uint64 max_size_);
+  ~Response_Recorder();
+
+  // False if the response has grown beyond max_size
+  bool is_complete() const { return complete; }
+  const std::string& get_response() const { return response; }
+
+protected:
+  virtual int_type overflow(int_type c);
+  virtual std::streamsize xsputn(const char* s, std::streamsize n);
+  virtual int sync();
+
+private:
+  std::ostream& stream;
+  std::streambuf* target;
+  uint64 max_size;
+  bool complete;
+  std::string response;
+
+  void record(const char* s, std::streamsize n);
+};
+
+
+#endif
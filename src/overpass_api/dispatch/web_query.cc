@@ -26,7 +26,9 @@
 #include "fcgio.h"
 #endif
 
+#include "query_plan_cache.h"
 #include "resource_manager.h"
+#include "result_cache.h"
 #include "scripting_core.h"
 #include "../frontend/web_output.h"
 #include "../frontend/user_interface.h"
@@ -58,31 +60,58 @@
 const unsigned long STDIN_MAX = 1000000;
 
 
-int handle_request(const std::string & content, bool is_cgi, Index_Cache* ic)
+int handle_request(const std::string & content, bool is_cgi, Index_Cache* ic, Index_Cache* area_ic,
+    Query_Plan_Cache* plan_cache, Result_Cache* result_cache)
 {
-  Parsed_Query global_settings;
+  // The plan must outlive error_output, because the latter writes the footer through the output handler
+  std::unique_ptr< Query_Plan > new_plan;
   Web_Output error_output(Error_Output::ASSISTING);
   Statement::set_error_output(&error_output);
 
   try
   {
-    global_settings.set_input_params(
+    std::map< std::string, std::string > input_params =
 	get_xml_cgi(content, &error_output, 16*1024*1024,
-	error_output.http_method, error_output.allow_headers, error_output.has_origin, is_cgi));
+	error_output.http_method, error_output.allow_headers, error_output.has_origin, is_cgi);
 
     if (error_output.display_encoding_errors())
       return 0;
 
-    Statement::Factory stmt_factory(global_settings);
-    if (!parse_and_validate(stmt_factory, global_settings, global_settings.get_input_params().find("data")->second,
-        &error_output, parser_execute))
-      return 0;
+    std::string result_key;
+    if (result_cache
+        && (error_output.http_method == http_get || error_output.http_method == http_post))
+    {
+      result_key = result_cache_key(input_params, error_output);
+      const std::string* response = result_cache->find(result_key);
+      if (response)
+      {
+        // The response is served without a read operation, hence without a slot of the rate limit
+        std::cout.write(response->data(), response->size());
+        return 0;
+      }
+    }
+
+    Query_Plan* plan = (plan_cache ? plan_cache->find(input_params) : 0);
+    if (!plan)
+    {
+      new_plan.reset(new Query_Plan());
+      plan = new_plan.get();
+      plan->global_settings.set_input_params(input_params);
+
+      Query_Plan_Recording recording(*plan);
+      if (!parse_and_validate(plan->stmt_factory, plan->global_settings, input_params.find("data")->second,
+          &error_output, parser_execute))
+        return 0;
+      plan->statements = *get_statement_stack();
+      plan->area_level = determine_area_level(&error_output, 0);
+    }
+    Parsed_Query& global_settings = plan->global_settings;
 
     error_output.set_output_handler(global_settings.get_output_handler());
 
     Osm_Script_Statement* osm_script = 0;
-    if (!get_statement_stack()->empty())
-      osm_script = dynamic_cast< Osm_Script_Statement* >(get_statement_stack()->front());
+    if (!plan->statements.empty())
+      osm_script = dynamic_cast< Osm_Script_Statement* >(plan->statements.front());
 
     uint32 max_allowed_time = 0;
     uint64 max_allowed_space = 0;
@@ -104,21 +133,25 @@ int handle_request(const std::string & content, bool is_cgi, Index_Cache* ic)
     else
     {
       // open read transaction and log this.
-      int area_level = determine_area_level(&error_output, 0);
+      int area_level = plan->area_level;
       Dispatcher_Stub dispatcher("", &error_output, global_settings.get_input_params().find("data")->second,
 			         get_uses_meta_data(), area_level,
-				 max_allowed_time, max_allowed_space, global_settings, ic);
+				 max_allowed_time, max_allowed_space, global_settings, ic, area_ic);
       if (osm_script && osm_script->get_desired_timestamp())
         dispatcher.resource_manager().set_desired_timestamp(osm_script->get_desired_timestamp());
 
+      std::unique_ptr< Response_Recorder > recorder;
+      if (!result_key.empty() && area_level < 2)
+        recorder.reset(new Response_Recorder(std::cout, result_cache->get_max_size()));
+
       error_output.write_payload_header(dispatcher.get_db_dir(), dispatcher.get_timestamp(),
  	  area_level > 0 ? dispatcher.get_area_timestamp() : "", true);
 
       try
       {
         Cpu_Timer cpu(dispatcher.resource_manager(), 0);
-        for (std::vector< Statement* >::const_iterator it(get_statement_stack()->begin());
-	    it != get_statement_stack()->end(); ++it)
+        for (std::vector< Statement* >::const_iterator it(plan->statements.begin());
+	    it != plan->statements.end(); ++it)
           (*it)->execute(dispatcher.resource_manager());
       }
       catch(const File_Error& e)
@@ -133,6 +166,21 @@ int handle_request(const std::string & content, bool is_cgi, Index_Cache* ic)
         throw;
       }
 
+      if (new_plan && plan_cache)
+        plan_cache->insert(new_plan);
+
+      if (recorder)
+      {
+        error_output.write_footer();
+        if (recorder->is_complete() && !error_output.has_runtime_errors())
+        {
+          std::string generation = dispatcher.resource_manager().get_transaction()->get_replicate_id();
+          if (area_level > 0)
+            generation += '\n' + dispatcher.resource_manager().get_area_transaction()->get_replicate_id();
+          result_cache->insert(result_key, generation, area_level, recorder->get_response());
+        }
+      }
+
     //TODO
 //       if (osm_script && osm_script->get_type() == "popup")
 //       {
@@ -250,7 +298,10 @@ std::string get_request_content(const FCGX_Request & request) {
 
 int main(int argc, char *argv[])
 {
+  // Both caches stay resident across FastCGI requests and are only refreshed
+  // when the respective dispatcher has committed new data.
   Index_Cache ic;
+  Index_Cache area_ic;
 
 #ifdef HAVE_FASTCGI
 
@@ -259,7 +310,7 @@ int main(int argc, char *argv[])
 
 #endif
 
-    int ret = handle_request("", true, &ic);
+    int ret = handle_request("", true, &ic, &area_ic, 0, 0);
     return (ret);
 
 #ifdef HAVE_FASTCGI
@@ -272,12 +323,23 @@ int main(int argc, char *argv[])
 
     char const* max_requests_c = std::getenv("OVERPASS_FCGI_MAX_REQUESTS");
     char const* max_elapsed_time_c = std::getenv("OVERPASS_FCGI_MAX_ELAPSED_TIME");
+    char const* plan_cache_size_c = std::getenv("OVERPASS_FCGI_PLAN_CACHE_SIZE");
+    char const* result_cache_size_c = std::getenv("OVERPASS_FCGI_RESULT_CACHE_SIZE");
 
     int max_requests = (max_requests_c == NULL) ? 0 : atoi(max_requests_c);
     int max_elapsed_time = (max_elapsed_time_c == NULL) ? 0 : atoi(max_elapsed_time_c);
+    int plan_cache_size = (plan_cache_size_c == NULL) ? 256 : atoi(plan_cache_size_c);
+    int result_cache_size = (result_cache_size_c == NULL) ? 0 : atoi(result_cache_size_c);
 
     if (max_requests < 0) max_requests = 0;
     if (max_elapsed_time < 0) max_elapsed_time = 0;
+    if (plan_cache_size < 0) plan_cache_size = 0;
+    if (result_cache_size < 0) result_cache_size = 0;
+
+    // Parsed queries are reused for later requests that differ only in bboxes, ids or dates
+    Query_Plan_Cache plan_cache(plan_cache_size);
+    // Complete responses in MB, served as long as the database has not changed. Off by default.
+    Result_Cache result_cache(uint64(result_cache_size)*1024*1024);
 
     // Backup the stdio streambuffers
     std::streambuf * cin_streambuf  = std::cin.rdbuf();
@@ -314,7 +376,8 @@ int main(int argc, char *argv[])
 
       initialize();
 
-      int ret = handle_request(content, FCGX_IsCGI(), &ic);
+      int ret = handle_request(content, FCGX_IsCGI(), &ic, &area_ic, &plan_cache,
+          result_cache_size > 0 ? &result_cache : 0);
 
       // Restart process after error or a certain number of time / requests
       time_t elapsed_time = time(NULL) - start_time;
@@ -0,0 +1,160 @@
+/** Copyright 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018 Roland Olbricht et al.
+ *
+ * This file is part of Overpass_API.
+ *
+ * Overpass_API is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Overpass_API is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Overpass_API.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DE__OSM3S___OVERPASS_API__FRONTEND__OUTPUT_BUFFER_H
+#define DE__OSM3S___OVERPASS_API__FRONTEND__OUTPUT_BUFFER_H
+
+
+#include "../../expat/escape_json.h"
+#include "../../expat/escape_xml.h"
+#include "../core/basic_types.h"
+
+#include <cmath>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <type_traits>
+
+#include <fmt/format.h>
+
+
+/* Collects the text of an output handler and passes it with a single write to std::cout.
+ *
+ * Other code writes to std::cout between the calls of an output handler, e.g. the http headers.
+ * Output handlers therefore flush the buffer at the end of every call.
+ * Within a call the buffer is flushed when it grows beyond flush_size.
+ *
+ * Integers, coordinates and escaped strings are formatted straight into the buffer.
+ * There is deliberately no operator for floating point values: use fixed_7() or format(). */
+class Output_Buffer
+{
+public:
+  struct Fixed_7
+  {
+    explicit Fixed_7(double value_) : value(value_) {}
+    double value;
+  };
+
+  struct Escaped_Xml
+  {
+    explicit Escaped_Xml(const std::string& value_) : value(value_) {}
+    const std::string& value;
+  };
+
+  struct Escaped_Cstr
+  {
+    explicit Escaped_Cstr(const std::string& value_) : value(value_) {}
+    const std::string& value;
+  };
+
+  Output_Buffer(uint32 flush_size_ = 64*1024) : flush_size(flush_size_) {}
+  ~Output_Buffer() { flush(); }
+
+  void flush()
+  {
+    if (!buffer.empty())
+    {
+      std::cout.write(buffer.data(), buffer.size());
+      buffer.clear();
+    }
+  }
+
+  Output_Buffer& operator<<(const std::string& s) { buffer += s; return check_size(); }
+  Output_Buffer& operator<<(const char* s) { buffer += s; return check_size(); }
+  Output_Buffer& operator<<(char c) { buffer += c; return check_size(); }
+
+  template< typename Int >
+  typename std::enable_if< std::is_integral< Int >::value, Output_Buffer& >::type operator<<(Int value)
+  {
+    fmt::format_int formatted(value);
+    buffer.append(formatted.data(), formatted.size());
+    return check_size();
+  }
+
+  // Would otherwise silently convert to char
+  Output_Buffer& operator<<(double value) = delete;
+
+  Output_Buffer& operator<<(Fixed_7 value);
+  Output_Buffer& operator<<(Escaped_Xml value) { escape_xml(value.value, buffer); return check_size(); }
+  Output_Buffer& operator<<(Escaped_Cstr value) { escape_cstr(value.value, buffer); return check_size(); }
+
+  // Takes a plain string_view rather than fmt::format_string to keep working with fmt < 8.
+  // The format string is therefore checked at runtime only.
+  template< typename... Args >
+  Output_Buffer& format(fmt::string_view format_str, const Args&... args)
+  {
+    fmt::vformat_to(std::back_inserter(buffer), format_str, fmt::make_format_args(args...));
+    return check_size();
+  }
+
+private:
+  std::string buffer;
+  uint32 flush_size;
+
+  Output_Buffer& check_size()
+  {
+    if (buffer.size() >= flush_size)
+      flush();
+    return *this;
+  }
+};
+
+
+// Formats like printf("%.7f", value)
+inline Output_Buffer::Fixed_7 fixed_7(double value) { return Output_Buffer::Fixed_7(value); }
+
+// Appends the value escaped like escape_xml(value)
+inline Output_Buffer::Escaped_Xml escaped_xml(const std::string& value) { return Output_Buffer::Escaped_Xml(value); }
+
+// Appends the value escaped like escape_cstr(value)
+inline Output_Buffer::Escaped_Cstr escaped_cstr(const std::string& value)
+{ return Output_Buffer::Escaped_Cstr(value); }
+
+
+inline Output_Buffer& Output_Buffer::operator<<(Fixed_7 value)
+{
+  // Coordinates are almost always close to a multiple of 1e-7. If the scaled value is closer
+  // than 0.25 to an integer, then rounding the exact value gives the same integer, because
+  // the scaling is off by at most 0.125 below 1e15. Then integer formatting suffices.
+  double scaled = std::fabs(value.value) * 1e7;
+  double rounded = std::floor(scaled + 0.5);
+  if (scaled < 1e15 && std::fabs(scaled - rounded) < 0.25)
+  {
+    uint64 digits = (uint64)rounded;
+    if (std::signbit(value.value))
+      buffer += '-';
+    fmt::format_int integral(digits / 10000000);
+    buffer.append(integral.data(), integral.size());
+
+    uint32 fraction = digits % 10000000;
+    char fraction_chars[8];
+    fraction_chars[0] = '.';
+    for (int i = 7; i > 0; --i)
+    {
+      fraction_chars[i] = '0' + fraction % 10;
+      fraction /= 10;
+    }
+    buffer.append(fraction_chars, 8);
+  }
+  else
+    fmt::format_to(std::back_inserter(buffer), "{:.7f}", value.value);
+  return check_size();
+}
+
+
+#endif
@@ -98,6 +98,7 @@ void Web_Output::add_static_remark(const std::string& error, int line_number)
 
 void Web_Output::runtime_error(const std::string& error)
 {
+  runtime_errors = true;
   if (log_level != Error_Output::QUIET)
   {
     std::ostringstream out;
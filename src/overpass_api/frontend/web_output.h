@@ -28,8 +28,8 @@
 struct Web_Output : public Error_Output
 {
   Web_Output(uint log_level_) : http_method(http_get), has_origin(false), header_written(not_yet),
-      encoding_errors(false), parse_errors(false), static_errors(false), log_level(log_level_),
-      output_handler(0) {}
+      encoding_errors(false), parse_errors(false), static_errors(false), runtime_errors(false),
+      log_level(log_level_), output_handler(0) {}
 
   ~Web_Output() {
     try {
@@ -55,6 +55,7 @@ struct Web_Output : public Error_Output
   virtual bool display_encoding_errors() { return encoding_errors; }
   virtual bool display_parse_errors() { return parse_errors; }
   virtual bool display_static_errors() { return static_errors; }
+  bool has_runtime_errors() const { return runtime_errors; }
 
   void enforce_header(uint write_mime);
   void write_html_header
@@ -77,6 +78,7 @@ private:
   bool encoding_errors;
   bool parse_errors;
   bool static_errors;
+  bool runtime_errors;
   uint log_level;
   std::string messages;
 
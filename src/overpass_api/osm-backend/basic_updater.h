@@ -26,6 +26,7 @@
 #include <vector>
 
 #include "../../template_db/block_backend.h"
+#include "../../template_db/key_value_statistics.h"
 #include "../../template_db/transaction.h"
 #include "../core/datatypes.h"
 #include "../core/settings.h"
@@ -649,6 +650,49 @@ void update_elements
 }
 
 
+template< typename Id_Type >
+void count_tags_per_tile
+    (const std::map< Tag_Index_Global, std::set< Tag_Object_Global< Id_Type > > >& tags, int64 sign,
+     Key_Value_Statistics& stats)
+{
+  for (typename std::map< Tag_Index_Global, std::set< Tag_Object_Global< Id_Type > > >::const_iterator
+      it = tags.begin(); it != tags.end(); ++it)
+  {
+    std::map< uint32, int64 > per_tile;
+    for (typename std::set< Tag_Object_Global< Id_Type > >::const_iterator it2 = it->second.begin();
+        it2 != it->second.end(); ++it2)
+      ++per_tile[tag_statistics_tile(it2->idx.val())];
+    for (std::map< uint32, int64 >::const_iterator it2 = per_tile.begin(); it2 != per_tile.end(); ++it2)
+      stats.add(it->first.key, it->first.value, it2->first, sign * it2->second);
+  }
+}
+
+
+/* Applies the changes of a global tag file to its key and value statistics.
+ * Must be called before the tag file is written. The statistics are only started together
+ * with the tag file because they cannot be derived from the changes for existing data.
+ * Within an update under the dispatcher, the shadow of the statistics file is written.
+ * The dispatcher then replaces the statistics file when it commits the index files. */
+template< typename Id_Type >
+void update_tag_statistics
+    (const std::map< Tag_Index_Global, std::set< Tag_Object_Global< Id_Type > > >& attic_global_tags,
+     const std::map< Tag_Index_Global, std::set< Tag_Object_Global< Id_Type > > >& new_global_tags,
+     Transaction& transaction, const File_Properties& file_properties)
+{
+  std::string shadow_suffix = transaction.get_use_shadow() ? file_properties.get_shadow_suffix() : "";
+  std::string file_name = tag_statistics_file_name(transaction.get_db_dir(), file_properties) + shadow_suffix;
+  if (!file_exists(file_name) && file_exists(transaction.get_db_dir() + file_properties.get_file_name_trunk()
+      + file_properties.get_data_suffix() + file_properties.get_index_suffix() + shadow_suffix))
+    return;
+
+  Key_Value_Statistics stats;
+  stats.read(file_name);
+  count_tags_per_tile(attic_global_tags, -1, stats);
+  count_tags_per_tile(new_global_tags, 1, stats);
+  stats.write(file_name);
+}
+
+
 template< typename Id_Type >
 std::map< Id_Type, std::set< Uint31_Index > > get_existing_idx_lists
     (const std::vector< Id_Type >& ids,
@@ -25,6 +25,7 @@
 #include "../core/settings.h"
 #include "../../template_db/block_backend.h"
 #include "../../template_db/file_blocks.h"
+#include "../../template_db/key_value_statistics.h"
 #include "../../template_db/random_file.h"
 
 
@@ -117,6 +118,24 @@ void clone_map_file(const File_Properties& file_prop, Transaction& transaction,
 }
 
 
+void clone_tag_statistics(const File_Properties& file_prop, Transaction& transaction, std::string dest_db_dir)
+{
+  try
+  {
+    std::string source_name = tag_statistics_file_name(transaction.get_db_dir(), file_prop);
+    if (!file_exists(source_name))
+      return;
+    Key_Value_Statistics stats;
+    stats.read(source_name);
+    stats.write(tag_statistics_file_name(dest_db_dir, file_prop));
+  }
+  catch (const File_Error &e)
+  {
+    std::cout<<e.origin<<' '<<e.error_number<<' '<<strerror(e.error_number)<<' '<<e.filename<<'\n';
+  }
+}
+
+
 void clone_database(Transaction& transaction, const std::string& dest_db_dir, const Clone_Settings& clone_settings)
 {
   const unsigned int PARALLEL_PROCS = 4;
@@ -140,6 +159,7 @@ void clone_database(Transaction& transaction, const std::string& dest_db_dir, co
   f.push_back( [&] {
     clone_bin_file< Tag_Index_Global >(*osm_base_settings().NODE_TAGS_GLOBAL, *osm_base_settings().NODE_TAGS_GLOBAL,
                                        transaction, dest_db_dir, clone_settings);
+    clone_tag_statistics(*osm_base_settings().NODE_TAGS_GLOBAL, transaction, dest_db_dir);
   });
 
   f.push_back( [&] {
@@ -170,6 +190,7 @@ void clone_database(Transaction& transaction, const std::string& dest_db_dir, co
   f.push_back( [&] {
     clone_bin_file< Tag_Index_Global >(*osm_base_settings().WAY_TAGS_GLOBAL, *osm_base_settings().WAY_TAGS_GLOBAL,
                                        transaction, dest_db_dir, clone_settings);
+    clone_tag_statistics(*osm_base_settings().WAY_TAGS_GLOBAL, transaction, dest_db_dir);
   });
 
   f.push_back( [&] {
@@ -202,6 +223,7 @@ void clone_database(Transaction& transaction, const std::string& dest_db_dir, co
     clone_bin_file< Tag_Index_Global >(
         *osm_base_settings().RELATION_TAGS_GLOBAL, *osm_base_settings().RELATION_TAGS_GLOBAL,
         transaction, dest_db_dir, clone_settings);
+    clone_tag_statistics(*osm_base_settings().RELATION_TAGS_GLOBAL, transaction, dest_db_dir);
   });
   
   f.push_back( [&] {
@@ -3799,6 +3799,8 @@ int main(int argc, char* args[])
       modifier = new Accept_Query_173(pattern_size);
     else if (std::string(args[2]) == "query_174")
       modifier = new Accept_Query_174(pattern_size);
+    else if (std::string(args[2]) == "query_175")
+      modifier = new Accept_Query_1(pattern_size);
     else if (std::string(args[2]) == "foreach_1")
       modifier = new Accept_Foreach_1(pattern_size);
     else if (std::string(args[2]) == "foreach_2")
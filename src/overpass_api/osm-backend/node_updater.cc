@@ -572,6 +572,7 @@ void Node_Updater::update(Osm_Backend_Callback* callback, Cpu_Stopwatch* cpu_sto
   f.push_back( [&]
   {
     // Update global tags
+    update_tag_statistics(attic_global_tags, new_global_tags, *transaction, *osm_base_settings().NODE_TAGS_GLOBAL);
     update_elements(attic_global_tags, new_global_tags, *transaction, *osm_base_settings().NODE_TAGS_GLOBAL);
     callback->tags_global_finished();
   });
@@ -583,9 +584,13 @@ void Node_Updater::update(Osm_Backend_Callback* callback, Cpu_Stopwatch* cpu_sto
     callback->update_coords_finished();
   });
 
-  process_package(f, parallel_processes);
+  // The current files are written in the background while the attic data is collected and written.
+  Task_Group current_files_update(parallel_processes);
+  current_files_update.run(f);
 
   std::map< uint32, std::vector< uint32 > > idxs_by_id;
+  if (meta != only_data)
+    copy_idxs_by_id(new_meta, idxs_by_id);
 
   if (meta == keep_attic)
   {
@@ -614,74 +619,76 @@ void Node_Updater::update(Osm_Backend_Callback* callback, Cpu_Stopwatch* cpu_sto
 				existing_attic_skeleton_timestamps,
                                 new_attic_skeletons, new_attic_idx_lists);
 
-    std::map< Uint31_Index, std::set< Attic< Node_Skeleton::Id_Type > > > new_undeleted
-        = compute_undeleted_skeletons(new_data, existing_map_positions, existing_idx_lists);
-
-    strip_single_idxs(existing_idx_lists);
-    std::vector< std::pair< Node_Skeleton::Id_Type, Uint31_Index > > new_attic_map_positions
-        = strip_single_idxs(new_attic_idx_lists);
+    std::map< Uint31_Index, std::set< Attic< Node_Skeleton::Id_Type > > > new_undeleted;
+    std::vector< std::pair< Node_Skeleton::Id_Type, Uint31_Index > > new_attic_map_positions;
+    // attic_meta is still in use by the update of the current meta files, hence work on a copy.
+    std::map< Uint31_Index, std::set< OSM_Element_Metadata_Skeleton< Node_Skeleton::Id_Type > > > new_attic_meta
+        = attic_meta;
+    std::map< Tag_Index_Local, std::set< Attic< Node_Skeleton::Id_Type > > > new_attic_local_tags;
+    std::map< Tag_Index_Global, std::set< Attic< Tag_Object_Global< Node_Skeleton::Id_Type > > > >
+        new_attic_global_tags;
+    std::map< Timestamp, std::set< Change_Entry< Node_Skeleton::Id_Type > > > changelog;
 
-    compute_new_attic_meta(new_data, existing_map_positions, attic_meta);
+    // Every attic file is written in the background as soon as its content is computed.
+    // The task group is declared after the data it refers to such that it is destroyed first.
+    Task_Group attic_files_update(parallel_processes);
 
-    // Compute tags
-    std::map< Tag_Index_Local, std::set< Attic< Node_Skeleton::Id_Type > > > new_attic_local_tags
-        = compute_new_attic_local_tags(new_data,
-	    existing_map_positions, existing_attic_map_positions, full_attic_local_tags);
-    std::map< Tag_Index_Global, std::set< Attic< Tag_Object_Global< Node_Skeleton::Id_Type > > > >
-        new_attic_global_tags = compute_attic_global_tags(new_attic_local_tags);
+    attic_files_update.run( [&]
+    {
+      // Add attic elements
+      update_elements(std::map< Uint31_Index, std::set< Attic< Node_Skeleton > > >(), new_attic_skeletons,
+           *transaction, *attic_settings().NODES);
+    });
 
-    // Compute changelog
-    std::map< Timestamp, std::set< Change_Entry< Node_Skeleton::Id_Type > > > changelog
-        = compute_changelog(new_data, existing_map_positions, attic_skeletons);
+    new_undeleted = compute_undeleted_skeletons(new_data, existing_map_positions, existing_idx_lists);
 
-    // Prepare user indices
-    copy_idxs_by_id(attic_meta, idxs_by_id);
+    attic_files_update.run( [&]
+    {
+      // Add attic elements
+      update_elements(std::map< Uint31_Index, std::set< Attic< Node_Skeleton::Id_Type > > >(),
+              new_undeleted, *transaction, *attic_settings().NODES_UNDELETED);
+    });
 
-    std::vector< std::function< void() > > f;
+    strip_single_idxs(existing_idx_lists);
+    new_attic_map_positions = strip_single_idxs(new_attic_idx_lists);
 
-    f.push_back( [&]
+    attic_files_update.run( [&]
     {
       // Update id indexes
        update_map_positions(new_attic_map_positions, *transaction, *attic_settings().NODES);
     });
 
-    f.push_back( [&]
+    attic_files_update.run( [&]
     {
       // Update id index lists
       update_elements(existing_idx_lists, new_attic_idx_lists,
               *transaction, *attic_settings().NODE_IDX_LIST);
     });
 
-    f.push_back( [&]
-    {
-      // Add attic elements
-      update_elements(std::map< Uint31_Index, std::set< Attic< Node_Skeleton > > >(), new_attic_skeletons,
-           *transaction, *attic_settings().NODES);
-    });
-
-    f.push_back( [&]
-    {
-      // Add attic elements
-      update_elements(std::map< Uint31_Index, std::set< Attic< Node_Skeleton::Id_Type > > >(),
-              new_undeleted, *transaction, *attic_settings().NODES_UNDELETED);
-    });
+    compute_new_attic_meta(new_data, existing_map_positions, new_attic_meta);
 
-    f.push_back( [&]
+    attic_files_update.run( [&]
     {
       // Add attic meta
       update_elements
          (std::map< Uint31_Index, std::set< OSM_Element_Metadata_Skeleton< Node_Skeleton::Id_Type > > >(),
-             attic_meta, *transaction, *attic_settings().NODES_META);
+             new_attic_meta, *transaction, *attic_settings().NODES_META);
     });
 
-    f.push_back( [&]
+    // Compute tags
+    new_attic_local_tags = compute_new_attic_local_tags(new_data,
+	existing_map_positions, existing_attic_map_positions, full_attic_local_tags);
+
+    attic_files_update.run( [&]
     {
       // Update tags
       update_elements(std::map< Tag_Index_Local, std::set< Attic < Node_Skeleton::Id_Type > > >(),
             new_attic_local_tags, *transaction, *attic_settings().NODE_TAGS_LOCAL);
     });
 
-    f.push_back( [&]
+    new_attic_global_tags = compute_attic_global_tags(new_attic_local_tags);
+
+    attic_files_update.run( [&]
     {
       // Update tags
       update_elements(std::map< Tag_Index_Global,
@@ -689,21 +696,26 @@ void Node_Updater::update(Osm_Backend_Callback* callback, Cpu_Stopwatch* cpu_sto
             new_attic_global_tags, *transaction, *attic_settings().NODE_TAGS_GLOBAL);
     });
 
-    f.push_back( [&]
+    // Compute changelog
+    changelog = compute_changelog(new_data, existing_map_positions, attic_skeletons);
+
+    attic_files_update.run( [&]
     {
       // Write changelog
       update_elements(std::map< Timestamp, std::set< Change_Entry< Node_Skeleton::Id_Type > > >(), changelog,
             *transaction, *attic_settings().NODE_CHANGELOG);
     });
 
-    process_package(f, parallel_processes);
-  }
-
-  if (meta != only_data)
-  {
-    copy_idxs_by_id(new_meta, idxs_by_id);
+    // The user files are written while the attic files are still in progress
+    copy_idxs_by_id(new_attic_meta, idxs_by_id);
     process_user_data(*transaction, user_by_id, idxs_by_id);
+
+    attic_files_update.wait();
   }
+  else if (meta != only_data)
+    process_user_data(*transaction, user_by_id, idxs_by_id);
+
+  current_files_update.wait();
   callback->update_finished();
 
   new_data.data.clear();
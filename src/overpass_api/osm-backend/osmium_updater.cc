@@ -43,12 +43,18 @@
 #include <unistd.h>
 
 #include <array>
+#include <condition_variable>
 #include <cstdio>
+#include <deque>
+#include <exception>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <list>
+#include <mutex>
 #include <sstream>
+#include <thread>
 
 #include <osmium/io/any_input.hpp>
 #include <osmium/io/detail/output_format.hpp>
@@ -68,7 +74,197 @@
 #include <osmium/thread/pool.hpp>
 #include <osmium/visitor.hpp>
 
-struct Osmium_Updater_Handler: public osmium::handler::Handler {
+/** The objects of one osmium buffer, already converted to the types of the updaters.
+ *
+ * Conversion happens on the reader thread, such that decoding and conversion
+ * of the next buffers overlap with the flushes of the updaters on the main thread. */
+struct Osmium_Batch
+{
+  struct Node_Item
+  {
+    Node_Item(Node&& node_, bool deleted_) : node(std::move(node_)), deleted(deleted_) {}
+
+    Node node;
+    OSM_Element_Metadata meta;
+    bool deleted;
+  };
+
+  struct Way_Item
+  {
+    Way_Item(Way&& way_, bool deleted_) : way(std::move(way_)), deleted(deleted_) {}
+
+    Way way;
+    OSM_Element_Metadata meta;
+    bool deleted;
+  };
+
+  struct Relation_Item
+  {
+    Relation_Item(Relation&& relation_, bool deleted_) : relation(std::move(relation_)), deleted(deleted_) {}
+
+    Relation relation;
+    // Role ids are assigned by the Relation_Updater on the main thread
+    std::vector< std::string > roles;
+    OSM_Element_Metadata meta;
+    bool deleted;
+  };
+
+  std::vector< Node_Item > nodes;
+  std::vector< Way_Item > ways;
+  std::vector< Relation_Item > relations;
+};
+
+
+struct Osmium_Batch_Converter: public osmium::handler::Handler {
+
+  Osmium_Batch& batch;
+
+  Osmium_Batch_Converter(Osmium_Batch& batch_) : batch(batch_) {}
+
+  void node(const osmium::Node& n) {
+
+    batch.nodes.emplace_back(Node(n.id(), n.location() ? n.location().lat() : 100.0,
+                                          n.location() ? n.location().lon() : 200.0), n.deleted());
+    Osmium_Batch::Node_Item& item = batch.nodes.back();
+
+    for (const auto & tag : n.tags())
+      item.node.tags.push_back(make_pair(tag.key(), tag.value()));
+
+    get_meta(n, item.meta);
+  }
+
+  void way(const osmium::Way& w) {
+
+    batch.ways.emplace_back(Way(w.id()), w.deleted());
+    Osmium_Batch::Way_Item& item = batch.ways.back();
+
+    for (const auto & tag : w.tags())
+      item.way.tags.push_back(make_pair(tag.key(), tag.value()));
+
+    item.way.nds.reserve(w.nodes().size());
+
+    for (const auto & nd : w.nodes())
+      item.way.nds.push_back(nd.ref());
+
+    get_meta(w, item.meta);
+  }
+
+  void relation(const osmium::Relation& r) {
+
+    batch.relations.emplace_back(Relation(r.id()), r.deleted());
+    Osmium_Batch::Relation_Item& item = batch.relations.back();
+
+    for (const auto & tag : r.tags())
+      item.relation.tags.push_back(make_pair(tag.key(), tag.value()));
+
+    item.relation.members.reserve(r.members().size());
+    item.roles.reserve(r.members().size());
+
+    for (const auto & member : r.members())
+    {
+      Relation_Entry entry;
+      entry.ref = member.ref();
+      if (member.type() == osmium::item_type::node)
+        entry.type = Relation_Entry::NODE;
+      else if (member.type() == osmium::item_type::way)
+        entry.type = Relation_Entry::WAY;
+      else if (member.type() == osmium::item_type::relation)
+        entry.type = Relation_Entry::RELATION;
+
+      item.relation.members.push_back(entry);
+      item.roles.push_back(member.role());
+    }
+
+    get_meta(r, item.meta);
+  }
+
+  void get_meta(const osmium::OSMObject& object, OSM_Element_Metadata& meta) {
+
+    std::tm tm;
+    auto sse = object.timestamp().seconds_since_epoch();
+    gmtime_r(&sse, &tm);
+
+    uint64 timestamp = Timestamp(tm.tm_year + 1900,
+                                 tm.tm_mon + 1,
+                                 tm.tm_mday,
+                                 tm.tm_hour,
+                                 tm.tm_min,
+                                 tm.tm_sec).timestamp;
+
+    meta.changeset = object.changeset();
+    meta.timestamp = timestamp;
+    meta.user_id = object.uid();
+    meta.user_name = std::string(object.user());
+    meta.version = object.version();
+  }
+};
+
+
+/** Bounded queue between the reader thread and the main thread.
+ *
+ * The bound keeps the memory footprint limited while the updaters flush. */
+class Osmium_Batch_Queue
+{
+public:
+  Osmium_Batch_Queue(unsigned int capacity_) : capacity(capacity_), finished(false), cancelled(false) {}
+
+  // Returns false if the consumer has given up and the producer should stop.
+  bool push(Osmium_Batch&& batch)
+  {
+    std::unique_lock< std::mutex > lock(mutex);
+    not_full.wait(lock, [&]{ return batches.size() < capacity || cancelled; });
+    if (cancelled)
+      return false;
+    batches.push_back(std::move(batch));
+    not_empty.notify_one();
+    return true;
+  }
+
+  // Returns false once the producer has finished and all batches are consumed.
+  bool pop(Osmium_Batch& batch)
+  {
+    std::unique_lock< std::mutex > lock(mutex);
+    not_empty.wait(lock, [&]{ return !batches.empty() || finished; });
+    if (batches.empty())
+    {
+      if (error)
+        std::rethrow_exception(error);
+      return false;
+    }
+    batch = std::move(batches.front());
+    batches.pop_front();
+    not_full.notify_one();
+    return true;
+  }
+
+  void finish(std::exception_ptr error_ = nullptr)
+  {
+    std::lock_guard< std::mutex > lock(mutex);
+    finished = true;
+    error = error_;
+    not_empty.notify_one();
+  }
+
+  void cancel()
+  {
+    std::lock_guard< std::mutex > lock(mutex);
+    cancelled = true;
+    not_full.notify_one();
+  }
+
+private:
+  unsigned int capacity;
+  bool finished;
+  bool cancelled;
+  std::exception_ptr error;
+  std::deque< Osmium_Batch > batches;
+  std::mutex mutex;
+  std::condition_variable not_empty;
+  std::condition_variable not_full;
+};
+
+
+struct Osmium_Updater_Handler {
 
   uint32 osm_element_count;
   uint flush_limit;
@@ -92,62 +288,54 @@ struct Osmium_Updater_Handler: public osmium::handler::Handler {
       relation_updater(rel_upd_), callback(cb_),
       cpu_stopwatch(cpu_stopwatch_){};
 
-  void node(const osmium::Node& n) {
+  void apply(Osmium_Batch& batch) {
+
+    for (auto & item : batch.nodes)
+      node(item);
+    for (auto & item : batch.ways)
+      way(item);
+    for (auto & item : batch.relations)
+      relation(item);
+  }
+
+  void node(Osmium_Batch::Node_Item& item) {
 
     if (state == 0)
       state = IN_NODES;
 
     ++osm_element_count;
 
-    OSM_Element_Metadata meta;
-    get_meta(n, meta);
-
-    Node node(n.id(), n.location() ? n.location().lat() : 100.0,
-                      n.location() ? n.location().lon() : 200.0);
+    Node::Id_Type id = item.node.id;
 
-    for (const auto & tag : n.tags())
-      node.tags.push_back(make_pair(tag.key(), tag.value()));
-
-    if (n.deleted())
-      node_updater->set_id_deleted(n.id(), &meta);
+    if (item.deleted)
+      node_updater->set_id_deleted(id, &item.meta);
     else
-      node_updater->set_node(std::move(node), &meta);
+      node_updater->set_node(std::move(item.node), &item.meta);
 
     if (osm_element_count >= flush_limit)
     {
-      callback->node_elapsed(n.id());
+      callback->node_elapsed(id);
       node_updater->update(callback, cpu_stopwatch, true);
       callback->parser_started();
       osm_element_count = 0;
     }
   }
 
-  void way(const osmium::Way& w) {
+  void way(Osmium_Batch::Way_Item& item) {
 
     move_to_state_in_ways();
     ++osm_element_count;
 
-    Way way(w.id());
-
-    for (const auto & tag : w.tags())
-      way.tags.push_back(make_pair(tag.key(), tag.value()));
-
-    way.nds.reserve(w.nodes().size());
+    Way::Id_Type id = item.way.id;
 
-    for (const auto & nd : w.nodes())
-      way.nds.push_back(nd.ref());
-
-    OSM_Element_Metadata meta;
-    get_meta(w, meta);
-
-    if (w.deleted())
-      way_updater->set_id_deleted(w.id(), &meta);
+    if (item.deleted)
+      way_updater->set_id_deleted(id, &item.meta);
     else
-      way_updater->set_way(std::move(way), &meta);
+      way_updater->set_way(std::move(item.way), &item.meta);
 
     if (osm_element_count * 5 >= flush_limit)
     {
-      callback->way_elapsed(w.id());
+      callback->way_elapsed(id);
       way_updater->update(callback, cpu_stopwatch, true, node_updater->get_new_skeletons(),
           node_updater->get_attic_skeletons(),
           node_updater->get_new_attic_skeletons());
@@ -156,44 +344,24 @@ struct Osmium_Updater_Handler: public osmium::handler::Handler {
     }
   }
 
-  void relation(const osmium::Relation& r) {
+  void relation(Osmium_Batch::Relation_Item& item) {
 
     move_to_state_in_relations();
     ++osm_element_count;
 
-    Relation relation(r.id());
-
-    for (const auto & tag : r.tags())
-      relation.tags.push_back(make_pair(tag.key(), tag.value()));
-
-    relation.members.reserve(r.members().size());
-
-    for (const auto & member : r.members())
-    {
-      Relation_Entry entry;
-      entry.ref = member.ref();
-      if (member.type() == osmium::item_type::node)
-        entry.type = Relation_Entry::NODE;
-      else if (member.type() == osmium::item_type::way)
-        entry.type = Relation_Entry::WAY;
-      else if (member.type() == osmium::item_type::relation)
-        entry.type = Relation_Entry::RELATION;
-      entry.role = relation_updater->get_role_id(member.role());
-
-      relation.members.push_back(entry);
-    }
+    for (std::vector< Relation_Entry >::size_type i = 0; i < item.relation.members.size(); ++i)
+      item.relation.members[i].role = relation_updater->get_role_id(item.roles[i]);
 
-    OSM_Element_Metadata meta;
-    get_meta(r, meta);
+    Relation::Id_Type id = item.relation.id;
 
-    if (r.deleted())
-      relation_updater->set_id_deleted(r.id(), &meta);
+    if (item.deleted)
+      relation_updater->set_id_deleted(id, &item.meta);
     else
-      relation_updater->set_relation(std::move(relation), &meta);
+      relation_updater->set_relation(std::move(item.relation), &item.meta);
 
     if (osm_element_count >= flush_limit)
     {
-      callback->relation_elapsed(r.id());
+      callback->relation_elapsed(id);
       relation_updater->update(callback, cpu_stopwatch, node_updater->get_new_skeletons(),
           node_updater->get_attic_skeletons(),
           node_updater->get_new_attic_skeletons(),
@@ -204,26 +372,6 @@ struct Osmium_Updater_Handler: public osmium::handler::Handler {
     }
   }
 
-  void get_meta(const osmium::OSMObject& object, OSM_Element_Metadata& meta) {
-
-    std::tm tm;
-    auto sse = object.timestamp().seconds_since_epoch();
-    gmtime_r(&sse, &tm);
-
-    uint64 timestamp = Timestamp(tm.tm_year + 1900,
-                                 tm.tm_mon + 1,
-                                 tm.tm_mday,
-                                 tm.tm_hour,
-                                 tm.tm_min,
-                                 tm.tm_sec).timestamp;
-
-    meta.changeset = object.changeset();
-    meta.timestamp = timestamp;
-    meta.user_id = object.uid();
-    meta.user_name = std::string(object.user());
-    meta.version = object.version();
-  }
-
   void finish_updater() {
     if (state == IN_NODES)
       callback->nodes_finished();
@@ -296,21 +444,75 @@ struct Osmium_Updater_Handler: public osmium::handler::Handler {
   }
 };
 
-void Osmium_Updater::parse_file_completely(FILE* in) {
+namespace
+{
+  // Number of converted buffers that may wait for the updaters
+  const unsigned int PIPELINE_DEPTH = 8;
 
-  this->callback_->parser_started();
 
-  osmium::io::File infile("-", "osm.pbf");
+  /* Runs produce(reader) on a separate thread and feeds the resulting batches into the handler.
+   * Osmium itself decodes the blocks of the input file on its own thread pool. */
+  template< typename Producer >
+  void apply_pipelined(Producer produce, Osmium_Updater_Handler& handler)
+  {
+    Osmium_Batch_Queue queue(PIPELINE_DEPTH);
+
+    std::thread reader_thread([&]()
+    {
+      try
+      {
+        produce([&](const osmium::memory::Buffer& buffer)
+        {
+          Osmium_Batch batch;
+          Osmium_Batch_Converter converter(batch);
+          osmium::apply(buffer, converter);
+          return queue.push(std::move(batch));
+        });
+        queue.finish();
+      }
+      catch (...)
+      {
+        queue.finish(std::current_exception());
+      }
+    });
+
+    try
+    {
+      Osmium_Batch batch;
+      while (queue.pop(batch))
+        handler.apply(batch);
+    }
+    catch (...)
+    {
+      queue.cancel();
+      reader_thread.join();
+      throw;
+    }
+    reader_thread.join();
+  }
+}
+
 
-  osmium::io::Reader reader(infile);
+void Osmium_Updater::parse_file_completely(FILE* in) {
+
+  this->callback_->parser_started();
 
   Osmium_Updater_Handler osm_updater(node_updater_, way_updater_,
       relation_updater_, callback_, flush_limit, cpu_stopwatch);
 
-  while (osmium::memory::Buffer buffer = reader.read())
-    osmium::apply(buffer, osm_updater);
+  apply_pipelined([&](const std::function< bool(const osmium::memory::Buffer&) >& consume)
+  {
+    osmium::io::File infile("-", "osm.pbf");
+    osmium::io::Reader reader(infile);
 
-  reader.close();
+    while (osmium::memory::Buffer buffer = reader.read())
+    {
+      if (!consume(buffer))
+        break;
+    }
+
+    reader.close();
+  }, osm_updater);
 
   osm_updater.finish_updater();
   flush();
@@ -328,17 +530,23 @@ void Osmium_Updater::parse_multiple_files(const std::string& source_dir, const s
                                                          osmium::osm_entity_bits::way,
                                                          osmium::osm_entity_bits::relation};
 
-  for (const auto& t : types) {
-    for (const auto& file_name : source_file_names) {
-      osmium::io::File infile(source_dir + file_name);
-      osmium::io::Reader reader{infile, t};
-
-      while (osmium::memory::Buffer buffer = reader.read())
-        osmium::apply(buffer, osm_updater);
-
-      reader.close();
+  apply_pipelined([&](const std::function< bool(const osmium::memory::Buffer&) >& consume)
+  {
+    for (const auto& t : types) {
+      for (const auto& file_name : source_file_names) {
+        osmium::io::File infile(source_dir + file_name);
+        osmium::io::Reader reader{infile, t};
+
+        while (osmium::memory::Buffer buffer = reader.read())
+        {
+          if (!consume(buffer))
+            return;
+        }
+
+        reader.close();
+      }
     }
-  }
+  }, osm_updater);
 
   osm_updater.finish_updater();
   flush();
@@ -21,49 +21,291 @@
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <functional>
-#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 
-inline void process_package(std::vector< std::function< void() > >& f, const int parallel_processes)
+/* A process wide pool of worker threads.
+ *
+ * Every worker owns a queue. It takes new work from the back of its own queue and,
+ * if that is empty, steals from the front of the queues of the other workers.
+ * Tasks that are submitted from a worker go into that worker's queue, all other tasks
+ * are spread round robin. The threads are started on first demand and then kept
+ * for the lifetime of the process, hence subsequent packages don't pay for thread creation. */
+class Work_Stealing_Pool
 {
-  if (f.empty())
-    return;
+public:
+  static Work_Stealing_Pool& instance()
+  {
+    static Work_Stealing_Pool pool;
+    return pool;
+  }
+
+  static const unsigned int MAX_WORKERS = 256;
+
+  // Makes sure that at least the given number of workers is running.
+  void ensure_workers(unsigned int count)
+  {
+    std::lock_guard< std::mutex > guard(mutex);
+    while (threads.size() < std::min(count, MAX_WORKERS))
+    {
+      queues.push_back(std::unique_ptr< Worker_Queue >(new Worker_Queue()));
+      unsigned int id = threads.size();
+      threads.push_back(std::thread([this, id] { work(id); }));
+    }
+    worker_count.store(threads.size(), std::memory_order_release);
+  }
+
+  void submit(std::function< void() > task)
+  {
+    unsigned int count = worker_count.load(std::memory_order_acquire);
+    unsigned int target = (current_worker() >= 0 ? current_worker() : next_queue++ % count);
+    {
+      std::lock_guard< std::mutex > guard(queues[target]->mutex);
+      queues[target]->tasks.push_back(std::move(task));
+    }
+    {
+      std::lock_guard< std::mutex > guard(mutex);
+      ++pending;
+    }
+    wakeup.notify_one();
+  }
+
+  // Lets the calling thread execute one queued task, if any. This allows threads
+  // that wait for a group of tasks to help instead of blocking a worker.
+  bool try_run_one()
+  {
+    std::function< void() > task;
+    if (!take(current_worker() >= 0 ? current_worker() : 0, task))
+      return false;
+    task();
+    return true;
+  }
+
+  ~Work_Stealing_Pool()
+  {
+    {
+      std::lock_guard< std::mutex > guard(mutex);
+      stop = true;
+    }
+    wakeup.notify_all();
+    for (auto& thread : threads)
+      thread.join();
+  }
+
+private:
+  struct Worker_Queue
+  {
+    std::mutex mutex;
+    std::deque< std::function< void() > > tasks;
+  };
+
+  Work_Stealing_Pool() : worker_count(0), next_queue(0), pending(0), stop(false)
+  {
+    // Other threads access the queues without the mutex, hence the vector must never reallocate.
+    queues.reserve(MAX_WORKERS);
+  }
+
+  static int& current_worker()
+  {
+    static thread_local int id = -1;
+    return id;
+  }
+
+  bool take(unsigned int own, std::function< void() >& task)
+  {
+    unsigned int count = worker_count.load(std::memory_order_acquire);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      Worker_Queue& queue = *queues[(own + i) % count];
+      std::lock_guard< std::mutex > guard(queue.mutex);
+      if (queue.tasks.empty())
+        continue;
+      if (i == 0)
+      {
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+      }
+      else
+      {
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+      }
+      std::lock_guard< std::mutex > pending_guard(mutex);
+      --pending;
+      return true;
+    }
+    return false;
+  }
 
-  // skip thread creation if no parallel processing requested
-  if (parallel_processes <= 1)
+  void work(unsigned int id)
   {
-    for (int i = 0; i < f.size(); i++)
-      f[i]();
+    current_worker() = id;
+    while (true)
+    {
+      std::function< void() > task;
+      if (take(id, task))
+      {
+        task();
+        continue;
+      }
+      std::unique_lock< std::mutex > lock(mutex);
+      wakeup.wait(lock, [this] { return stop || pending > 0; });
+      if (stop)
+        return;
+    }
+  }
+
+  // Queues are only ever appended, and only before worker_count is raised.
+  std::vector< std::unique_ptr< Worker_Queue > > queues;
+  std::vector< std::thread > threads;
+  std::atomic< unsigned int > worker_count;
+  std::atomic< unsigned int > next_queue;
+  std::mutex mutex;
+  std::condition_variable wakeup;
+  // May become negative for a moment because a task can be taken before submit() has counted it.
+  int pending;
+  bool stop;
+};
+
+
+/* A set of tasks on the Work_Stealing_Pool that can be waited for as a whole.
+ * The tasks run in the background until wait() is called, so independent work can proceed
+ * on the calling thread meanwhile. The first exception of any task is rethrown by wait().
+ *
+ * The pool is shared by the whole process and may have more workers than this group is allowed
+ * to use. Hence at most parallel_processes tasks of the group are in the pool at the same time;
+ * the further tasks wait in the group and are run by the pool task that finishes first. */
+class Task_Group
+{
+public:
+  Task_Group(int parallel_processes_) : parallel_processes(parallel_processes_), outstanding(0), running(0)
+  {
+    // The calling thread helps while waiting, hence one worker less is needed.
+    if (parallel_processes > 1)
+      Work_Stealing_Pool::instance().ensure_workers(parallel_processes - 1);
+  }
+
+  ~Task_Group()
+  {
+    try
+    {
+      wait();
+    }
+    catch (...) {}
+  }
+
+  // Runs the tasks immediately one after another if no parallel processing is requested.
+  void run(std::function< void() > task)
+  {
+    if (parallel_processes <= 1)
+    {
+      task();
+      return;
+    }
+
+    {
+      std::lock_guard< std::mutex > guard(mutex);
+      ++outstanding;
+      if (running >= (unsigned int)parallel_processes)
+      {
+        queued.push_back(std::move(task));
+        return;
+      }
+      ++running;
+    }
+    Work_Stealing_Pool::instance().submit([this, task] { run_queued(task); });
+  }
+
+  void run(std::vector< std::function< void() > >& f)
+  {
+    for (auto& task : f)
+      run(task);
     f.clear();
-    return;
   }
 
-  std::vector< std::future< void > > futures;
-  std::atomic< unsigned int > package{0};
+  void wait()
+  {
+    while (true)
+    {
+      {
+        std::unique_lock< std::mutex > lock(mutex);
+        if (outstanding == 0)
+          break;
+      }
+      if (Work_Stealing_Pool::instance().try_run_one())
+        continue;
+      std::unique_lock< std::mutex > lock(mutex);
+      done.wait_for(lock, std::chrono::milliseconds(1), [this] { return outstanding == 0; });
+    }
+
+    std::exception_ptr result;
+    {
+      std::lock_guard< std::mutex > guard(mutex);
+      std::swap(result, error);
+    }
+    if (result)
+      std::rethrow_exception(result);
+  }
 
-  const int procs = (f.size() < parallel_processes ? f.size() : parallel_processes);
+private:
+  Task_Group(const Task_Group&);
+  Task_Group& operator=(const Task_Group&);
 
-  for (int i = 0; i < procs; i++)
+  // Runs the given task and then the queued tasks of the group until none is left.
+  void run_queued(std::function< void() > task)
   {
-    futures.push_back(
-        std::async(std::launch::async, [&]
+    while (true)
+    {
+      try
       {
-        while (true) {
-          int current_package = package++;
-          if (current_package >= f.size())
-            return;
-          f[current_package]();
-        }
-      }));
+        task();
+      }
+      catch (...)
+      {
+        std::lock_guard< std::mutex > guard(mutex);
+        if (!error)
+          error = std::current_exception();
+      }
+      std::lock_guard< std::mutex > guard(mutex);
+      if (--outstanding == 0)
+        done.notify_all();
+      if (queued.empty())
+      {
+        --running;
+        return;
+      }
+      task = std::move(queued.front());
+      queued.pop_front();
+    }
   }
 
-  for (auto &e : futures)
-    e.get();
+  int parallel_processes;
+  std::mutex mutex;
+  std::condition_variable done;
+  unsigned int outstanding;
+  // Number of tasks of this group in the pool and the tasks that wait for one of them
+  unsigned int running;
+  std::deque< std::function< void() > > queued;
+  std::exception_ptr error;
+};
+
+
+inline void process_package(std::vector< std::function< void() > >& f, const int parallel_processes)
+{
+  if (f.empty())
+    return;
 
-  futures.clear();
-  f.clear();
+  Task_Group group(std::min(parallel_processes, (int)f.size()));
+  group.run(f);
+  group.wait();
 }
 
 #endif
@@ -953,15 +953,20 @@ void Way_Updater::update(Osm_Backend_Callback* callback, Cpu_Stopwatch* cpu_stop
   f.push_back( [&]
   {
     // Update global tags
+    update_tag_statistics(attic_global_tags, new_global_tags, *transaction, *osm_base_settings().WAY_TAGS_GLOBAL);
     update_elements(attic_global_tags, new_global_tags, *transaction, *osm_base_settings().WAY_TAGS_GLOBAL);
     callback->tags_global_finished();
   });
 
-  process_package(f, parallel_processes);
+  // The current files are written in the background while the attic data is collected and written.
+  Task_Group current_files_update(parallel_processes);
+  current_files_update.run(f);
 
 
   std::map< uint32, std::vector< uint32 > > idxs_by_id;
-    
+  if (meta != only_data)
+    copy_idxs_by_id(new_meta, idxs_by_id);
+
   if (meta == keep_attic)
   {
     // TODO: For compatibility with the update_logger, this doesn't happen during the tag processing itself.
@@ -996,65 +1001,38 @@ void Way_Updater::update(Osm_Backend_Callback* callback, Cpu_Stopwatch* cpu_stop
                                 new_node_idx_by_id, new_attic_node_skeletons,
                                 new_attic_skeletons, new_undeleted, new_attic_idx_lists, attic_skeletons_to_delete);
 
-    std::map< Way_Skeleton::Id_Type, std::vector< Attic< Uint31_Index > > > new_attic_idx_by_id_and_time =
-        compute_new_attic_idx_by_id_and_time(new_data, new_skeletons, new_attic_skeletons);
-
-    // Compute new meta data
-    std::map< Uint31_Index, std::set< OSM_Element_Metadata_Skeleton< Way_Skeleton::Id_Type > > >
-        new_attic_meta = compute_new_attic_meta(new_attic_idx_by_id_and_time,
-            compute_meta_by_id_and_time(new_data, attic_meta), new_meta);
-
-    // Compute tags
-    std::map< Tag_Index_Local, std::set< Attic< Way_Skeleton::Id_Type > > > new_attic_local_tags
-        = compute_new_attic_local_tags(new_attic_idx_by_id_and_time,
-            compute_tags_by_id_and_time(new_data, full_attic_local_tags),
-                                       existing_map_positions, existing_idx_lists);
-    std::map< Tag_Index_Global, std::set< Attic< Tag_Object_Global< Way_Skeleton::Id_Type > > > >
-        new_attic_global_tags = compute_attic_global_tags(new_attic_local_tags);
-
-    // Compute changelog
-    std::map< Timestamp, std::set< Change_Entry< Way_Skeleton::Id_Type > > > changelog
-        = compute_changelog(new_data, implicitly_moved_skeletons,
-                            existing_map_positions, existing_attic_map_positions, attic_skeletons,
-                            new_node_idx_by_id, new_attic_node_skeletons);
-
-    strip_single_idxs(existing_idx_lists);
-    std::vector< std::pair< Way_Skeleton::Id_Type, Uint31_Index > > new_attic_map_positions
-        = strip_single_idxs(new_attic_idx_lists);
+    std::vector< std::pair< Way_Skeleton::Id_Type, Uint31_Index > > new_attic_map_positions;
+    std::map< Uint31_Index, std::set< OSM_Element_Metadata_Skeleton< Way_Skeleton::Id_Type > > > new_attic_meta;
+    std::map< Tag_Index_Local, std::set< Attic< Way_Skeleton::Id_Type > > > new_attic_local_tags;
+    std::map< Tag_Index_Global, std::set< Attic< Tag_Object_Global< Way_Skeleton::Id_Type > > > > new_attic_global_tags;
+    std::map< Timestamp, std::set< Change_Entry< Way_Skeleton::Id_Type > > > changelog;
 
-    // Prepare user indices
-    copy_idxs_by_id(new_attic_meta, idxs_by_id);
-    
-    std::vector< std::function< void() > > f;
+    // Every attic file is written in the background as soon as its content is computed.
+    // The task group is declared after the data it refers to such that it is destroyed first.
+    Task_Group attic_files_update(parallel_processes);
 
-    f.push_back( [&]
-    {
-      // Update id indexes
-      update_map_positions(new_attic_map_positions, *transaction, *attic_settings().WAYS);
-    });
-
-    f.push_back( [&]
-    {
-      // Update id index lists
-      update_elements(existing_idx_lists, new_attic_idx_lists,
-            *transaction, *attic_settings().WAY_IDX_LIST);
-    });
-
-    f.push_back( [&]
+    attic_files_update.run( [&]
     {
       // Add attic elements
-        update_elements(attic_skeletons_to_delete, new_attic_skeletons,
-            *transaction, *attic_settings().WAYS);
+      update_elements(attic_skeletons_to_delete, new_attic_skeletons,
+          *transaction, *attic_settings().WAYS);
     });
 
-    f.push_back( [&]
+    attic_files_update.run( [&]
     {
       // Add attic elements
       update_elements(std::map< Uint31_Index, std::set< Attic< Way_Skeleton::Id_Type > > >(),
           new_undeleted, *transaction, *attic_settings().WAYS_UNDELETED);
     });
 
-    f.push_back( [&]
+    std::map< Way_Skeleton::Id_Type, std::vector< Attic< Uint31_Index > > > new_attic_idx_by_id_and_time =
+        compute_new_attic_idx_by_id_and_time(new_data, new_skeletons, new_attic_skeletons);
+
+    // Compute new meta data
+    new_attic_meta = compute_new_attic_meta(new_attic_idx_by_id_and_time,
+        compute_meta_by_id_and_time(new_data, attic_meta), new_meta);
+
+    attic_files_update.run( [&]
     {
       // Add attic meta
       update_elements
@@ -1062,35 +1040,66 @@ void Way_Updater::update(Osm_Backend_Callback* callback, Cpu_Stopwatch* cpu_stop
             new_attic_meta, *transaction, *attic_settings().WAYS_META);
     });
 
-    f.push_back( [&]
+    // Compute tags
+    new_attic_local_tags = compute_new_attic_local_tags(new_attic_idx_by_id_and_time,
+        compute_tags_by_id_and_time(new_data, full_attic_local_tags),
+        existing_map_positions, existing_idx_lists);
+
+    attic_files_update.run( [&]
     {
       // Update tags
       update_elements(std::map< Tag_Index_Local, std::set< Attic < Way_Skeleton::Id_Type > > >(),
             new_attic_local_tags, *transaction, *attic_settings().WAY_TAGS_LOCAL);
     });
 
-    f.push_back( [&]
+    new_attic_global_tags = compute_attic_global_tags(new_attic_local_tags);
+
+    attic_files_update.run( [&]
     {
       update_elements(std::map< Tag_Index_Global,
-           std::set< Attic < Tag_Object_Global< Way_Skeleton::Id_Type > > > >(),
-           new_attic_global_tags, *transaction, *attic_settings().WAY_TAGS_GLOBAL);
+          std::set< Attic < Tag_Object_Global< Way_Skeleton::Id_Type > > > >(),
+          new_attic_global_tags, *transaction, *attic_settings().WAY_TAGS_GLOBAL);
     });
 
-    f.push_back( [&]
+    // Compute changelog
+    changelog = compute_changelog(new_data, implicitly_moved_skeletons,
+        existing_map_positions, existing_attic_map_positions, attic_skeletons,
+        new_node_idx_by_id, new_attic_node_skeletons);
+
+    attic_files_update.run( [&]
     {
       // Write changelog
       update_elements(std::map< Timestamp, std::set< Change_Entry< Way_Skeleton::Id_Type > > >(), changelog,
-            *transaction, *attic_settings().WAY_CHANGELOG);
+          *transaction, *attic_settings().WAY_CHANGELOG);
     });
 
-    process_package(f, parallel_processes);
-  }
+    // The tags computation above still needs the unstripped idx lists
+    strip_single_idxs(existing_idx_lists);
+    new_attic_map_positions = strip_single_idxs(new_attic_idx_lists);
 
-  if (meta != only_data)
-  {
-    copy_idxs_by_id(new_meta, idxs_by_id);
+    attic_files_update.run( [&]
+    {
+      // Update id indexes
+      update_map_positions(new_attic_map_positions, *transaction, *attic_settings().WAYS);
+    });
+
+    attic_files_update.run( [&]
+    {
+      // Update id index lists
+      update_elements(existing_idx_lists, new_attic_idx_lists,
+          *transaction, *attic_settings().WAY_IDX_LIST);
+    });
+
+    // The user files are written while the attic files are still in progress
+    copy_idxs_by_id(new_attic_meta, idxs_by_id);
     process_user_data(*transaction, user_by_id, idxs_by_id);
+
+    attic_files_update.wait();
   }
+  else if (meta != only_data)
+    process_user_data(*transaction, user_by_id, idxs_by_id);
+
+  current_files_update.wait();
   callback->update_finished();
 
   new_data.data.clear();
@@ -19,11 +19,11 @@
 #include "../../expat/escape_json.h"
 #include "output_csv.h"
 
-#include <fmt/core.h>
 
 bool Output_CSV::write_http_headers()
 {
-  std::cout<<"Content-type: text/csv\n";
+  out<<"Content-type: text/csv\n";
+  out.flush();
   return true;
 }
 
@@ -65,12 +65,13 @@ void Output_CSV::write_payload_header
     for (std::vector< std::pair< std::string, bool > >::const_iterator it = csv_settings.keyfields.begin();
         it != csv_settings.keyfields.end(); ++it)
     {
-      std::cout<<(it->second ? "@" : "")<<escape_csv(it->first, csv_settings.separator);
+      out<<(it->second ? "@" : "")<<escape_csv(it->first, csv_settings.separator);
       if (it + 1 != csv_settings.keyfields.end())
-        std::cout<<csv_settings.separator;
+        out<<csv_settings.separator;
     }
-    std::cout<<'\n';
+    out<<'\n';
   }
+  out.flush();
 }
 
 
@@ -82,13 +83,15 @@ void Output_CSV::write_footer()
 
 void Output_CSV::display_remark(const std::string& text)
 {
-  std::cout << "\n\n" << text;
+  out << "\n\n" << text;
+  out.flush();
 }
 
 
 void Output_CSV::display_error(const std::string& text)
 {
-  std::cout << "\n\n" << text;
+  out << "\n\n" << text;
+  out.flush();
 }
 
 
@@ -119,45 +122,46 @@ std::string Output_CSV::dump_config() const
 
 
 template< typename OSM_Element_Metadata_Skeleton >
-void print_meta(const std::string& keyfield,
+void print_meta(Output_Buffer& out, const std::string& keyfield,
     const OSM_Element_Metadata_Skeleton& meta, const std::map< uint32, std::string >* users)
 {
   if (keyfield == "version")
-    std::cout<<meta.version;
+    out<<meta.version;
   else if (keyfield == "timestamp")
-    std::cout<<Timestamp(meta.timestamp).str();
+    out<<Timestamp(meta.timestamp).str();
   else if (keyfield == "changeset")
-    std::cout<<meta.changeset;
+    out<<meta.changeset;
   else if (keyfield == "uid")
-    std::cout<<meta.user_id;
+    out<<meta.user_id;
   else if (users && keyfield == "user")
   {
     std::map< uint32, std::string >::const_iterator uit = users->find(meta.user_id);
     if (uit != users->end())
-      std::cout<<uit->second;
+      out<<uit->second;
   }
 }
 
 
 template< >
-void print_meta< int >(const std::string& keyfield,
+void print_meta< int >(Output_Buffer& out, const std::string& keyfield,
     const int& meta, const std::map< uint32, std::string >* users) {}
 
-std::string get_count_tag(const std::vector< std::pair< std::string, std::string> >* tags, std::string tag)
+std::string get_count_tag(const Interned_Tags* tags, std::string tag)
 {
   if (tags)
-    for (std::vector< std::pair< std::string, std::string> >::const_iterator it_tags = tags->begin();
+    for (Interned_Tags::const_iterator it_tags = tags->begin();
          it_tags != tags->end(); ++it_tags)
-      if (it_tags->first == tag)
-        return it_tags->second;
+      if (*it_tags->first == tag)
+        return *it_tags->second;
   return "0";
 }
 
 
 template< typename Id_Type, typename OSM_Element_Metadata_Skeleton >
-void process_csv_line(int otype, const std::string& type, Id_Type id, const Opaque_Geometry& geometry,
+void process_csv_line(Output_Buffer& out,
+    int otype, const std::string& type, Id_Type id, const Opaque_Geometry& geometry,
     const OSM_Element_Metadata_Skeleton* meta,
-    const std::vector< std::pair< std::string, std::string> >* tags,
+    const Interned_Tags* tags,
     const std::map< uint32, std::string >* users,
     const Csv_Settings& csv_settings,
     Output_Mode mode)
@@ -169,12 +173,12 @@ void process_csv_line(int otype, const std::string& type, Id_Type id, const Opaq
     {
       if (tags)
       {
-	for (std::vector< std::pair< std::string, std::string> >::const_iterator it_tags = tags->begin();
+	for (Interned_Tags::const_iterator it_tags = tags->begin();
 	     it_tags != tags->end(); ++it_tags)
 	{
-	  if (it_tags->first == it->first)
+	  if (*it_tags->first == it->first)
 	  {
-	    std::cout<<escape_csv(it_tags->second, csv_settings.separator);
+	    out<<escape_csv(*it_tags->second, csv_settings.separator);
 	    break;
 	  }
 	}
@@ -183,87 +187,89 @@ void process_csv_line(int otype, const std::string& type, Id_Type id, const Opaq
     else
     {
       if (meta)
-        print_meta(it->first, *meta, users);
+        print_meta(out, it->first, *meta, users);
 
       if (it->first == "id")
       {
         if (mode.mode & Output_Mode::ID)
-          std::cout<<id.val();
+          out<<id.val();
       }
       else if (it->first == "otype")
-        std::cout<<otype;
+        out<<otype;
       else if (it->first == "type")
-	std::cout<<type;
+	out<<type;
       else if (it->first == "lat")
       {
         if ((mode.mode & (Output_Mode::COORDS | Output_Mode::GEOMETRY | Output_Mode::BOUNDS | Output_Mode::CENTER))
 	    && geometry.has_center())
-          std::cout<< fmt::format("{:.7f}", geometry.center_lat());
+          out<<fixed_7(geometry.center_lat());
       }
       else if (it->first == "lon")
       {
         if ((mode.mode & (Output_Mode::COORDS | Output_Mode::GEOMETRY | Output_Mode::BOUNDS | Output_Mode::CENTER))
 	    && geometry.has_center())
-          std::cout<< fmt::format("{:.7f}", geometry.center_lon());
+          out<<fixed_7(geometry.center_lon());
       }
       if (type == "count")
       {
         if (it->first == "count")
-          std::cout << get_count_tag(tags, "total");
+          out << get_count_tag(tags, "total");
         else if (it->first == "count:nodes")
-          std::cout << get_count_tag(tags, "nodes");
+          out << get_count_tag(tags, "nodes");
         else if (it->first == "count:ways")
-          std::cout << get_count_tag(tags, "ways");
+          out << get_count_tag(tags, "ways");
         else if (it->first == "count:relations")
-          std::cout << get_count_tag(tags, "relations");
+          out << get_count_tag(tags, "relations");
         else if (it->first == "count:areas")
-          std::cout << get_count_tag(tags, "areas");
+          out << get_count_tag(tags, "areas");
       }
     }
 
     if (++it == csv_settings.keyfields.end())
       break;
-    std::cout<<csv_settings.separator;
+    out<<csv_settings.separator;
   }
-  std::cout<<"\n";
+  out<<"\n";
 }
 
 
 void Output_CSV::print_item(const Node_Skeleton& skel,
       const Opaque_Geometry& geometry,
-      const std::vector< std::pair< std::string, std::string > >* tags,
+      const Interned_Tags* tags,
       const OSM_Element_Metadata_Skeleton< Node::Id_Type >* meta,
       const std::map< uint32, std::string >* users,
       Output_Mode mode,
       const Feature_Action& action,
       const Node_Skeleton* new_skel,
       const Opaque_Geometry* new_geometry,
-      const std::vector< std::pair< std::string, std::string > >* new_tags,
+      const Interned_Tags* new_tags,
       const OSM_Element_Metadata_Skeleton< Node::Id_Type >* new_meta)
 {
-  process_csv_line(1, "node", skel.id, geometry, meta, tags, users, csv_settings, mode);
+  process_csv_line(out, 1, "node", skel.id, geometry, meta, tags, users, csv_settings, mode);
+  out.flush();
 }
 
 
 void Output_CSV::print_item(const Way_Skeleton& skel,
       const Opaque_Geometry& geometry,
-      const std::vector< std::pair< std::string, std::string > >* tags,
+      const Interned_Tags* tags,
       const OSM_Element_Metadata_Skeleton< Way::Id_Type >* meta,
       const std::map< uint32, std::string >* users,
       Output_Mode mode,
       const Feature_Action& action,
       const Way_Skeleton* new_skel,
       const Opaque_Geometry* new_geometry,
-      const std::vector< std::pair< std::string, std::string > >* new_tags,
+      const Interned_Tags* new_tags,
       const OSM_Element_Metadata_Skeleton< Way::Id_Type >* new_meta)
 {
-  process_csv_line(2, "way", skel.id, geometry, meta, tags, users, csv_settings, mode);
+  process_csv_line(out, 2, "way", skel.id, geometry, meta, tags, users, csv_settings, mode);
+  out.flush();
 }
 
 
 void Output_CSV::print_item(const Relation_Skeleton& skel,
       const Opaque_Geometry& geometry,
-      const std::vector< std::pair< std::string, std::string > >* tags,
+      const Interned_Tags* tags,
       const OSM_Element_Metadata_Skeleton< Relation::Id_Type >* meta,
       const std::map< uint32, std::string >* roles,
       const std::map< uint32, std::string >* users,
@@ -271,19 +277,21 @@ void Output_CSV::print_item(const Relation_Skeleton& skel,
       const Feature_Action& action,
       const Relation_Skeleton* new_skel,
       const Opaque_Geometry* new_geometry,
-      const std::vector< std::pair< std::string, std::string > >* new_tags,
+      const Interned_Tags* new_tags,
       const OSM_Element_Metadata_Skeleton< Relation::Id_Type >* new_meta)
 {
-  process_csv_line(3, "relation", skel.id, geometry, meta, tags, users, csv_settings, mode);
+  process_csv_line(out, 3, "relation", skel.id, geometry, meta, tags, users, csv_settings, mode);
+  out.flush();
 }
 
 
 void Output_CSV::print_item(const Derived_Skeleton& skel,
       const Opaque_Geometry& geometry,
-      const std::vector< std::pair< std::string, std::string > >* tags,
+      const Interned_Tags* tags,
       Output_Mode mode,
       const Feature_Action& action)
 {
   process_csv_line< Derived_Skeleton::Id_Type, int >(
-      4, skel.type_name, skel.id, geometry, 0, tags, 0, csv_settings, mode);
+      out, 4, skel.type_name, skel.id, geometry, 0, tags, 0, csv_settings, mode);
+  out.flush();
 }
@@ -21,11 +21,11 @@
 #include "../frontend/basic_formats.h"
 #include "output_json.h"
 
-#include <fmt/core.h>
 
 bool Output_JSON::write_http_headers()
 {
-  std::cout<<"Content-type: application/json\n";
+  out<<"Content-type: application/json\n";
+  out.flush();
   return true;
 }
 
@@ -34,27 +34,29 @@ void Output_JSON::write_payload_header
     (const std::string& db_dir, const std::string& timestamp, const std::string& area_timestamp)
 {
   if (padding != "")
-    std::cout<<padding<<"(";
+    out<<padding<<"(";
 
-  std::cout<<"{\n"
+  out<<"{\n"
         "  \"version\": 0.6,\n"
         "  \"generator\": \"Overpass API "<<basic_settings().version<<" "
             <<basic_settings().source_hash.substr(0, 8)<<"\",\n"
         "  \"osm3s\": {\n"
 	"    \"timestamp_osm_base\": \""<<timestamp<<"\",\n";
   if (area_timestamp != "")
-    std::cout<<"    \"timestamp_areas_base\": \""<<area_timestamp<<"\",\n";
-  std::cout<<"    \"copyright\": \"The data included in this document is from www.openstreetmap.org."
+    out<<"    \"timestamp_areas_base\": \""<<area_timestamp<<"\",\n";
+  out<<"    \"copyright\": \"The data included in this document is from www.openstreetmap.org."
 	" The data is made available under ODbL.\"\n"
         "  },\n";
-  std::cout<< "  \"elements\": [\n\n";
+  out<< "  \"elements\": [\n\n";
+  out.flush();
 }
 
 
 void Output_JSON::write_footer()
 {
-  std::cout<<"\n\n  ]"<<(messages != "" ? ",\n\"remark\": \"" + escape_cstr(messages) + "\"" : "")
+  out<<"\n\n  ]"<<(messages != "" ? ",\n\"remark\": \"" + escape_cstr(messages) + "\"" : "")
       <<"\n}"<<(padding != "" ? ");\n" : "\n");
+  out.flush();
 }
 
 
@@ -70,76 +72,77 @@ void Output_JSON::display_error(const std::string& text)
 }
 
 
-void handle_first_elem(bool& first_elem)
+void handle_first_elem(Output_Buffer& out, bool& first_elem)
 {
   if (!first_elem)
-    std::cout<<",\n";
+    out<<",\n";
   first_elem = false;
 }
 
 
 template< typename Id_Type >
-void print_meta_json(const OSM_Element_Metadata_Skeleton< Id_Type >& meta,
+void print_meta_json(Output_Buffer& out, const OSM_Element_Metadata_Skeleton< Id_Type >& meta,
 		    const std::map< uint32, std::string >& users)
 {
-  std::cout<<",\n  \"timestamp\": \""<<iso_string(meta.timestamp)<<"\""
+  out<<",\n  \"timestamp\": \""<<iso_string(meta.timestamp)<<"\""
         ",\n  \"version\": "<<meta.version<<
 	",\n  \"changeset\": "<<meta.changeset;
   std::map< uint32, std::string >::const_iterator it = users.find(meta.user_id);
   if (it != users.end())
-    std::cout<<",\n  \"user\": \""<<escape_cstr(it->second)<<"\"";
-  std::cout<<",\n  \"uid\": "<<meta.user_id;
+    out<<",\n  \"user\": \""<<escaped_cstr(it->second)<<"\"";
+  out<<",\n  \"uid\": "<<meta.user_id;
 }
 
 
-void print_tags(const std::vector< std::pair< std::string, std::string > >* tags)
+void print_tags(Output_Buffer& out, const Interned_Tags* tags)
 {
   if (tags != 0 && !tags->empty())
   {
-    std::vector< std::pair< std::string, std::string > >::const_iterator it = tags->begin();
-    std::cout<<",\n  \"tags\": {"
-           "\n    \""<<escape_cstr(it->first)<<"\": \""<<escape_cstr(it->second)<<"\"";
+    Interned_Tags::const_iterator it = tags->begin();
+    out<<",\n  \"tags\": {"
+           "\n    \""<<escaped_cstr(*it->first)<<"\": \""<<escaped_cstr(*it->second)<<"\"";
     for (++it; it != tags->end(); ++it)
-      std::cout<<",\n    \""<<escape_cstr(it->first)<<"\": \""<<escape_cstr(it->second)<<"\"";
-    std::cout<<"\n  }";
+      out<<",\n    \""<<escaped_cstr(*it->first)<<"\": \""<<escaped_cstr(*it->second)<<"\"";
+    out<<"\n  }";
   }
 }
 
 
 void Output_JSON::print_item(const Node_Skeleton& skel,
       const Opaque_Geometry& geometry,
-      const std::vector< std::pair< std::string, std::string > >* tags,
+      const Interned_Tags* tags,
       const OSM_Element_Metadata_Skeleton< Node::Id_Type >* meta,
       const std::map< uint32, std::string >* users,
       Output_Mode mode,
       const Feature_Action& action,
       const Node_Skeleton* new_skel,
       const Opaque_Geometry* new_geometry,
-      const std::vector< std::pair< std::string, std::string > >* new_tags,
+      const Interned_Tags* new_tags,
       const OSM_Element_Metadata_Skeleton< Node::Id_Type >* new_meta)
 {
-  handle_first_elem(first_elem);
-  std::cout<<"{\n"
+  handle_first_elem(out, first_elem);
+  out<<"{\n"
         "  \"type\": \"node\"";
   if (mode.mode & Output_Mode::ID)
-    std::cout<<",\n  \"id\": "<<skel.id.val();
+    out<<",\n  \"id\": "<<skel.id.val();
 
   if (mode.mode & (Output_Mode::COORDS | Output_Mode::GEOMETRY | Output_Mode::BOUNDS | Output_Mode::CENTER))
-      std::cout<< fmt::format(",\n  \"lat\": {:.7f},\n  \"lon\": {:.7f}", geometry.center_lat(), geometry.center_lon());
+      out<<",\n  \"lat\": "<<fixed_7(geometry.center_lat())<<",\n  \"lon\": "<<fixed_7(geometry.center_lon());
 
   if (meta)
-    print_meta_json(*meta, *users);
+    print_meta_json(out, *meta, *users);
 
-  print_tags(tags);
-  std::cout<<"\n}";
+  print_tags(out, tags);
+  out<<"\n}";
+  out.flush();
 }
 
 
-void print_bounds(const Opaque_Geometry& geometry, Output_Mode mode)
+void print_bounds(Output_Buffer& out, const Opaque_Geometry& geometry, Output_Mode mode)
 {
   if ((mode.mode & Output_Mode::BOUNDS) && geometry.has_bbox())
 
-  std::cout<<  fmt::format(",\n  \"bounds\": {{\n"
+  out.format(",\n  \"bounds\": {{\n"
       "    \"minlat\": {:.7f},\n"
       "    \"minlon\": {:.7f},\n"
       "    \"maxlat\": {:.7f},\n"
@@ -147,7 +150,7 @@ void print_bounds(const Opaque_Geometry& geometry, Output_Mode mode)
       "  }}", geometry.south(), geometry.west(), geometry.north(), geometry.east());
   else if ((mode.mode & Output_Mode::CENTER) && geometry.has_center())
 
-    std::cout<< fmt::format(",\n  \"center\": {{\n"
+    out.format(",\n  \"center\": {{\n"
         "    \"lat\": {:.7f},\n"
         "    \"lon\": {:.7f}\n"
         "  }}", geometry.center_lat(), geometry.center_lon());
@@ -157,61 +160,62 @@ void print_bounds(const Opaque_Geometry& geometry, Output_Mode mode)
 
 void Output_JSON::print_item(const Way_Skeleton& skel,
       const Opaque_Geometry& geometry,
-      const std::vector< std::pair< std::string, std::string > >* tags,
+      const Interned_Tags* tags,
       const OSM_Element_Metadata_Skeleton< Way::Id_Type >* meta,
       const std::map< uint32, std::string >* users,
       Output_Mode mode,
       const Feature_Action& action,
       const Way_Skeleton* new_skel,
       const Opaque_Geometry* new_geometry,
-      const std::vector< std::pair< std::string, std::string > >* new_tags,
+      const Interned_Tags* new_tags,
       const OSM_Element_Metadata_Skeleton< Way::Id_Type >* new_meta)
 {
-  handle_first_elem(first_elem);
-  std::cout<<"{\n"
+  handle_first_elem(out, first_elem);
+  out<<"{\n"
         "  \"type\": \"way\"";
   if (mode.mode & Output_Mode::ID)
-    std::cout<<",\n  \"id\": "<<skel.id.val();
+    out<<",\n  \"id\": "<<skel.id.val();
 
   if (meta)
-    print_meta_json(*meta, *users);
+    print_meta_json(out, *meta, *users);
 
-  print_bounds(geometry, mode);
+  print_bounds(out, geometry, mode);
 
   if ((mode.mode & Output_Mode::NDS) != 0 && !skel.nds().empty())
   {
     std::vector< Node::Id_Type >::const_iterator it = skel.nds().begin();
-    std::cout<<",\n  \"nodes\": ["
+    out<<",\n  \"nodes\": ["
            "\n    "<<it->val();
     for (++it; it != skel.nds().end(); ++it)
-      std::cout<<",\n    "<<it->val();
-    std::cout<<"\n  ]";
+      out<<",\n    "<<it->val();
+    out<<"\n  ]";
   }
 
   if ((mode.mode & Output_Mode::GEOMETRY) != 0 && geometry.has_faithful_way_geometry())
   {
-    std::cout<<",\n  \"geometry\": [";
+    out<<",\n  \"geometry\": [";
     for (uint i = 0; i < geometry.way_size(); ++i)
     {
       if (geometry.way_pos_is_valid(i))
-        std::cout<< fmt::format("\n    {{ \"lat\": {:.7f}, \"lon\": {:.7f} }}", geometry.way_pos_lat(i), geometry.way_pos_lon(i));
+        out<<"\n    { \"lat\": "<<fixed_7(geometry.way_pos_lat(i))<<", \"lon\": "<<fixed_7(geometry.way_pos_lon(i))<<" }";
       else
-        std::cout<<"\n    null";
+        out<<"\n    null";
 
       if (i < geometry.way_size() - 1)
-        std::cout << ",";
+        out << ",";
     }
-    std::cout<<"\n  ]";
+    out<<"\n  ]";
   }
 
-  print_tags(tags);
-  std::cout<<"\n}";
+  print_tags(out, tags);
+  out<<"\n}";
+  out.flush();
 }
 
 
 void Output_JSON::print_item(const Relation_Skeleton& skel,
       const Opaque_Geometry& geometry,
-      const std::vector< std::pair< std::string, std::string > >* tags,
+      const Interned_Tags* tags,
       const OSM_Element_Metadata_Skeleton< Relation::Id_Type >* meta,
       const std::map< uint32, std::string >* roles,
       const std::map< uint32, std::string >* users,
@@ -219,68 +223,71 @@ void Output_JSON::print_item(const Relation_Skeleton& skel,
       const Feature_Action& action,
       const Relation_Skeleton* new_skel,
       const Opaque_Geometry* new_geometry,
-      const std::vector< std::pair< std::string, std::string > >* new_tags,
+      const Interned_Tags* new_tags,
       const OSM_Element_Metadata_Skeleton< Relation::Id_Type >* new_meta)
 {
-  handle_first_elem(first_elem);
-  std::cout<<"{\n"
+  handle_first_elem(out, first_elem);
+  out<<"{\n"
         "  \"type\": \"relation\"";
   if (mode.mode & Output_Mode::ID)
-    std::cout<<",\n  \"id\": "<<skel.id.val();
+    out<<",\n  \"id\": "<<skel.id.val();
 
   if (meta)
-    print_meta_json(*meta, *users);
+    print_meta_json(out, *meta, *users);
 
-  print_bounds(geometry, mode);
+  print_bounds(out, geometry, mode);
 
   if (roles && (mode.mode & Output_Mode::MEMBERS) != 0 && !skel.members().empty())
   {
-    std::cout<<",\n  \"members\": [";
+    out<<",\n  \"members\": [";
     for (uint i = 0; i < skel.members().size(); i++)
     {
       std::map< uint32, std::string >::const_iterator rit = roles->find(skel.members()[i].role);
-      std::cout<< (i == 0 ? "" : ",");
-      std::cout <<"\n    {"
+      out<< (i == 0 ? "" : ",");
+      out <<"\n    {"
             "\n      \"type\": \""<<member_type_name(skel.members()[i].type)<<
             "\",\n      \"ref\": "<<skel.members()[i].ref.val()<<
-            ",\n      \"role\": \""<<escape_cstr(rit != roles->end() ? rit->second : "???") << "\"";
+            ",\n      \"role\": \""<<escaped_cstr(rit != roles->end() ? rit->second : "???") << "\"";
 
       if (skel.members()[i].type == Relation_Entry::NODE &&
           geometry.has_faithful_relation_geometry() && geometry.relation_pos_is_valid(i))
-        std::cout<< fmt::format(",\n      \"lat\": {:.7f},\n      \"lon\": {:.7f}", geometry.relation_pos_lat(i), geometry.relation_pos_lon(i));
+        out<<",\n      \"lat\": "<<fixed_7(geometry.relation_pos_lat(i))
+            <<",\n      \"lon\": "<<fixed_7(geometry.relation_pos_lon(i));
 
       if (skel.members()[i].type == Relation_Entry::WAY && geometry.has_faithful_relation_geometry())
       {
-        std::cout<<",\n      \"geometry\": [";
+        out<<",\n      \"geometry\": [";
         for (uint j = 0; j < geometry.relation_way_size(i); ++j)
         {
           if (geometry.relation_pos_is_valid(i, j))
           {
-            std::cout<<  fmt::format("\n         {{ \"lat\": {:.7f}, \"lon\": {:.7f} }}", geometry.relation_pos_lat(i, j), geometry.relation_pos_lon(i, j));
+            out<<"\n         { \"lat\": "<<fixed_7(geometry.relation_pos_lat(i, j))
+                <<", \"lon\": "<<fixed_7(geometry.relation_pos_lon(i, j))<<" }";
           }
           else
-            std::cout<<"\n         null";
+            out<<"\n         null";
           if (j < geometry.relation_way_size(i) - 1)
-            std::cout << ",";
+            out << ",";
         }
-        std::cout<<"\n      ]";
+        out<<"\n      ]";
       }
 
-      std::cout<<"\n    }";
+      out<<"\n    }";
     }
-    std::cout<<"\n  ]";
+    out<<"\n  ]";
   }
 
-  print_tags(tags);
-  std::cout<<"\n}";
+  print_tags(out, tags);
+  out<<"\n}";
+  out.flush();
 }
 
 
-void print_geometry(const Opaque_Geometry& geometry, const std::string& indent)
+void print_geometry(Output_Buffer& out, const Opaque_Geometry& geometry, const std::string& indent)
 {
   if (geometry.has_components())
   {
-    std::cout<<"{"
+    out<<"{"
         "\n"<<indent<<"  \"type\": \"GeometryCollection\","
         "\n"<<indent<<"  \"geometries\": [";
 
@@ -293,32 +300,32 @@ void print_geometry(const Opaque_Geometry& geometry, const std::string& indent)
         if (first_printed)
           first_printed = false;
         else
-          std::cout<<",";
+          out<<",";
 
-        std::cout<<"\n"<<indent<<"    ";
-        print_geometry(**it, indent + "    ");
+        out<<"\n"<<indent<<"    ";
+        print_geometry(out, **it, indent + "    ");
       }
     }
 
-    std::cout<<"\n"<<indent<<"  ]\n"<<indent<<"}";
+    out<<"\n"<<indent<<"  ]\n"<<indent<<"}";
   }
   else if (geometry.has_line_geometry())
   {
-    std::cout<<"{"
+    out<<"{"
         "\n"<<indent<<"  \"type\": \"LineString\","
         "\n"<<indent<<"  \"coordinates\": [";
 
     const std::vector< Point_Double >* line = geometry.get_line_geometry();
     for (std::vector< Point_Double >::const_iterator it = line->begin(); it != line->end(); ++it)
-      std::cout<<(it == line->begin() ? "" : ",")<<"\n"<<indent<<"    ["
-          <<std::fixed<<std::setprecision(7)<<it->lon<<", "
-          <<std::fixed<<std::setprecision(7)<<it->lat<<"]";
+      out<<(it == line->begin() ? "" : ",")<<"\n"<<indent<<"    ["
+          <<fixed_7(it->lon)<<", "
+          <<fixed_7(it->lat)<<"]";
 
-    std::cout<<"\n"<<indent<<"  ]\n"<<indent<<"}";
+    out<<"\n"<<indent<<"  ]\n"<<indent<<"}";
   }
   else if (geometry.has_multiline_geometry())
   {
-    std::cout<<"{"
+    out<<"{"
         "\n"<<indent<<"  \"type\": \"Polygon\","
         "\n"<<indent<<"  \"coordinates\": [";
 
@@ -326,76 +333,77 @@ void print_geometry(const Opaque_Geometry& geometry, const std::string& indent)
     for (std::vector< std::vector< Point_Double > >::const_iterator iti = linestrings->begin();
         iti != linestrings->end(); ++iti)
     {
-      std::cout<<(iti == linestrings->begin() ? "" : ",")<<"\n"<<indent<<"    [";
+      out<<(iti == linestrings->begin() ? "" : ",")<<"\n"<<indent<<"    [";
       for (std::vector< Point_Double >::const_iterator it = iti->begin(); it != iti->end(); ++it)
-        std::cout<<(it == iti->begin() ? "" : ",")<<"\n"<<indent<<"      ["
-            <<std::fixed<<std::setprecision(7)<<it->lon<<", "
-            <<std::fixed<<std::setprecision(7)<<it->lat<<"]";
-      std::cout<<"\n"<<indent<<"    ]";
+        out<<(it == iti->begin() ? "" : ",")<<"\n"<<indent<<"      ["
+            <<fixed_7(it->lon)<<", "
+            <<fixed_7(it->lat)<<"]";
+      out<<"\n"<<indent<<"    ]";
     }
 
-    std::cout<<"\n"<<indent<<"  ]\n"<<indent<<"}";
+    out<<"\n"<<indent<<"  ]\n"<<indent<<"}";
   }
   else if (geometry.has_center())
-    std::cout<<"{"
+    out<<"{"
         "\n"<<indent<<"  \"type\": \"Point\","
         "\n"<<indent<<"  \"coordinates\": [ "
-        <<std::fixed<<std::setprecision(7)<<geometry.center_lon()<<", "
-        <<std::fixed<<std::setprecision(7)<<geometry.center_lat()<<" ]"
+        <<fixed_7(geometry.center_lon())<<", "
+        <<fixed_7(geometry.center_lat())<<" ]"
     "\n"<<indent<<"}";
 }
 
 
-void print_geometry(const Opaque_Geometry& geometry, Output_Mode mode)
+void print_geometry(Output_Buffer& out, const Opaque_Geometry& geometry, Output_Mode mode)
 {
   if ((mode.mode & Output_Mode::GEOMETRY) && (geometry.has_center()))
   {
-    std::cout<<",\n  \"geometry\": ";
-    print_geometry(geometry, "  ");
+    out<<",\n  \"geometry\": ";
+    print_geometry(out, geometry, "  ");
   }
   else if ((mode.mode & Output_Mode::BOUNDS) && geometry.has_bbox())
-    std::cout<<",\n  \"geometry\": {"
+    out<<",\n  \"geometry\": {"
         "\n    \"type\": \"Polygon\","
         "\n    \"coordinates\": ["
         "\n      ["
-            <<std::fixed<<std::setprecision(7)<<geometry.west()<<", "
-            <<std::fixed<<std::setprecision(7)<<geometry.south()<<"]"
+            <<fixed_7(geometry.west())<<", "
+            <<fixed_7(geometry.south())<<"]"
         ",\n      ["
-            <<std::fixed<<std::setprecision(7)<<geometry.east()<<", "
-            <<std::fixed<<std::setprecision(7)<<geometry.south()<<"]"
+            <<fixed_7(geometry.east())<<", "
+            <<fixed_7(geometry.south())<<"]"
         ",\n      ["
-            <<std::fixed<<std::setprecision(7)<<geometry.east()<<", "
-            <<std::fixed<<std::setprecision(7)<<geometry.north()<<"]"
+            <<fixed_7(geometry.east())<<", "
+            <<fixed_7(geometry.north())<<"]"
         ",\n      ["
-            <<std::fixed<<std::setprecision(7)<<geometry.west()<<", "
-            <<std::fixed<<std::setprecision(7)<<geometry.north()<<"]"
+            <<fixed_7(geometry.west())<<", "
+            <<fixed_7(geometry.north())<<"]"
         ",\n      ["
-            <<std::fixed<<std::setprecision(7)<<geometry.west()<<", "
-            <<std::fixed<<std::setprecision(7)<<geometry.south()<<"]"
+            <<fixed_7(geometry.west())<<", "
+            <<fixed_7(geometry.south())<<"]"
         "\n    ]\n  }";
   else if ((mode.mode & Output_Mode::CENTER) && geometry.has_center())
-    std::cout<<",\n  \"geometry\": {"
+    out<<",\n  \"geometry\": {"
         "\n    \"type\": \"Point\","
         "\n    \"coordinates\": [ "
-        <<std::fixed<<std::setprecision(7)<<geometry.center_lon()<<", "
-        <<std::fixed<<std::setprecision(7)<<geometry.center_lat()<<" ]"
+        <<fixed_7(geometry.center_lon())<<", "
+        <<fixed_7(geometry.center_lat())<<" ]"
         "\n  }";
 }
 
 
 void Output_JSON::print_item(const Derived_Skeleton& skel,
       const Opaque_Geometry& geometry,
-      const std::vector< std::pair< std::string, std::string > >* tags,
+      const Interned_Tags* tags,
       Output_Mode mode,
       const Feature_Action& action)
 {
-  handle_first_elem(first_elem);
-  std::cout<<"{\n"
+  handle_first_elem(out, first_elem);
+  out<<"{\n"
         "  \"type\": \""<<skel.type_name<<"\"";
   if (mode.mode & Output_Mode::ID)
-    std::cout<<",\n  \"id\": "<<skel.id.val();
+    out<<",\n  \"id\": "<<skel.id.val();
 
-  print_geometry(geometry, mode);
-  print_tags(tags);
-  std::cout<<"\n}";
+  print_geometry(out, geometry, mode);
+  print_tags(out, tags);
+  out<<"\n}";
+  out.flush();
 }
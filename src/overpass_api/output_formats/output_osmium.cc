@@ -168,14 +168,14 @@ void Output_Osmium::print_global_bbox(const Bbox_Double& bbox)
 
 void Output_Osmium::print_item(const Node_Skeleton& skel,
       const Opaque_Geometry& geometry,
-      const std::vector< std::pair< std::string, std::string > >* tags,
+      const Interned_Tags* tags,
       const OSM_Element_Metadata_Skeleton< Node::Id_Type >* meta,
       const std::map< uint32, std::string >* users,
       Output_Mode mode,
       const Feature_Action& action,
       const Node_Skeleton* new_skel,
       const Opaque_Geometry* new_geometry,
-      const std::vector< std::pair< std::string, std::string > >* new_tags,
+      const Interned_Tags* new_tags,
       const OSM_Element_Metadata_Skeleton< Node::Id_Type >* new_meta)
 {
   using namespace osmium::builder::attr;
@@ -194,9 +194,9 @@ void Output_Osmium::print_item(const Node_Skeleton& skel,
 
   if ((tags != 0) && (!tags->empty()))
   {
-    for (std::vector< std::pair< std::string, std::string > >::const_iterator it(tags->begin());
+    for (Interned_Tags::const_iterator it(tags->begin());
         it != tags->end(); ++it)
-      tag_list.push_back(std::make_pair(it->first.c_str(), it->second.c_str()));
+      tag_list.push_back(std::make_pair(it->first->c_str(), it->second->c_str()));
   }
 
   if ((mode.mode & (Output_Mode::VERSION | Output_Mode::META)) && meta && users)
@@ -228,14 +228,14 @@ void Output_Osmium::print_item(const Node_Skeleton& skel,
 
 void Output_Osmium::print_item(const Way_Skeleton& skel,
       const Opaque_Geometry& geometry,
-      const std::vector< std::pair< std::string, std::string > >* tags,
+      const Interned_Tags* tags,
       const OSM_Element_Metadata_Skeleton< Way::Id_Type >* meta,
       const std::map< uint32, std::string >* users,
       Output_Mode mode,
       const Feature_Action& action,
       const Way_Skeleton* new_skel,
       const Opaque_Geometry* new_geometry,
-      const std::vector< std::pair< std::string, std::string > >* new_tags,
+      const Interned_Tags* new_tags,
       const OSM_Element_Metadata_Skeleton< Way::Id_Type >* new_meta)
 {
   using namespace osmium::builder::attr;
@@ -270,9 +270,9 @@ void Output_Osmium::print_item(const Way_Skeleton& skel,
 
   if ((tags != 0) && (!tags->empty()))
   {
-    for (std::vector< std::pair< std::string, std::string > >::const_iterator it(tags->begin());
+    for (Interned_Tags::const_iterator it(tags->begin());
         it != tags->end(); ++it)
-      tag_list.push_back(std::make_pair(it->first.c_str(), it->second.c_str()));
+      tag_list.push_back(std::make_pair(it->first->c_str(), it->second->c_str()));
   }
 
   if ((mode.mode & (Output_Mode::VERSION | Output_Mode::META)) && meta && users)
@@ -305,7 +305,7 @@ void Output_Osmium::print_item(const Way_Skeleton& skel,
 
 void Output_Osmium::print_item(const Relation_Skeleton& skel,
       const Opaque_Geometry& geometry,
-      const std::vector< std::pair< std::string, std::string > >* tags,
+      const Interned_Tags* tags,
       const OSM_Element_Metadata_Skeleton< Relation::Id_Type >* meta,
       const std::map< uint32, std::string >* roles,
       const std::map< uint32, std::string >* users,
@@ -313,7 +313,7 @@ void Output_Osmium::print_item(const Relation_Skeleton& skel,
       const Feature_Action& action,
       const Relation_Skeleton* new_skel,
       const Opaque_Geometry* new_geometry,
-      const std::vector< std::pair< std::string, std::string > >* new_tags,
+      const Interned_Tags* new_tags,
       const OSM_Element_Metadata_Skeleton< Relation::Id_Type >* new_meta)
 {
   using namespace osmium::builder::attr;
@@ -359,9 +359,9 @@ void Output_Osmium::print_item(const Relation_Skeleton& skel,
 
   if ((tags != 0) && (!tags->empty()))
   {
-    for (std::vector< std::pair< std::string, std::string > >::const_iterator it(tags->begin());
+    for (Interned_Tags::const_iterator it(tags->begin());
         it != tags->end(); ++it)
-      tag_list.push_back(std::make_pair(it->first.c_str(), it->second.c_str()));
+      tag_list.push_back(std::make_pair(it->first->c_str(), it->second->c_str()));
   }
 
   if ((mode.mode & (Output_Mode::VERSION | Output_Mode::META)) && meta && users)
@@ -394,7 +394,7 @@ void Output_Osmium::print_item(const Relation_Skeleton& skel,
 
 void Output_Osmium::print_item(const Derived_Skeleton& skel,
       const Opaque_Geometry& geometry,
-      const std::vector< std::pair< std::string, std::string > >* tags,
+      const Interned_Tags* tags,
       Output_Mode mode,
       const Feature_Action& action)
 {
@@ -10,6 +10,7 @@
 
 
 #include "output_osmium.h"
+#include "output_pbf.h"
 #include "../frontend/tokenizer_utils.h"
 
 
@@ -59,7 +60,7 @@ Output_Handler* Output_Osmium_PBF_Generator::new_output_handler(const std::map<
                                                          Tokenizer_Wrapper* token, Error_Output* error_output)
 {
   auto params = osmium_arguments(token, error_output);
-  return new Output_Osmium("pbf", params);
+  return new Output_PBF(params.find("locations_on_ways=yes") != std::string::npos);
 }
 
 
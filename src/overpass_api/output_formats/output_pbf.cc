@@ -0,0 +1,532 @@
+/** Copyright 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018 Roland Olbricht et al.
+ *
+ * This file is part of Overpass_API.
+ *
+ * Overpass_API is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Overpass_API is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Overpass_API.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "../../template_db/zlib_wrapper.h"
+#include "../core/settings.h"
+#include "output_pbf.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+#include <protozero/pbf_writer.hpp>
+
+
+namespace
+{
+  // Coordinate written for elements without a location, as libosmium does
+  const int64 UNDEFINED_COORDINATE = 2147483647;
+
+  int64 fixed_coord(double coord) { return std::llround(coord * 10000000.); }
+
+
+  // Compresses a HeaderBlock or PrimitiveBlock and frames it as BlobHeader and Blob
+  std::string make_blob(const std::string& type, const std::string& data)
+  {
+    std::string compressed(compressBound(data.size()) + 64, '\0');
+    Zlib_Deflate deflate(Z_DEFAULT_COMPRESSION);
+    compressed.resize(deflate.compress(data.data(), data.size(), &compressed[0], compressed.size()));
+
+    std::string blob;
+    {
+      protozero::pbf_writer pbf_blob(blob);
+      pbf_blob.add_int32(2, data.size());
+      pbf_blob.add_bytes(3, compressed);
+    }
+
+    std::string blob_header;
+    {
+      protozero::pbf_writer pbf_blob_header(blob_header);
+      pbf_blob_header.add_string(1, type);
+      pbf_blob_header.add_int32(3, blob.size());
+    }
+
+    std::string result;
+    result.reserve(4 + blob_header.size() + blob.size());
+    uint32 header_size = blob_header.size();
+    result.push_back(char(header_size>>24));
+    result.push_back(char((header_size>>16) & 0xff));
+    result.push_back(char((header_size>>8) & 0xff));
+    result.push_back(char(header_size & 0xff));
+    result += blob_header;
+    result += blob;
+    return result;
+  }
+}
+
+
+void Output_PBF::Dense_Nodes::clear()
+{
+  ids.clear();
+  lats.clear();
+  lons.clear();
+  keys_vals.clear();
+  versions.clear();
+  timestamps.clear();
+  changesets.clear();
+  uids.clear();
+  user_sids.clear();
+
+  last_id = 0;
+  last_lat = 0;
+  last_lon = 0;
+  last_timestamp = 0;
+  last_changeset = 0;
+  last_uid = 0;
+  last_user_sid = 0;
+}
+
+
+bool Output_PBF::write_http_headers()
+{
+  std::cout<<"Content-type: application/vnd.openstreetmap.data.pbf\n" << std::flush;
+  return true;
+}
+
+
+void Output_PBF::write_payload_header
+    (const std::string& db_dir, const std::string& timestamp, const std::string& area_timestamp)
+{
+  max_pending_blobs = std::max(1u, std::min(std::thread::hardware_concurrency(), 4u));
+
+  std::string header_block;
+  {
+    protozero::pbf_writer pbf_header(header_block);
+    pbf_header.add_string(4, "OsmSchema-V0.6");
+    pbf_header.add_string(4, "DenseNodes");
+    if (locations_on_ways)
+      pbf_header.add_string(5, "LocationsOnWays");
+    pbf_header.add_string(16, "Overpass API " + basic_settings().version
+        + " " + basic_settings().source_hash.substr(0, 8));
+
+    Timestamp replication_timestamp(timestamp);
+    if (replication_timestamp.timestamp != 0)
+      pbf_header.add_int64(32, replication_timestamp.seconds_since_epoch());
+  }
+  push_blob("OSMHeader", std::move(header_block));
+}
+
+
+void Output_PBF::write_footer()
+{
+  finish_block();
+  write_blobs(0);
+  std::cout << std::flush;
+}
+
+
+void Output_PBF::display_remark(const std::string& text)
+{
+  // Intentionally empty
+}
+
+
+void Output_PBF::display_error(const std::string& text)
+{
+  // Intentionally empty
+}
+
+
+void Output_PBF::print_global_bbox(const Bbox_Double& bbox)
+{
+  // Intentionally empty
+}
+
+
+uint32 Output_PBF::string_id(const std::string& s)
+{
+  std::unordered_map< std::string, uint32 >::const_iterator it = string_ids.find(s);
+  if (it != string_ids.end())
+    return it->second;
+
+  uint32 id = strings.size();
+  strings.push_back(s);
+  string_ids.insert(std::make_pair(s, id));
+  string_bytes += s.size();
+  return id;
+}
+
+
+const std::string& Output_PBF::user_name(uint32 user_id, const std::map< uint32, std::string >* users)
+{
+  static const std::string unknown_user = "???";
+
+  std::map< uint32, std::string >::const_iterator it = users->find(user_id);
+  return it != users->end() ? it->second : unknown_user;
+}
+
+
+template< typename Id_Type >
+std::string Output_PBF::info(const OSM_Element_Metadata_Skeleton< Id_Type >& meta,
+    const std::map< uint32, std::string >* users)
+{
+  std::string result;
+  protozero::pbf_writer pbf_info(result);
+  pbf_info.add_int32(1, meta.version);
+  pbf_info.add_int64(2, Timestamp(meta.timestamp).seconds_since_epoch());
+  pbf_info.add_int64(3, meta.changeset);
+  pbf_info.add_int32(4, meta.user_id);
+  pbf_info.add_uint32(5, string_id(user_name(meta.user_id, users)));
+  return result;
+}
+
+
+template< typename Id_Type >
+void Output_PBF::add_dense_info(const OSM_Element_Metadata_Skeleton< Id_Type >& meta,
+    const std::map< uint32, std::string >* users)
+{
+  int64 timestamp = Timestamp(meta.timestamp).seconds_since_epoch();
+  int32 user_sid = string_id(user_name(meta.user_id, users));
+
+  dense.versions.push_back(meta.version);
+  dense.timestamps.push_back(timestamp - dense.last_timestamp);
+  dense.changesets.push_back(int64(meta.changeset) - dense.last_changeset);
+  dense.uids.push_back(int32(meta.user_id) - dense.last_uid);
+  dense.user_sids.push_back(user_sid - dense.last_user_sid);
+
+  dense.last_timestamp = timestamp;
+  dense.last_changeset = meta.changeset;
+  dense.last_uid = meta.user_id;
+  dense.last_user_sid = user_sid;
+}
+
+
+// A PrimitiveGroup holds only one kind of element, and DenseInfo must be present for all or no nodes
+void Output_PBF::start_group(Group_Type type, bool with_meta)
+{
+  if (group_type == type && group_with_meta == with_meta)
+    return;
+
+  finish_group();
+  group_type = type;
+  group_with_meta = with_meta;
+}
+
+
+void Output_PBF::element_added()
+{
+  ++group_size;
+  ++block_size;
+
+  uint64 estimated_bytes = string_bytes + groups.size() + group.size() + dense.ids.size() * 32;
+  if (block_size >= MAX_BLOCK_ELEMENTS || estimated_bytes >= MAX_BLOCK_BYTES)
+    finish_block();
+}
+
+
+void Output_PBF::finish_group()
+{
+  if (group_type == NO_GROUP || group_size == 0)
+  {
+    group_type = NO_GROUP;
+    return;
+  }
+
+  protozero::pbf_writer pbf_groups(groups);
+  if (group_type == DENSE_NODES)
+  {
+    protozero::pbf_writer pbf_group(pbf_groups, 2);
+    protozero::pbf_writer pbf_dense(pbf_group, 2);
+
+    pbf_dense.add_packed_sint64(1, dense.ids.begin(), dense.ids.end());
+    if (group_with_meta)
+    {
+      protozero::pbf_writer pbf_dense_info(pbf_dense, 5);
+      pbf_dense_info.add_packed_int32(1, dense.versions.begin(), dense.versions.end());
+      pbf_dense_info.add_packed_sint64(2, dense.timestamps.begin(), dense.timestamps.end());
+      pbf_dense_info.add_packed_sint64(3, dense.changesets.begin(), dense.changesets.end());
+      pbf_dense_info.add_packed_sint32(4, dense.uids.begin(), dense.uids.end());
+      pbf_dense_info.add_packed_sint32(5, dense.user_sids.begin(), dense.user_sids.end());
+    }
+    pbf_dense.add_packed_sint64(8, dense.lats.begin(), dense.lats.end());
+    pbf_dense.add_packed_sint64(9, dense.lons.begin(), dense.lons.end());
+    if (dense.keys_vals.size() > dense.ids.size())
+      pbf_dense.add_packed_int32(10, dense.keys_vals.begin(), dense.keys_vals.end());
+
+    dense.clear();
+  }
+  else
+  {
+    pbf_groups.add_message(2, group);
+    group.clear();
+  }
+
+  group_type = NO_GROUP;
+  group_size = 0;
+}
+
+
+void Output_PBF::finish_block()
+{
+  finish_group();
+  if (block_size == 0)
+    return;
+
+  std::string block;
+  {
+    protozero::pbf_writer pbf_block(block);
+    protozero::pbf_writer pbf_string_table(pbf_block, 1);
+    for (std::vector< std::string >::const_iterator it = strings.begin(); it != strings.end(); ++it)
+      pbf_string_table.add_bytes(1, *it);
+  }
+  block += groups;
+
+  strings.assign(1, "");
+  string_ids.clear();
+  string_bytes = 0;
+  groups.clear();
+  block_size = 0;
+
+  push_blob("OSMData", std::move(block));
+}
+
+
+void Output_PBF::push_blob(const char* type, std::string&& data)
+{
+  write_blobs(max_pending_blobs - 1);
+  pending_blobs.push_back(std::async(std::launch::async, make_blob, std::string(type), std::move(data)));
+}
+
+
+void Output_PBF::write_blobs(uint32 max_pending)
+{
+  while (pending_blobs.size() > max_pending)
+  {
+    std::string blob;
+    try
+    {
+      blob = pending_blobs.front().get();
+    }
+    catch (const Zlib_Deflate::Error& e)
+    {
+      pending_blobs.pop_front();
+      throw File_Error(e.error_code, "", "Output_PBF::write_blobs");
+    }
+    pending_blobs.pop_front();
+    std::cout.write(blob.data(), blob.size());
+  }
+}
+
+
+void Output_PBF::print_item(const Node_Skeleton& skel,
+      const Opaque_Geometry& geometry,
+      const Interned_Tags* tags,
+      const OSM_Element_Metadata_Skeleton< Node::Id_Type >* meta,
+      const std::map< uint32, std::string >* users,
+      Output_Mode mode,
+      const Feature_Action& action,
+      const Node_Skeleton* new_skel,
+      const Opaque_Geometry* new_geometry,
+      const Interned_Tags* new_tags,
+      const OSM_Element_Metadata_Skeleton< Node::Id_Type >* new_meta)
+{
+  bool with_meta = (mode.mode & (Output_Mode::VERSION | Output_Mode::META)) && meta && users;
+  start_group(DENSE_NODES, with_meta);
+
+  int64 id = skel.id.val();
+  int64 lat = UNDEFINED_COORDINATE;
+  int64 lon = UNDEFINED_COORDINATE;
+  if (mode & (Output_Mode::COORDS | Output_Mode::GEOMETRY | Output_Mode::BOUNDS | Output_Mode::CENTER))
+  {
+    lat = fixed_coord(geometry.center_lat());
+    lon = fixed_coord(geometry.center_lon());
+  }
+
+  dense.ids.push_back(id - dense.last_id);
+  dense.lats.push_back(lat - dense.last_lat);
+  dense.lons.push_back(lon - dense.last_lon);
+  dense.last_id = id;
+  dense.last_lat = lat;
+  dense.last_lon = lon;
+
+  if (tags)
+  {
+    for (Interned_Tags::const_iterator it = tags->begin();
+        it != tags->end(); ++it)
+    {
+      dense.keys_vals.push_back(string_id(*it->first));
+      dense.keys_vals.push_back(string_id(*it->second));
+    }
+  }
+  dense.keys_vals.push_back(0);
+
+  if (with_meta)
+    add_dense_info(*meta, users);
+
+  element_added();
+}
+
+
+void Output_PBF::print_item(const Way_Skeleton& skel,
+      const Opaque_Geometry& geometry,
+      const Interned_Tags* tags,
+      const OSM_Element_Metadata_Skeleton< Way::Id_Type >* meta,
+      const std::map< uint32, std::string >* users,
+      Output_Mode mode,
+      const Feature_Action& action,
+      const Way_Skeleton* new_skel,
+      const Opaque_Geometry* new_geometry,
+      const Interned_Tags* new_tags,
+      const OSM_Element_Metadata_Skeleton< Way::Id_Type >* new_meta)
+{
+  bool with_meta = (mode.mode & (Output_Mode::VERSION | Output_Mode::META)) && meta && users;
+  start_group(WAYS, with_meta);
+
+  std::vector< uint32 > keys;
+  std::vector< uint32 > vals;
+  if (tags)
+  {
+    for (Interned_Tags::const_iterator it = tags->begin();
+        it != tags->end(); ++it)
+    {
+      keys.push_back(string_id(*it->first));
+      vals.push_back(string_id(*it->second));
+    }
+  }
+
+  std::vector< int64 > refs;
+  std::vector< int64 > lats;
+  std::vector< int64 > lons;
+  if (mode & Output_Mode::NDS)
+  {
+    int64 last_ref = 0;
+    int64 last_lat = 0;
+    int64 last_lon = 0;
+    for (uint i = 0; i < skel.nds().size(); ++i)
+    {
+      int64 ref = skel.nds()[i].val();
+      refs.push_back(ref - last_ref);
+      last_ref = ref;
+
+      if (locations_on_ways)
+      {
+        int64 lat = UNDEFINED_COORDINATE;
+        int64 lon = UNDEFINED_COORDINATE;
+        if (geometry.has_faithful_way_geometry() && geometry.way_pos_is_valid(i))
+        {
+          lat = fixed_coord(geometry.way_pos_lat(i));
+          lon = fixed_coord(geometry.way_pos_lon(i));
+        }
+        lats.push_back(lat - last_lat);
+        lons.push_back(lon - last_lon);
+        last_lat = lat;
+        last_lon = lon;
+      }
+    }
+  }
+
+  {
+    protozero::pbf_writer pbf_group(group);
+    protozero::pbf_writer pbf_way(pbf_group, 3);
+    pbf_way.add_int64(1, skel.id.val());
+    pbf_way.add_packed_uint32(2, keys.begin(), keys.end());
+    pbf_way.add_packed_uint32(3, vals.begin(), vals.end());
+    if (with_meta)
+      pbf_way.add_message(4, info(*meta, users));
+    pbf_way.add_packed_sint64(8, refs.begin(), refs.end());
+    pbf_way.add_packed_sint64(9, lats.begin(), lats.end());
+    pbf_way.add_packed_sint64(10, lons.begin(), lons.end());
+  }
+
+  element_added();
+}
+
+
+void Output_PBF::print_item(const Relation_Skeleton& skel,
+      const Opaque_Geometry& geometry,
+      const Interned_Tags* tags,
+      const OSM_Element_Metadata_Skeleton< Relation::Id_Type >* meta,
+      const std::map< uint32, std::string >* roles,
+      const std::map< uint32, std::string >* users,
+      Output_Mode mode,
+      const Feature_Action& action,
+      const Relation_Skeleton* new_skel,
+      const Opaque_Geometry* new_geometry,
+      const Interned_Tags* new_tags,
+      const OSM_Element_Metadata_Skeleton< Relation::Id_Type >* new_meta)
+{
+  bool with_meta = (mode.mode & (Output_Mode::VERSION | Output_Mode::META)) && meta && users;
+  start_group(RELATIONS, with_meta);
+
+  std::vector< uint32 > keys;
+  std::vector< uint32 > vals;
+  if (tags)
+  {
+    for (Interned_Tags::const_iterator it = tags->begin();
+        it != tags->end(); ++it)
+    {
+      keys.push_back(string_id(*it->first));
+      vals.push_back(string_id(*it->second));
+    }
+  }
+
+  std::vector< int32 > roles_sid;
+  std::vector< int64 > memids;
+  std::vector< int32 > types;
+  if (((tags != 0 && !tags->empty()) ||
+      (mode & (Output_Mode::NDS | Output_Mode::GEOMETRY | Output_Mode::BOUNDS | Output_Mode::CENTER)))
+      && (mode & Output_Mode::MEMBERS))
+  {
+    static const std::string unknown_role = "???";
+
+    int64 last_ref = 0;
+    for (uint i = 0; i < skel.members().size(); ++i)
+    {
+      // MemberType in the PBF schema is NODE = 0, WAY = 1, RELATION = 2
+      uint32 type = skel.members()[i].type;
+      if (type < 1 || type > 3)
+        continue;
+
+      std::map< uint32, std::string >::const_iterator it;
+      bool role_known = roles && (it = roles->find(skel.members()[i].role)) != roles->end();
+
+      int64 ref = skel.members()[i].ref.val();
+      roles_sid.push_back(string_id(role_known ? it->second : unknown_role));
+      memids.push_back(ref - last_ref);
+      types.push_back(type - 1);
+      last_ref = ref;
+    }
+  }
+
+  {
+    protozero::pbf_writer pbf_group(group);
+    protozero::pbf_writer pbf_relation(pbf_group, 4);
+    pbf_relation.add_int64(1, skel.id.val());
+    pbf_relation.add_packed_uint32(2, keys.begin(), keys.end());
+    pbf_relation.add_packed_uint32(3, vals.begin(), vals.end());
+    if (with_meta)
+      pbf_relation.add_message(4, info(*meta, users));
+    pbf_relation.add_packed_int32(8, roles_sid.begin(), roles_sid.end());
+    pbf_relation.add_packed_sint64(9, memids.begin(), memids.end());
+    pbf_relation.add_packed_int32(10, types.begin(), types.end());
+  }
+
+  element_added();
+}
+
+
+void Output_PBF::print_item(const Derived_Skeleton& skel,
+      const Opaque_Geometry& geometry,
+      const Interned_Tags* tags,
+      Output_Mode mode,
+      const Feature_Action& action)
+{
+  // Intentionally empty
+}
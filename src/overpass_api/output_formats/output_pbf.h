@@ -0,0 +1,170 @@
+/** Copyright 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018 Roland Olbricht et al.
+ *
+ * This file is part of Overpass_API.
+ *
+ * Overpass_API is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Overpass_API is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Overpass_API.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef DE__OSM3S___OVERPASS_API__OUTPUT_FORMATS__OUTPUT_PBF_H
+#define DE__OSM3S___OVERPASS_API__OUTPUT_FORMATS__OUTPUT_PBF_H
+
+
+#include "../core/datatypes.h"
+#include "../core/geometry.h"
+#include "../frontend/output_handler.h"
+#include "../../template_db/types.h"
+
+#include <deque>
+#include <future>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+/* Writes OSM PBF directly with protozero.
+ *
+ * The elements are collected into PrimitiveBlocks of at most 8000 elements as they arrive.
+ * Each full block is compressed by a worker thread while the next block is filled,
+ * and the finished blobs are written to std::cout in the order of the blocks. */
+class Output_PBF : public Output_Handler
+{
+public:
+  Output_PBF(bool locations_on_ways_) :
+      locations_on_ways(locations_on_ways_), strings(1, ""), string_bytes(0),
+      group_type(NO_GROUP), group_with_meta(false),
+      group_size(0), block_size(0), max_pending_blobs(1) {}
+
+  virtual bool write_http_headers();
+  virtual void write_payload_header(const std::string& db_dir,
+                                    const std::string& timestamp, const std::string& area_timestamp);
+  virtual void write_footer();
+  virtual void display_remark(const std::string& text);
+  virtual void display_error(const std::string& text);
+
+  virtual void print_global_bbox(const Bbox_Double& bbox);
+
+  virtual void print_item(const Node_Skeleton& skel,
+      const Opaque_Geometry& geometry,
+      const Interned_Tags* tags,
+      const OSM_Element_Metadata_Skeleton< Node::Id_Type >* meta,
+      const std::map< uint32, std::string >* users,
+      Output_Mode mode,
+      const Feature_Action& action = keep,
+      const Node_Skeleton* new_skel = 0,
+      const Opaque_Geometry* new_geometry = 0,
+      const Interned_Tags* new_tags = 0,
+      const OSM_Element_Metadata_Skeleton< Node::Id_Type >* new_meta = 0);
+
+  virtual void print_item(const Way_Skeleton& skel,
+      const Opaque_Geometry& geometry,
+      const Interned_Tags* tags,
+      const OSM_Element_Metadata_Skeleton< Way::Id_Type >* meta,
+      const std::map< uint32, std::string >* users,
+      Output_Mode mode,
+      const Feature_Action& action = keep,
+      const Way_Skeleton* new_skel = 0,
+      const Opaque_Geometry* new_geometry = 0,
+      const Interned_Tags* new_tags = 0,
+      const OSM_Element_Metadata_Skeleton< Way::Id_Type >* new_meta = 0);
+
+  virtual void print_item(const Relation_Skeleton& skel,
+      const Opaque_Geometry& geometry,
+      const Interned_Tags* tags,
+      const OSM_Element_Metadata_Skeleton< Relation::Id_Type >* meta,
+      const std::map< uint32, std::string >* roles,
+      const std::map< uint32, std::string >* users,
+      Output_Mode mode,
+      const Feature_Action& action = keep,
+      const Relation_Skeleton* new_skel = 0,
+      const Opaque_Geometry* new_geometry = 0,
+      const Interned_Tags* new_tags = 0,
+      const OSM_Element_Metadata_Skeleton< Relation::Id_Type >* new_meta = 0);
+
+  virtual void print_item(const Derived_Skeleton& skel,
+      const Opaque_Geometry& geometry,
+      const Interned_Tags* tags,
+      Output_Mode mode,
+      const Feature_Action& action = keep);
+
+  virtual std::string dump_config() const { return locations_on_ways ? "(geom)" : ""; }
+
+  // Upper limits for the elements and the uncompressed size of a PrimitiveBlock
+  const static uint32 MAX_BLOCK_ELEMENTS = 8000;
+  const static uint32 MAX_BLOCK_BYTES = 8*1024*1024;
+
+private:
+  enum Group_Type { NO_GROUP, DENSE_NODES, WAYS, RELATIONS };
+
+  // The columns of a DenseNodes group, already delta coded
+  struct Dense_Nodes
+  {
+    Dense_Nodes() { clear(); }
+    void clear();
+
+    std::vector< int64 > ids;
+    std::vector< int64 > lats;
+    std::vector< int64 > lons;
+    std::vector< int32 > keys_vals;
+    std::vector< int32 > versions;
+    std::vector< int64 > timestamps;
+    std::vector< int64 > changesets;
+    std::vector< int32 > uids;
+    std::vector< int32 > user_sids;
+
+    int64 last_id;
+    int64 last_lat;
+    int64 last_lon;
+    int64 last_timestamp;
+    int64 last_changeset;
+    int32 last_uid;
+    int32 last_user_sid;
+  };
+
+  uint32 string_id(const std::string& s);
+  const std::string& user_name(uint32 user_id, const std::map< uint32, std::string >* users);
+  template< typename Id_Type >
+  std::string info(const OSM_Element_Metadata_Skeleton< Id_Type >& meta,
+      const std::map< uint32, std::string >* users);
+  template< typename Id_Type >
+  void add_dense_info(const OSM_Element_Metadata_Skeleton< Id_Type >& meta,
+      const std::map< uint32, std::string >* users);
+
+  void start_group(Group_Type type, bool with_meta);
+  void element_added();
+  void finish_group();
+  void finish_block();
+  void push_blob(const char* type, std::string&& data);
+  void write_blobs(uint32 max_pending);
+
+  bool locations_on_ways;
+
+  std::vector< std::string > strings;
+  std::unordered_map< std::string, uint32 > string_ids;
+  uint64 string_bytes;
+
+  Group_Type group_type;
+  bool group_with_meta;
+  uint32 group_size;
+  uint32 block_size;
+  std::string group;
+  std::string groups;
+  Dense_Nodes dense;
+
+  uint32 max_pending_blobs;
+  std::deque< std::future< std::string > > pending_blobs;
+};
+
+
+#endif
@@ -35,7 +35,7 @@ public:
   Tag_Filter(const std::string& key_, const std::string& value_, bool straight_)
       : key(key_), straight(straight_), condition(value_, true) {}
 
-  bool matches(const std::vector< std::pair< std::string, std::string > >* tags) const;
+  bool matches(const Interned_Tags* tags) const;
 
 private:
   std::string key;
@@ -62,9 +62,9 @@ struct Category_Filter
   void set_title_key(const std::string& title_key);
   void add_filter(const std::vector< Tag_Filter* >& conjunction) { filter_disjunction.push_back(conjunction); }
 
-  bool consider(const Node_Skeleton& skel, const std::vector< std::pair< std::string, std::string > >* tags);
-  bool consider(const Way_Skeleton& skel, const std::vector< std::pair< std::string, std::string > >* tags);
-  bool consider(const Relation_Skeleton& skel, const std::vector< std::pair< std::string, std::string > >* tags);
+  bool consider(const Node_Skeleton& skel, const Interned_Tags* tags);
+  bool consider(const Way_Skeleton& skel, const Interned_Tags* tags);
+  bool consider(const Relation_Skeleton& skel, const Interned_Tags* tags);
 
   std::string result() const { return output; }
 
@@ -100,31 +100,31 @@ public:
 
   virtual void print_item(const Node_Skeleton& skel,
       const Opaque_Geometry& geometry,
-      const std::vector< std::pair< std::string, std::string > >* tags,
+      const Interned_Tags* tags,
       const OSM_Element_Metadata_Skeleton< Node::Id_Type >* meta,
       const std::map< uint32, std::string >* users,
       Output_Mode mode,
       const Feature_Action& action = keep,
       const Node_Skeleton* new_skel = 0,
       const Opaque_Geometry* new_geometry = 0,
-      const std::vector< std::pair< std::string, std::string > >* new_tags = 0,
+      const Interned_Tags* new_tags = 0,
       const OSM_Element_Metadata_Skeleton< Node::Id_Type >* new_meta = 0);
 
   virtual void print_item(const Way_Skeleton& skel,
       const Opaque_Geometry& geometry,
-      const std::vector< std::pair< std::string, std::string > >* tags,
+      const Interned_Tags* tags,
       const OSM_Element_Metadata_Skeleton< Way::Id_Type >* meta,
       const std::map< uint32, std::string >* users,
       Output_Mode mode,
       const Feature_Action& action = keep,
       const Way_Skeleton* new_skel = 0,
       const Opaque_Geometry* new_geometry = 0,
-      const std::vector< std::pair< std::string, std::string > >* new_tags = 0,
+      const Interned_Tags* new_tags = 0,
       const OSM_Element_Metadata_Skeleton< Way::Id_Type >* new_meta = 0);
 
   virtual void print_item(const Relation_Skeleton& skel,
       const Opaque_Geometry& geometry,
-      const std::vector< std::pair< std::string, std::string > >* tags,
+      const Interned_Tags* tags,
       const OSM_Element_Metadata_Skeleton< Relation::Id_Type >* meta,
       const std::map< uint32, std::string >* roles,
       const std::map< uint32, std::string >* users,
@@ -132,12 +132,12 @@ public:
       const Feature_Action& action = keep,
       const Relation_Skeleton* new_skel = 0,
       const Opaque_Geometry* new_geometry = 0,
-      const std::vector< std::pair< std::string, std::string > >* new_tags = 0,
+      const Interned_Tags* new_tags = 0,
       const OSM_Element_Metadata_Skeleton< Relation::Id_Type >* new_meta = 0);
 
   virtual void print_item(const Derived_Skeleton& skel,
       const Opaque_Geometry& geometry,
-      const std::vector< std::pair< std::string, std::string > >* tags,
+      const Interned_Tags* tags,
       Output_Mode mode,
       const Feature_Action& action = keep);
 
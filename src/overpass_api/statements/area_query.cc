@@ -48,6 +48,7 @@ class Area_Constraint final : public Query_Constraint
         (Resource_Manager& rman, std::set< std::pair< Uint31_Index, Uint31_Index > >& ranges);
     void filter(Resource_Manager& rman, Set& into);
     void filter(const Statement& query, Resource_Manager& rman, Set& into);
+    uint64 estimate_filter_effort(Resource_Manager& rman);
     virtual ~Area_Constraint() {}
   private:
     virtual std::ostream& print_constraint( std::ostream &os ) const {
@@ -101,6 +102,24 @@ bool Area_Constraint::get_ranges
 }
 
 
+uint64 Area_Constraint::estimate_filter_effort(Resource_Manager& rman)
+{
+  if (!rman.get_area_transaction())
+    return 0;
+
+  // Query_Statement::execute has asked for the ranges before it orders the filters,
+  // hence area_blocks_req already holds the blocks of this execution.
+  // The expensive filter reads all area blocks of the covered indices.
+  std::set< std::pair< Uint31_Index, Uint31_Index > > block_ranges;
+  for (std::set< Uint31_Index >::const_iterator it = area_blocks_req.begin(); it != area_blocks_req.end(); ++it)
+    block_ranges.insert(std::make_pair(*it, Uint31_Index(it->val() + 1)));
+
+  return estimate_read_volume(*(File_Blocks_Index< Uint31_Index >*)
+      rman.get_area_transaction()->data_index(area_settings().AREA_BLOCKS),
+      block_ranges.begin(), block_ranges.end());
+}
+
+
 void Area_Constraint::filter(Resource_Manager& rman, Set& into)
 {
   std::set< std::pair< Uint31_Index, Uint31_Index > > ranges;
@@ -141,9 +160,11 @@ void Area_Constraint::filter(const Statement& query, Resource_Manager& rman, Set
 
   //Process relations
 
-  // Retrieve all nodes referred by the relations.
   std::set< std::pair< Uint32_Index, Uint32_Index > > node_ranges;
-  get_ranges(rman, node_ranges);
+  copy_discrete_to_area_ranges(area_blocks_req, node_ranges);
+  std::set< std::pair< Uint31_Index, Uint31_Index > > way_ranges = calc_parents(node_ranges);
+
+  // Retrieve all nodes referred by the relations.
   std::map< Uint32_Index, std::vector< Node_Skeleton > > node_members
       = relation_node_members(&query, rman, into.relations, &node_ranges);
 
@@ -151,8 +172,6 @@ void Area_Constraint::filter(const Statement& query, Resource_Manager& rman, Set
   area->collect_nodes(node_members, area_blocks_req, false, rman);
 
   // Retrieve all ways referred by the relations.
-  std::set< std::pair< Uint31_Index, Uint31_Index > > way_ranges;
-  get_ranges(rman, way_ranges);
   std::map< Uint31_Index, std::vector< Way_Skeleton > > way_members_
       = relation_way_members(&query, rman, into.relations, &way_ranges);
 
@@ -177,8 +196,6 @@ void Area_Constraint::filter(const Statement& query, Resource_Manager& rman, Set
   if (!into.attic_relations.empty())
   {
     // Retrieve all nodes referred by the relations.
-    std::set< std::pair< Uint32_Index, Uint32_Index > > node_ranges;
-    get_ranges(rman, node_ranges);
     std::map< Uint32_Index, std::vector< Attic< Node_Skeleton > > > node_members
         = relation_node_members(&query, rman, into.attic_relations, &node_ranges);
 
@@ -186,8 +203,6 @@ void Area_Constraint::filter(const Statement& query, Resource_Manager& rman, Set
     area->collect_nodes(node_members, area_blocks_req, false, rman);
 
     // Retrieve all ways referred by the relations.
-    std::set< std::pair< Uint31_Index, Uint31_Index > > way_ranges;
-    get_ranges(rman, way_ranges);
     std::map< Uint31_Index, std::vector< Attic< Way_Skeleton > > > way_members_
         = relation_way_members(&query, rman, into.attic_relations, &way_ranges);
 
@@ -367,6 +382,29 @@ Query_Filter_Strategy Area_Constraint::delivers_data(Resource_Manager& rman)
   }
 }
 
+namespace
+{
+  // Coordinates of an area block as range in an arena of ilat/ilon pairs
+  struct Area_Block_Range
+  {
+    Area_Block_Range(Area_Skeleton::Id_Type id_, uint32 begin_, uint32 end_) : id(id_), begin(begin_), end(end_) {}
+
+    Area_Skeleton::Id_Type id;
+    uint32 begin;
+    uint32 end;
+
+    bool operator<(const Area_Block_Range& rhs) const
+    {
+      if (id < rhs.id)
+        return true;
+      if (rhs.id < id)
+        return false;
+      return begin < rhs.begin;
+    }
+  };
+}
+
+
 template< typename Node_Skeleton >
 void Area_Query_Statement::collect_nodes
     (std::map< Uint32_Index, std::vector< Node_Skeleton > >& nodes,
@@ -384,6 +422,12 @@ void Area_Query_Statement::collect_nodes
 
   typename std::map< Uint32_Index, std::vector< Node_Skeleton > >::iterator nodes_it = nodes.begin();
 
+  // The blocks of the current index are decoded from the raw data into one arena.
+  // Both containers keep their capacity from index to index.
+  std::vector< std::pair< uint32, int32 > > ilat_ilon_pairs;
+  std::vector< Area_Block_Range > area_blocks;
+  Area_Block_Batch_Check batch_check;
+
   uint32 loop_count = 0;
   uint32 current_idx(0);
   while (!(area_it == area_blocks_db.discrete_end()))
@@ -395,14 +439,23 @@ void Area_Query_Statement::collect_nodes
       loop_count = 0;
     }
 
-    std::map< Area_Skeleton::Id_Type, std::vector< Area_Block > > areas;
+    ilat_ilon_pairs.clear();
+    area_blocks.clear();
     while ((!(area_it == area_blocks_db.discrete_end())) &&
         (area_it.index().val() == current_idx))
     {
-      if (binary_search(area_id.begin(), area_id.end(), area_it.handle().id()))
-	areas[area_it.object().id].push_back(area_it.object());
+      Area_Skeleton::Id_Type id = area_it.handle().id();
+      if (binary_search(area_id.begin(), area_id.end(), id))
+      {
+        uint32 begin = ilat_ilon_pairs.size();
+        area_it.handle().append_ilat_ilon_pairs(ilat_ilon_pairs);
+        if (begin < ilat_ilon_pairs.size())
+          area_blocks.push_back(Area_Block_Range(id, begin, ilat_ilon_pairs.size()));
+      }
       ++area_it;
     }
+    // Group the blocks by area. Blocks of the same area keep their order.
+    std::sort(area_blocks.begin(), area_blocks.end());
 
     while (nodes_it != nodes.end() && nodes_it->first.val() < current_idx)
     {
@@ -412,7 +465,7 @@ void Area_Query_Statement::collect_nodes
     while (nodes_it != nodes.end() &&
         (nodes_it->first.val() & 0xffffff00) == current_idx)
     {
-      std::vector< Node_Skeleton > into;
+      batch_check.clear_coords();
       for (typename std::vector< Node_Skeleton >::const_iterator iit = nodes_it->second.begin();
           iit != nodes_it->second.end(); ++iit)
       {
@@ -420,30 +473,32 @@ void Area_Query_Statement::collect_nodes
             + 91.0)*10000000+0.5);
         int32 ilon(::lon(nodes_it->first.val(), iit->ll_lower)*10000000
             + (::lon(nodes_it->first.val(), iit->ll_lower) > 0 ? 0.5 : -0.5));
-        for (std::map< Area_Skeleton::Id_Type, std::vector< Area_Block > >::const_iterator it = areas.begin();
-	     it != areas.end(); ++it)
-        {
-          int inside = 0;
-          for (std::vector< Area_Block >::const_iterator it2 = it->second.begin(); it2 != it->second.end();
-	       ++it2)
-          {
-            ++loop_count;
+        batch_check.add_coord(ilat, ilon);
+      }
 
-	    int check(Coord_Query_Statement::check_area_block(current_idx, *it2, ilat, ilon));
-	    if (check == Coord_Query_Statement::HIT && add_border)
-	    {
-	      inside = 1;
-	      break;
-	    }
-	    else if (check != 0)
-	      inside ^= check;
-          }
-          if (inside)
-	  {
-	    into.push_back(*iit);
-	    break;
-	  }
+      std::vector< Area_Block_Range >::size_type block_it = 0;
+      while (block_it < area_blocks.size() && !batch_check.all_found())
+      {
+        std::vector< Area_Block_Range >::size_type area_end = block_it + 1;
+        while (area_end < area_blocks.size() && area_blocks[area_end].id == area_blocks[block_it].id)
+          ++area_end;
+
+        batch_check.start_area();
+        for (; block_it < area_end; ++block_it)
+        {
+          loop_count += batch_check.coord_count();
+          batch_check.add_block(current_idx,
+              ilat_ilon_pairs.data() + area_blocks[block_it].begin,
+              ilat_ilon_pairs.data() + area_blocks[block_it].end, add_border);
         }
+        batch_check.finish_area();
+      }
+
+      std::vector< Node_Skeleton > into;
+      for (uint32 i = 0; i < nodes_it->second.size(); ++i)
+      {
+        if (batch_check.found(i))
+          into.push_back(nodes_it->second[i]);
       }
       nodes_it->second.swap(into);
       ++nodes_it;
@@ -294,7 +294,7 @@ Prepared_BBox::Prepared_BBox()
   max_lon = -200.0;
 }
 
-inline void Prepared_BBox::merge(Prepared_BBox & bbox)
+inline void Prepared_BBox::merge(const Prepared_BBox & bbox)
 {
   min_lat = std::min(min_lat, bbox.min_lat);
   max_lat = std::max(max_lat, bbox.max_lat);
@@ -325,6 +325,61 @@ inline bool Prepared_BBox::intersects(const std::vector < Prepared_BBox > & bbox
  return false;
 }
 
+const double Prepared_BBox_Index::MAX_INDEXED_EXTENT = 5.0;
+
+
+void Prepared_BBox_Index::clear()
+{
+  levels.clear();
+  packed_entries.clear();
+  unindexed_entries.clear();
+}
+
+
+void Prepared_BBox_Index::build(const std::vector< Prepared_BBox >& bboxes)
+{
+  clear();
+
+  std::vector< uint32 > entries;
+  for (uint32 i = 0; i < bboxes.size(); ++i)
+  {
+    if (bboxes[i].min_lat <= bboxes[i].max_lat && bboxes[i].min_lon <= bboxes[i].max_lon
+        && bboxes[i].max_lat - bboxes[i].min_lat <= MAX_INDEXED_EXTENT
+        && bboxes[i].max_lon - bboxes[i].min_lon <= MAX_INDEXED_EXTENT)
+      entries.push_back(i);
+    else
+      unindexed_entries.push_back(i);
+  }
+  if (entries.empty())
+    return;
+
+  // Sort-tile-recursive: cut the entries into vertical slices by longitude,
+  // then order each slice by latitude such that consecutive entries are close
+  std::sort(entries.begin(), entries.end(), [&bboxes](uint32 lhs, uint32 rhs)
+      { return bboxes[lhs].min_lon + bboxes[lhs].max_lon < bboxes[rhs].min_lon + bboxes[rhs].max_lon; });
+  uint32 leaf_count = (entries.size() + FANOUT - 1) / FANOUT;
+  uint32 slice_size = FANOUT * (uint32)ceil(sqrt((double)leaf_count));
+  for (uint32 i = 0; i < entries.size(); i += slice_size)
+    std::sort(entries.begin() + i, entries.begin() + std::min(i + slice_size, (uint32)entries.size()),
+        [&bboxes](uint32 lhs, uint32 rhs)
+        { return bboxes[lhs].min_lat + bboxes[lhs].max_lat < bboxes[rhs].min_lat + bboxes[rhs].max_lat; });
+
+  packed_entries = entries;
+  levels.push_back(std::vector< Prepared_BBox >());
+  levels.back().reserve(entries.size());
+  for (std::vector< uint32 >::const_iterator it = entries.begin(); it != entries.end(); ++it)
+    levels.back().push_back(bboxes[*it]);
+
+  while (levels.back().size() > FANOUT)
+  {
+    std::vector< Prepared_BBox > upper((levels.back().size() + FANOUT - 1) / FANOUT);
+    for (uint32 i = 0; i < levels.back().size(); ++i)
+      upper[i / FANOUT].merge(levels.back()[i]);
+    levels.push_back(upper);
+  }
+}
+
+
 std::ostream& operator << (std::ostream &o, const Prepared_BBox &b)
 {
   o << std::fixed << std::setprecision(7)
@@ -419,6 +474,25 @@ inline Prepared_BBox calc_distance_bbox(double lat, double lon, double dist)
   return bbox;
 }
 
+// Bounding box of all points that are accepted as close to the segment with distance dist.
+// Returns an invalid bounding box for very long segments and segments at the date line.
+inline Prepared_BBox segment_distance_bbox(const Prepared_Segment& segment, double dist)
+{
+  double length = great_circle_dist(segment.first_lat, segment.first_lon, segment.second_lat, segment.second_lon);
+  if (length + dist > 1000.0 * 1000.0)
+    return Prepared_BBox();
+
+  // An accepted point is at most 1.5 * dist + length/2 away from the nearer endpoint.
+  double pad = 1.5 * dist + 0.5 * length + 1.0;
+  Prepared_BBox bbox = calc_distance_bbox(segment.first_lat, segment.first_lon, pad);
+  Prepared_BBox second_bbox = calc_distance_bbox(segment.second_lat, segment.second_lon, pad);
+  if (bbox.max_lon < bbox.min_lon || second_bbox.max_lon < second_bbox.min_lon)
+    return Prepared_BBox();
+
+  bbox.merge(second_bbox);
+  return bbox;
+}
+
 }
 
 //-----------------------------------------------------------------------------
@@ -1233,11 +1307,13 @@ void Around_Statement::calc_lat_lons(const Set& input, Statement& query, Resourc
   {
     add_coord(points[0].lat, points[0].lon, radius, radius_lat_lons, simple_lat_lons);
     node_bboxes.push_back(::calc_distance_bbox(points[0].lat, points[0].lon, radius));
+    build_spatial_indexes();
     return;
   }
   else if (points.size() > 1)
   {
     add_way(points, radius, radius_lat_lons, simple_lat_lons, simple_segments, way_bboxes);
+    build_spatial_indexes();
     return;
   }
 
@@ -1265,8 +1341,28 @@ void Around_Statement::calc_lat_lons(const Set& input, Statement& query, Resourc
         = relation_way_members(&query, rman, input.attic_relations);
     add_ways(way_members, Way_Geometry_Store(way_members, query, rman));
   }
+
+  build_spatial_indexes();
+}
+
+
+void Around_Statement::build_spatial_indexes()
+{
+  std::vector< Prepared_BBox > bboxes;
+  bboxes.reserve(std::max(simple_lat_lons.size(), simple_segments.size()));
+  for (std::vector< std::pair< Prepared_BBox, Prepared_Point> >::const_iterator
+      it = simple_lat_lons.begin(); it != simple_lat_lons.end(); ++it)
+    bboxes.push_back(it->first);
+  point_index.build(bboxes);
+
+  bboxes.clear();
+  for (std::vector< std::pair< Prepared_BBox, Prepared_Segment> >::const_iterator
+      it = simple_segments.begin(); it != simple_segments.end(); ++it)
+    bboxes.push_back(::segment_distance_bbox(it->second, radius));
+  segment_index.build(bboxes);
 }
 
+
 bool Around_Statement::matches_bboxes(double lat, double lon) const
 {
   Prepared_BBox bbox = ::lat_lon_bbox(lat, lon);
@@ -1300,23 +1396,21 @@ bool Around_Statement::is_inside(double lat, double lon) const
   std::tuple< double, double, double > coord_cartesian = cartesian(lat, lon);
   Prepared_BBox bbox_lat_lon = ::lat_lon_bbox(lat, lon);
 
-  for (std::vector< std::pair< Prepared_BBox, Prepared_Segment> >::const_iterator
-
-      it = simple_segments.begin(); it != simple_segments.end(); ++it)
+  return segment_index.any_of(bbox_lat_lon, [&](uint32 i)
   {
-    if (bbox_lat_lon.intersects(it->first) &&
-        great_circle_line_dist(it->second, coord_cartesian) <= radius)
+    const std::pair< Prepared_BBox, Prepared_Segment >& it = simple_segments[i];
+    if (bbox_lat_lon.intersects(it.first) &&
+        great_circle_line_dist(it.second, coord_cartesian) <= radius)
     {
       double gcdist = great_circle_dist
-          (it->second.first_lat, it->second.first_lon, it->second.second_lat, it->second.second_lon);
+          (it.second.first_lat, it.second.first_lon, it.second.second_lat, it.second.second_lon);
       double limit = sqrt(gcdist*gcdist + radius*radius);
-      if (great_circle_dist(lat, lon, it->second.first_lat, it->second.first_lon) <= limit &&
-          great_circle_dist(lat, lon, it->second.second_lat, it->second.second_lon) <= limit)
-	return true;
+      if (great_circle_dist(lat, lon, it.second.first_lat, it.second.first_lon) <= limit &&
+          great_circle_dist(lat, lon, it.second.second_lat, it.second.second_lon) <= limit)
+        return true;
     }
-  }
-
-  return false;
+    return false;
+  });
 }
 
 bool Around_Statement::is_inside
@@ -1325,30 +1419,28 @@ bool Around_Statement::is_inside
   Prepared_Segment segment(first_lat, first_lon, second_lat, second_lon);
   Prepared_BBox bbox_segment = ::lat_lon_bbox(first_lat, first_lon, second_lat, second_lon);
   
-  for (std::vector< std::pair< Prepared_BBox, Prepared_Point> >::const_iterator cit = simple_lat_lons.begin();
-
-      cit != simple_lat_lons.end(); ++cit)
-  {
-    if (bbox_segment.intersects(cit->first) &&
-        great_circle_line_dist(segment, cit->second.cartesian) <= radius)
-    {
-      double gcdist = great_circle_dist(first_lat, first_lon, second_lat, second_lon);
-      double limit = sqrt(gcdist*gcdist + radius*radius);
-      if (great_circle_dist(cit->second.lat, cit->second.lon, first_lat, first_lon) <= limit &&
-	  great_circle_dist(cit->second.lat, cit->second.lon, second_lat, second_lon) <= limit)
-        return true;
-    }
-  }
-
-  for (std::vector< std::pair< Prepared_BBox, Prepared_Segment> >::const_iterator
-      cit = simple_segments.begin(); cit != simple_segments.end(); ++cit)
-  {
-    if (bbox_segment.intersects(cit->first) &&
-        intersect(cit->second, segment))
-      return true;
-  }
+  if (point_index.any_of(bbox_segment, [&](uint32 i)
+      {
+        const std::pair< Prepared_BBox, Prepared_Point >& cit = simple_lat_lons[i];
+        if (bbox_segment.intersects(cit.first) &&
+            great_circle_line_dist(segment, cit.second.cartesian) <= radius)
+        {
+          double gcdist = great_circle_dist(first_lat, first_lon, second_lat, second_lon);
+          double limit = sqrt(gcdist*gcdist + radius*radius);
+          if (great_circle_dist(cit.second.lat, cit.second.lon, first_lat, first_lon) <= limit &&
+              great_circle_dist(cit.second.lat, cit.second.lon, second_lat, second_lon) <= limit)
+            return true;
+        }
+        return false;
+      }))
+    return true;
 
-  return false;
+  // Crossing points lie on both segments, hence also in the bounding box of the bent segment
+  return segment_index.any_of(::segment_distance_bbox(segment, 0), [&](uint32 i)
+      {
+        const std::pair< Prepared_BBox, Prepared_Segment >& cit = simple_segments[i];
+        return bbox_segment.intersects(cit.first) && intersect(cit.second, segment);
+      });
 }
 
 
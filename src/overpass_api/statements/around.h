@@ -19,6 +19,7 @@
 #ifndef DE__OSM3S___OVERPASS_API__STATEMENTS__AROUND_H
 #define DE__OSM3S___OVERPASS_API__STATEMENTS__AROUND_H
 
+#include <algorithm>
 #include <iostream>
 #include <map>
 #include <set>
@@ -39,7 +40,7 @@ struct Prepared_BBox
   double max_lon;
 
   Prepared_BBox();
-  void merge(Prepared_BBox&);
+  void merge(const Prepared_BBox&);
   bool intersects(const Prepared_BBox &) const;
   bool intersects(const std::vector < Prepared_BBox > &) const;
 };
@@ -68,6 +69,73 @@ struct Prepared_Point
 };
 
 
+/* Static R-tree over the bounding boxes of the prepared points or segments.
+ * It is packed once by sort-tile-recursive after all geometry has been added.
+ * Entries with a bounding box that wraps around the date line or that spans more than
+ * MAX_INDEXED_EXTENT degrees are kept out of the tree and are always candidates:
+ * a few huge boxes would otherwise inflate the boxes of all nodes above them. */
+class Prepared_BBox_Index
+{
+public:
+  void build(const std::vector< Prepared_BBox >& bboxes);
+  void clear();
+
+  // Returns true if pred(i) is true for any entry i whose bounding box intersects bbox
+  template< typename Predicate >
+  bool any_of(const Prepared_BBox& bbox, Predicate pred) const;
+
+private:
+  static const uint32 FANOUT = 16;
+  static const uint32 MAX_LEVELS = 8;
+  static const double MAX_INDEXED_EXTENT;
+
+  // levels[0] has the bounding boxes of the entries in packed order,
+  // every further level the merged bounding boxes of FANOUT nodes of the level below
+  std::vector< std::vector< Prepared_BBox > > levels;
+  std::vector< uint32 > packed_entries;
+  std::vector< uint32 > unindexed_entries;
+};
+
+
+template< typename Predicate >
+bool Prepared_BBox_Index::any_of(const Prepared_BBox& bbox, Predicate pred) const
+{
+  for (std::vector< uint32 >::const_iterator it = unindexed_entries.begin(); it != unindexed_entries.end(); ++it)
+  {
+    if (pred(*it))
+      return true;
+  }
+  if (levels.empty())
+    return false;
+
+  // Depth first search. A node pushes at most FANOUT children, hence the stack is bounded.
+  std::pair< uint32, uint32 > stack[FANOUT * MAX_LEVELS];
+  uint32 stack_size = 0;
+  for (uint32 i = 0; i < levels.back().size(); ++i)
+    stack[stack_size++] = std::make_pair(levels.size() - 1, i);
+
+  while (stack_size > 0)
+  {
+    std::pair< uint32, uint32 > node = stack[--stack_size];
+    if (!bbox.intersects(levels[node.first][node.second]))
+      continue;
+
+    if (node.first == 0)
+    {
+      if (pred(packed_entries[node.second]))
+        return true;
+    }
+    else
+    {
+      uint32 end = std::min((node.second + 1) * FANOUT, (uint32)levels[node.first - 1].size());
+      for (uint32 i = node.second * FANOUT; i < end; ++i)
+        stack[stack_size++] = std::make_pair(node.first - 1, i);
+    }
+  }
+  return false;
+}
+
+
 class Around_Statement final : public Output_Statement
 {
   public:
@@ -159,10 +227,14 @@ class Around_Statement final : public Output_Statement
     std::map< Uint32_Index, std::vector< Point_Double > > radius_lat_lons;
     std::vector< std::pair< Prepared_BBox, Prepared_Point> > simple_lat_lons;
     std::vector< std::pair< Prepared_BBox, Prepared_Segment> > simple_segments;
+    Prepared_BBox_Index point_index;
+    Prepared_BBox_Index segment_index;
 
     std::vector< Query_Constraint* > constraints;
     std::vector< Prepared_BBox > node_bboxes;
     std::vector< Prepared_BBox > way_bboxes;
+
+    void build_spatial_indexes();
 };
 
 #endif
@@ -45,6 +45,8 @@ class Bbox_Constraint final : public Query_Constraint
         (Resource_Manager& rman, std::set< std::pair< Uint31_Index, Uint31_Index > >& ranges);
     void filter(Resource_Manager& rman, Set& into);
     void filter(const Statement& query, Resource_Manager& rman, Set& into);
+    void update_bbox()
+    { filter_ = Bbox_Filter(Bbox_Double(bbox->get_south(), bbox->get_west(), bbox->get_north(), bbox->get_east())); }
     virtual ~Bbox_Constraint() {}
   private:
     std::ostream& print_constraint( std::ostream &os ) const override {
@@ -258,3 +260,45 @@ Query_Constraint* Bbox_Query_Statement::get_query_constraint()
   constraints.push_back(new Bbox_Constraint(*this));
   return constraints.back();
 }
+
+
+bool Bbox_Query_Statement::bind_parameters(const std::map< std::string, std::string >& attributes)
+{
+  double new_south = south;
+  double new_north = north;
+  double new_west = west;
+  double new_east = east;
+
+  for (std::map< std::string, std::string >::const_iterator it = attributes.begin(); it != attributes.end(); ++it)
+  {
+    if (it->second.empty())
+      return false;
+    if (it->first == "s")
+      new_south = atof(it->second.c_str());
+    else if (it->first == "n")
+      new_north = atof(it->second.c_str());
+    else if (it->first == "w")
+      new_west = atof(it->second.c_str());
+    else if (it->first == "e")
+      new_east = atof(it->second.c_str());
+    else
+      return false;
+  }
+
+  // Same checks as in the constructor
+  if (new_south < -90.0 || new_south > 90.0 || new_north < -90.0 || new_north > 90.0 || new_north < new_south
+      || new_west < -180.0 || new_west > 180.0 || new_east < -180.0 || new_east > 180.0)
+    return false;
+
+  south = new_south;
+  north = new_north;
+  west = new_west;
+  east = new_east;
+  ranges_32.clear();
+  ranges_31.clear();
+
+  for (std::vector< Query_Constraint* >::const_iterator it = constraints.begin(); it != constraints.end(); ++it)
+    static_cast< Bbox_Constraint* >(*it)->update_bbox();
+
+  return true;
+}
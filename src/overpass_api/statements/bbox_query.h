@@ -53,6 +53,7 @@ class Bbox_Query_Statement final : public Output_Statement
     static Criterion_Maker criterion_maker;
 
     virtual Query_Constraint* get_query_constraint();
+    virtual bool bind_parameters(const std::map< std::string, std::string >& attributes);
 
     const std::set< std::pair< Uint32_Index, Uint32_Index > >& get_ranges_32();
     const std::set< std::pair< Uint31_Index, Uint31_Index > >& get_ranges_31();
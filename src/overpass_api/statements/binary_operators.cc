@@ -73,92 +73,170 @@ Eval_Task* Evaluator_Pair_Operator::get_string_task(Prepare_Task_Context& contex
 
 std::string Binary_Eval_Task::eval(const std::string* key) const
 {
-  return evaluator->process([&] { return (lhs ? lhs->eval(key) : ""); },
-                            [&] { return (rhs ? rhs->eval(key) : ""); });
+  return eval_value(key).release_str();
 }
 
 
 std::string Binary_Eval_Task::eval(const Element_With_Context< Node_Skeleton >& data, const std::string* key) const
 {
-  return evaluator->process([&] { return (lhs ? lhs->eval(data, key) : ""); },
-                            [&] { return (rhs ? rhs->eval(data, key) : ""); });
+  return eval_value(data, key).release_str();
 }
 
 
 std::string Binary_Eval_Task::eval(const Element_With_Context< Attic< Node_Skeleton > >& data, const std::string* key) const
 {
-  return evaluator->process([&] { return (lhs ? lhs->eval(data, key) : ""); },
-                            [&] { return (rhs ? rhs->eval(data, key) : ""); });
+  return eval_value(data, key).release_str();
 }
 
 
 std::string Binary_Eval_Task::eval(const Element_With_Context< Way_Skeleton >& data, const std::string* key) const
 {
-  return evaluator->process([&] { return (lhs ? lhs->eval(data, key) : ""); },
-                            [&] { return (rhs ? rhs->eval(data, key) : ""); });
+  return eval_value(data, key).release_str();
 }
 
 
 std::string Binary_Eval_Task::eval(const Element_With_Context< Attic< Way_Skeleton > >& data, const std::string* key) const
 {
-  return evaluator->process([&] { return (lhs ? lhs->eval(data, key) : ""); },
-                            [&] { return (rhs ? rhs->eval(data, key) : ""); });
+  return eval_value(data, key).release_str();
 }
 
 
 std::string Binary_Eval_Task::eval(const Element_With_Context< Relation_Skeleton >& data, const std::string* key) const
 {
-  return evaluator->process([&] { return (lhs ? lhs->eval(data, key) : ""); },
-                            [&] { return (rhs ? rhs->eval(data, key) : ""); });
+  return eval_value(data, key).release_str();
 }
 
 
 std::string Binary_Eval_Task::eval(const Element_With_Context< Attic< Relation_Skeleton > >& data, const std::string* key) const
 {
-  return evaluator->process([&] { return (lhs ? lhs->eval(data, key) : ""); },
-                            [&] { return (rhs ? rhs->eval(data, key) : ""); });
+  return eval_value(data, key).release_str();
 }
 
 
 std::string Binary_Eval_Task::eval(const Element_With_Context< Area_Skeleton >& data, const std::string* key) const
 {
-  return evaluator->process([&] { return (lhs ? lhs->eval(data, key) : ""); },
-                            [&] { return (rhs ? rhs->eval(data, key) : ""); });
+  return eval_value(data, key).release_str();
 }
 
 
 std::string Binary_Eval_Task::eval(const Element_With_Context< Derived_Skeleton >& data, const std::string* key) const
 {
-  return evaluator->process([&] { return (lhs ? lhs->eval(data, key) : ""); },
-                            [&] { return (rhs ? rhs->eval(data, key) : ""); });
+  return eval_value(data, key).release_str();
 }
 
 
 std::string Binary_Eval_Task::eval(uint pos, const Element_With_Context< Way_Skeleton >& data, const std::string* key) const
 {
-  return evaluator->process([&] { return (lhs ? lhs->eval(pos, data, key) : ""); },
-                            [&] { return (rhs ? rhs->eval(pos, data, key) : ""); });
+  return eval_value(pos, data, key).release_str();
 }
 
 
 std::string Binary_Eval_Task::eval(uint pos, const Element_With_Context< Attic< Way_Skeleton > >& data, const std::string* key) const
 {
-  return evaluator->process([&] { return (lhs ? lhs->eval(pos, data, key) : ""); },
-                            [&] { return (rhs ? rhs->eval(pos, data, key) : ""); });
+  return eval_value(pos, data, key).release_str();
 }
 
 
 std::string Binary_Eval_Task::eval(uint pos, const Element_With_Context< Relation_Skeleton >& data, const std::string* key) const
 {
-  return evaluator->process([&] { return (lhs ? lhs->eval(pos, data, key) : ""); },
-                            [&] { return (rhs ? rhs->eval(pos, data, key) : ""); });
+  return eval_value(pos, data, key).release_str();
 }
 
 
 std::string Binary_Eval_Task::eval(uint pos, const Element_With_Context< Attic< Relation_Skeleton > >& data, const std::string* key) const
 {
-  return evaluator->process([&] { return (lhs ? lhs->eval(pos, data, key) : ""); },
-                            [&] { return (rhs ? rhs->eval(pos, data, key) : ""); });
+  return eval_value(pos, data, key).release_str();
+}
+
+
+Eval_Value Binary_Eval_Task::eval_value(const std::string* key) const
+{
+  return evaluator->process([&] { return (lhs ? lhs->eval_value(key) : Eval_Value()); },
+                            [&] { return (rhs ? rhs->eval_value(key) : Eval_Value()); });
+}
+
+
+Eval_Value Binary_Eval_Task::eval_value(const Element_With_Context< Node_Skeleton >& data, const std::string* key) const
+{
+  return evaluator->process([&] { return (lhs ? lhs->eval_value(data, key) : Eval_Value()); },
+                            [&] { return (rhs ? rhs->eval_value(data, key) : Eval_Value()); });
+}
+
+
+Eval_Value Binary_Eval_Task::eval_value(const Element_With_Context< Attic< Node_Skeleton > >& data, const std::string* key) const
+{
+  return evaluator->process([&] { return (lhs ? lhs->eval_value(data, key) : Eval_Value()); },
+                            [&] { return (rhs ? rhs->eval_value(data, key) : Eval_Value()); });
+}
+
+
+Eval_Value Binary_Eval_Task::eval_value(const Element_With_Context< Way_Skeleton >& data, const std::string* key) const
+{
+  return evaluator->process([&] { return (lhs ? lhs->eval_value(data, key) : Eval_Value()); },
+                            [&] { return (rhs ? rhs->eval_value(data, key) : Eval_Value()); });
+}
+
+
+Eval_Value Binary_Eval_Task::eval_value(const Element_With_Context< Attic< Way_Skeleton > >& data, const std::string* key) const
+{
+  return evaluator->process([&] { return (lhs ? lhs->eval_value(data, key) : Eval_Value()); },
+                            [&] { return (rhs ? rhs->eval_value(data, key) : Eval_Value()); });
+}
+
+
+Eval_Value Binary_Eval_Task::eval_value(const Element_With_Context< Relation_Skeleton >& data, const std::string* key) const
+{
+  return evaluator->process([&] { return (lhs ? lhs->eval_value(data, key) : Eval_Value()); },
+                            [&] { return (rhs ? rhs->eval_value(data, key) : Eval_Value()); });
+}
+
+
+Eval_Value Binary_Eval_Task::eval_value(const Element_With_Context< Attic< Relation_Skeleton > >& data, const std::string* key) const
+{
+  return evaluator->process([&] { return (lhs ? lhs->eval_value(data, key) : Eval_Value()); },
+                            [&] { return (rhs ? rhs->eval_value(data, key) : Eval_Value()); });
+}
+
+
+Eval_Value Binary_Eval_Task::eval_value(const Element_With_Context< Area_Skeleton >& data, const std::string* key) const
+{
+  return evaluator->process([&] { return (lhs ? lhs->eval_value(data, key) : Eval_Value()); },
+                            [&] { return (rhs ? rhs->eval_value(data, key) : Eval_Value()); });
+}
+
+
+Eval_Value Binary_Eval_Task::eval_value(const Element_With_Context< Derived_Skeleton >& data, const std::string* key) const
+{
+  return evaluator->process([&] { return (lhs ? lhs->eval_value(data, key) : Eval_Value()); },
+                            [&] { return (rhs ? rhs->eval_value(data, key) : Eval_Value()); });
+}
+
+
+Eval_Value Binary_Eval_Task::eval_value(uint pos, const Element_With_Context< Way_Skeleton >& data, const std::string* key) const
+{
+  return evaluator->process([&] { return (lhs ? lhs->eval_value(pos, data, key) : Eval_Value()); },
+                            [&] { return (rhs ? rhs->eval_value(pos, data, key) : Eval_Value()); });
+}
+
+
+Eval_Value Binary_Eval_Task::eval_value(uint pos, const Element_With_Context< Attic< Way_Skeleton > >& data, const std::string* key) const
+{
+  return evaluator->process([&] { return (lhs ? lhs->eval_value(pos, data, key) : Eval_Value()); },
+                            [&] { return (rhs ? rhs->eval_value(pos, data, key) : Eval_Value()); });
+}
+
+
+Eval_Value Binary_Eval_Task::eval_value(uint pos, const Element_With_Context< Relation_Skeleton >& data, const std::string* key) const
+{
+  return evaluator->process([&] { return (lhs ? lhs->eval_value(pos, data, key) : Eval_Value()); },
+                            [&] { return (rhs ? rhs->eval_value(pos, data, key) : Eval_Value()); });
+}
+
+
+Eval_Value Binary_Eval_Task::eval_value(uint pos, const Element_With_Context< Attic< Relation_Skeleton > >& data, const std::string* key) const
+{
+  return evaluator->process([&] { return (lhs ? lhs->eval_value(pos, data, key) : Eval_Value()); },
+                            [&] { return (rhs ? rhs->eval_value(pos, data, key) : Eval_Value()); });
 }
 
 
@@ -186,14 +264,14 @@ Operator_Stmt_Maker< Evaluator_And > Evaluator_And::statement_maker;
 Operator_Eval_Maker< Evaluator_And > Evaluator_And::evaluator_maker;
 
 
-std::string Evaluator_And::process(const std::string& lhs_s, const std::string& rhs_s) const
+Eval_Value Evaluator_And::process(const Eval_Value& lhs_v, const Eval_Value& rhs_v) const
 {
-  return string_represents_boolean_true(lhs_s) && string_represents_boolean_true(rhs_s) ? "1" : "0";
+  return Eval_Value::of_bool(lhs_v.represents_boolean_true() && rhs_v.represents_boolean_true());
 }
 
-inline std::string Evaluator_And::process(TransientFunction<std::string()> lhs, TransientFunction<std::string()> rhs) const
+inline Eval_Value Evaluator_And::process(TransientFunction<Eval_Value()> lhs, TransientFunction<Eval_Value()> rhs) const
 {
-  return string_represents_boolean_true(lhs()) && string_represents_boolean_true(rhs()) ? "1" : "0";
+  return Eval_Value::of_bool(lhs().represents_boolean_true() && rhs().represents_boolean_true());
 }
 
 
@@ -204,14 +282,14 @@ Operator_Stmt_Maker< Evaluator_Or > Evaluator_Or::statement_maker;
 Operator_Eval_Maker< Evaluator_Or > Evaluator_Or::evaluator_maker;
 
 
-std::string Evaluator_Or::process(const std::string& lhs_s, const std::string& rhs_s) const
+Eval_Value Evaluator_Or::process(const Eval_Value& lhs_v, const Eval_Value& rhs_v) const
 {
-  return string_represents_boolean_true(lhs_s) || string_represents_boolean_true(rhs_s) ? "1" : "0";
+  return Eval_Value::of_bool(lhs_v.represents_boolean_true() || rhs_v.represents_boolean_true());
 }
 
-inline std::string Evaluator_Or::process(TransientFunction<std::string()> lhs, TransientFunction<std::string()> rhs) const
+inline Eval_Value Evaluator_Or::process(TransientFunction<Eval_Value()> lhs, TransientFunction<Eval_Value()> rhs) const
 {
-  return string_represents_boolean_true(lhs()) || string_represents_boolean_true(rhs()) ? "1" : "0";
+  return Eval_Value::of_bool(lhs().represents_boolean_true() || rhs().represents_boolean_true());
 }
 
 
@@ -222,19 +300,19 @@ Operator_Stmt_Maker< Evaluator_Equal > Evaluator_Equal::statement_maker;
 Operator_Eval_Maker< Evaluator_Equal > Evaluator_Equal::evaluator_maker;
 
 
-std::string Evaluator_Equal::process(const std::string& lhs_s, const std::string& rhs_s) const
+Eval_Value Evaluator_Equal::process(const Eval_Value& lhs_v, const Eval_Value& rhs_v) const
 {
   int64 lhs_l = 0;
   int64 rhs_l = 0;
-  if (try_int64(lhs_s, lhs_l) && try_int64(rhs_s, rhs_l))
-    return lhs_l == rhs_l ? "1" : "0";
+  if (lhs_v.try_int64(lhs_l) && rhs_v.try_int64(rhs_l))
+    return Eval_Value::of_bool(lhs_l == rhs_l);
 
   double lhs_d = 0;
   double rhs_d = 0;
-  if (try_double(lhs_s, lhs_d) && try_double(rhs_s, rhs_d))
-    return lhs_d == rhs_d ? "1" : "0";
+  if (lhs_v.try_double(lhs_d) && rhs_v.try_double(rhs_d))
+    return Eval_Value::of_bool(lhs_d == rhs_d);
 
-  return lhs_s == rhs_s ? "1" : "0";
+  return Eval_Value::of_bool(lhs_v.str() == rhs_v.str());
 }
 
 
@@ -245,19 +323,19 @@ Operator_Stmt_Maker< Evaluator_Not_Equal > Evaluator_Not_Equal::statement_maker;
 Operator_Eval_Maker< Evaluator_Not_Equal > Evaluator_Not_Equal::evaluator_maker;
 
 
-std::string Evaluator_Not_Equal::process(const std::string& lhs_s, const std::string& rhs_s) const
+Eval_Value Evaluator_Not_Equal::process(const Eval_Value& lhs_v, const Eval_Value& rhs_v) const
 {
   int64 lhs_l = 0;
   int64 rhs_l = 0;
-  if (try_int64(lhs_s, lhs_l) && try_int64(rhs_s, rhs_l))
-    return lhs_l == rhs_l ? "0" : "1";
+  if (lhs_v.try_int64(lhs_l) && rhs_v.try_int64(rhs_l))
+    return Eval_Value::of_bool(lhs_l != rhs_l);
 
   double lhs_d = 0;
   double rhs_d = 0;
-  if (try_double(lhs_s, lhs_d) && try_double(rhs_s, rhs_d))
-    return lhs_d == rhs_d ? "0" : "1";
+  if (lhs_v.try_double(lhs_d) && rhs_v.try_double(rhs_d))
+    return Eval_Value::of_bool(lhs_d != rhs_d);
 
-  return lhs_s == rhs_s ? "0" : "1";
+  return Eval_Value::of_bool(lhs_v.str() != rhs_v.str());
 }
 
 
@@ -268,19 +346,19 @@ Operator_Stmt_Maker< Evaluator_Less > Evaluator_Less::statement_maker;
 Operator_Eval_Maker< Evaluator_Less > Evaluator_Less::evaluator_maker;
 
 
-std::string Evaluator_Less::process(const std::string& lhs_s, const std::string& rhs_s) const
+Eval_Value Evaluator_Less::process(const Eval_Value& lhs_v, const Eval_Value& rhs_v) const
 {
   int64 lhs_l = 0;
   int64 rhs_l = 0;
-  if (try_int64(lhs_s, lhs_l) && try_int64(rhs_s, rhs_l))
-    return lhs_l < rhs_l ? "1" : "0";
+  if (lhs_v.try_int64(lhs_l) && rhs_v.try_int64(rhs_l))
+    return Eval_Value::of_bool(lhs_l < rhs_l);
 
   double lhs_d = 0;
   double rhs_d = 0;
-  if (try_double(lhs_s, lhs_d) && try_double(rhs_s, rhs_d))
-    return lhs_d < rhs_d ? "1" : "0";
+  if (lhs_v.try_double(lhs_d) && rhs_v.try_double(rhs_d))
+    return Eval_Value::of_bool(lhs_d < rhs_d);
 
-  return lhs_s < rhs_s ? "1" : "0";
+  return Eval_Value::of_bool(lhs_v.str() < rhs_v.str());
 }
 
 
@@ -291,19 +369,19 @@ Operator_Stmt_Maker< Evaluator_Less_Equal > Evaluator_Less_Equal::statement_make
 Operator_Eval_Maker< Evaluator_Less_Equal > Evaluator_Less_Equal::evaluator_maker;
 
 
-std::string Evaluator_Less_Equal::process(const std::string& lhs_s, const std::string& rhs_s) const
+Eval_Value Evaluator_Less_Equal::process(const Eval_Value& lhs_v, const Eval_Value& rhs_v) const
 {
   int64 lhs_l = 0;
   int64 rhs_l = 0;
-  if (try_int64(lhs_s, lhs_l) && try_int64(rhs_s, rhs_l))
-    return lhs_l <= rhs_l ? "1" : "0";
+  if (lhs_v.try_int64(lhs_l) && rhs_v.try_int64(rhs_l))
+    return Eval_Value::of_bool(lhs_l <= rhs_l);
 
   double lhs_d = 0;
   double rhs_d = 0;
-  if (try_double(lhs_s, lhs_d) && try_double(rhs_s, rhs_d))
-    return lhs_d <= rhs_d ? "1" : "0";
+  if (lhs_v.try_double(lhs_d) && rhs_v.try_double(rhs_d))
+    return Eval_Value::of_bool(lhs_d <= rhs_d);
 
-  return lhs_s <= rhs_s ? "1" : "0";
+  return Eval_Value::of_bool(lhs_v.str() <= rhs_v.str());
 }
 
 
@@ -314,19 +392,19 @@ Operator_Stmt_Maker< Evaluator_Greater > Evaluator_Greater::statement_maker;
 Operator_Eval_Maker< Evaluator_Greater > Evaluator_Greater::evaluator_maker;
 
 
-std::string Evaluator_Greater::process(const std::string& lhs_s, const std::string& rhs_s) const
+Eval_Value Evaluator_Greater::process(const Eval_Value& lhs_v, const Eval_Value& rhs_v) const
 {
   int64 lhs_l = 0;
   int64 rhs_l = 0;
-  if (try_int64(lhs_s, lhs_l) && try_int64(rhs_s, rhs_l))
-    return lhs_l > rhs_l ? "1" : "0";
+  if (lhs_v.try_int64(lhs_l) && rhs_v.try_int64(rhs_l))
+    return Eval_Value::of_bool(lhs_l > rhs_l);
 
   double lhs_d = 0;
   double rhs_d = 0;
-  if (try_double(lhs_s, lhs_d) && try_double(rhs_s, rhs_d))
-    return lhs_d > rhs_d ? "1" : "0";
+  if (lhs_v.try_double(lhs_d) && rhs_v.try_double(rhs_d))
+    return Eval_Value::of_bool(lhs_d > rhs_d);
 
-  return lhs_s > rhs_s ? "1" : "0";
+  return Eval_Value::of_bool(lhs_v.str() > rhs_v.str());
 }
 
 
@@ -337,19 +415,19 @@ Operator_Stmt_Maker< Evaluator_Greater_Equal > Evaluator_Greater_Equal::statemen
 Operator_Eval_Maker< Evaluator_Greater_Equal > Evaluator_Greater_Equal::evaluator_maker;
 
 
-std::string Evaluator_Greater_Equal::process(const std::string& lhs_s, const std::string& rhs_s) const
+Eval_Value Evaluator_Greater_Equal::process(const Eval_Value& lhs_v, const Eval_Value& rhs_v) const
 {
   int64 lhs_l = 0;
   int64 rhs_l = 0;
-  if (try_int64(lhs_s, lhs_l) && try_int64(rhs_s, rhs_l))
-    return lhs_l >= rhs_l ? "1" : "0";
+  if (lhs_v.try_int64(lhs_l) && rhs_v.try_int64(rhs_l))
+    return Eval_Value::of_bool(lhs_l >= rhs_l);
 
   double lhs_d = 0;
   double rhs_d = 0;
-  if (try_double(lhs_s, lhs_d) && try_double(rhs_s, rhs_d))
-    return lhs_d >= rhs_d ? "1" : "0";
+  if (lhs_v.try_double(lhs_d) && rhs_v.try_double(rhs_d))
+    return Eval_Value::of_bool(lhs_d >= rhs_d);
 
-  return lhs_s >= rhs_s ? "1" : "0";
+  return Eval_Value::of_bool(lhs_v.str() >= rhs_v.str());
 }
 
 
@@ -360,19 +438,19 @@ Operator_Stmt_Maker< Evaluator_Plus > Evaluator_Plus::statement_maker;
 Operator_Eval_Maker< Evaluator_Plus > Evaluator_Plus::evaluator_maker;
 
 
-std::string Evaluator_Plus::process(const std::string& lhs_s, const std::string& rhs_s) const
+Eval_Value Evaluator_Plus::process(const Eval_Value& lhs_v, const Eval_Value& rhs_v) const
 {
   int64 lhs_l = 0;
   int64 rhs_l = 0;
-  if (try_int64(lhs_s, lhs_l) && try_int64(rhs_s, rhs_l))
-    return to_string(lhs_l + rhs_l);
+  if (lhs_v.try_int64(lhs_l) && rhs_v.try_int64(rhs_l))
+    return Eval_Value::of_int64(lhs_l + rhs_l);
 
   double lhs_d = 0;
   double rhs_d = 0;
-  if (try_double(lhs_s, lhs_d) && try_double(rhs_s, rhs_d))
-    return to_string(lhs_d + rhs_d);
+  if (lhs_v.try_double(lhs_d) && rhs_v.try_double(rhs_d))
+    return Eval_Value::of_double(lhs_d + rhs_d);
 
-  return lhs_s + rhs_s;
+  return Eval_Value(lhs_v.str() + rhs_v.str());
 }
 
 
@@ -383,19 +461,19 @@ Operator_Stmt_Maker< Evaluator_Minus > Evaluator_Minus::statement_maker;
 Operator_Eval_Maker< Evaluator_Minus > Evaluator_Minus::evaluator_maker;
 
 
-std::string Evaluator_Minus::process(const std::string& lhs_s, const std::string& rhs_s) const
+Eval_Value Evaluator_Minus::process(const Eval_Value& lhs_v, const Eval_Value& rhs_v) const
 {
   int64 lhs_l = 0;
   int64 rhs_l = 0;
-  if (try_int64(lhs_s, lhs_l) && try_int64(rhs_s, rhs_l))
-    return to_string(lhs_l - rhs_l);
+  if (lhs_v.try_int64(lhs_l) && rhs_v.try_int64(rhs_l))
+    return Eval_Value::of_int64(lhs_l - rhs_l);
 
   double lhs_d = 0;
   double rhs_d = 0;
-  if (try_double(lhs_s, lhs_d) && try_double(rhs_s, rhs_d))
-    return to_string(lhs_d - rhs_d);
+  if (lhs_v.try_double(lhs_d) && rhs_v.try_double(rhs_d))
+    return Eval_Value::of_double(lhs_d - rhs_d);
 
-  return "NaN";
+  return Eval_Value(std::string("NaN"));
 }
 
 
@@ -406,19 +484,19 @@ Operator_Stmt_Maker< Evaluator_Times > Evaluator_Times::statement_maker;
 Operator_Eval_Maker< Evaluator_Times > Evaluator_Times::evaluator_maker;
 
 
-std::string Evaluator_Times::process(const std::string& lhs_s, const std::string& rhs_s) const
+Eval_Value Evaluator_Times::process(const Eval_Value& lhs_v, const Eval_Value& rhs_v) const
 {
   int64 lhs_l = 0;
   int64 rhs_l = 0;
-  if (try_int64(lhs_s, lhs_l) && try_int64(rhs_s, rhs_l))
-    return to_string(lhs_l * rhs_l);
+  if (lhs_v.try_int64(lhs_l) && rhs_v.try_int64(rhs_l))
+    return Eval_Value::of_int64(lhs_l * rhs_l);
 
   double lhs_d = 0;
   double rhs_d = 0;
-  if (try_double(lhs_s, lhs_d) && try_double(rhs_s, rhs_d))
-    return to_string(lhs_d * rhs_d);
+  if (lhs_v.try_double(lhs_d) && rhs_v.try_double(rhs_d))
+    return Eval_Value::of_double(lhs_d * rhs_d);
 
-  return "NaN";
+  return Eval_Value(std::string("NaN"));
 }
 
 
@@ -429,16 +507,16 @@ Operator_Stmt_Maker< Evaluator_Divided > Evaluator_Divided::statement_maker;
 Operator_Eval_Maker< Evaluator_Divided > Evaluator_Divided::evaluator_maker;
 
 
-std::string Evaluator_Divided::process(const std::string& lhs_s, const std::string& rhs_s) const
+Eval_Value Evaluator_Divided::process(const Eval_Value& lhs_v, const Eval_Value& rhs_v) const
 {
   // On purpose no int64 detection
 
   double lhs_d = 0;
   double rhs_d = 0;
-  if (try_double(lhs_s, lhs_d) && try_double(rhs_s, rhs_d))
-    return to_string(lhs_d / rhs_d);
+  if (lhs_v.try_double(lhs_d) && rhs_v.try_double(rhs_d))
+    return Eval_Value::of_double(lhs_d / rhs_d);
 
-  return "NaN";
+  return Eval_Value(std::string("NaN"));
 }
 
 //-----------------------------------------------------------------------------
@@ -448,12 +526,12 @@ Operator_Stmt_Maker< Evaluator_Modulo > Evaluator_Modulo::statement_maker;
 Operator_Eval_Maker< Evaluator_Modulo > Evaluator_Modulo::evaluator_maker;
 
 
-std::string Evaluator_Modulo::process(const std::string& lhs_s, const std::string& rhs_s) const
+Eval_Value Evaluator_Modulo::process(const Eval_Value& lhs_v, const Eval_Value& rhs_v) const
 {
   int64 lhs_l = 0;
   int64 rhs_l = 0;
-  if (try_int64(lhs_s, lhs_l) && try_int64(rhs_s, rhs_l))
-    return (rhs_l == 0 ? "NaN" : to_string(lhs_l % rhs_l));
+  if (lhs_v.try_int64(lhs_l) && rhs_v.try_int64(rhs_l))
+    return (rhs_l == 0 ? Eval_Value(std::string("NaN")) : Eval_Value::of_int64(lhs_l % rhs_l));
 
-  return "NaN";
+  return Eval_Value(std::string("NaN"));
 }
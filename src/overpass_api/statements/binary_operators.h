@@ -83,10 +83,10 @@ public:
   virtual Statement::Eval_Return_Type return_type() const { return Statement::string; };
   virtual Eval_Task* get_string_task(Prepare_Task_Context& context, const std::string* key);
 
-  virtual std::string process(const std::string& lhs_result, const std::string& rhs_result) const = 0;
+  virtual Eval_Value process(const Eval_Value& lhs_result, const Eval_Value& rhs_result) const = 0;
 
 
-  virtual inline std::string process(TransientFunction<std::string()> lhs, TransientFunction<std::string()> rhs) const {
+  virtual inline Eval_Value process(TransientFunction<Eval_Value()> lhs, TransientFunction<Eval_Value()> rhs) const {
     return process(lhs(), rhs());
   }
 
@@ -126,6 +126,22 @@ struct Binary_Eval_Task : public Eval_Task
   virtual std::string eval(uint pos, const Element_With_Context< Relation_Skeleton >& data, const std::string* key) const;
   virtual std::string eval(uint pos, const Element_With_Context< Attic< Relation_Skeleton > >& data, const std::string* key) const;
 
+  virtual Eval_Value eval_value(const std::string* key) const;
+
+  virtual Eval_Value eval_value(const Element_With_Context< Node_Skeleton >& data, const std::string* key) const;
+  virtual Eval_Value eval_value(const Element_With_Context< Attic< Node_Skeleton > >& data, const std::string* key) const;
+  virtual Eval_Value eval_value(const Element_With_Context< Way_Skeleton >& data, const std::string* key) const;
+  virtual Eval_Value eval_value(const Element_With_Context< Attic< Way_Skeleton > >& data, const std::string* key) const;
+  virtual Eval_Value eval_value(const Element_With_Context< Relation_Skeleton >& data, const std::string* key) const;
+  virtual Eval_Value eval_value(const Element_With_Context< Attic< Relation_Skeleton > >& data, const std::string* key) const;
+  virtual Eval_Value eval_value(const Element_With_Context< Area_Skeleton >& data, const std::string* key) const;
+  virtual Eval_Value eval_value(const Element_With_Context< Derived_Skeleton >& data, const std::string* key) const;
+
+  virtual Eval_Value eval_value(uint pos, const Element_With_Context< Way_Skeleton >& data, const std::string* key) const;
+  virtual Eval_Value eval_value(uint pos, const Element_With_Context< Attic< Way_Skeleton > >& data, const std::string* key) const;
+  virtual Eval_Value eval_value(uint pos, const Element_With_Context< Relation_Skeleton >& data, const std::string* key) const;
+  virtual Eval_Value eval_value(uint pos, const Element_With_Context< Attic< Relation_Skeleton > >& data, const std::string* key) const;
+
 private:
   Eval_Task* lhs;
   Eval_Task* rhs;
@@ -193,9 +209,9 @@ struct Evaluator_Or final : public Evaluator_Pair_Operator_Syntax< Evaluator_Or
   Evaluator_Or(int line_number_, const std::map< std::string, std::string >& input_attributes, Parsed_Query& global_settings)
       : Evaluator_Pair_Operator_Syntax< Evaluator_Or >(line_number_, input_attributes) {}
 
-  virtual std::string process(const std::string& lhs_result, const std::string& rhs_result) const;
+  virtual Eval_Value process(const Eval_Value& lhs_result, const Eval_Value& rhs_result) const;
 
-  virtual inline std::string process(TransientFunction<std::string()> lhs, TransientFunction<std::string()> rhs) const;
+  virtual inline Eval_Value process(TransientFunction<Eval_Value()> lhs, TransientFunction<Eval_Value()> rhs) const;
 
 };
 
@@ -226,9 +242,9 @@ struct Evaluator_And final : public Evaluator_Pair_Operator_Syntax< Evaluator_An
   Evaluator_And(int line_number_, const std::map< std::string, std::string >& input_attributes, Parsed_Query& global_settings)
       : Evaluator_Pair_Operator_Syntax< Evaluator_And >(line_number_, input_attributes) {}
 
-  virtual std::string process(const std::string& lhs_result, const std::string& rhs_result) const;
+  virtual Eval_Value process(const Eval_Value& lhs_result, const Eval_Value& rhs_result) const;
 
-  virtual inline std::string process(TransientFunction<std::string()> lhs, TransientFunction<std::string()> rhs) const;
+  virtual inline Eval_Value process(TransientFunction<Eval_Value()> lhs, TransientFunction<Eval_Value()> rhs) const;
 };
 
 
@@ -263,7 +279,7 @@ struct Evaluator_Equal final : public Evaluator_Pair_Operator_Syntax< Evaluator_
   Evaluator_Equal(int line_number_, const std::map< std::string, std::string >& input_attributes, Parsed_Query& global_settings)
       : Evaluator_Pair_Operator_Syntax< Evaluator_Equal >(line_number_, input_attributes) {}
 
-  virtual std::string process(const std::string& lhs_result, const std::string& rhs_result) const;
+  virtual Eval_Value process(const Eval_Value& lhs_result, const Eval_Value& rhs_result) const;
 };
 
 
@@ -277,7 +293,7 @@ struct Evaluator_Not_Equal final : public Evaluator_Pair_Operator_Syntax< Evalua
   Evaluator_Not_Equal(int line_number_, const std::map< std::string, std::string >& input_attributes, Parsed_Query& global_settings)
       : Evaluator_Pair_Operator_Syntax< Evaluator_Not_Equal >(line_number_, input_attributes) {}
 
-  virtual std::string process(const std::string& lhs_result, const std::string& rhs_result) const;
+  virtual Eval_Value process(const Eval_Value& lhs_result, const Eval_Value& rhs_result) const;
 };
 
 
@@ -312,7 +328,7 @@ struct Evaluator_Less final : public Evaluator_Pair_Operator_Syntax< Evaluator_L
   Evaluator_Less(int line_number_, const std::map< std::string, std::string >& input_attributes, Parsed_Query& global_settings)
       : Evaluator_Pair_Operator_Syntax< Evaluator_Less >(line_number_, input_attributes) {}
 
-  virtual std::string process(const std::string& lhs_result, const std::string& rhs_result) const;
+  virtual Eval_Value process(const Eval_Value& lhs_result, const Eval_Value& rhs_result) const;
 };
 
 
@@ -326,7 +342,7 @@ struct Evaluator_Less_Equal final : public Evaluator_Pair_Operator_Syntax< Evalu
   Evaluator_Less_Equal(int line_number_, const std::map< std::string, std::string >& input_attributes, Parsed_Query& global_settings)
       : Evaluator_Pair_Operator_Syntax< Evaluator_Less_Equal >(line_number_, input_attributes) {}
 
-  virtual std::string process(const std::string& lhs_result, const std::string& rhs_result) const;
+  virtual Eval_Value process(const Eval_Value& lhs_result, const Eval_Value& rhs_result) const;
 };
 
 
@@ -340,7 +356,7 @@ struct Evaluator_Greater final : public Evaluator_Pair_Operator_Syntax< Evaluato
   Evaluator_Greater(int line_number_, const std::map< std::string, std::string >& input_attributes, Parsed_Query& global_settings)
       : Evaluator_Pair_Operator_Syntax< Evaluator_Greater >(line_number_, input_attributes) {}
 
-  virtual std::string process(const std::string& lhs_result, const std::string& rhs_result) const;
+  virtual Eval_Value process(const Eval_Value& lhs_result, const Eval_Value& rhs_result) const;
 };
 
 
@@ -354,7 +370,7 @@ struct Evaluator_Greater_Equal final : public Evaluator_Pair_Operator_Syntax< Ev
   Evaluator_Greater_Equal(int line_number_, const std::map< std::string, std::string >& input_attributes, Parsed_Query& global_settings)
       : Evaluator_Pair_Operator_Syntax< Evaluator_Greater_Equal >(line_number_, input_attributes) {}
 
-  virtual std::string process(const std::string& lhs_result, const std::string& rhs_result) const;
+  virtual Eval_Value process(const Eval_Value& lhs_result, const Eval_Value& rhs_result) const;
 };
 
 
@@ -388,7 +404,7 @@ struct Evaluator_Plus final : public Evaluator_Pair_Operator_Syntax< Evaluator_P
   Evaluator_Plus(int line_number_, const std::map< std::string, std::string >& input_attributes, Parsed_Query& global_settings)
       : Evaluator_Pair_Operator_Syntax< Evaluator_Plus >(line_number_, input_attributes) {}
 
-  virtual std::string process(const std::string& lhs_result, const std::string& rhs_result) const;
+  virtual Eval_Value process(const Eval_Value& lhs_result, const Eval_Value& rhs_result) const;
 };
 
 
@@ -402,7 +418,7 @@ struct Evaluator_Minus final : public Evaluator_Pair_Operator_Syntax< Evaluator_
   Evaluator_Minus(int line_number_, const std::map< std::string, std::string >& input_attributes, Parsed_Query& global_settings)
       : Evaluator_Pair_Operator_Syntax< Evaluator_Minus >(line_number_, input_attributes) {}
 
-  virtual std::string process(const std::string& lhs_result, const std::string& rhs_result) const;
+  virtual Eval_Value process(const Eval_Value& lhs_result, const Eval_Value& rhs_result) const;
 };
 
 
@@ -433,7 +449,7 @@ struct Evaluator_Times final : public Evaluator_Pair_Operator_Syntax< Evaluator_
   Evaluator_Times(int line_number_, const std::map< std::string, std::string >& input_attributes, Parsed_Query& global_settings)
       : Evaluator_Pair_Operator_Syntax< Evaluator_Times >(line_number_, input_attributes) {}
 
-  virtual std::string process(const std::string& lhs_result, const std::string& rhs_result) const;
+  virtual Eval_Value process(const Eval_Value& lhs_result, const Eval_Value& rhs_result) const;
 };
 
 
@@ -447,7 +463,7 @@ struct Evaluator_Divided final : public Evaluator_Pair_Operator_Syntax< Evaluato
   Evaluator_Divided(int line_number_, const std::map< std::string, std::string >& input_attributes, Parsed_Query& global_settings)
       : Evaluator_Pair_Operator_Syntax< Evaluator_Divided >(line_number_, input_attributes) {}
 
-  virtual std::string process(const std::string& lhs_result, const std::string& rhs_result) const;
+  virtual Eval_Value process(const Eval_Value& lhs_result, const Eval_Value& rhs_result) const;
 };
 
 
@@ -464,7 +480,7 @@ struct Evaluator_Modulo final : public Evaluator_Pair_Operator_Syntax< Evaluator
   Evaluator_Modulo(int line_number_, const std::map< std::string, std::string >& input_attributes, Parsed_Query& global_settings)
       : Evaluator_Pair_Operator_Syntax< Evaluator_Modulo >(line_number_, input_attributes) {}
 
-  virtual std::string process(const std::string& lhs_result, const std::string& rhs_result) const;
+  virtual Eval_Value process(const Eval_Value& lhs_result, const Eval_Value& rhs_result) const;
 };
 
 
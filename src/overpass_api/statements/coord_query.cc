@@ -16,6 +16,7 @@
  * along with Overpass_API.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <cctype>
 #include <fstream>
 #include <iostream>
@@ -28,6 +29,9 @@
 #include <vector>
 
 #include <iomanip>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 #include "../../template_db/block_backend.h"
 #include "coord_query.h"
@@ -88,6 +92,93 @@ Coord_Query_Statement::Coord_Query_Statement
 int Coord_Query_Statement::check_area_block
     (uint32 ll_index, const Area_Block& area_block,
      uint32 coord_lat, int32 coord_lon)
+{
+  const std::vector< std::pair< uint32, int32 > >& ilat_ilon_pairs = area_block.get_ilat_ilon_pairs();
+  return check_area_block(ll_index, ilat_ilon_pairs.data(), ilat_ilon_pairs.data() + ilat_ilon_pairs.size(),
+      coord_lat, coord_lon);
+}
+
+
+namespace
+{
+  // Evaluates a single segment of an area block for the coordinate, see the cases below.
+  // Returns HIT or the bits to toggle.
+  inline int check_area_segment
+      (uint32 last_lat, int32 last_lon, uint32 lat, int32 lon, uint32 coord_lat, int32 coord_lon)
+  {
+    if (last_lon < lon)
+    {
+      if (lon < coord_lon)
+        return 0; // case (1)
+      else if (last_lon > coord_lon)
+        return 0; // case (1)
+      else if (lon == coord_lon)
+      {
+        if (lat < coord_lat)
+          return Coord_Query_Statement::TOGGLE_WEST; // case (4)
+        else if (lat == coord_lat)
+          return Coord_Query_Statement::HIT; // case (2)
+        // else: case (1)
+        return 0;
+      }
+      else if (last_lon == coord_lon)
+      {
+        if (last_lat < coord_lat)
+          return Coord_Query_Statement::TOGGLE_EAST; // case (4)
+        else if (last_lat == coord_lat)
+          return Coord_Query_Statement::HIT; // case (2)
+        // else: case (1)
+        return 0;
+      }
+    }
+    else if (last_lon > lon)
+    {
+      if (lon > coord_lon)
+        return 0; // case (1)
+      else if (last_lon < coord_lon)
+        return 0; // case (1)
+      else if (lon == coord_lon)
+      {
+        if (lat < coord_lat)
+          return Coord_Query_Statement::TOGGLE_EAST; // case (4)
+        else if (lat == coord_lat)
+          return Coord_Query_Statement::HIT; // case (2)
+        // else: case (1)
+        return 0;
+      }
+      else if (last_lon == coord_lon)
+      {
+        if (last_lat < coord_lat)
+          return Coord_Query_Statement::TOGGLE_WEST; // case (4)
+        else if (last_lat == coord_lat)
+          return Coord_Query_Statement::HIT; // case (2)
+        // else: case (1)
+        return 0;
+      }
+    }
+    else // last_lon == lon
+    {
+      if (lon == coord_lon &&
+          ((last_lat <= coord_lat && coord_lat <= lat) || (lat <= coord_lat && coord_lat <= last_lat)))
+        return Coord_Query_Statement::HIT; // case (2)
+      return 0; // else: case (1)
+    }
+
+    uint32 intersect_lat = lat +
+        ((int64)coord_lon - lon)*((int64)last_lat - lat)/((int64)last_lon - lon);
+    if (coord_lat > intersect_lat)
+      return (Coord_Query_Statement::TOGGLE_EAST | Coord_Query_Statement::TOGGLE_WEST); // case (3)
+    else if (coord_lat == intersect_lat)
+      return Coord_Query_Statement::HIT; // case (2)
+    // else: case (1)
+    return 0;
+  }
+}
+
+
+int Coord_Query_Statement::check_area_block
+    (uint32 ll_index, const std::pair< uint32, int32 >* begin, const std::pair< uint32, int32 >* end,
+     uint32 coord_lat, int32 coord_lon)
 {
   // An area block is a chain of segments. We consider each
   // segment individually. This falls into different cases, determined by
@@ -104,7 +195,7 @@ int Coord_Query_Statement::check_area_block
   // end the western or eastern side have an odd state.
   int state = 0;
 
-  std::vector< std::pair< uint32, int32 > >::const_iterator it(area_block.get_ilat_ilon_pairs().begin());
+  const std::pair< uint32, int32 >* it = begin;
 
   uint32 ll_index_ilat = ::ilat(ll_index, 0);
   int32 ll_index_ilon = ::ilon(ll_index, 0);
@@ -112,7 +203,7 @@ int Coord_Query_Statement::check_area_block
   uint32 lat = ll_index_ilat | it->first;
   int32 lon = ll_index_ilon | (it->second ^ 0x80000000);
 
-  while (++it != area_block.get_ilat_ilon_pairs().end())
+  while (++it != end)
   {
     uint32 last_lat = lat;
     int32 last_lon = lon;
@@ -120,73 +211,170 @@ int Coord_Query_Statement::check_area_block
     lat = ll_index_ilat | it->first;
     lon = ll_index_ilon | (it->second ^ 0x80000000);
 
-    if (last_lon < lon)
+    int result = check_area_segment(last_lat, last_lon, lat, lon, coord_lat, coord_lon);
+    if (result == HIT)
+      return HIT;
+    state ^= result;
+  }
+  return state;
+}
+
+
+void Area_Block_Batch_Check::clear_coords()
+{
+  lats.clear();
+  lons.clear();
+  coord_states.clear();
+  area_states.clear();
+  block_states.clear();
+  block_hits.clear();
+  found_count = 0;
+}
+
+
+void Area_Block_Batch_Check::add_coord(uint32 coord_lat, int32 coord_lon)
+{
+  lats.push_back(coord_lat);
+  lons.push_back(coord_lon);
+  coord_states.push_back(ACTIVE);
+  area_states.push_back(0);
+  block_states.push_back(0);
+  block_hits.push_back(0);
+}
+
+
+void Area_Block_Batch_Check::start_area()
+{
+  for (uint32 i = 0; i < coord_states.size(); ++i)
+  {
+    if (coord_states[i] == AREA_DECIDED)
+      coord_states[i] = ACTIVE;
+    area_states[i] = 0;
+  }
+}
+
+
+void Area_Block_Batch_Check::finish_area()
+{
+  for (uint32 i = 0; i < coord_states.size(); ++i)
+  {
+    if (coord_states[i] != FOUND && area_states[i] != 0)
     {
-      if (lon < coord_lon)
-	continue; // case (1)
-      else if (last_lon > coord_lon)
-	continue; // case (1)
-      else if (lon == coord_lon)
-      {
-	if (lat < coord_lat)
-	  state ^= TOGGLE_WEST; // case (4)
-	else if (lat == coord_lat)
-	  return HIT; // case (2)
-	// else: case (1)
-	continue;
-      }
-      else if (last_lon == coord_lon)
-      {
-	if (last_lat < coord_lat)
-	  state ^= TOGGLE_EAST; // case (4)
-	else if (last_lat == coord_lat)
-	  return HIT; // case (2)
-	// else: case (1)
-	continue;
-      }
+      coord_states[i] = FOUND;
+      ++found_count;
     }
-    else if (last_lon > lon)
+  }
+}
+
+
+inline void Area_Block_Batch_Check::check_segment
+    (uint32 last_lat, int32 last_lon, uint32 lat, int32 lon, uint32 i)
+{
+  if (coord_states[i] != ACTIVE || block_hits[i])
+    return;
+
+  int result = check_area_segment(last_lat, last_lon, lat, lon, lats[i], lons[i]);
+  if (result == 0)
+    return;
+
+  if (block_states[i] == 0)
+  {
+    touched.push_back(i);
+    block_states[i] = TOUCHED;
+  }
+  if (result == Coord_Query_Statement::HIT)
+    block_hits[i] = 1;
+  else
+    block_states[i] ^= result;
+}
+
+
+void Area_Block_Batch_Check::add_block(uint32 ll_index, const std::pair< uint32, int32 >* begin,
+    const std::pair< uint32, int32 >* end, bool add_border)
+{
+  if (begin == end)
+    return;
+
+  const uint32 count = lons.size();
+  const int32* coord_lons = lons.data();
+  touched.clear();
+
+  const std::pair< uint32, int32 >* it = begin;
+
+  uint32 ll_index_ilat = ::ilat(ll_index, 0);
+  int32 ll_index_ilon = ::ilon(ll_index, 0);
+
+  uint32 lat = ll_index_ilat | it->first;
+  int32 lon = ll_index_ilon | (it->second ^ 0x80000000);
+
+  while (++it != end)
+  {
+    uint32 last_lat = lat;
+    int32 last_lon = lon;
+
+    lat = ll_index_ilat | it->first;
+    lon = ll_index_ilon | (it->second ^ 0x80000000);
+
+    // A segment can only affect coordinates within its longitude range, see case (1).
+    int32 lower = std::min(last_lon, lon);
+    int32 upper = std::max(last_lon, lon);
+
+    uint32 i = 0;
+#if defined(__AVX2__)
+    const __m256i lower_8 = _mm256_set1_epi32(lower);
+    const __m256i upper_8 = _mm256_set1_epi32(upper);
+    for (; i + 8 <= count; i += 8)
     {
-      if (lon > coord_lon)
-	continue; // case (1)
-      else if (last_lon < coord_lon)
-	continue; // case (1)
-      else if (lon == coord_lon)
+      __m256i lons_8 = _mm256_loadu_si256((const __m256i*)(coord_lons + i));
+      __m256i out_of_range = _mm256_or_si256(
+          _mm256_cmpgt_epi32(lower_8, lons_8), _mm256_cmpgt_epi32(lons_8, upper_8));
+      uint32 mask = ~_mm256_movemask_ps(_mm256_castsi256_ps(out_of_range)) & 0xff;
+      while (mask)
       {
-	if (lat < coord_lat)
-	  state ^= TOGGLE_EAST; // case (4)
-	else if (lat == coord_lat)
-	  return HIT; // case (2)
-	// else: case (1)
-	continue;
+        check_segment(last_lat, last_lon, lat, lon, i + __builtin_ctz(mask));
+        mask &= mask - 1;
       }
-      else if (last_lon == coord_lon)
+    }
+#elif defined(__SSE2__)
+    const __m128i lower_4 = _mm_set1_epi32(lower);
+    const __m128i upper_4 = _mm_set1_epi32(upper);
+    for (; i + 4 <= count; i += 4)
+    {
+      __m128i lons_4 = _mm_loadu_si128((const __m128i*)(coord_lons + i));
+      __m128i out_of_range = _mm_or_si128(
+          _mm_cmpgt_epi32(lower_4, lons_4), _mm_cmpgt_epi32(lons_4, upper_4));
+      uint32 mask = ~_mm_movemask_ps(_mm_castsi128_ps(out_of_range)) & 0xf;
+      while (mask)
       {
-	if (last_lat < coord_lat)
-	  state ^= TOGGLE_WEST; // case (4)
-	else if (last_lat == coord_lat)
-	  return HIT; // case (2)
-	// else: case (1)
-	continue;
+        check_segment(last_lat, last_lon, lat, lon, i + __builtin_ctz(mask));
+        mask &= mask - 1;
       }
     }
-    else // last_lon == lon
+#endif
+    for (; i < count; ++i)
     {
-      if (lon == coord_lon &&
-          ((last_lat <= coord_lat && coord_lat <= lat) || (lat <= coord_lat && coord_lat <= last_lat)))
-        return HIT; // case (2)
-      continue; // else: case (1)
+      if (lower <= coord_lons[i] && coord_lons[i] <= upper)
+        check_segment(last_lat, last_lon, lat, lon, i);
     }
+  }
 
-    uint32 intersect_lat = lat +
-        ((int64)coord_lon - lon)*((int64)last_lat - lat)/((int64)last_lon - lon);
-    if (coord_lat > intersect_lat)
-      state ^= (TOGGLE_EAST | TOGGLE_WEST); // case (3)
-    else if (coord_lat == intersect_lat)
-      return HIT; // case (2)
-    // else: case (1)
+  // Combine the block results with the area state like a loop over the blocks per coordinate would do.
+  // Coordinates not in touched have the block result 0 which leaves the area state unchanged.
+  for (std::vector< uint32 >::const_iterator it = touched.begin(); it != touched.end(); ++it)
+  {
+    int check = (block_hits[*it] ? Coord_Query_Statement::HIT
+        : block_states[*it] & (Coord_Query_Statement::TOGGLE_EAST | Coord_Query_Statement::TOGGLE_WEST));
+    if (check == Coord_Query_Statement::HIT && add_border)
+    {
+      area_states[*it] = 1;
+      coord_states[*it] = AREA_DECIDED;
+    }
+    else
+      area_states[*it] ^= check;
+
+    block_states[*it] = 0;
+    block_hits[*it] = 0;
   }
-  return state;
 }
 
 
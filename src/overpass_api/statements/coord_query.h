@@ -49,6 +49,10 @@ class Coord_Query_Statement final : public Output_Statement
     static int check_area_block
         (uint32 ll_index, const Area_Block& area_block,
 	 uint32 coord_lat, int32 coord_lon);
+    // Same as above, for ilat/ilon pairs as delivered by Area_Block::get_ilat_ilon_pairs()
+    static int check_area_block
+        (uint32 ll_index, const std::pair< uint32, int32 >* begin, const std::pair< uint32, int32 >* end,
+	 uint32 coord_lat, int32 coord_lon);
 
     // Used as bitmasks.
     const static int HIT = 1;
@@ -84,4 +88,52 @@ class Coord_Query_Statement final : public Output_Statement
     static int coord_stmt_ref_counter_;
 };
 
+
+/* Tests many coordinates of one index at once against the area blocks of that index.
+ * The result per coordinate is the same as calling Coord_Query_Statement::check_area_block
+ * for each block and combining the results per area: a HIT with add_border makes the coordinate
+ * inside, otherwise the results are xored. Coordinates inside an earlier area are skipped.
+ *
+ * The blocks are evaluated segment by segment. Only the coordinates whose longitude lies
+ * in the longitude range of a segment can be affected by it; they are selected with SIMD compares
+ * where available. */
+class Area_Block_Batch_Check
+{
+  public:
+    Area_Block_Batch_Check() : found_count(0) {}
+
+    void clear_coords();
+    void add_coord(uint32 coord_lat, int32 coord_lon);
+    uint32 coord_count() const { return lons.size(); }
+
+    // Starts a new area
+    void start_area();
+    void add_block(uint32 ll_index, const std::pair< uint32, int32 >* begin,
+        const std::pair< uint32, int32 >* end, bool add_border);
+    // Marks the coordinates inside the current area as found
+    void finish_area();
+
+    bool found(uint32 i) const { return coord_states[i] == FOUND; }
+    bool all_found() const { return found_count == lons.size(); }
+
+  private:
+    // Per coordinate: still to evaluate, decided for the current area by a HIT, inside an area
+    enum { ACTIVE, AREA_DECIDED, FOUND };
+    // Set in block_states for the coordinates listed in touched
+    const static int TOUCHED = 0x10;
+
+    std::vector< uint32 > lats;
+    std::vector< int32 > lons;
+    std::vector< uint8 > coord_states;
+    std::vector< int > area_states;
+    uint32 found_count;
+
+    // State of the current block, only valid for the coordinates in touched
+    std::vector< int > block_states;
+    std::vector< uint8 > block_hits;
+    std::vector< uint32 > touched;
+
+    void check_segment(uint32 last_lat, int32 last_lon, uint32 lat, int32 lon, uint32 i);
+};
+
 #endif
@@ -0,0 +1,224 @@
+/** Copyright 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018 Roland Olbricht et al.
+ *
+ * This file is part of Overpass_API.
+ *
+ * Overpass_API is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Overpass_API is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Overpass_API.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../core/index_computations.h"
+#include "coord_query.h"
+
+
+/**
+ * Compares Area_Block_Batch_Check with Coord_Query_Statement::check_area_block on random areas.
+ * The coordinates are chosen on a small grid such that many of them are on segment end points,
+ * on horizontal or vertical segments or on the same longitude as a segment end point.
+ */
+
+//-----------------------------------------------------------------------------
+
+typedef std::vector< std::pair< uint32, int32 > > Block;
+
+struct Test_Area
+{
+  std::vector< Block > blocks;
+  std::vector< bool > add_border;
+};
+
+
+uint32 random_below(std::mt19937& rng, uint32 limit)
+{
+  return rng() % limit;
+}
+
+
+// The lower bits of the coordinates, see Area_Block::get_ilat_ilon_pairs
+std::pair< uint32, int32 > random_vertex(std::mt19937& rng, const Block& block)
+{
+  if (block.empty())
+    return std::make_pair(random_below(rng, 32), (int32)random_below(rng, 32));
+
+  // Produce horizontal and vertical segments often
+  uint32 kind = random_below(rng, 4);
+  if (kind == 0)
+    return std::make_pair(block.back().first, (int32)random_below(rng, 32));
+  else if (kind == 1)
+    return std::make_pair(random_below(rng, 32), block.back().second);
+  return std::make_pair(random_below(rng, 32), (int32)random_below(rng, 32));
+}
+
+
+Test_Area random_area(std::mt19937& rng)
+{
+  Test_Area area;
+  uint32 block_count = 1 + random_below(rng, 3);
+  for (uint32 i = 0; i < block_count; ++i)
+  {
+    Block block;
+    uint32 vertex_count = 2 + random_below(rng, 10);
+    for (uint32 j = 0; j < vertex_count; ++j)
+      block.push_back(random_vertex(rng, block));
+    if (random_below(rng, 2) == 0)
+      block.push_back(block.front());
+    area.blocks.push_back(block);
+    area.add_border.push_back(random_below(rng, 4) != 0);
+  }
+  return area;
+}
+
+
+std::pair< uint32, int32 > absolute(uint32 ll_index, const std::pair< uint32, int32 >& vertex)
+{
+  return std::make_pair(::ilat(ll_index, 0) | vertex.first, ::ilon(ll_index, 0) | (vertex.second ^ 0x80000000));
+}
+
+
+// Picks a segment end point, a point on a segment, a point on the longitude of an end point or a grid point
+std::pair< uint32, int32 > random_coord(std::mt19937& rng, uint32 ll_index, const std::vector< Test_Area >& areas)
+{
+  const Test_Area& area = areas[random_below(rng, areas.size())];
+  const Block& block = area.blocks[random_below(rng, area.blocks.size())];
+  uint32 pos = random_below(rng, block.size() - 1);
+  std::pair< uint32, int32 > from = block[pos];
+  std::pair< uint32, int32 > to = block[pos + 1];
+
+  uint32 kind = random_below(rng, 4);
+  if (kind == 0)
+    return absolute(ll_index, from);
+  else if (kind == 1)
+  {
+    // On the segment if it is horizontal or vertical, otherwise on its bounding box
+    uint32 lat = std::min(from.first, to.first) + random_below(rng, std::abs((int32)(from.first - to.first)) + 1);
+    int32 lon = std::min(from.second, to.second) + random_below(rng, std::abs(from.second - to.second) + 1);
+    return absolute(ll_index, std::make_pair(lat, lon));
+  }
+  else if (kind == 2)
+    return absolute(ll_index, std::make_pair(random_below(rng, 32), from.second));
+  return absolute(ll_index, std::make_pair(random_below(rng, 32), (int32)random_below(rng, 32)));
+}
+
+
+// Evaluates the areas block by block for a single coordinate like the unbatched code does
+bool reference_found(uint32 ll_index, const std::vector< Test_Area >& areas, uint32 lat, int32 lon)
+{
+  for (std::vector< Test_Area >::const_iterator it = areas.begin(); it != areas.end(); ++it)
+  {
+    int inside = 0;
+    for (uint32 i = 0; i < it->blocks.size(); ++i)
+    {
+      int check = Coord_Query_Statement::check_area_block(ll_index,
+          it->blocks[i].data(), it->blocks[i].data() + it->blocks[i].size(), lat, lon);
+      if (check == Coord_Query_Statement::HIT && it->add_border[i])
+      {
+        inside = 1;
+        break;
+      }
+      inside ^= check;
+    }
+    if (inside != 0)
+      return true;
+  }
+  return false;
+}
+
+
+// Runs the given number of rounds with coord counts in [min_coords, max_coords]
+void compare_batch_check(uint32 seed, uint32 rounds, uint32 min_coords, uint32 max_coords)
+{
+  std::mt19937 rng(seed);
+  uint32 ll_index = ll_upper_(uint32((51.25 + 91.0)*10000000+0.5), int32(7.15*10000000+0.5)) & 0xffffff00;
+
+  uint32 coords_checked = 0;
+  uint32 coords_found = 0;
+  uint32 mismatches = 0;
+  for (uint32 round = 0; round < rounds; ++round)
+  {
+    std::vector< Test_Area > areas;
+    uint32 area_count = 1 + random_below(rng, 3);
+    for (uint32 i = 0; i < area_count; ++i)
+      areas.push_back(random_area(rng));
+
+    Area_Block_Batch_Check batch_check;
+    std::vector< std::pair< uint32, int32 > > coords;
+    uint32 coord_count = min_coords + random_below(rng, max_coords - min_coords + 1);
+    for (uint32 i = 0; i < coord_count; ++i)
+    {
+      coords.push_back(random_coord(rng, ll_index, areas));
+      batch_check.add_coord(coords.back().first, coords.back().second);
+    }
+
+    for (std::vector< Test_Area >::const_iterator it = areas.begin(); it != areas.end(); ++it)
+    {
+      batch_check.start_area();
+      for (uint32 i = 0; i < it->blocks.size(); ++i)
+        batch_check.add_block(ll_index, it->blocks[i].data(), it->blocks[i].data() + it->blocks[i].size(),
+            it->add_border[i]);
+      batch_check.finish_area();
+    }
+
+    bool all_found = true;
+    for (uint32 i = 0; i < coords.size(); ++i)
+    {
+      bool expected = reference_found(ll_index, areas, coords[i].first, coords[i].second);
+      all_found &= expected;
+      coords_found += expected;
+      if (batch_check.found(i) != expected)
+      {
+        ++mismatches;
+        if (mismatches <= 10)
+          std::cout<<"Round "<<round<<", coord "<<i<<": batch "<<batch_check.found(i)
+              <<", expected "<<expected<<'\n';
+      }
+    }
+    if (batch_check.all_found() != all_found)
+    {
+      ++mismatches;
+      std::cout<<"Round "<<round<<": all_found differs\n";
+    }
+    coords_checked += coords.size();
+  }
+
+  // The found count shows that the random data does not degenerate to all or nothing
+  std::cout<<coords_checked<<" coords checked, "<<(coords_found > coords_checked/10
+      && coords_found < coords_checked*9/10 ? "mixed results" : "degenerated results")
+      <<", "<<mismatches<<" mismatches.\n";
+}
+
+
+int main(int argc, char* args[])
+{
+  if (argc < 2)
+  {
+    std::cout<<"Usage: "<<args[0]<<" test_to_execute\n";
+    return 0;
+  }
+  std::string test_to_execute = args[1];
+
+  if ((test_to_execute == "") || (test_to_execute == "1"))
+  {
+    std::cout<<"** Compare the batch check with fewer coords than a SIMD register holds\n";
+    compare_batch_check(1, 20000, 1, 3);
+  }
+  if ((test_to_execute == "") || (test_to_execute == "2"))
+  {
+    std::cout<<"** Compare the batch check with SIMD groups and a remainder\n";
+    compare_batch_check(2, 5000, 4, 43);
+  }
+
+  return 0;
+}
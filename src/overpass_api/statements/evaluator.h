@@ -37,14 +37,14 @@ template< typename Object >
 struct Element_With_Context
 {
   Element_With_Context(const Object* object_,
-      const std::vector< std::pair< std::string, std::string > >* tags_,
+      const Interned_Tags* tags_,
       const Opaque_Geometry* geometry_,
       const OSM_Element_Metadata_Skeleton< typename Object::Id_Type >* meta_,
       const std::string* user_name_)
       : object(object_), tags(tags_), geometry(geometry_), meta(meta_), user_name(user_name_) {}
 
   const Object* object;
-  const std::vector< std::pair< std::string, std::string > >* tags;
+  const Interned_Tags* tags;
   const Opaque_Geometry* geometry;
   const OSM_Element_Metadata_Skeleton< typename Object::Id_Type >* meta;
   const std::string* user_name;
@@ -223,6 +223,97 @@ They only make sense in the context of a single element.
 */
 
 
+/* The value of a string evaluation.
+ * Integers computed by operators stay in binary form, and the results of parsing a value as a number
+ * are kept with the value. Thus an operator need not parse again what its operand has just computed.
+ * The string representation is produced on demand and is always the string the evaluation stands for. */
+class Eval_Value
+{
+public:
+  Eval_Value() : s_valid(true), int_state(UNKNOWN), double_state(UNKNOWN), l(0), d(0) {}
+  explicit Eval_Value(const std::string& s_)
+      : s(s_), s_valid(true), int_state(UNKNOWN), double_state(UNKNOWN), l(0), d(0) {}
+  explicit Eval_Value(std::string&& s_)
+      : s(std::move(s_)), s_valid(true), int_state(UNKNOWN), double_state(UNKNOWN), l(0), d(0) {}
+
+  static Eval_Value of_int64(int64 value)
+  {
+    Eval_Value result;
+    result.s_valid = false;
+    result.int_state = VALID;
+    result.l = value;
+    // Parsing to_string(value) as a double gives the same value
+    result.double_state = VALID;
+    result.d = value;
+    return result;
+  }
+  // Doubles are formatted at once: operands parse the rounded string representation
+  static Eval_Value of_double(double value) { return Eval_Value(to_string(value)); }
+  static Eval_Value of_bool(bool value) { return of_int64(value ? 1 : 0); }
+
+  const std::string& str() const
+  {
+    if (!s_valid)
+    {
+      s = ::to_string(l);
+      s_valid = true;
+    }
+    return s;
+  }
+
+  std::string release_str()
+  {
+    str();
+    return std::move(s);
+  }
+
+  bool try_int64(int64& result) const
+  {
+    if (int_state == UNKNOWN)
+      int_state = ::try_int64(s, l) ? VALID : INVALID;
+    result = l;
+    return int_state == VALID;
+  }
+
+  bool try_double(double& result) const
+  {
+    if (double_state == UNKNOWN)
+      double_state = ::try_double(s, d) ? VALID : INVALID;
+    result = d;
+    return double_state == VALID;
+  }
+
+  // Same as string_represents_boolean_true(str())
+  bool represents_boolean_true() const
+  {
+    if (!s_valid)
+      return l != 0;
+    if (s.size() == 1)
+    {
+      if (s[0] == '0')
+        return false;
+      if (s[0] == '1')
+        return true;
+    }
+
+    double val_d = 0;
+    if (try_double(val_d))
+      return val_d != 0;
+    return !s.empty();
+  }
+
+private:
+  enum Parse_State { UNKNOWN, VALID, INVALID };
+
+  mutable std::string s;
+  mutable bool s_valid;
+  mutable Parse_State int_state;
+  mutable Parse_State double_state;
+  mutable int64 l;
+  mutable double d;
+};
+
+
 struct Eval_Task
 {
   virtual ~Eval_Task() {}
@@ -254,17 +345,78 @@ struct Eval_Task
       { return eval(data, key); }
   virtual std::string eval(uint pos, const Element_With_Context< Attic< Relation_Skeleton > >& data, const std::string* key) const
       { return eval(data, key); }
+
+  // Tasks that compute numbers override these to avoid the detour through strings
+  virtual Eval_Value eval_value(const std::string* key) const { return Eval_Value(eval(key)); }
+
+  virtual Eval_Value eval_value(const Element_With_Context< Node_Skeleton >& data, const std::string* key) const
+      { return Eval_Value(eval(data, key)); }
+  virtual Eval_Value eval_value(const Element_With_Context< Attic< Node_Skeleton > >& data, const std::string* key) const
+      { return Eval_Value(eval(data, key)); }
+  virtual Eval_Value eval_value(const Element_With_Context< Way_Skeleton >& data, const std::string* key) const
+      { return Eval_Value(eval(data, key)); }
+  virtual Eval_Value eval_value(const Element_With_Context< Attic< Way_Skeleton > >& data, const std::string* key) const
+      { return Eval_Value(eval(data, key)); }
+  virtual Eval_Value eval_value(const Element_With_Context< Relation_Skeleton >& data, const std::string* key) const
+      { return Eval_Value(eval(data, key)); }
+  virtual Eval_Value eval_value(const Element_With_Context< Attic< Relation_Skeleton > >& data, const std::string* key) const
+      { return Eval_Value(eval(data, key)); }
+  virtual Eval_Value eval_value(const Element_With_Context< Area_Skeleton >& data, const std::string* key) const
+      { return Eval_Value(eval(data, key)); }
+  virtual Eval_Value eval_value(const Element_With_Context< Derived_Skeleton >& data, const std::string* key) const
+      { return Eval_Value(eval(data, key)); }
+
+  virtual Eval_Value eval_value(uint pos, const Element_With_Context< Way_Skeleton >& data, const std::string* key) const
+      { return Eval_Value(eval(pos, data, key)); }
+  virtual Eval_Value eval_value(uint pos, const Element_With_Context< Attic< Way_Skeleton > >& data, const std::string* key) const
+      { return Eval_Value(eval(pos, data, key)); }
+  virtual Eval_Value eval_value(uint pos, const Element_With_Context< Relation_Skeleton >& data, const std::string* key) const
+      { return Eval_Value(eval(pos, data, key)); }
+  virtual Eval_Value eval_value(uint pos, const Element_With_Context< Attic< Relation_Skeleton > >& data, const std::string* key) const
+      { return Eval_Value(eval(pos, data, key)); }
 };
 
 
 struct Const_Eval_Task final : public Eval_Task
 {
-  Const_Eval_Task(const std::string& value_) : value(value_) {}
+  Const_Eval_Task(const std::string& value_) : value(value_)
+  {
+    // Parse once such that all copies carry the parsed numbers
+    int64 value_l = 0;
+    value.try_int64(value_l);
+    double value_d = 0;
+    value.try_double(value_d);
+  }
 
-  virtual std::string eval(const std::string* key) const { return value; }
+  virtual std::string eval(const std::string*) const { return value.str(); }
+  virtual Eval_Value eval_value(const std::string*) const { return value; }
+  virtual Eval_Value eval_value(const Element_With_Context< Node_Skeleton >&, const std::string*) const
+      { return value; }
+  virtual Eval_Value eval_value(const Element_With_Context< Attic< Node_Skeleton > >&, const std::string*) const
+      { return value; }
+  virtual Eval_Value eval_value(const Element_With_Context< Way_Skeleton >&, const std::string*) const
+      { return value; }
+  virtual Eval_Value eval_value(const Element_With_Context< Attic< Way_Skeleton > >&, const std::string*) const
+      { return value; }
+  virtual Eval_Value eval_value(const Element_With_Context< Relation_Skeleton >&, const std::string*) const
+      { return value; }
+  virtual Eval_Value eval_value(const Element_With_Context< Attic< Relation_Skeleton > >&, const std::string*) const
+      { return value; }
+  virtual Eval_Value eval_value(const Element_With_Context< Area_Skeleton >&, const std::string*) const
+      { return value; }
+  virtual Eval_Value eval_value(const Element_With_Context< Derived_Skeleton >&, const std::string*) const
+      { return value; }
+  virtual Eval_Value eval_value(uint, const Element_With_Context< Way_Skeleton >&, const std::string*) const
+      { return value; }
+  virtual Eval_Value eval_value(uint, const Element_With_Context< Attic< Way_Skeleton > >&, const std::string*) const
+      { return value; }
+  virtual Eval_Value eval_value(uint, const Element_With_Context< Relation_Skeleton >&, const std::string*) const
+      { return value; }
+  virtual Eval_Value eval_value(uint, const Element_With_Context< Attic< Relation_Skeleton > >&, const std::string*) const
+      { return value; }
 
 private:
-  std::string value;
+  Eval_Value value;
 };
 
 
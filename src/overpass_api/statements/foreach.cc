@@ -142,6 +142,23 @@ void loop_over_area_elements(const std::map< Index, std::vector< Area_Skeleton >
 }
 
 
+namespace
+{
+  // Releases the batched results of the substatements also if the loop is left by an exception,
+  // because the statements may be reused for another query
+  struct Batch_Guard
+  {
+    ~Batch_Guard()
+    {
+      for (std::vector< Statement* >::iterator it = prepared.begin(); it != prepared.end(); ++it)
+        (*it)->clear_batch();
+    }
+
+    std::vector< Statement* > prepared;
+  };
+}
+
+
 void Foreach_Statement::execute(Resource_Manager& rman)
 {
   Set base_result_set;
@@ -153,6 +170,9 @@ void Foreach_Statement::execute(Resource_Manager& rman)
   if (!base_set)
     base_set = &base_result_set;
 
+  Batch_Guard batch_guard;
+  prepare_batches(substatements, rman, get_result_name(), *base_set, batch_guard.prepared);
+
   loop_over_elements(base_set->nodes, rman, substatements, input, get_result_name());
   loop_over_elements(base_set->attic_nodes, rman, substatements, input, get_result_name());
   loop_over_elements(base_set->ways, rman, substatements, input, get_result_name());
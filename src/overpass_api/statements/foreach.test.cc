@@ -24,6 +24,7 @@
 #include "foreach.h"
 #include "id_query.h"
 #include "print.h"
+#include "recurse.h"
 #include "testing_tools.h"
 
 
@@ -84,6 +85,41 @@ Resource_Manager& fill_loop_set
   return rman;
 }
 
+// The substatements of tests 5 and 6. The second recursion replaces the loop set,
+// hence the loop prepares no batch for the last recursion.
+std::vector< Statement* > create_recursions(Parsed_Query& global_settings)
+{
+  std::vector< Statement* > result;
+  result.push_back(new Recurse_Statement(0, Attr()("type", "up")("into", "up").kvs(), global_settings));
+  result.push_back(new Print_Statement(0, Attr()("from", "up").kvs(), global_settings));
+  result.push_back(new Recurse_Statement(0, Attr()("type", "down").kvs(), global_settings));
+  result.push_back(new Print_Statement(0, Attr().kvs(), global_settings));
+  result.push_back(new Recurse_Statement(0, Attr()("type", "up").kvs(), global_settings));
+  result.push_back(new Print_Statement(0, Attr().kvs(), global_settings));
+  return result;
+}
+
+
+// Executes the statements once per element of the set, with the element as the only content of "_"
+template< typename Index, typename Object >
+void execute_per_element(const Set& loop_set, std::map< Index, std::vector< Object > > Set::* elems,
+    Resource_Manager& rman, const std::vector< Statement* >& stmts)
+{
+  for (typename std::map< Index, std::vector< Object > >::const_iterator it = (loop_set.*elems).begin();
+      it != (loop_set.*elems).end(); ++it)
+  {
+    for (typename std::vector< Object >::const_iterator it2 = it->second.begin(); it2 != it->second.end(); ++it2)
+    {
+      Set single;
+      (single.*elems)[it->first].push_back(*it2);
+      rman.swap_set("_", single);
+      for (std::vector< Statement* >::const_iterator it_stmt = stmts.begin(); it_stmt != stmts.end(); ++it_stmt)
+        (*it_stmt)->execute(rman);
+    }
+  }
+}
+
+
 int main(int argc, char* args[])
 {
   if (argc < 5)
@@ -143,6 +179,33 @@ int main(int argc, char* args[])
       Foreach_Statement(0, Attr()("from", "A")("into", "B").kvs(), global_settings).execute(rman);
       Print_Statement(0, Attr()("from", "A").kvs(), global_settings).execute(rman);
     }
+    if ((test_to_execute == "") || (test_to_execute == "5"))
+    {
+      Nonsynced_Transaction transaction(false, false, args[3], "");
+      Resource_Manager rman(transaction, &global_settings);
+      fill_loop_set(rman, "_", pattern_size, global_node_offset, transaction);
+
+      Foreach_Statement stmt(0, Attr().kvs(), global_settings);
+      std::vector< Statement* > substatements = create_recursions(global_settings);
+      for (std::vector< Statement* >::const_iterator it = substatements.begin(); it != substatements.end(); ++it)
+        stmt_cont.add_stmt(*it, &stmt);
+      stmt.execute(rman);
+    }
+    if ((test_to_execute == "") || (test_to_execute == "6"))
+    {
+      // Same as test 5, but without loop such that no statement is batched
+      Nonsynced_Transaction transaction(false, false, args[3], "");
+      Resource_Manager rman(transaction, &global_settings);
+      fill_loop_set(rman, "A", pattern_size, global_node_offset, transaction);
+      Set loop_set = *rman.get_set("A");
+
+      std::vector< Statement* > stmts = create_recursions(global_settings);
+      execute_per_element(loop_set, &Set::nodes, rman, stmts);
+      execute_per_element(loop_set, &Set::ways, rman, stmts);
+      execute_per_element(loop_set, &Set::relations, rman, stmts);
+      for (std::vector< Statement* >::const_iterator it = stmts.begin(); it != stmts.end(); ++it)
+        delete *it;
+    }
   }
   catch (File_Error e)
   {
@@ -303,13 +303,35 @@ Id_Query_Statement::Id_Query_Statement
     add_static_error(temp.str());
   }
 
-  uint64 ref = atoll(attributes["ref"].c_str());
+  for (std::map< std::string, std::string >::iterator it = attributes.begin();
+      it != attributes.end(); ++it)
+  {
+    if (it->first == "ref" || it->first == "lower" || it->first == "upper" || it->first.find("ref_") == 0)
+      ref_attributes.insert(*it);
+  }
+
+  if (!set_refs())
+  {
+    std::ostringstream temp;
+    temp<<"For the attribute \"ref\" of the element \"id-query\""
+        <<" the only allowed values are positive integers.";
+    add_static_error(temp.str());
+  }
+}
+
+
+bool Id_Query_Statement::set_refs()
+{
+  bool valid = true;
+  refs.clear();
+
+  uint64 ref = atoll(ref_attributes["ref"].c_str());
 
   if (ref > 0)
     refs.push_back(ref);
 
-  for (std::map< std::string, std::string >::iterator it = attributes.begin();
-      it != attributes.end(); ++it)
+  for (std::map< std::string, std::string >::iterator it = ref_attributes.begin();
+      it != ref_attributes.end(); ++it)
   {
     if (it->first.find("ref_") == 0)
     {
@@ -319,18 +341,13 @@ Id_Query_Statement::Id_Query_Statement
     }
   }
 
-  uint64 lower = atoll(attributes["lower"].c_str());
-  uint64 upper = atoll(attributes["upper"].c_str());
+  uint64 lower = atoll(ref_attributes["lower"].c_str());
+  uint64 upper = atoll(ref_attributes["upper"].c_str());
 
   if (ref <= 0)
   {
     if (lower == 0 || upper == 0)
-    {
-      std::ostringstream temp;
-      temp<<"For the attribute \"ref\" of the element \"id-query\""
-	  <<" the only allowed values are positive integers.";
-      add_static_error(temp.str());
-    }
+      valid = false;
     ++upper;
   }
   else
@@ -347,6 +364,32 @@ Id_Query_Statement::Id_Query_Statement
 
   std::sort(refs.begin(), refs.end());
   refs.erase(std::unique(refs.begin(), refs.end()), refs.end());
+
+  return valid;
+}
+
+
+bool Id_Query_Statement::bind_parameters(const std::map< std::string, std::string >& attributes)
+{
+  std::map< std::string, std::string > old_attributes = ref_attributes;
+
+  for (std::map< std::string, std::string >::const_iterator it = attributes.begin(); it != attributes.end(); ++it)
+  {
+    std::map< std::string, std::string >::iterator rit = ref_attributes.find(it->first);
+    if (rit == ref_attributes.end())
+    {
+      ref_attributes.swap(old_attributes);
+      return false;
+    }
+    rit->second = it->second;
+  }
+
+  if (set_refs())
+    return true;
+
+  ref_attributes.swap(old_attributes);
+  set_refs();
+  return false;
 }
 
 
@@ -53,6 +53,7 @@ class Id_Query_Statement final : public Output_Statement
     static Criterion_Maker criterion_maker;
 
     virtual Query_Constraint* get_query_constraint();
+    virtual bool bind_parameters(const std::map< std::string, std::string >& attributes);
 
     const std::vector< uint64 >& get_refs() { return refs; }
     int get_type() const { return type; }
@@ -107,10 +108,14 @@ class Id_Query_Statement final : public Output_Statement
   private:
     int type;
 
+    // The attributes ref, ref_*, lower and upper as given
+    std::map< std::string, std::string > ref_attributes;
     std::vector< uint64 > refs;
     std::vector< Query_Constraint* > constraints;
 
     static int area_query_ref_counter_;
+
+    bool set_refs();
 };
 
 #endif
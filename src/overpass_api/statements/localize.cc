@@ -461,7 +461,7 @@ struct Derived_Structure_Builder
 {
   Derived_Structure_Builder(Resource_Manager& rman,
       const std::string& name, Opaque_Geometry* geometry,
-      const std::vector< std::pair< std::string, std::string > >* tags)
+      const Interned_Tags* tags)
       : target(name, 0ull)
   {
     target.id = rman.get_global_settings().dispense_derived_id();
@@ -469,11 +469,10 @@ struct Derived_Structure_Builder
 
     if (tags)
     {
-      for (std::vector< std::pair< std::string, std::string > >::const_iterator it_tag = tags->begin();
-          it_tag != tags->end(); ++it_tag)
+      for (Interned_Tags::const_iterator it_tag = tags->begin(); it_tag != tags->end(); ++it_tag)
         target.tags.push_back(std::make_pair(
-            it_tag->first.empty() ? "" : it_tag->first[0] == '_' ? "_" + it_tag->first : it_tag->first,
-            it_tag->second));
+            it_tag->first->empty() ? "" : (*it_tag->first)[0] == '_' ? "_" + *it_tag->first : *it_tag->first,
+            *it_tag->second));
     }
   }
 
@@ -225,6 +225,21 @@ void Osm_Script_Statement::add_statement(Statement* statement, std::string text)
 }
 
 
+bool Osm_Script_Statement::bind_parameters(const std::map< std::string, std::string >& attributes)
+{
+  // Only the date of a query without diff can be replaced
+  if (comparison_timestamp > 0 || attributes.size() != 1 || attributes.begin()->first != "date")
+    return false;
+
+  uint64 timestamp = Timestamp(attributes.begin()->second).timestamp;
+  if (timestamp == 0)
+    return false;
+
+  desired_timestamp = timestamp;
+  return true;
+}
+
+
 void Osm_Script_Statement::execute(Resource_Manager& rman)
 {
   rman.set_limits(max_allowed_time, max_allowed_space);
@@ -37,6 +37,7 @@ class Osm_Script_Statement : public Statement
     virtual std::string get_name() const { return "osm-script"; }
     virtual std::string get_result_name() const { return ""; }
     virtual void execute(Resource_Manager& rman);
+    virtual bool bind_parameters(const std::map< std::string, std::string >& attributes);
 
     static Generic_Statement_Maker< Osm_Script_Statement > statement_maker;
 
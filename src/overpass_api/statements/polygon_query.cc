@@ -354,19 +354,26 @@ void Polygon_Query_Statement::collect_nodes(std::map< Uint32_Index, std::vector<
   std::vector< Aligned_Segment >::const_iterator area_it = segments.begin();
   typename std::map< Uint32_Index, std::vector< Node_Skeleton > >::iterator nodes_it = nodes.begin();
 
+  // Both keep their capacity from index to index
+  std::vector< std::pair< uint32, int32 > > ilat_ilon_pairs;
+  Area_Block_Batch_Check batch_check;
+
   uint32 current_idx(0);
 
   while (area_it != segments.end())
   {
     current_idx = area_it->ll_upper_;
 
-    std::vector< Area_Block > areas;
+    // Each segment is a block of two coordinates
+    ilat_ilon_pairs.clear();
     while (area_it != segments.end() && area_it->ll_upper_ == current_idx)
     {
-      Area_Block block;
-      block.coors().push_back(area_it->ll_lower_a);
-      block.coors().push_back(area_it->ll_lower_b);
-      areas.push_back(block);
+      ilat_ilon_pairs.push_back(std::make_pair(
+          ::ilat((area_it->ll_lower_a >> 32) & 0xff, area_it->ll_lower_a & 0xffffffffull),
+          ::ilon((area_it->ll_lower_a >> 32) & 0xff, area_it->ll_lower_a & 0xffffffffull)));
+      ilat_ilon_pairs.push_back(std::make_pair(
+          ::ilat((area_it->ll_lower_b >> 32) & 0xff, area_it->ll_lower_b & 0xffffffffull),
+          ::ilon((area_it->ll_lower_b >> 32) & 0xff, area_it->ll_lower_b & 0xffffffffull)));
       ++area_it;
     }
 
@@ -378,7 +385,7 @@ void Polygon_Query_Statement::collect_nodes(std::map< Uint32_Index, std::vector<
     while (nodes_it != nodes.end() &&
         (nodes_it->first.val() & 0xffffff00) == current_idx)
     {
-      std::vector< Node_Skeleton > into;
+      batch_check.clear_coords();
       for (typename std::vector< Node_Skeleton >::const_iterator iit = nodes_it->second.begin();
           iit != nodes_it->second.end(); ++iit)
       {
@@ -386,22 +393,19 @@ void Polygon_Query_Statement::collect_nodes(std::map< Uint32_Index, std::vector<
             + 91.0)*10000000+0.5);
         int32 ilon(::lon(nodes_it->first.val(), iit->ll_lower)*10000000
             + (::lon(nodes_it->first.val(), iit->ll_lower) > 0 ? 0.5 : -0.5));
+        batch_check.add_coord(ilat, ilon);
+      }
 
-        int inside = 0;
-        for (std::vector< Area_Block >::const_iterator it = areas.begin();
-	     it != areas.end(); ++it)
-        {
-	  int check(Coord_Query_Statement::check_area_block(current_idx, *it, ilat, ilon));
-	  if (check == Coord_Query_Statement::HIT && add_border)
-	  {
-	    inside = 1;
-	    break;
-	  }
-	  else if (check != 0)
-	    inside ^= check;
-        }
-        if (inside)
-	  into.push_back(*iit);
+      batch_check.start_area();
+      for (uint32 i = 0; i < ilat_ilon_pairs.size(); i += 2)
+        batch_check.add_block(current_idx, ilat_ilon_pairs.data() + i, ilat_ilon_pairs.data() + i + 2, add_border);
+      batch_check.finish_area();
+
+      std::vector< Node_Skeleton > into;
+      for (uint32 i = 0; i < nodes_it->second.size(); ++i)
+      {
+        if (batch_check.found(i))
+          into.push_back(nodes_it->second[i]);
       }
       nodes_it->second.swap(into);
       ++nodes_it;
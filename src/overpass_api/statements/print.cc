@@ -278,7 +278,7 @@ Extra_Data::~Extra_Data()
 
 
 void print_item(Extra_Data& extra_data, Output_Handler& output, uint32 ll_upper, const Node_Skeleton& skel,
-                    const std::vector< std::pair< std::string, std::string > >* tags = 0,
+                    const Interned_Tags* tags = 0,
                     const OSM_Element_Metadata_Skeleton< Node_Skeleton::Id_Type >* meta = 0)
 {
   output.print_item(skel, Point_Geometry(::lat(ll_upper, skel.ll_lower), ::lon(ll_upper, skel.ll_lower)),
@@ -287,7 +287,7 @@ void print_item(Extra_Data& extra_data, Output_Handler& output, uint32 ll_upper,
 
 
 void print_item(Extra_Data& extra_data, Output_Handler& output, uint32 ll_upper, const Way_Skeleton& skel,
-                    const std::vector< std::pair< std::string, std::string > >* tags = 0,
+                    const Interned_Tags* tags = 0,
                     const OSM_Element_Metadata_Skeleton< Way_Skeleton::Id_Type >* meta = 0)
 {
   Geometry_From_Quad_Coords broker;
@@ -298,7 +298,7 @@ void print_item(Extra_Data& extra_data, Output_Handler& output, uint32 ll_upper,
 
 
 void print_item(Extra_Data& extra_data, Output_Handler& output, uint32 ll_upper, const Attic< Way_Skeleton >& skel,
-                    const std::vector< std::pair< std::string, std::string > >* tags = 0,
+                    const Interned_Tags* tags = 0,
                     const OSM_Element_Metadata_Skeleton< Way_Skeleton::Id_Type >* meta = 0)
 {
   Geometry_From_Quad_Coords broker;
@@ -309,7 +309,7 @@ void print_item(Extra_Data& extra_data, Output_Handler& output, uint32 ll_upper,
 
 
 void print_item(Extra_Data& extra_data, Output_Handler& output, uint32 ll_upper, const Relation_Skeleton& skel,
-                    const std::vector< std::pair< std::string, std::string > >* tags = 0,
+                    const Interned_Tags* tags = 0,
                     const OSM_Element_Metadata_Skeleton< Relation_Skeleton::Id_Type >* meta = 0)
 {
   Geometry_From_Quad_Coords broker;
@@ -320,7 +320,7 @@ void print_item(Extra_Data& extra_data, Output_Handler& output, uint32 ll_upper,
 
 
 void print_item(Extra_Data& extra_data, Output_Handler& output, uint32 ll_upper, const Attic< Relation_Skeleton >& skel,
-                    const std::vector< std::pair< std::string, std::string > >* tags = 0,
+                    const Interned_Tags* tags = 0,
                     const OSM_Element_Metadata_Skeleton< Relation_Skeleton::Id_Type >* meta = 0)
 {
   Geometry_From_Quad_Coords broker;
@@ -331,7 +331,7 @@ void print_item(Extra_Data& extra_data, Output_Handler& output, uint32 ll_upper,
 
 
 void print_item(Extra_Data& extra_data, Output_Handler& output, uint32 ll_upper, const Area_Skeleton& skel,
-                    const std::vector< std::pair< std::string, std::string > >* tags = 0,
+                    const Interned_Tags* tags = 0,
                     const OSM_Element_Metadata_Skeleton< Area_Skeleton::Id_Type >* meta = 0)
 {
   Derived_Skeleton derived("area", Uint64(skel.id.val()));
@@ -340,7 +340,7 @@ void print_item(Extra_Data& extra_data, Output_Handler& output, uint32 ll_upper,
 
 
 void print_item(Extra_Data& extra_data, Output_Handler& output, uint32 ll_upper, const Derived_Structure& skel,
-                    const std::vector< std::pair< std::string, std::string > >* tags = 0,
+                    const Interned_Tags* tags = 0,
                     const OSM_Element_Metadata_Skeleton< Derived_Skeleton::Id_Type >* meta = 0)
 {
   if (skel.get_geometry())
@@ -565,7 +565,7 @@ void by_id
 
 
 template< class Index, class Object >
-void collect_metadata(std::set< OSM_Element_Metadata_Skeleton< typename Object::Id_Type > >& metadata,
+void collect_metadata(std::vector< OSM_Element_Metadata_Skeleton< typename Object::Id_Type > >& metadata,
 		      const std::map< Index, std::vector< Object > >& items,
 		      typename Object::Id_Type lower_id_bound, typename Object::Id_Type upper_id_bound,
 		      Meta_Collector< Index, typename Object::Id_Type >& meta_printer)
@@ -581,15 +581,47 @@ void collect_metadata(std::set< OSM_Element_Metadata_Skeleton< typename Object::
 	const OSM_Element_Metadata_Skeleton< typename Object::Id_Type >* meta
 	    = meta_printer.get(it->first, it2->id);
 	if (meta)
-	  metadata.insert(*meta);
+	  metadata.push_back(*meta);
       }
     }
   }
+  std::sort(metadata.begin(), metadata.end());
 }
 
 
+/* Collects the metadata of the elements items_by_id[begin] to items_by_id[end-1].
+ * Only the indices of these elements are read from the meta file. */
 template< class Index, class Object >
-void collect_metadata(std::set< OSM_Element_Metadata_Skeleton< typename Object::Id_Type > >& metadata,
+void collect_metadata(std::vector< OSM_Element_Metadata_Skeleton< typename Object::Id_Type > >& metadata,
+		      const std::vector< std::pair< const Object*, uint32 > >& items_by_id,
+		      uint32 begin, uint32 end, Transaction& transaction, const File_Properties* meta_file_prop)
+{
+  std::vector< std::pair< Index, typename Object::Id_Type > > refs;
+  refs.reserve(end - begin);
+  for (uint32 i = begin; i < end; ++i)
+    refs.push_back(std::make_pair(Index(items_by_id[i].second), items_by_id[i].first->id));
+  std::sort(refs.begin(), refs.end());
+
+  std::set< Index > used_indices;
+  for (typename std::vector< std::pair< Index, typename Object::Id_Type > >::const_iterator
+      it = refs.begin(); it != refs.end(); ++it)
+    used_indices.insert(used_indices.end(), it->first);
+
+  Meta_Collector< Index, typename Object::Id_Type > meta_printer(used_indices, transaction, meta_file_prop);
+  metadata.reserve(refs.size());
+  for (typename std::vector< std::pair< Index, typename Object::Id_Type > >::const_iterator
+      it = refs.begin(); it != refs.end(); ++it)
+  {
+    const OSM_Element_Metadata_Skeleton< typename Object::Id_Type >* meta = meta_printer.get(it->first, it->second);
+    if (meta)
+      metadata.push_back(*meta);
+  }
+  std::sort(metadata.begin(), metadata.end());
+}
+
+
+template< class Index, class Object >
+void collect_metadata(std::vector< OSM_Element_Metadata_Skeleton< typename Object::Id_Type > >& metadata,
                       const std::map< Index, std::vector< Attic< Object > > >& items,
                       typename Object::Id_Type lower_id_bound, typename Object::Id_Type upper_id_bound,
                       Attic_Meta_Collector< Index, Object >& meta_printer)
@@ -605,21 +637,22 @@ void collect_metadata(std::set< OSM_Element_Metadata_Skeleton< typename Object::
         const OSM_Element_Metadata_Skeleton< typename Object::Id_Type >* meta
             = meta_printer.get(it->first, it2->id, it2->timestamp);
         if (meta)
-          metadata.insert(*meta);
+          metadata.push_back(*meta);
       }
     }
   }
+  std::sort(metadata.begin(), metadata.end());
 }
 
 
 template< typename Id_Type >
-typename std::set< OSM_Element_Metadata_Skeleton< Id_Type > >::const_iterator
+typename std::vector< OSM_Element_Metadata_Skeleton< Id_Type > >::const_iterator
     find_matching_metadata
-    (const std::set< OSM_Element_Metadata_Skeleton< Id_Type > >& metadata,
+    (const std::vector< OSM_Element_Metadata_Skeleton< Id_Type > >& metadata,
      Id_Type ref, uint64 timestamp)
 {
-  typename std::set< OSM_Element_Metadata_Skeleton< Id_Type > >::iterator it
-      = metadata.lower_bound(OSM_Element_Metadata_Skeleton< Id_Type >(ref, timestamp));
+  typename std::vector< OSM_Element_Metadata_Skeleton< Id_Type > >::const_iterator it
+      = std::lower_bound(metadata.begin(), metadata.end(), OSM_Element_Metadata_Skeleton< Id_Type >(ref, timestamp));
   if (it == metadata.begin())
     return metadata.end();
   --it;
@@ -634,10 +667,12 @@ template< class Index, class Object >
 void tags_by_id
   (Extra_Data& extra_data, const std::map< Index, std::vector< Object > >& items,
    uint32 FLUSH_SIZE, Output_Handler& output,
-   Resource_Manager& rman, Meta_Collector< Index, typename Object::Id_Type >* meta_printer,
+   Resource_Manager& rman, Transaction& transaction, const File_Properties* meta_file_prop,
    Tag_Store< Index, Object >& tag_store, uint32 limit, uint32& element_count)
 {
   std::vector< std::pair< const Object*, uint32 > > items_by_id = collect_items_by_id(items);
+  std::map< uint32, std::vector< typename Object::Id_Type > > ids_by_coarse;
+  generate_ids_by_coarse(ids_by_coarse, items);
 
   // iterate over the result
   for (typename Object::Id_Type id_pos; id_pos < items_by_id.size(); id_pos += FLUSH_SIZE)
@@ -655,15 +690,13 @@ void tags_by_id
       ++upper_id_bound;
     }
 
-    tag_store.prefetch_chunk(items, lower_id_bound, upper_id_bound);
+    tag_store.prefetch_chunk(ids_by_coarse, lower_id_bound, upper_id_bound);
 
-    std::set< OSM_Element_Metadata_Skeleton< typename Object::Id_Type > > metadata;
-    if (meta_printer)
-    {
-      // collect metadata if required
-      collect_metadata(metadata, items, lower_id_bound, upper_id_bound, *meta_printer);
-      meta_printer->reset();
-    }
+    // collect metadata if required
+    std::vector< OSM_Element_Metadata_Skeleton< typename Object::Id_Type > > metadata;
+    if (meta_file_prop)
+      collect_metadata< Index >(metadata, items_by_id, id_pos.val(),
+          std::min((uint64)id_pos.val() + FLUSH_SIZE, (uint64)items_by_id.size()), transaction, meta_file_prop);
 
     // print the result
     for (typename Object::Id_Type i(id_pos);
@@ -671,8 +704,8 @@ void tags_by_id
     {
       if (++element_count > limit)
 	return;
-      typename std::set< OSM_Element_Metadata_Skeleton< typename Object::Id_Type > >::const_iterator meta_it
-          = metadata.lower_bound(OSM_Element_Metadata_Skeleton< typename Object::Id_Type >
+      typename std::vector< OSM_Element_Metadata_Skeleton< typename Object::Id_Type > >::const_iterator meta_it
+          = std::lower_bound(metadata.begin(), metadata.end(), OSM_Element_Metadata_Skeleton< typename Object::Id_Type >
               (items_by_id[i.val()].first->id));
       print_item(extra_data, output, items_by_id[i.val()].second, *(items_by_id[i.val()].first),
 		 tag_store.get(Index(items_by_id[i.val()].second), *items_by_id[i.val()].first),
@@ -695,6 +728,10 @@ void tags_by_id_attic
 
   Tag_Store< Index, Object > current_tag_store(transaction);
   Tag_Store< Index, Object > attic_tag_store(transaction);
+  std::map< uint32, std::vector< typename Object::Id_Type > > current_ids_by_coarse;
+  generate_ids_by_coarse(current_ids_by_coarse, current_items);
+  std::map< uint32, std::vector< Attic< typename Object::Id_Type > > > attic_ids_by_coarse;
+  generate_ids_by_coarse(attic_ids_by_coarse, attic_items);
 
   // formulate meta query if meta data shall be printed
   Meta_Collector< Index, typename Object::Id_Type > only_current_meta_printer
@@ -716,17 +753,17 @@ void tags_by_id_attic
       ++upper_id_bound;
     }
 
-    current_tag_store.prefetch_chunk(current_items, lower_id_bound, upper_id_bound);
-    attic_tag_store.prefetch_chunk(attic_items, lower_id_bound, upper_id_bound);
+    current_tag_store.prefetch_chunk(current_ids_by_coarse, lower_id_bound, upper_id_bound);
+    attic_tag_store.prefetch_chunk(attic_ids_by_coarse, lower_id_bound, upper_id_bound);
 
     // collect metadata if required
-    std::set< OSM_Element_Metadata_Skeleton< typename Object::Id_Type > > only_current_metadata;
+    std::vector< OSM_Element_Metadata_Skeleton< typename Object::Id_Type > > only_current_metadata;
     collect_metadata(only_current_metadata, current_items, lower_id_bound, upper_id_bound,
 		     only_current_meta_printer);
     only_current_meta_printer.reset();
 
     Attic_Meta_Collector< Index, Object > meta_printer(attic_items, transaction, extra_data.mode & Output_Mode::META);
-    std::set< OSM_Element_Metadata_Skeleton< typename Object::Id_Type > > attic_metadata;
+    std::vector< OSM_Element_Metadata_Skeleton< typename Object::Id_Type > > attic_metadata;
     collect_metadata(attic_metadata, attic_items, lower_id_bound, upper_id_bound, meta_printer);
 
     // print the result
@@ -737,9 +774,9 @@ void tags_by_id_attic
 	return;
       if (items_by_id[i.val()].timestamp == NOW)
       {
-        typename std::set< OSM_Element_Metadata_Skeleton< typename Object::Id_Type > >::const_iterator meta_it
-            = only_current_metadata.lower_bound(OSM_Element_Metadata_Skeleton< typename Object::Id_Type >
-                (items_by_id[i.val()].obj->id));
+        typename std::vector< OSM_Element_Metadata_Skeleton< typename Object::Id_Type > >::const_iterator meta_it
+            = std::lower_bound(only_current_metadata.begin(), only_current_metadata.end(),
+                OSM_Element_Metadata_Skeleton< typename Object::Id_Type >(items_by_id[i.val()].obj->id));
         print_item(extra_data, output, items_by_id[i.val()].idx.val(), *items_by_id[i.val()].obj,
 		 current_tag_store.get(items_by_id[i.val()].idx, *items_by_id[i.val()].obj),
 		 (meta_it != only_current_metadata.end() && meta_it->ref == items_by_id[i.val()].obj->id) ?
@@ -747,7 +784,7 @@ void tags_by_id_attic
       }
       else
       {
-        typename std::set< OSM_Element_Metadata_Skeleton< typename Object::Id_Type > >::const_iterator meta_it
+        typename std::vector< OSM_Element_Metadata_Skeleton< typename Object::Id_Type > >::const_iterator meta_it
             = find_matching_metadata(attic_metadata,
                   items_by_id[i.val()].obj->id, items_by_id[i.val()].timestamp);
         print_item(extra_data, output, items_by_id[i.val()].idx.val(),
@@ -772,9 +809,8 @@ void tags_by_id
     if (rman.get_desired_timestamp() == NOW)
     {
       Tag_Store< Index, Object > tag_store(*rman.get_transaction());
-      Meta_Collector< Index, typename Object::Id_Type > meta_printer(items, *rman.get_transaction(),
-          current_meta_file_properties< Object >());
-      tags_by_id(extra_data, items, FLUSH_SIZE, output, rman, &meta_printer, tag_store, limit, element_count);
+      tags_by_id(extra_data, items, FLUSH_SIZE, output, rman, *rman.get_transaction(),
+          current_meta_file_properties< Object >(), tag_store, limit, element_count);
     }
     else
       tags_by_id_attic(items, attic_items, extra_data, FLUSH_SIZE, output, rman, *rman.get_transaction(),
@@ -785,8 +821,8 @@ void tags_by_id
     if (rman.get_desired_timestamp() == NOW)
     {
       Tag_Store< Index, Object > tag_store(*rman.get_transaction());
-      tags_by_id(extra_data, items, FLUSH_SIZE, output, rman,
-          (Meta_Collector< Index, typename Object::Id_Type >*)0, tag_store, limit, element_count);
+      tags_by_id(extra_data, items, FLUSH_SIZE, output, rman, *rman.get_transaction(),
+          (const File_Properties*)0, tag_store, limit, element_count);
     }
     else
       tags_by_id_attic(items, attic_items, extra_data, FLUSH_SIZE, output, rman, *rman.get_transaction(),
@@ -795,6 +831,14 @@ void tags_by_id
 }
 
 
+// Tags and metadata are held in memory for at most this many elements at once
+uint32 print_chunk_size(Resource_Manager& rman, uint32 flush_size)
+{
+  int chunk_size = rman.get_global_settings().get_print_chunk_size();
+  return chunk_size > 0 ? std::min(flush_size, (uint32)chunk_size) : flush_size;
+}
+
+
 std::vector< std::pair< std::string, std::string > > make_count_tags(const Set& set, bool include_areas)
 {
   unsigned int num_nodes = count(set.nodes) + count(set.attic_nodes);
@@ -864,24 +908,23 @@ void Print_Statement::execute(Resource_Manager& rman)
   {
     if (mode & Output_Mode::TAGS)
     {
-      tags_by_id(extra_data, output_items->nodes, output_items->attic_nodes, mode, NODE_FLUSH_SIZE,
+      tags_by_id(extra_data, output_items->nodes, output_items->attic_nodes, mode, print_chunk_size(rman, NODE_FLUSH_SIZE),
 		 output_handler, rman, limit, element_count);
-      tags_by_id(extra_data, output_items->ways, output_items->attic_ways, mode, WAY_FLUSH_SIZE,
+      tags_by_id(extra_data, output_items->ways, output_items->attic_ways, mode, print_chunk_size(rman, WAY_FLUSH_SIZE),
 		 output_handler, rman, limit, element_count);
-      tags_by_id(extra_data, output_items->relations, output_items->attic_relations, mode, RELATION_FLUSH_SIZE,
+      tags_by_id(extra_data, output_items->relations, output_items->attic_relations, mode, print_chunk_size(rman, RELATION_FLUSH_SIZE),
 		 output_handler, rman, limit, element_count);
 
       if (rman.get_area_transaction())
       {
 	Tag_Store< Uint31_Index, Area_Skeleton > tag_store(*rman.get_transaction());
-	tags_by_id(extra_data, output_items->areas, AREA_FLUSH_SIZE, output_handler, rman,
-		   (Meta_Collector< Uint31_Index, Area_Skeleton::Id_Type >*)0,
-		   tag_store, limit, element_count);
+	tags_by_id(extra_data, output_items->areas, print_chunk_size(rman, AREA_FLUSH_SIZE), output_handler, rman,
+		   *rman.get_transaction(), (const File_Properties*)0, tag_store, limit, element_count);
       }
 
       Tag_Store< Uint31_Index, Derived_Structure > tag_store;
       tags_by_id(extra_data, output_items->deriveds, std::numeric_limits< uint32 >::max(), output_handler, rman,
-          (Meta_Collector< Uint31_Index, Derived_Structure::Id_Type >*)0, tag_store, limit, element_count);
+          *rman.get_transaction(), (const File_Properties*)0, tag_store, limit, element_count);
     }
     else
     {
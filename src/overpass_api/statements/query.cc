@@ -26,6 +26,7 @@
 #include "../data/filter_ids_by_tags.h"
 #include "../data/meta_collector.h"
 #include "../data/regular_expression.h"
+#include "../osm-backend/parallel_proc.h"
 #include "area_query.h"
 #include "bbox_query.h"
 #include "query.h"
@@ -501,7 +502,8 @@ std::vector< std::pair< Id_Type, Uint31_Index > > Query_Statement::collect_ids
 
       if (timestamp == NOW)
       {
-        std::set< std::pair< Tag_Index_Global, Tag_Index_Global > > range_req = get_k_req(krit->first);
+        std::set< std::pair< Tag_Index_Global, Tag_Index_Global > > range_req
+            = restrict_to_value_prefix(get_k_req(krit->first), *krit->second);
         new_ids = filter_id_list_fast<Id_Type>(tmp_ids, filtered,
 	    tags_db.range_begin(range_req.begin(), range_req.end()), tags_db.range_end(),
 		Trivial_Regex(), *krit->second, check_keys_late, last);
@@ -532,7 +534,7 @@ std::vector< std::pair< Id_Type, Uint31_Index > > Query_Statement::collect_ids
       if (timestamp == NOW)
       {
 	std::set< std::pair< Tag_Index_Global, Tag_Index_Global > > range_req
-	    = get_regk_req< Skeleton >(it->first, rman, *this);
+	    = restrict_to_value_prefix(get_regk_req< Skeleton >(it->first, rman, *this), *it->second);
 	new_ids = filter_id_list_fast<Id_Type>(tmp_ids, filtered,
 	    tags_db.range_begin(range_req.begin(), range_req.end()), tags_db.range_end(),
 	    *it->first, *it->second, check_keys_late, last);
@@ -670,7 +672,8 @@ IdSetHybrid<typename Id_Type::Id_Type> Query_Statement::collect_non_ids_hybrid
   {
     if (timestamp == NOW)
     {
-      std::set< std::pair< Tag_Index_Global, Tag_Index_Global > > range_req = get_k_req(knrit->first);
+      std::set< std::pair< Tag_Index_Global, Tag_Index_Global > > range_req
+          = restrict_to_value_prefix(get_k_req(knrit->first), *knrit->second);
       for (typename Block_Backend< Tag_Index_Global, Tag_Object_Global< Id_Type > >::Range_Iterator
           it2(tags_db.range_begin
           (Default_Range_Iterator< Tag_Index_Global >(range_req.begin()),
@@ -746,7 +749,8 @@ std::vector< Id_Type > Query_Statement::collect_non_ids
   {
     if (timestamp == NOW)
     {
-      std::set< std::pair< Tag_Index_Global, Tag_Index_Global > > range_req = get_k_req(knrit->first);
+      std::set< std::pair< Tag_Index_Global, Tag_Index_Global > > range_req
+          = restrict_to_value_prefix(get_k_req(knrit->first), *knrit->second);
       for (typename Block_Backend< Tag_Index_Global, Tag_Object_Global< Id_Type > >::Range_Iterator
           it2(tags_db.range_begin
           (Default_Range_Iterator< Tag_Index_Global >(range_req.begin()),
@@ -810,7 +814,8 @@ std::vector< Id_Type > Query_Statement::collect_non_ids
   for (std::vector< std::pair< std::string, Regular_Expression* > >::const_iterator knrit = key_nregexes.begin();
       knrit != key_nregexes.end(); ++knrit)
   {
-    std::set< std::pair< Tag_Index_Global, Tag_Index_Global > > range_req = get_k_req(knrit->first);
+    std::set< std::pair< Tag_Index_Global, Tag_Index_Global > > range_req
+        = restrict_to_value_prefix(get_k_req(knrit->first), *knrit->second);
     for (typename Block_Backend< Tag_Index_Global, Id_Type >::Range_Iterator
         it2(tags_db.range_begin
         (Default_Range_Iterator< Tag_Index_Global >(range_req.begin()),
@@ -1523,12 +1528,13 @@ template< typename Skeleton, typename Id_Type, typename Index >
 void Query_Statement::progress_1(std::vector< Id_Type >& ids, std::vector< Index >& range_vec,
                                  bool& invert_ids, uint64 timestamp,
                                  Answer_State& answer_state, Query_Filter_Strategy& check_keys_late,
+                                 bool check_values_late,
                                  const File_Properties& file_prop, const File_Properties& attic_file_prop,
                                  Resource_Manager& rman)
 {
   ids.clear();
   range_vec.clear();
-  if (!key_values.empty()
+  if ((!key_values.empty() && !check_values_late)
       || (check_keys_late != prefer_ranges
           && (!keys.empty() || !key_regexes.empty() || !regkey_regexes.empty())))
   {
@@ -1715,8 +1721,188 @@ std::set< std::pair< Index, Index > > intersect_ranges
 }
 
 
+namespace
+{
+  template< typename Index >
+  bool intersect_constraint_ranges(
+      const std::vector< Query_Constraint* >& constraints, Resource_Manager& rman,
+      bool (Query_Constraint::*get_ranges)(Resource_Manager&, std::set< std::pair< Index, Index > >&),
+      std::set< std::pair< Index, Index > >& ranges)
+  {
+    bool ranges_found = false;
+    for (std::vector< Query_Constraint* >::const_iterator it = constraints.begin(); it != constraints.end(); ++it)
+    {
+      std::set< std::pair< Index, Index > > range_req;
+      if (((*it)->*get_ranges)(rman, range_req))
+      {
+        if (ranges_found)
+          intersect_ranges(ranges, range_req).swap(ranges);
+        else
+          range_req.swap(ranges);
+        ranges_found = true;
+      }
+    }
+    return ranges_found;
+  }
+
+
+  bool repeats_a_key(const std::vector< std::pair< std::string, std::string > >& key_values)
+  {
+    std::set< std::string > keys;
+    for (std::vector< std::pair< std::string, std::string > >::const_iterator it = key_values.begin();
+        it != key_values.end(); ++it)
+    {
+      if (!keys.insert(it->first).second)
+        return true;
+    }
+    return false;
+  }
+
+
+  template< typename Index >
+  uint64 estimate_range_volume(
+      Resource_Manager& rman, const File_Properties& file_prop, const std::set< std::pair< Index, Index > >& ranges)
+  {
+    return estimate_read_volume(*(File_Blocks_Index< Index >*)rman.get_transaction()->data_index(&file_prop),
+        ranges.begin(), ranges.end());
+  }
+}
+
+
+void Query_Statement::estimate_tag_index_volume(const File_Properties& file_prop, Resource_Manager& rman,
+    uint64& values_volume, uint64& keys_volume) const
+{
+  File_Blocks_Index< Tag_Index_Global >& index
+      = *(File_Blocks_Index< Tag_Index_Global >*)rman.get_transaction()->data_index(&file_prop);
+
+  std::set< std::pair< Tag_Index_Global, Tag_Index_Global > > value_ranges;
+  for (std::vector< std::pair< std::string, std::string > >::const_iterator it = key_values.begin();
+      it != key_values.end(); ++it)
+    value_ranges.insert(std::make_pair(
+        Tag_Index_Global(it->first, it->second), Tag_Index_Global(it->first, it->second + '\0')));
+  values_volume += estimate_read_volume(index, value_ranges.begin(), value_ranges.end());
+
+  if (!regkey_regexes.empty())
+  {
+    keys_volume += estimate_read_volume(index);
+    return;
+  }
+
+  std::set< std::string > key_set(keys.begin(), keys.end());
+  for (std::vector< std::pair< std::string, std::string > >::const_iterator it = key_nvalues.begin();
+      it != key_nvalues.end(); ++it)
+    key_set.insert(it->first);
+
+  // All values of a key are between the empty value of the key and the smallest following key
+  std::set< std::pair< Tag_Index_Global, Tag_Index_Global > > key_ranges;
+  for (std::set< std::string >::const_iterator it = key_set.begin(); it != key_set.end(); ++it)
+    key_ranges.insert(std::make_pair(Tag_Index_Global(*it, ""), Tag_Index_Global(*it + '\0', "")));
+
+  // Regular expressions with a prefix need only the values with that prefix
+  for (std::vector< std::pair< std::string, Regular_Expression* > >::const_iterator it = key_regexes.begin();
+      it != key_regexes.end(); ++it)
+  {
+    std::set< std::pair< Tag_Index_Global, Tag_Index_Global > > ranges
+        = restrict_to_value_prefix(get_k_req(it->first), *it->second);
+    key_ranges.insert(ranges.begin(), ranges.end());
+  }
+  for (std::vector< std::pair< std::string, Regular_Expression* > >::const_iterator it = key_nregexes.begin();
+      it != key_nregexes.end(); ++it)
+  {
+    std::set< std::pair< Tag_Index_Global, Tag_Index_Global > > ranges
+        = restrict_to_value_prefix(get_k_req(it->first), *it->second);
+    key_ranges.insert(ranges.begin(), ranges.end());
+  }
+  keys_volume += estimate_read_volume(index, key_ranges.begin(), key_ranges.end());
+}
+
+
+void Query_Statement::collect_constraint_ranges(Resource_Manager& rman, Constraint_Ranges& ranges)
+{
+  if (type & QUERY_NODE)
+    ranges.nodes_found = intersect_constraint_ranges(constraints, rman,
+        static_cast< bool (Query_Constraint::*)(
+            Resource_Manager&, std::set< std::pair< Uint32_Index, Uint32_Index > >&) >(
+                &Query_Constraint::get_ranges), ranges.nodes);
+  if (type & QUERY_WAY)
+    ranges.ways_found = intersect_constraint_ranges(
+        constraints, rman, &Query_Constraint::get_way_ranges, ranges.ways);
+  if (type & QUERY_RELATION)
+    ranges.relations_found = intersect_constraint_ranges(
+        constraints, rman, &Query_Constraint::get_relation_ranges, ranges.relations);
+}
+
+
+Query_Filter_Strategy Query_Statement::choose_access_path(
+    Resource_Manager& rman, uint64 timestamp, const Constraint_Ranges& ranges,
+    Query_Filter_Strategy check_keys_late, bool& check_values_late)
+{
+  check_values_late = false;
+
+  // The estimates cover only the current data and the element types with a global tag index
+  if (check_keys_late == ids_required || timestamp != NOW || (type & (QUERY_DERIVED | QUERY_AREA))
+      || (key_values.empty() && keys.empty() && key_regexes.empty() && regkey_regexes.empty()
+          && key_nvalues.empty() && key_nregexes.empty()))
+    return check_keys_late;
+
+  uint64 range_volume = 0;
+  uint64 values_volume = 0;
+  uint64 keys_volume = 0;
+
+  if (type & QUERY_NODE)
+  {
+    if (!ranges.nodes_found)
+      return check_keys_late;
+    range_volume += estimate_range_volume(rman, rman.get_global_settings().get_use_nodes_tagged()
+        ? *osm_base_settings().NODES_TAGGED : *osm_base_settings().NODES, ranges.nodes);
+    estimate_tag_index_volume(*osm_base_settings().NODE_TAGS_GLOBAL, rman, values_volume, keys_volume);
+  }
+  if (type & QUERY_WAY)
+  {
+    if (!ranges.ways_found)
+      return check_keys_late;
+    range_volume += estimate_range_volume(rman, *osm_base_settings().WAYS, ranges.ways);
+    estimate_tag_index_volume(*osm_base_settings().WAY_TAGS_GLOBAL, rman, values_volume, keys_volume);
+  }
+  if (type & QUERY_RELATION)
+  {
+    if (!ranges.relations_found)
+      return check_keys_late;
+    range_volume += estimate_range_volume(rman, *osm_base_settings().RELATIONS, ranges.relations);
+    estimate_tag_index_volume(*osm_base_settings().RELATION_TAGS_GLOBAL, rman, values_volume, keys_volume);
+  }
+
+  // Even the key-value pairs are cheaper to check on the elements from the ranges.
+  // The late tag filter holds only one value per key, hence a repeated key needs the tag index.
+  if (!key_values.empty() && range_volume < values_volume && !repeats_a_key(key_values))
+  {
+    check_values_late = true;
+    return prefer_ranges;
+  }
+
+  if (keys_volume == 0)
+    return check_keys_late;
+  return keys_volume < range_volume ? ids_useful : prefer_ranges;
+}
+
+
+std::vector< Query_Constraint* > Query_Statement::order_filters(Resource_Manager& rman)
+{
+  std::vector< std::pair< uint64, uint > > efforts;
+  for (uint i = 0; i < constraints.size(); ++i)
+    efforts.push_back(std::make_pair(constraints[i]->estimate_filter_effort(rman), i));
+  std::sort(efforts.begin(), efforts.end());
+
+  std::vector< Query_Constraint* > result;
+  for (std::vector< std::pair< uint64, uint > >::const_iterator it = efforts.begin(); it != efforts.end(); ++it)
+    result.push_back(constraints[it->second]);
+  return result;
+}
+
+
 void Query_Statement::apply_all_filters(
-    Resource_Manager& rman, uint64 timestamp, Query_Filter_Strategy check_keys_late, Set& into)
+    Resource_Manager& rman, uint64 timestamp, Query_Filter_Strategy check_keys_late,
+    const std::vector< Query_Constraint* >& filter_order, Set& into)
 {
   set_progress(5);
   rman.health_check(*this);
@@ -1728,35 +1914,61 @@ void Query_Statement::apply_all_filters(
   set_progress(6);
   rman.health_check(*this);
 
-  filter_attic_elements(rman, timestamp, into.nodes, into.attic_nodes);
-  filter_attic_elements(rman, timestamp, into.ways, into.attic_ways);
-  filter_attic_elements(rman, timestamp, into.relations, into.attic_relations);
+  // Nodes, ways, and relations live in different files and different members of the set.
+  // Hence the per-type passes are independent and can run in parallel.
+  int query_threads = rman.get_global_settings().get_query_threads();
+  std::vector< std::function< void() > > tasks;
+
+  if (timestamp != NOW)
+  {
+    tasks.push_back([&]() { filter_attic_elements(rman, timestamp, into.nodes, into.attic_nodes); });
+    tasks.push_back([&]() { filter_attic_elements(rman, timestamp, into.ways, into.attic_ways); });
+    tasks.push_back([&]() { filter_attic_elements(rman, timestamp, into.relations, into.attic_relations); });
+    process_package(tasks, query_threads);
+    tasks.clear();
+  }
 
   set_progress(7);
   rman.health_check(*this);
 
   if (check_keys_late == prefer_ranges)
   {
-    filter_by_tags(into.nodes, &into.attic_nodes, timestamp,
-                   *osm_base_settings().NODE_TAGS_LOCAL, attic_settings().NODE_TAGS_LOCAL,
-		   rman, *rman.get_transaction());
-    filter_by_tags(into.ways, &into.attic_ways, timestamp,
-                   *osm_base_settings().WAY_TAGS_LOCAL, attic_settings().WAY_TAGS_LOCAL,
-		   rman, *rman.get_transaction());
-    filter_by_tags(into.relations, &into.attic_relations, timestamp,
-                   *osm_base_settings().RELATION_TAGS_LOCAL, attic_settings().RELATION_TAGS_LOCAL,
-		   rman, *rman.get_transaction());
+    tasks.push_back([&]()
+    {
+      filter_by_tags(into.nodes, &into.attic_nodes, timestamp,
+                     *osm_base_settings().NODE_TAGS_LOCAL, attic_settings().NODE_TAGS_LOCAL,
+                     rman, *rman.get_transaction());
+    });
+    tasks.push_back([&]()
+    {
+      filter_by_tags(into.ways, &into.attic_ways, timestamp,
+                     *osm_base_settings().WAY_TAGS_LOCAL, attic_settings().WAY_TAGS_LOCAL,
+                     rman, *rman.get_transaction());
+    });
+    tasks.push_back([&]()
+    {
+      filter_by_tags(into.relations, &into.attic_relations, timestamp,
+                     *osm_base_settings().RELATION_TAGS_LOCAL, attic_settings().RELATION_TAGS_LOCAL,
+                     rman, *rman.get_transaction());
+    });
     if (rman.get_area_transaction())
-      filter_by_tags(into.areas,
-                     *area_settings().AREA_TAGS_LOCAL,
-		     rman, *rman.get_transaction());
+      tasks.push_back([&]()
+      {
+        filter_by_tags(into.areas,
+                       *area_settings().AREA_TAGS_LOCAL,
+                       rman, *rman.get_transaction());
+      });
+
+    // Regular expressions cache their last match and cannot be shared between threads
+    process_package(tasks, key_regexes.empty() && regkey_regexes.empty() && key_nregexes.empty()
+        && regkey_nregexes.empty() ? query_threads : 1);
   }
 
   set_progress(8);
   rman.health_check(*this);
 
-  for (std::vector< Query_Constraint* >::iterator it = constraints.begin();
-      it != constraints.end(); ++it)
+  for (std::vector< Query_Constraint* >::const_iterator it = filter_order.begin();
+      it != filter_order.end(); ++it)
     (*it)->filter(*this, rman, into);
 }
 
@@ -1783,6 +1995,11 @@ void Query_Statement::execute(Resource_Manager& rman)
   Query_Filter_Strategy check_keys_late = ids_required;
   for (std::vector< Query_Constraint* >::iterator it = constraints.begin(); it != constraints.end(); ++it)
     check_keys_late = std::max(check_keys_late, (*it)->delivers_data(rman));
+  Constraint_Ranges constraint_ranges;
+  collect_constraint_ranges(rman, constraint_ranges);
+  bool check_values_late = false;
+  check_keys_late = choose_access_path(rman, timestamp, constraint_ranges, check_keys_late, check_values_late);
+  std::vector< Query_Constraint* > filter_order = order_filters(rman);
 
   {
     std::vector< Node::Id_Type > node_ids;
@@ -1801,21 +2018,21 @@ void Query_Statement::execute(Resource_Manager& rman)
     if (type & QUERY_NODE)
     {
       progress_1< Node_Skeleton, Node::Id_Type, Uint32_Index >(
-	  node_ids, range_vec_32, invert_ids, timestamp, node_answer_state, check_keys_late,
+	  node_ids, range_vec_32, invert_ids, timestamp, node_answer_state, check_keys_late, check_values_late,
           *osm_base_settings().NODE_TAGS_GLOBAL, *attic_settings().NODE_TAGS_GLOBAL, rman);
       collect_nodes(node_ids, invert_ids, node_answer_state, into, rman);
     }
     if (type & QUERY_WAY)
     {
       progress_1< Way_Skeleton, Way::Id_Type, Uint31_Index >(
-	  way_ids, way_range_vec_31, invert_ids, timestamp, way_answer_state, check_keys_late,
+	  way_ids, way_range_vec_31, invert_ids, timestamp, way_answer_state, check_keys_late, check_values_late,
           *osm_base_settings().WAY_TAGS_GLOBAL, *attic_settings().WAY_TAGS_GLOBAL, rman);
       collect_elems(QUERY_WAY, way_ids, invert_ids, way_answer_state, into, rman);
     }
     if (type & QUERY_RELATION)
     {
       progress_1< Relation_Skeleton, Relation::Id_Type, Uint31_Index >(
-	  relation_ids, relation_range_vec_31, invert_ids, timestamp, relation_answer_state, check_keys_late,
+	  relation_ids, relation_range_vec_31, invert_ids, timestamp, relation_answer_state, check_keys_late, check_values_late,
           *osm_base_settings().RELATION_TAGS_GLOBAL,  *attic_settings().RELATION_TAGS_GLOBAL, rman);
       collect_elems(QUERY_RELATION, relation_ids, invert_ids, relation_answer_state, into, rman);
     }
@@ -1933,18 +2150,10 @@ void Query_Statement::execute(Resource_Manager& rman)
 
     if (type & QUERY_NODE)
     {
-      for (std::vector< Query_Constraint* >::iterator it = constraints.begin();
-          it != constraints.end() && node_answer_state < data_collected; ++it)
+      if (constraint_ranges.nodes_found && node_answer_state < data_collected)
       {
-        std::set< std::pair< Uint32_Index, Uint32_Index > > range_req;
-        if ((*it)->get_ranges(rman, range_req))
-        {
-          if (node_answer_state < ranges_collected)
-            range_req.swap(range_req_32);
-          else
-            intersect_ranges(range_req_32, range_req).swap(range_req_32);
-	  node_answer_state = ranges_collected;
-        }
+        range_req_32.swap(constraint_ranges.nodes);
+        node_answer_state = ranges_collected;
       }
 
       if (!range_vec_32.empty())
@@ -1962,19 +2171,10 @@ void Query_Statement::execute(Resource_Manager& rman)
     }
     if ((type & QUERY_WAY) && way_answer_state < data_collected)
     {
-      for (std::vector< Query_Constraint* >::iterator it = constraints.begin();
-          it != constraints.end(); ++it)
+      if (constraint_ranges.ways_found)
       {
-        std::set< std::pair< Uint31_Index, Uint31_Index > > range_req;
-	if ((*it)->get_way_ranges(rman, range_req))
-        {
-          if (way_answer_state < ranges_collected)
-            range_req.swap(way_range_req_31);
-          else
-            intersect_ranges(way_range_req_31, range_req).swap(way_range_req_31);
-          if (way_answer_state < ranges_collected)
-            way_answer_state = ranges_collected;
-        }
+        way_range_req_31.swap(constraint_ranges.ways);
+        way_answer_state = ranges_collected;
       }
 
       if (!way_range_vec_31.empty())
@@ -1992,19 +2192,10 @@ void Query_Statement::execute(Resource_Manager& rman)
     }
     if ((type & QUERY_RELATION) && relation_answer_state < data_collected)
     {
-      for (std::vector< Query_Constraint* >::iterator it = constraints.begin();
-          it != constraints.end(); ++it)
+      if (constraint_ranges.relations_found)
       {
-        std::set< std::pair< Uint31_Index, Uint31_Index > > range_req;
-	if ((*it)->get_relation_ranges(rman, range_req))
-        {
-          if (relation_answer_state < ranges_collected)
-            range_req.swap(relation_range_req_31);
-          else
-            intersect_ranges(relation_range_req_31, range_req).swap(relation_range_req_31);
-          if (relation_answer_state < ranges_collected)
-            relation_answer_state = ranges_collected;
-        }
+        relation_range_req_31.swap(constraint_ranges.relations);
+        relation_answer_state = ranges_collected;
       }
 
       if (!relation_range_vec_31.empty())
@@ -2124,7 +2315,7 @@ void Query_Statement::execute(Resource_Manager& rman)
             Set to_filter;
             to_filter.nodes.swap(into.nodes);
             to_filter.attic_nodes.swap(into.attic_nodes);
-            apply_all_filters(rman, timestamp, check_keys_late, to_filter);
+            apply_all_filters(rman, timestamp, check_keys_late, filter_order, to_filter);
             indexed_set_union(filtered.nodes, to_filter.nodes);
             indexed_set_union(filtered.attic_nodes, to_filter.attic_nodes);
           }
@@ -2159,7 +2350,7 @@ void Query_Statement::execute(Resource_Manager& rman)
             Set to_filter;
             to_filter.ways.swap(into.ways);
             to_filter.attic_ways.swap(into.attic_ways);
-            apply_all_filters(rman, timestamp, check_keys_late, to_filter);
+            apply_all_filters(rman, timestamp, check_keys_late, filter_order, to_filter);
             indexed_set_union(filtered.ways, to_filter.ways);
             indexed_set_union(filtered.attic_ways, to_filter.attic_ways);
           }
@@ -2194,7 +2385,7 @@ void Query_Statement::execute(Resource_Manager& rman)
             Set to_filter;
             to_filter.relations.swap(into.relations);
             to_filter.attic_relations.swap(into.attic_relations);
-            apply_all_filters(rman, timestamp, check_keys_late, to_filter);
+            apply_all_filters(rman, timestamp, check_keys_late, filter_order, to_filter);
             indexed_set_union(filtered.relations, to_filter.relations);
             indexed_set_union(filtered.attic_relations, to_filter.attic_relations);
           }
@@ -2208,27 +2399,41 @@ void Query_Statement::execute(Resource_Manager& rman)
     }
   }
 
-  apply_all_filters(rman, timestamp, check_keys_late, into);
-  indexed_set_union(into.nodes, filtered.nodes);
-  indexed_set_union(into.attic_nodes, filtered.attic_nodes);
-  indexed_set_union(into.ways, filtered.ways);
-  indexed_set_union(into.attic_ways, filtered.attic_ways);
-  indexed_set_union(into.relations, filtered.relations);
-  indexed_set_union(into.attic_relations, filtered.attic_relations);
-  indexed_set_union(into.areas, filtered.areas);
-  indexed_set_union(into.deriveds, filtered.deriveds);
-  
+  apply_all_filters(rman, timestamp, check_keys_late, filter_order, into);
+
+  std::vector< std::function< void() > > tasks;
+  tasks.push_back([&]()
+  {
+    indexed_set_union(into.nodes, filtered.nodes);
+    indexed_set_union(into.attic_nodes, filtered.attic_nodes);
+    clear_empty_indices(into.nodes);
+    clear_empty_indices(into.attic_nodes);
+  });
+  tasks.push_back([&]()
+  {
+    indexed_set_union(into.ways, filtered.ways);
+    indexed_set_union(into.attic_ways, filtered.attic_ways);
+    clear_empty_indices(into.ways);
+    clear_empty_indices(into.attic_ways);
+  });
+  tasks.push_back([&]()
+  {
+    indexed_set_union(into.relations, filtered.relations);
+    indexed_set_union(into.attic_relations, filtered.attic_relations);
+    clear_empty_indices(into.relations);
+  });
+  tasks.push_back([&]()
+  {
+    indexed_set_union(into.areas, filtered.areas);
+    indexed_set_union(into.deriveds, filtered.deriveds);
+    clear_empty_indices(into.deriveds);
+    clear_empty_indices(into.areas);
+  });
+  process_package(tasks, rman.get_global_settings().get_query_threads());
+
   set_progress(9);
   rman.health_check(*this);
 
-  clear_empty_indices(into.nodes);
-  clear_empty_indices(into.attic_nodes);
-  clear_empty_indices(into.ways);
-  clear_empty_indices(into.attic_ways);
-  clear_empty_indices(into.relations);
-  clear_empty_indices(into.deriveds);
-  clear_empty_indices(into.areas);
-
   transfer_output(rman, into);
   rman.health_check(*this);
 }
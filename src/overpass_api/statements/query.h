@@ -37,6 +37,20 @@ const int QUERY_AREA = 16;
 typedef enum { nothing, /*ids_collected,*/ ranges_collected, data_collected } Answer_State;
 
 
+// The intersection of the ranges of all constraints per element type
+struct Constraint_Ranges
+{
+  Constraint_Ranges() : nodes_found(false), ways_found(false), relations_found(false) {}
+
+  std::set< std::pair< Uint32_Index, Uint32_Index > > nodes;
+  std::set< std::pair< Uint31_Index, Uint31_Index > > ways;
+  std::set< std::pair< Uint31_Index, Uint31_Index > > relations;
+  bool nodes_found;
+  bool ways_found;
+  bool relations_found;
+};
+
+
 class Regular_Expression;
 class Bbox_Query_Statement;
 
@@ -217,6 +231,7 @@ class Query_Statement final : public Output_Statement
     void progress_1(std::vector< Id_Type >& ids, std::vector< Index >& range_req,
                     bool& invert_ids, uint64 timestamp,
                     Answer_State& answer_state, Query_Filter_Strategy& check_keys_late,
+                    bool check_values_late,
                     const File_Properties& file_prop, const File_Properties& attic_file_prop,
                     Resource_Manager& rman);
 
@@ -238,7 +253,26 @@ class Query_Statement final : public Output_Statement
 
     void collect_elems(Answer_State& answer_state, Set& into, Resource_Manager& rman);
     void apply_all_filters(
-        Resource_Manager& rman, uint64 timestamp, Query_Filter_Strategy check_keys_late, Set& into);
+        Resource_Manager& rman, uint64 timestamp, Query_Filter_Strategy check_keys_late,
+        const std::vector< Query_Constraint* >& filter_order, Set& into);
+
+    // Cost model: the estimated bytes to read from a global tag index
+    // for the key-value pairs resp. for the keys and negations
+    void estimate_tag_index_volume(const File_Properties& file_prop, Resource_Manager& rman,
+        uint64& values_volume, uint64& keys_volume) const;
+
+    // Asks every constraint once for its ranges
+    void collect_constraint_ranges(Resource_Manager& rman, Constraint_Ranges& ranges);
+
+    // Refines the strategy from the constraints by comparing the estimated bytes to read
+    // from the global tag indexes with the bytes to read from the data files for the common ranges.
+    // check_values_late is set if even the key-value pairs are cheaper to check on the elements.
+    Query_Filter_Strategy choose_access_path(
+        Resource_Manager& rman, uint64 timestamp, const Constraint_Ranges& ranges,
+        Query_Filter_Strategy check_keys_late, bool& check_values_late);
+
+    // The constraints in ascending order of the effort of their expensive filter
+    std::vector< Query_Constraint* > order_filters(Resource_Manager& rman);
 };
 
 
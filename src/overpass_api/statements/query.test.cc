@@ -1859,6 +1859,11 @@ int main(int argc, char* args[])
     perform_query_with_two_ids_query("wr", global_node_offset, args[3]);
   if ((test_to_execute == "") || (test_to_execute == "174"))
     perform_query_with_two_ids_query("nr", global_node_offset, args[3]);
+  if ((test_to_execute == "") || (test_to_execute == "175"))
+    // Test regular expressions: A quantifier on a quantifier makes the unit optional in POSIX
+    perform_regex_query("node", "", "",
+			"node_key_11", "^node_value_2x+?$", true,
+			"", "", true, "", "", true, "", "", true, args[3]);
 
   std::cout<<"</osm>\n";
   return 0;
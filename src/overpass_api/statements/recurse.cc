@@ -2371,7 +2371,7 @@ void Recurse_Constraint::filter(const Statement& query, Resource_Manager& rman,
 
 Recurse_Statement::Recurse_Statement
     (int line_number_, const std::map< std::string, std::string >& input_attributes, Parsed_Query& global_settings)
-    : Output_Statement(line_number_), restrict_to_role(false)
+    : Output_Statement(line_number_), restrict_to_role(false), batch(0)
 {
   std::map< std::string, std::string > attributes;
 
@@ -2573,114 +2573,399 @@ std::string Recurse_Statement::to_ql_representation(int type)
 }
 
 
-void Recurse_Statement::execute(Resource_Manager& rman)
+//-----------------------------------------------------------------------------
+
+
+template< typename Index, typename Skeleton >
+void collect_ids(const std::map< Index, std::vector< Skeleton > >& elems,
+    std::set< typename Skeleton::Id_Type >& ids)
 {
-  Set into;
+  for (typename std::map< Index, std::vector< Skeleton > >::const_iterator it = elems.begin();
+      it != elems.end(); ++it)
+  {
+    for (typename std::vector< Skeleton >::const_iterator it2 = it->second.begin(); it2 != it->second.end(); ++it2)
+      ids.insert(it2->id);
+  }
+}
 
-  const Set* input_set = rman.get_set(input);
-  if (!input_set)
+
+template< typename Index, typename Skeleton >
+bool all_ids_contained(const std::map< Index, std::vector< Skeleton > >& elems,
+    const std::set< typename Skeleton::Id_Type >& ids)
+{
+  for (typename std::map< Index, std::vector< Skeleton > >::const_iterator it = elems.begin();
+      it != elems.end(); ++it)
   {
-    transfer_output(rman, into);
-    return;
+    for (typename std::vector< Skeleton >::const_iterator it2 = it->second.begin(); it2 != it->second.end(); ++it2)
+    {
+      if (ids.find(it2->id) == ids.end())
+        return false;
+    }
+  }
+  return true;
+}
+
+
+template< typename Index, typename Skeleton >
+void index_by_id(const std::map< Index, std::vector< Skeleton > >& elems,
+    std::map< typename Skeleton::Id_Type, std::pair< Index, const Skeleton* > >& by_id)
+{
+  for (typename std::map< Index, std::vector< Skeleton > >::const_iterator it = elems.begin();
+      it != elems.end(); ++it)
+  {
+    for (typename std::vector< Skeleton >::const_iterator it2 = it->second.begin(); it2 != it->second.end(); ++it2)
+      by_id[it2->id] = std::make_pair(it->first, &*it2);
+  }
+}
+
+
+template< typename Index, typename Skeleton >
+void add_found_ids(const std::set< typename Skeleton::Id_Type >& ids,
+    const std::map< typename Skeleton::Id_Type, std::pair< Index, const Skeleton* > >& by_id,
+    std::map< Index, std::vector< Skeleton > >& into)
+{
+  for (typename std::set< typename Skeleton::Id_Type >::const_iterator it = ids.begin(); it != ids.end(); ++it)
+  {
+    typename std::map< typename Skeleton::Id_Type, std::pair< Index, const Skeleton* > >::const_iterator
+        it_found = by_id.find(*it);
+    if (it_found != by_id.end())
+      into[it_found->second.first].push_back(*it_found->second.second);
+  }
+}
+
+
+template< typename Id_Type, typename Parent_Id_Type >
+void add_parent_ids(const std::map< Id_Type, std::vector< Parent_Id_Type > >& parents_by_child,
+    const Id_Type& child, std::set< Parent_Id_Type >& ids)
+{
+  typename std::map< Id_Type, std::vector< Parent_Id_Type > >::const_iterator it = parents_by_child.find(child);
+  if (it != parents_by_child.end())
+    ids.insert(it->second.begin(), it->second.end());
+}
+
+
+/* Holds the result of a recursion over all elements of a loop.
+ * Because all supported recursions follow only the member lists of the elements,
+ * the result for any subset of the loop's elements can be assembled from it without database access. */
+struct Recurse_Batch
+{
+  Recurse_Batch(const Set& loop_set, Set& result_);
+
+  bool covers(const Set& input_set) const;
+  void derive(unsigned int type, const Set& input_set, Set& into) const;
+  uint64 size() const;
+
+  std::set< Node::Id_Type > loop_nodes;
+  std::set< Way::Id_Type > loop_ways;
+  std::set< Relation::Id_Type > loop_relations;
+
+  Set result;
+  std::map< Node::Id_Type, std::pair< Uint32_Index, const Node_Skeleton* > > nodes;
+  std::map< Way::Id_Type, std::pair< Uint31_Index, const Way_Skeleton* > > ways;
+  std::map< Relation::Id_Type, std::pair< Uint31_Index, const Relation_Skeleton* > > relations;
+
+  // Reverse member lists for the upward recursions
+  std::map< Node::Id_Type, std::vector< Way::Id_Type > > ways_by_node;
+  std::map< Node::Id_Type, std::vector< Relation::Id_Type > > relations_by_node;
+  std::map< Way::Id_Type, std::vector< Relation::Id_Type > > relations_by_way;
+  std::map< Relation::Id_Type, std::vector< Relation::Id_Type > > relations_by_relation;
+};
+
+
+Recurse_Batch::Recurse_Batch(const Set& loop_set, Set& result_)
+{
+  collect_ids(loop_set.nodes, loop_nodes);
+  collect_ids(loop_set.ways, loop_ways);
+  collect_ids(loop_set.relations, loop_relations);
+
+  result.swap(result_);
+  index_by_id(result.nodes, nodes);
+  index_by_id(result.ways, ways);
+  index_by_id(result.relations, relations);
+
+  for (std::map< Way::Id_Type, std::pair< Uint31_Index, const Way_Skeleton* > >::const_iterator
+      it = ways.begin(); it != ways.end(); ++it)
+  {
+    for (std::vector< Node::Id_Type >::const_iterator it_nd = it->second.second->nds().begin();
+        it_nd != it->second.second->nds().end(); ++it_nd)
+      ways_by_node[*it_nd].push_back(it->first);
   }
 
+  for (std::map< Relation::Id_Type, std::pair< Uint31_Index, const Relation_Skeleton* > >::const_iterator
+      it = relations.begin(); it != relations.end(); ++it)
+  {
+    for (std::vector< Relation_Entry >::const_iterator it_member = it->second.second->members().begin();
+        it_member != it->second.second->members().end(); ++it_member)
+    {
+      if (it_member->type == Relation_Entry::NODE)
+        relations_by_node[Node::Id_Type(it_member->ref.val())].push_back(it->first);
+      else if (it_member->type == Relation_Entry::WAY)
+        relations_by_way[it_member->ref32()].push_back(it->first);
+      else if (it_member->type == Relation_Entry::RELATION)
+        relations_by_relation[it_member->ref32()].push_back(it->first);
+    }
+  }
+}
+
+
+template< typename Key, typename Value >
+uint64 eval_reverse_members(const std::map< Key, std::vector< Value > >& reverse_members)
+{
+  uint64 size = 0;
+  for (typename std::map< Key, std::vector< Value > >::const_iterator it = reverse_members.begin();
+      it != reverse_members.end(); ++it)
+    size += it->second.size()*sizeof(Value) + eval_map_index_size;
+  return size;
+}
+
+
+uint64 Recurse_Batch::size() const
+{
+  return eval_map(result.nodes) + eval_map(result.ways) + eval_map(result.relations)
+      + (loop_nodes.size() + loop_ways.size() + loop_relations.size()
+          + nodes.size() + ways.size() + relations.size())*eval_map_index_size
+      + eval_reverse_members(ways_by_node) + eval_reverse_members(relations_by_node)
+      + eval_reverse_members(relations_by_way) + eval_reverse_members(relations_by_relation);
+}
+
+
+bool Recurse_Batch::covers(const Set& input_set) const
+{
+  return input_set.attic_nodes.empty() && input_set.attic_ways.empty() && input_set.attic_relations.empty()
+      && all_ids_contained(input_set.nodes, loop_nodes)
+      && all_ids_contained(input_set.ways, loop_ways)
+      && all_ids_contained(input_set.relations, loop_relations);
+}
+
+
+void Recurse_Batch::derive(unsigned int type, const Set& input_set, Set& into) const
+{
+  std::set< Node::Id_Type > node_ids;
+  std::set< Way::Id_Type > way_ids;
+  std::set< Relation::Id_Type > relation_ids;
+
+  bool member_nodes = (type == RECURSE_RELATION_NODE || type == RECURSE_RELATION_NWR
+      || type == RECURSE_RELATION_NW || type == RECURSE_RELATION_NR || type == RECURSE_DOWN);
+  bool member_ways = (type == RECURSE_RELATION_WAY || type == RECURSE_RELATION_NWR
+      || type == RECURSE_RELATION_NW || type == RECURSE_RELATION_WR || type == RECURSE_DOWN);
+  bool member_relations = (type == RECURSE_RELATION_RELATION || type == RECURSE_RELATION_NWR
+      || type == RECURSE_RELATION_WR || type == RECURSE_RELATION_NR);
+
+  if (member_nodes || member_ways || member_relations)
+  {
+    for (std::map< Uint31_Index, std::vector< Relation_Skeleton > >::const_iterator
+        it = input_set.relations.begin(); it != input_set.relations.end(); ++it)
+    {
+      for (std::vector< Relation_Skeleton >::const_iterator it2 = it->second.begin(); it2 != it->second.end(); ++it2)
+      {
+        for (std::vector< Relation_Entry >::const_iterator it_member = it2->members().begin();
+            it_member != it2->members().end(); ++it_member)
+        {
+          if (it_member->type == Relation_Entry::NODE && member_nodes)
+            node_ids.insert(Node::Id_Type(it_member->ref.val()));
+          else if (it_member->type == Relation_Entry::WAY && member_ways)
+            way_ids.insert(it_member->ref32());
+          else if (it_member->type == Relation_Entry::RELATION && member_relations)
+            relation_ids.insert(it_member->ref32());
+        }
+      }
+    }
+  }
+
+  if (type == RECURSE_WAY_NODE || type == RECURSE_DOWN)
+  {
+    for (std::map< Uint31_Index, std::vector< Way_Skeleton > >::const_iterator
+        it = input_set.ways.begin(); it != input_set.ways.end(); ++it)
+    {
+      for (std::vector< Way_Skeleton >::const_iterator it2 = it->second.begin(); it2 != it->second.end(); ++it2)
+        node_ids.insert(it2->nds().begin(), it2->nds().end());
+    }
+  }
+  if (type == RECURSE_DOWN)
+  {
+    for (std::set< Way::Id_Type >::const_iterator it = way_ids.begin(); it != way_ids.end(); ++it)
+    {
+      std::map< Way::Id_Type, std::pair< Uint31_Index, const Way_Skeleton* > >::const_iterator
+          it_way = ways.find(*it);
+      if (it_way != ways.end())
+        node_ids.insert(it_way->second.second->nds().begin(), it_way->second.second->nds().end());
+    }
+  }
+
+  bool node_parent_ways = (type == RECURSE_NODE_WAY || type == RECURSE_NODE_WR || type == RECURSE_UP);
+  bool node_parent_relations = (type == RECURSE_NODE_RELATION || type == RECURSE_NODE_WR || type == RECURSE_UP);
+  if (node_parent_ways || node_parent_relations)
+  {
+    for (std::map< Uint32_Index, std::vector< Node_Skeleton > >::const_iterator
+        it = input_set.nodes.begin(); it != input_set.nodes.end(); ++it)
+    {
+      for (std::vector< Node_Skeleton >::const_iterator it2 = it->second.begin(); it2 != it->second.end(); ++it2)
+      {
+        if (node_parent_ways)
+          add_parent_ids(ways_by_node, it2->id, way_ids);
+        if (node_parent_relations)
+          add_parent_ids(relations_by_node, it2->id, relation_ids);
+      }
+    }
+  }
+
+  if (type == RECURSE_WAY_RELATION || type == RECURSE_UP)
+  {
+    for (std::map< Uint31_Index, std::vector< Way_Skeleton > >::const_iterator
+        it = input_set.ways.begin(); it != input_set.ways.end(); ++it)
+    {
+      for (std::vector< Way_Skeleton >::const_iterator it2 = it->second.begin(); it2 != it->second.end(); ++it2)
+        add_parent_ids(relations_by_way, it2->id, relation_ids);
+    }
+  }
+  if (type == RECURSE_UP)
+  {
+    for (std::set< Way::Id_Type >::const_iterator it = way_ids.begin(); it != way_ids.end(); ++it)
+      add_parent_ids(relations_by_way, *it, relation_ids);
+  }
+
+  if (type == RECURSE_RELATION_BACKWARDS)
+  {
+    for (std::map< Uint31_Index, std::vector< Relation_Skeleton > >::const_iterator
+        it = input_set.relations.begin(); it != input_set.relations.end(); ++it)
+    {
+      for (std::vector< Relation_Skeleton >::const_iterator it2 = it->second.begin(); it2 != it->second.end(); ++it2)
+        add_parent_ids(relations_by_relation, it2->id, relation_ids);
+    }
+  }
+
+  add_found_ids(node_ids, nodes, into.nodes);
+  add_found_ids(way_ids, ways, into.ways);
+  add_found_ids(relation_ids, relations, into.relations);
+}
+
+
+bool Recurse_Statement::prepare_batch(Resource_Manager& rman, const std::string& loop_set_name, const Set& loop_set,
+    std::vector< Statement* >& prepared)
+{
+  // The transitive recursions and the attic and filtered variants are not assembled from member lists alone
+  if (input != loop_set_name || restrict_to_role || !pos.empty() || rman.get_desired_timestamp() != NOW
+      || type == RECURSE_DOWN_REL || type == RECURSE_UP_REL
+      || !loop_set.attic_nodes.empty() || !loop_set.attic_ways.empty() || !loop_set.attic_relations.empty())
+    return false;
+
+  Set result;
+  collect(rman, loop_set, result);
+
+  delete batch;
+  batch = new Recurse_Batch(loop_set, result);
+  prepared.push_back(this);
+
+  // The batch is released together with the stack frame of the loop
+  rman.add_batch_size(batch->size());
+  rman.health_check(*this);
+  return false;
+}
+
+
+void Recurse_Statement::clear_batch()
+{
+  delete batch;
+  batch = 0;
+}
+
+
+void Recurse_Statement::collect(Resource_Manager& rman, const Set& input_set, Set& into)
+{
   if (restrict_to_role)
   {
     uint32 role_id = determine_role_id(*rman.get_transaction(), role);
     if (role_id == std::numeric_limits< uint32 >::max())
-    {
-      transfer_output(rman, into);
       return;
-    }
 
     if (type == RECURSE_RELATION_RELATION || type == RECURSE_RELATION_NWR || type == RECURSE_RELATION_WR
         || type == RECURSE_RELATION_NR)
     {
       if (rman.get_desired_timestamp() == NOW)
-        into.relations = relation_relation_members(*this, rman, input_set->relations,
+        into.relations = relation_relation_members(*this, rman, input_set.relations,
                                                  0, 0, false, &role_id);
       else
         swap_components(relation_relation_members(
-                *this, rman, input_set->relations, input_set->attic_relations, 0, 0, false, &role_id),
+                *this, rman, input_set.relations, input_set.attic_relations, 0, 0, false, &role_id),
             into.relations, into.attic_relations);
     }
     if (type == RECURSE_RELATION_WAY || type == RECURSE_RELATION_NWR || type == RECURSE_RELATION_NW
         || type == RECURSE_RELATION_WR)
     {
       if (rman.get_desired_timestamp() == NOW)
-        into.ways = relation_way_members(this, rman, input_set->relations,
+        into.ways = relation_way_members(this, rman, input_set.relations,
                                          0, 0, false, &role_id);
       else
         swap_components(relation_way_members(
-                this, rman, input_set->relations, input_set->attic_relations, 0, 0, false, &role_id),
+                this, rman, input_set.relations, input_set.attic_relations, 0, 0, false, &role_id),
             into.ways, into.attic_ways);
     }
     if (type == RECURSE_RELATION_NODE || type == RECURSE_RELATION_NWR || type == RECURSE_RELATION_NW
         || type == RECURSE_RELATION_NR)
     {
       if (rman.get_desired_timestamp() == NOW)
-        into.nodes = relation_node_members(this, rman, input_set->relations,
+        into.nodes = relation_node_members(this, rman, input_set.relations,
                                            0, 0, false, &role_id);
       else
         swap_components(relation_node_members(
-                this, rman, input_set->relations, input_set->attic_relations, 0, 0, false, &role_id),
+                this, rman, input_set.relations, input_set.attic_relations, 0, 0, false, &role_id),
             into.nodes, into.attic_nodes);
     }
     else if (type == RECURSE_RELATION_BACKWARDS)
     {
       if (rman.get_desired_timestamp() == NOW)
-        collect_relations(*this, rman, input_set->relations, into.relations, role_id);
+        collect_relations(*this, rman, input_set.relations, into.relations, role_id);
       else
-        collect_relations(*this, rman, input_set->relations, input_set->attic_relations,
+        collect_relations(*this, rman, input_set.relations, input_set.attic_relations,
                           into.relations, into.attic_relations, role_id);
     }
     else if (type == RECURSE_NODE_RELATION)
     {
       if (rman.get_desired_timestamp() == NOW)
-        collect_relations(*this, rman, input_set->nodes, Relation_Entry::NODE, into.relations, role_id);
+        collect_relations(*this, rman, input_set.nodes, Relation_Entry::NODE, into.relations, role_id);
       else
-        collect_relations(*this, rman, input_set->nodes, input_set->attic_nodes, Relation_Entry::NODE,
+        collect_relations(*this, rman, input_set.nodes, input_set.attic_nodes, Relation_Entry::NODE,
                           into.relations, into.attic_relations, role_id);
     }
     else if (type == RECURSE_WAY_RELATION)
     {
       if (rman.get_desired_timestamp() == NOW)
-        collect_relations(*this, rman, input_set->ways, Relation_Entry::WAY, into.relations, role_id);
+        collect_relations(*this, rman, input_set.ways, Relation_Entry::WAY, into.relations, role_id);
       else
-        collect_relations(*this, rman, input_set->ways, input_set->attic_ways, Relation_Entry::WAY,
+        collect_relations(*this, rman, input_set.ways, input_set.attic_ways, Relation_Entry::WAY,
                           into.relations, into.attic_relations, role_id);
     }
   }
   else if (type == RECURSE_RELATION_RELATION)
   {
     if (rman.get_desired_timestamp() == NOW)
-      into.relations = relation_relation_members(*this, rman, input_set->relations);
+      into.relations = relation_relation_members(*this, rman, input_set.relations);
     else
-      swap_components(relation_relation_members(*this, rman, input_set->relations, input_set->attic_relations),
+      swap_components(relation_relation_members(*this, rman, input_set.relations, input_set.attic_relations),
           into.relations, into.attic_relations);
   }
   else if (type == RECURSE_RELATION_BACKWARDS)
   {
     if (rman.get_desired_timestamp() == NOW)
-      collect_relations(*this, rman, input_set->relations, into.relations);
+      collect_relations(*this, rman, input_set.relations, into.relations);
     else
-      collect_relations(*this, rman, input_set->relations, input_set->attic_relations,
+      collect_relations(*this, rman, input_set.relations, input_set.attic_relations,
                         into.relations, into.attic_relations);
   }
   else if (type == RECURSE_RELATION_WAY)
   {
     if (rman.get_desired_timestamp() == NOW)
-      into.ways = relation_way_members(this, rman, input_set->relations);
+      into.ways = relation_way_members(this, rman, input_set.relations);
     else
-      swap_components(relation_way_members(this, rman, input_set->relations, input_set->attic_relations),
+      swap_components(relation_way_members(this, rman, input_set.relations, input_set.attic_relations),
           into.ways, into.attic_ways);
   }
   else if (type == RECURSE_RELATION_NODE)
   {
     if (rman.get_desired_timestamp() == NOW)
-      into.nodes = relation_node_members(this, rman, input_set->relations);
+      into.nodes = relation_node_members(this, rman, input_set.relations);
     else
-      swap_components(relation_node_members(this, rman, input_set->relations, input_set->attic_relations),
+      swap_components(relation_node_members(this, rman, input_set.relations, input_set.attic_relations),
           into.nodes, into.attic_nodes);
   }
   else if (type == RECURSE_RELATION_NWR || type == RECURSE_RELATION_NW || type == RECURSE_RELATION_WR
@@ -2689,41 +2974,41 @@ void Recurse_Statement::execute(Resource_Manager& rman)
     if (rman.get_desired_timestamp() == NOW)
     {
       if (type == RECURSE_RELATION_NWR || type == RECURSE_RELATION_NR || type == RECURSE_RELATION_WR)
-        into.relations = relation_relation_members(*this, rman, input_set->relations);
+        into.relations = relation_relation_members(*this, rman, input_set.relations);
       if (type == RECURSE_RELATION_NWR || type == RECURSE_RELATION_NW || type == RECURSE_RELATION_WR)
-        into.ways = relation_way_members(this, rman, input_set->relations);
+        into.ways = relation_way_members(this, rman, input_set.relations);
       if (type == RECURSE_RELATION_NWR || type == RECURSE_RELATION_NW || type == RECURSE_RELATION_NR)
-        into.nodes = relation_node_members(this, rman, input_set->relations);
+        into.nodes = relation_node_members(this, rman, input_set.relations);
     }
     else
     {
       if (type == RECURSE_RELATION_NWR || type == RECURSE_RELATION_NR || type == RECURSE_RELATION_WR)
-        swap_components(relation_relation_members(*this, rman, input_set->relations, input_set->attic_relations),
+        swap_components(relation_relation_members(*this, rman, input_set.relations, input_set.attic_relations),
             into.relations, into.attic_relations);
 
       if (type == RECURSE_RELATION_NWR || type == RECURSE_RELATION_NW || type == RECURSE_RELATION_WR)
-        swap_components(relation_way_members(this, rman, input_set->relations, input_set->attic_relations),
+        swap_components(relation_way_members(this, rman, input_set.relations, input_set.attic_relations),
             into.ways, into.attic_ways);
 
       if (type == RECURSE_RELATION_NWR || type == RECURSE_RELATION_NW || type == RECURSE_RELATION_NR)
-        swap_components(relation_node_members(this, rman, input_set->relations, input_set->attic_relations),
+        swap_components(relation_node_members(this, rman, input_set.relations, input_set.attic_relations),
             into.nodes, into.attic_nodes);
     }
   }
   else if (type == RECURSE_WAY_NODE)
-    swap_components(way_members(this, rman, input_set->ways, input_set->attic_ways, get_pos()),
+    swap_components(way_members(this, rman, input_set.ways, input_set.attic_ways, get_pos()),
         into.nodes, into.attic_nodes);
   else if (type == RECURSE_DOWN)
-    add_nw_member_objects(rman, this, *input_set, into);
+    add_nw_member_objects(rman, this, input_set, into);
   else if (type == RECURSE_DOWN_REL)
   {
     if (rman.get_desired_timestamp() == NOW)
     {
-      relations_loop(*this, rman, input_set->relations, into.relations);
+      relations_loop(*this, rman, input_set.relations, into.relations);
       std::map< Uint32_Index, std::vector< Node_Skeleton > > rel_nodes
           = relation_node_members(this, rman, into.relations);
       into.ways = relation_way_members(this, rman, into.relations);
-      std::map< Uint31_Index, std::vector< Way_Skeleton > > source_ways = input_set->ways;
+      std::map< Uint31_Index, std::vector< Way_Skeleton > > source_ways = input_set.ways;
       sort_second(source_ways);
       sort_second(into.ways);
       indexed_set_union(source_ways, into.ways);
@@ -2735,15 +3020,15 @@ void Recurse_Statement::execute(Resource_Manager& rman)
     }
     else
     {
-      relations_loop(*this, rman, input_set->relations, input_set->attic_relations,
+      relations_loop(*this, rman, input_set.relations, input_set.attic_relations,
                      into.relations, into.attic_relations);
       swap_components(relation_node_members(this, rman, into.relations, into.attic_relations),
           into.nodes, into.attic_nodes);
       swap_components(relation_way_members(this, rman, into.relations, into.attic_relations),
           into.ways, into.attic_ways);
 
-      std::map< Uint31_Index, std::vector< Way_Skeleton > > source_ways = input_set->ways;
-      std::map< Uint31_Index, std::vector< Attic< Way_Skeleton > > > source_attic_ways = input_set->attic_ways;
+      std::map< Uint31_Index, std::vector< Way_Skeleton > > source_ways = input_set.ways;
+      std::map< Uint31_Index, std::vector< Attic< Way_Skeleton > > > source_attic_ways = input_set.attic_ways;
       sort_second(into.ways);
       sort_second(source_ways);
       indexed_set_union(source_ways, into.ways);
@@ -2768,33 +3053,33 @@ void Recurse_Statement::execute(Resource_Manager& rman)
     if (type == RECURSE_NODE_WAY || type == RECURSE_NODE_WR)
     {
       if (rman.get_desired_timestamp() == NOW)
-        collect_ways(*this, rman, input_set->nodes, get_pos(), into.ways);
+        collect_ways(*this, rman, input_set.nodes, get_pos(), into.ways);
       else
-        collect_ways(*this, rman, input_set->nodes, input_set->attic_nodes, get_pos(), into.ways, into.attic_ways);
+        collect_ways(*this, rman, input_set.nodes, input_set.attic_nodes, get_pos(), into.ways, into.attic_ways);
     }
     if (type == RECURSE_NODE_RELATION || type == RECURSE_NODE_WR)
     {
       if (rman.get_desired_timestamp() == NOW)
-        collect_relations(*this, rman, input_set->nodes, Relation_Entry::NODE, into.relations);
+        collect_relations(*this, rman, input_set.nodes, Relation_Entry::NODE, into.relations);
       else
-        collect_relations(*this, rman, input_set->nodes, input_set->attic_nodes, Relation_Entry::NODE,
+        collect_relations(*this, rman, input_set.nodes, input_set.attic_nodes, Relation_Entry::NODE,
             into.relations, into.attic_relations);
     }
   }
   else if (type == RECURSE_WAY_RELATION)
   {
     if (rman.get_desired_timestamp() == NOW)
-      collect_relations(*this, rman, input_set->ways, Relation_Entry::WAY, into.relations);
+      collect_relations(*this, rman, input_set.ways, Relation_Entry::WAY, into.relations);
     else
-      collect_relations(*this, rman, input_set->ways, input_set->attic_ways, Relation_Entry::WAY,
+      collect_relations(*this, rman, input_set.ways, input_set.attic_ways, Relation_Entry::WAY,
                         into.relations, into.attic_relations);
   }
   else if (type == RECURSE_UP)
   {
     if (rman.get_desired_timestamp() == NOW)
     {
-      std::map< Uint31_Index, std::vector< Way_Skeleton > > rel_ways = input_set->ways;
-      collect_ways(*this, rman, input_set->nodes, 0, into.ways);
+      std::map< Uint31_Index, std::vector< Way_Skeleton > > rel_ways = input_set.ways;
+      collect_ways(*this, rman, input_set.nodes, 0, into.ways);
 
       sort_second(rel_ways);
       sort_second(into.ways);
@@ -2802,16 +3087,16 @@ void Recurse_Statement::execute(Resource_Manager& rman)
       collect_relations(*this, rman, rel_ways, Relation_Entry::WAY, into.relations);
 
       std::map< Uint31_Index, std::vector< Relation_Skeleton > > node_rels;
-      collect_relations(*this, rman, input_set->nodes, Relation_Entry::NODE, node_rels);
+      collect_relations(*this, rman, input_set.nodes, Relation_Entry::NODE, node_rels);
       sort_second(into.relations);
       sort_second(node_rels);
       indexed_set_union(into.relations, node_rels);
     }
     else
     {
-      std::map< Uint31_Index, std::vector< Way_Skeleton > > rel_ways = input_set->ways;
-      std::map< Uint31_Index, std::vector< Attic< Way_Skeleton > > > attic_rel_ways = input_set->attic_ways;
-      collect_ways(*this, rman, input_set->nodes, input_set->attic_nodes, 0, into.ways, into.attic_ways);
+      std::map< Uint31_Index, std::vector< Way_Skeleton > > rel_ways = input_set.ways;
+      std::map< Uint31_Index, std::vector< Attic< Way_Skeleton > > > attic_rel_ways = input_set.attic_ways;
+      collect_ways(*this, rman, input_set.nodes, input_set.attic_nodes, 0, into.ways, into.attic_ways);
 
       sort_second(rel_ways);
       sort_second(into.ways);
@@ -2824,7 +3109,7 @@ void Recurse_Statement::execute(Resource_Manager& rman)
 
       std::map< Uint31_Index, std::vector< Relation_Skeleton > > node_rels;
       std::map< Uint31_Index, std::vector< Attic< Relation_Skeleton > > > attic_node_rels;
-      collect_relations(*this, rman, input_set->nodes, input_set->attic_nodes,
+      collect_relations(*this, rman, input_set.nodes, input_set.attic_nodes,
                         Relation_Entry::NODE, node_rels, attic_node_rels);
       sort_second(into.relations);
       sort_second(node_rels);
@@ -2838,10 +3123,10 @@ void Recurse_Statement::execute(Resource_Manager& rman)
   {
     if (rman.get_desired_timestamp() == NOW)
     {
-      std::map< Uint31_Index, std::vector< Way_Skeleton > > rel_ways = input_set->ways;
-      collect_ways(*this, rman, input_set->nodes, 0, into.ways);
+      std::map< Uint31_Index, std::vector< Way_Skeleton > > rel_ways = input_set.ways;
+      collect_ways(*this, rman, input_set.nodes, 0, into.ways);
 
-      std::map< Uint31_Index, std::vector< Relation_Skeleton > > rel_rels = input_set->relations;
+      std::map< Uint31_Index, std::vector< Relation_Skeleton > > rel_rels = input_set.relations;
       std::map< Uint31_Index, std::vector< Relation_Skeleton > > way_rels;
       sort_second(rel_ways);
       sort_second(into.ways);
@@ -2852,7 +3137,7 @@ void Recurse_Statement::execute(Resource_Manager& rman)
       indexed_set_union(rel_rels, way_rels);
 
       std::map< Uint31_Index, std::vector< Relation_Skeleton > > node_rels;
-      collect_relations(*this, rman, input_set->nodes, Relation_Entry::NODE, node_rels);
+      collect_relations(*this, rman, input_set.nodes, Relation_Entry::NODE, node_rels);
       sort_second(rel_rels);
       sort_second(node_rels);
       indexed_set_union(rel_rels, node_rels);
@@ -2861,10 +3146,10 @@ void Recurse_Statement::execute(Resource_Manager& rman)
     }
     else
     {
-      std::map< Uint31_Index, std::vector< Way_Skeleton > > rel_ways = input_set->ways;
-      std::map< Uint31_Index, std::vector< Attic< Way_Skeleton > > > attic_rel_ways = input_set->attic_ways;
+      std::map< Uint31_Index, std::vector< Way_Skeleton > > rel_ways = input_set.ways;
+      std::map< Uint31_Index, std::vector< Attic< Way_Skeleton > > > attic_rel_ways = input_set.attic_ways;
       collect_ways(*this, rman,
-                   input_set->nodes, input_set->attic_nodes, 0, into.ways, into.attic_ways);
+                   input_set.nodes, input_set.attic_nodes, 0, into.ways, into.attic_ways);
       sort_second(rel_ways);
       sort_second(into.ways);
       indexed_set_union(rel_ways, into.ways);
@@ -2877,8 +3162,8 @@ void Recurse_Statement::execute(Resource_Manager& rman)
       collect_relations(*this, rman, rel_ways, attic_rel_ways,
                         Relation_Entry::WAY, way_rels, attic_way_rels);
 
-      std::map< Uint31_Index, std::vector< Relation_Skeleton > > rel_rels = input_set->relations;
-      std::map< Uint31_Index, std::vector< Attic< Relation_Skeleton > > > attic_rel_rels = input_set->attic_relations;
+      std::map< Uint31_Index, std::vector< Relation_Skeleton > > rel_rels = input_set.relations;
+      std::map< Uint31_Index, std::vector< Attic< Relation_Skeleton > > > attic_rel_rels = input_set.attic_relations;
       sort_second(rel_rels);
       sort_second(way_rels);
       indexed_set_union(rel_rels, way_rels);
@@ -2888,7 +3173,7 @@ void Recurse_Statement::execute(Resource_Manager& rman)
 
       std::map< Uint31_Index, std::vector< Relation_Skeleton > > node_rels;
       std::map< Uint31_Index, std::vector< Attic< Relation_Skeleton > > > attic_node_rels;
-      collect_relations(*this, rman, input_set->nodes, input_set->attic_nodes,
+      collect_relations(*this, rman, input_set.nodes, input_set.attic_nodes,
                         Relation_Entry::NODE, node_rels, attic_node_rels);
       sort_second(rel_rels);
       sort_second(node_rels);
@@ -2907,6 +3192,24 @@ void Recurse_Statement::execute(Resource_Manager& rman)
     filter_attic_elements(rman, rman.get_desired_timestamp(), into.ways, into.attic_ways);
     filter_attic_elements(rman, rman.get_desired_timestamp(), into.relations, into.attic_relations);
   }
+}
+
+
+void Recurse_Statement::execute(Resource_Manager& rman)
+{
+  Set into;
+
+  const Set* input_set = rman.get_set(input);
+  if (!input_set)
+  {
+    transfer_output(rman, into);
+    return;
+  }
+
+  if (!batch || !batch->covers(*input_set))
+    collect(rman, *input_set, into);
+  else
+    batch->derive(type, *input_set, into);
 
   transfer_output(rman, into);
   rman.health_check(*this);
@@ -2918,6 +3221,7 @@ Recurse_Statement::~Recurse_Statement()
   for (std::vector< Query_Constraint* >::const_iterator it = constraints.begin();
       it != constraints.end(); ++it)
     delete *it;
+  delete batch;
 }
 
 
@@ -29,6 +29,9 @@
 #include <vector>
 
 
+struct Recurse_Batch;
+
+
 class Recurse_Statement final : public Output_Statement
 {
   public:
@@ -36,6 +39,9 @@ class Recurse_Statement final : public Output_Statement
                       Parsed_Query& global_settings);
     virtual std::string get_name() const { return "recurse"; }
     virtual void execute(Resource_Manager& rman);
+    virtual bool prepare_batch(Resource_Manager& rman, const std::string& loop_set_name, const Set& loop_set,
+        std::vector< Statement* >& prepared);
+    virtual void clear_batch();
     virtual ~Recurse_Statement();
 
     struct Statement_Maker : public Generic_Statement_Maker< Recurse_Statement >
@@ -133,6 +139,9 @@ class Recurse_Statement final : public Output_Statement
     bool restrict_to_role;
     std::vector< int > pos;
     std::vector< Query_Constraint* > constraints;
+    Recurse_Batch* batch;
+
+    void collect(Resource_Manager& rman, const Set& input_set, Set& into);
 
     std::string dump_ql_pos_restrictions() const
     {
@@ -245,11 +245,11 @@ void eval_elems(std::set< std::string >& existing_keys, Set_With_Context& input_
       Element_With_Context< Maybe_Attic > data = input_set.get_context(idx_it->first, *elem_it);
       if (data.tags)
       {
-        for (std::vector< std::pair< std::string, std::string > >::const_iterator it_keys = data.tags->begin();
+        for (Interned_Tags::const_iterator it_keys = data.tags->begin();
             it_keys != data.tags->end(); ++it_keys)
         {
-          if (!std::binary_search(otherwise_set_keys.begin(), otherwise_set_keys.end(), it_keys->first))
-            existing_keys.insert(it_keys->first);
+          if (!std::binary_search(otherwise_set_keys.begin(), otherwise_set_keys.end(), *it_keys->first))
+            existing_keys.insert(*it_keys->first);
         }
       }
     }
@@ -270,11 +270,11 @@ void eval_elems(std::set< std::string >& existing_keys, Set_With_Context& input_
       Element_With_Context< Derived_Skeleton > data = input_set.get_context(idx_it->first, *elem_it);
       if (data.tags)
       {
-        for (std::vector< std::pair< std::string, std::string > >::const_iterator it_keys = data.tags->begin();
+        for (Interned_Tags::const_iterator it_keys = data.tags->begin();
             it_keys != data.tags->end(); ++it_keys)
         {
-          if (!std::binary_search(otherwise_set_keys.begin(), otherwise_set_keys.end(), it_keys->first))
-            existing_keys.insert(it_keys->first);
+          if (!std::binary_search(otherwise_set_keys.begin(), otherwise_set_keys.end(), *it_keys->first))
+            existing_keys.insert(*it_keys->first);
         }
       }
     }
@@ -353,9 +353,9 @@ void process(const std::string& key, Set_Prop_Task::Mode mode, Eval_Task* rhs,
     if (data.tags)
     {
       std::vector< std::string > found_keys;
-      for (std::vector< std::pair< std::string, std::string > >::const_iterator it_keys = data.tags->begin();
+      for (Interned_Tags::const_iterator it_keys = data.tags->begin();
           it_keys != data.tags->end(); ++it_keys)
-        found_keys.push_back(it_keys->first);
+        found_keys.push_back(*it_keys->first);
       std::sort(found_keys.begin(), found_keys.end());
       found_keys.erase(std::unique(found_keys.begin(), found_keys.end()), found_keys.end());
       found_keys.erase(std::set_difference(found_keys.begin(), found_keys.end(),
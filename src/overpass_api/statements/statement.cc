@@ -57,6 +57,9 @@ std::map< std::string, std::vector< Statement::Evaluator_Maker* > >& Statement::
 void Statement::eval_attributes_array(std::string element, std::map< std::string, std::string >& attributes,
 				      const std::map< std::string, std::string >& input)
 {
+  if (attribute_observer)
+    attribute_observer->statement_created(this, element, input);
+
   for (std::map< std::string, std::string >::const_iterator it = input.begin(); it != input.end(); ++it)
   {
     std::map< std::string, std::string >::iterator ait(attributes.find(it->first));
@@ -103,6 +106,19 @@ void Statement::add_final_text(std::string text)
   assure_no_text(text, this->get_name());
 }
 
+bool Statement::prepare_batches(const std::vector< Statement* >& statements, Resource_Manager& rman,
+    const std::string& loop_set_name, const Set& loop_set, std::vector< Statement* >& prepared)
+{
+  for (std::vector< Statement* >::const_iterator it = statements.begin(); it != statements.end(); ++it)
+  {
+    if ((*it)->prepare_batch(rman, loop_set_name, loop_set, prepared)
+        || (*it)->get_result_name() == loop_set_name)
+      return true;
+  }
+  return false;
+}
+
+
 void Statement::display_full()
 {
   //display_verbatim(get_source(startpos, endpos - startpos));
@@ -341,6 +357,7 @@ Statement* Statement::Factory::create_criterion(const Token_Node_Ptr& tree_it,
 
 
 Error_Output* Statement::error_output = 0;
+Statement::Attribute_Observer* Statement::attribute_observer = 0;
 
 
 void Statement::add_static_error(std::string error)
@@ -93,6 +93,10 @@ class Query_Constraint
     // to minimize the number of elements that need to be processed.
     virtual void filter(const Statement& query, Resource_Manager& rman, Set& into) {}
 
+    // Estimated effort of the expensive filter, in bytes to read. The expensive filters
+    // of a query are applied in ascending order of their estimated effort.
+    virtual uint64 estimate_filter_effort(Resource_Manager&) { return 0; }
+
     virtual ~Query_Constraint() {}
     friend std::ostream & operator<<(std::ostream &os, const Query_Constraint& p);
 
@@ -198,6 +202,25 @@ class Statement
     // object.
     virtual Query_Constraint* get_query_constraint() { return 0; }
 
+    // Replaces the values of some attributes when a cached query plan is reused.
+    // Returns false if the statement does not support this or a value is invalid.
+    virtual bool bind_parameters(const std::map< std::string, std::string >&) { return false; }
+
+    // Called by loops with the name and content of their loop set before they execute their body
+    // once per element of that set. A statement that reads the loop set may evaluate itself
+    // for all elements at once here and then serve the single iterations from that result.
+    // It adds itself to the given list such that the loop can call clear_batch() when it is done.
+    // Returns true if one of its substatements replaces the loop set.
+    virtual bool prepare_batch(Resource_Manager&, const std::string&, const Set&, std::vector< Statement* >&)
+    { return false; }
+    virtual void clear_batch() {}
+
+    // Calls prepare_batch() for the statements up to the first one that replaces the loop set,
+    // because the statements after it do not read the loop set anymore.
+    // Returns true if one of the statements replaces the loop set.
+    static bool prepare_batches(const std::vector< Statement* >& statements, Resource_Manager& rman,
+        const std::string& loop_set_name, const Set& loop_set, std::vector< Statement* >& prepared);
+
     virtual ~Statement() {}
 
     int get_progress() const { return progress; }
@@ -222,6 +245,19 @@ class Statement
       error_output = error_output_;
     }
 
+    // Is told the attributes of each statement constructed while it is set
+    struct Attribute_Observer
+    {
+      virtual void statement_created(Statement* statement, const std::string& element,
+          const std::map< std::string, std::string >& attributes) = 0;
+      virtual ~Attribute_Observer() {}
+    };
+
+    static void set_attribute_observer(Attribute_Observer* attribute_observer_)
+    {
+      attribute_observer = attribute_observer_;
+    }
+
     void runtime_error(std::string error) const;
     void runtime_remark(std::string error) const;
 
@@ -233,6 +269,7 @@ class Statement
 
   private:
     static Error_Output* error_output;
+    static Attribute_Observer* attribute_observer;
 
     int line_number;
     int startpos, endpos, tagendpos;
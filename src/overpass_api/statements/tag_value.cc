@@ -114,16 +114,16 @@ Evaluator_Type::Evaluator_Type
 //-----------------------------------------------------------------------------
 
 
-std::string find_value(const std::vector< std::pair< std::string, std::string > >* tags, const std::string& key)
+std::string find_value(const Interned_Tags* tags, const std::string& key)
 {
   if (!tags)
     return "";
 
-  for (std::vector< std::pair< std::string, std::string > >::const_iterator it = tags->begin();
+  for (Interned_Tags::const_iterator it = tags->begin();
       it != tags->end(); ++it)
   {
-    if (it->first == key)
-      return it->second;
+    if (*it->first == key)
+      return *it->second;
   }
 
   return "";
@@ -264,15 +264,15 @@ std::string Value_Eval_Task::eval(const Element_With_Context< Derived_Skeleton >
 //-----------------------------------------------------------------------------
 
 
-std::string exists_value(const std::vector< std::pair< std::string, std::string > >* tags, const std::string& key)
+std::string exists_value(const Interned_Tags* tags, const std::string& key)
 {
   if (!tags)
     return "0";
 
-  for (std::vector< std::pair< std::string, std::string > >::const_iterator it = tags->begin();
+  for (Interned_Tags::const_iterator it = tags->begin();
       it != tags->end(); ++it)
   {
-    if (it->first == key)
+    if (*it->first == key)
       return "1";
   }
 
@@ -326,15 +326,15 @@ Evaluator_All_Keys::Statement_Maker Evaluator_All_Keys::statement_maker;
 Element_Function_Maker< Evaluator_All_Keys > Evaluator_All_Keys::evaluator_maker;
 
 
-std::vector< std::string > all_keys(const std::vector< std::pair< std::string, std::string > >* tags)
+std::vector< std::string > all_keys(const Interned_Tags* tags)
 {
   std::vector< std::string > result;
   if (!tags)
     return result;
 
-  for (std::vector< std::pair< std::string, std::string > >::const_iterator it = tags->begin();
+  for (Interned_Tags::const_iterator it = tags->begin();
       it != tags->end(); ++it)
-    result.push_back(it->first);
+    result.push_back(*it->first);
 
   std::sort(result.begin(), result.end());
   result.erase(std::unique(result.begin(), result.end()), result.end());
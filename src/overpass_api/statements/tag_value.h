@@ -240,7 +240,7 @@ Its syntax is
   ::
 */
 
-std::string find_value(const std::vector< std::pair< std::string, std::string > >* tags, const std::string& key);
+std::string find_value(const Interned_Tags* tags, const std::string& key);
 
 
 struct Value_Eval_Task final : public Eval_Task
@@ -308,7 +308,7 @@ private:
 };
 
 
-std::string exists_value(const std::vector< std::pair< std::string, std::string > >* tags, const std::string& key);
+std::string exists_value(const Interned_Tags* tags, const std::string& key);
 
 
 struct Is_Tag_Eval_Task final : public Eval_Task
@@ -448,7 +448,7 @@ Its syntax is
 */
 
 
-std::vector< std::string > all_keys(const std::vector< std::pair< std::string, std::string > >* tags);
+std::vector< std::string > all_keys(const Interned_Tags* tags);
 
 
 struct All_Keys_Eval_Task final : public Eval_Container_Task
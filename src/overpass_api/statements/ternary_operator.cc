@@ -109,131 +109,209 @@ Eval_Task* Ternary_Evaluator::get_string_task(Prepare_Task_Context& context, con
 
 std::string Ternary_Eval_Task::eval(const std::string* key) const
 {
-  if (!condition)
-    return "0";
-  if (string_represents_boolean_true(condition->eval(key)))
-    return lhs ? lhs->eval(key) : "";
-  return rhs ? rhs->eval(key) : "";
+  return eval_value(key).release_str();
 }
 
 
 std::string Ternary_Eval_Task::eval(const Element_With_Context< Node_Skeleton >& data, const std::string* key) const
 {
-  if (!condition)
-    return "0";
-  if (string_represents_boolean_true(condition->eval(data, key)))
-    return lhs ? lhs->eval(data, key) : "";
-  return rhs ? rhs->eval(data, key) : "";
+  return eval_value(data, key).release_str();
 }
 
 
 std::string Ternary_Eval_Task::eval(const Element_With_Context< Attic< Node_Skeleton > >& data, const std::string* key) const
 {
-  if (!condition)
-    return "0";
-  if (string_represents_boolean_true(condition->eval(data, key)))
-    return lhs ? lhs->eval(data, key) : "";
-  return rhs ? rhs->eval(data, key) : "";
+  return eval_value(data, key).release_str();
 }
 
 
 std::string Ternary_Eval_Task::eval(const Element_With_Context< Way_Skeleton >& data, const std::string* key) const
 {
-  if (!condition)
-    return "0";
-  if (string_represents_boolean_true(condition->eval(data, key)))
-    return lhs ? lhs->eval(data, key) : "";
-  return rhs ? rhs->eval(data, key) : "";
+  return eval_value(data, key).release_str();
 }
 
 
 std::string Ternary_Eval_Task::eval(const Element_With_Context< Attic< Way_Skeleton > >& data, const std::string* key) const
 {
-  if (!condition)
-    return "0";
-  if (string_represents_boolean_true(condition->eval(data, key)))
-    return lhs ? lhs->eval(data, key) : "";
-  return rhs ? rhs->eval(data, key) : "";
+  return eval_value(data, key).release_str();
 }
 
 
 std::string Ternary_Eval_Task::eval(const Element_With_Context< Relation_Skeleton >& data, const std::string* key) const
 {
-  if (!condition)
-    return "0";
-  if (string_represents_boolean_true(condition->eval(data, key)))
-    return lhs ? lhs->eval(data, key) : "";
-  return rhs ? rhs->eval(data, key) : "";
+  return eval_value(data, key).release_str();
 }
 
 
 std::string Ternary_Eval_Task::eval(const Element_With_Context< Attic< Relation_Skeleton > >& data, const std::string* key) const
 {
-  if (!condition)
-    return "0";
-  if (string_represents_boolean_true(condition->eval(data, key)))
-    return lhs ? lhs->eval(data, key) : "";
-  return rhs ? rhs->eval(data, key) : "";
+  return eval_value(data, key).release_str();
 }
 
 
 std::string Ternary_Eval_Task::eval(const Element_With_Context< Area_Skeleton >& data, const std::string* key) const
 {
-  if (!condition)
-    return "0";
-  if (string_represents_boolean_true(condition->eval(data, key)))
-    return lhs ? lhs->eval(data, key) : "";
-  return rhs ? rhs->eval(data, key) : "";
+  return eval_value(data, key).release_str();
 }
 
 
 std::string Ternary_Eval_Task::eval(const Element_With_Context< Derived_Skeleton >& data, const std::string* key) const
 {
-  if (!condition)
-    return "0";
-  if (string_represents_boolean_true(condition->eval(data, key)))
-    return lhs ? lhs->eval(data, key) : "";
-  return rhs ? rhs->eval(data, key) : "";
+  return eval_value(data, key).release_str();
 }
 
 
 std::string Ternary_Eval_Task::eval(uint pos, const Element_With_Context< Way_Skeleton >& data, const std::string* key) const
 {
-  if (!condition)
-    return "0";
-  if (string_represents_boolean_true(condition->eval(pos, data, key)))
-    return lhs ? lhs->eval(pos, data, key) : "";
-  return rhs ? rhs->eval(pos, data, key) : "";
+  return eval_value(pos, data, key).release_str();
 }
 
 
 std::string Ternary_Eval_Task::eval(uint pos, const Element_With_Context< Attic< Way_Skeleton > >& data, const std::string* key) const
 {
-  if (!condition)
-    return "0";
-  if (string_represents_boolean_true(condition->eval(pos, data, key)))
-    return lhs ? lhs->eval(pos, data, key) : "";
-  return rhs ? rhs->eval(pos, data, key) : "";
+  return eval_value(pos, data, key).release_str();
 }
 
 
 std::string Ternary_Eval_Task::eval(uint pos, const Element_With_Context< Relation_Skeleton >& data, const std::string* key) const
 {
-  if (!condition)
-    return "0";
-  if (string_represents_boolean_true(condition->eval(pos, data, key)))
-    return lhs ? lhs->eval(pos, data, key) : "";
-  return rhs ? rhs->eval(pos, data, key) : "";
+  return eval_value(pos, data, key).release_str();
 }
 
 
 std::string Ternary_Eval_Task::eval(uint pos, const Element_With_Context< Attic< Relation_Skeleton > >& data, const std::string* key) const
+{
+  return eval_value(pos, data, key).release_str();
+}
+
+
+Eval_Value Ternary_Eval_Task::eval_value(const std::string* key) const
+{
+  if (!condition)
+    return Eval_Value::of_bool(false);
+  if (condition->eval_value(key).represents_boolean_true())
+    return lhs ? lhs->eval_value(key) : Eval_Value();
+  return rhs ? rhs->eval_value(key) : Eval_Value();
+}
+
+
+Eval_Value Ternary_Eval_Task::eval_value(const Element_With_Context< Node_Skeleton >& data, const std::string* key) const
+{
+  if (!condition)
+    return Eval_Value::of_bool(false);
+  if (condition->eval_value(data, key).represents_boolean_true())
+    return lhs ? lhs->eval_value(data, key) : Eval_Value();
+  return rhs ? rhs->eval_value(data, key) : Eval_Value();
+}
+
+
+Eval_Value Ternary_Eval_Task::eval_value(const Element_With_Context< Attic< Node_Skeleton > >& data, const std::string* key) const
+{
+  if (!condition)
+    return Eval_Value::of_bool(false);
+  if (condition->eval_value(data, key).represents_boolean_true())
+    return lhs ? lhs->eval_value(data, key) : Eval_Value();
+  return rhs ? rhs->eval_value(data, key) : Eval_Value();
+}
+
+
+Eval_Value Ternary_Eval_Task::eval_value(const Element_With_Context< Way_Skeleton >& data, const std::string* key) const
+{
+  if (!condition)
+    return Eval_Value::of_bool(false);
+  if (condition->eval_value(data, key).represents_boolean_true())
+    return lhs ? lhs->eval_value(data, key) : Eval_Value();
+  return rhs ? rhs->eval_value(data, key) : Eval_Value();
+}
+
+
+Eval_Value Ternary_Eval_Task::eval_value(const Element_With_Context< Attic< Way_Skeleton > >& data, const std::string* key) const
+{
+  if (!condition)
+    return Eval_Value::of_bool(false);
+  if (condition->eval_value(data, key).represents_boolean_true())
+    return lhs ? lhs->eval_value(data, key) : Eval_Value();
+  return rhs ? rhs->eval_value(data, key) : Eval_Value();
+}
+
+
+Eval_Value Ternary_Eval_Task::eval_value(const Element_With_Context< Relation_Skeleton >& data, const std::string* key) const
+{
+  if (!condition)
+    return Eval_Value::of_bool(false);
+  if (condition->eval_value(data, key).represents_boolean_true())
+    return lhs ? lhs->eval_value(data, key) : Eval_Value();
+  return rhs ? rhs->eval_value(data, key) : Eval_Value();
+}
+
+
+Eval_Value Ternary_Eval_Task::eval_value(const Element_With_Context< Attic< Relation_Skeleton > >& data, const std::string* key) const
+{
+  if (!condition)
+    return Eval_Value::of_bool(false);
+  if (condition->eval_value(data, key).represents_boolean_true())
+    return lhs ? lhs->eval_value(data, key) : Eval_Value();
+  return rhs ? rhs->eval_value(data, key) : Eval_Value();
+}
+
+
+Eval_Value Ternary_Eval_Task::eval_value(const Element_With_Context< Area_Skeleton >& data, const std::string* key) const
+{
+  if (!condition)
+    return Eval_Value::of_bool(false);
+  if (condition->eval_value(data, key).represents_boolean_true())
+    return lhs ? lhs->eval_value(data, key) : Eval_Value();
+  return rhs ? rhs->eval_value(data, key) : Eval_Value();
+}
+
+
+Eval_Value Ternary_Eval_Task::eval_value(const Element_With_Context< Derived_Skeleton >& data, const std::string* key) const
+{
+  if (!condition)
+    return Eval_Value::of_bool(false);
+  if (condition->eval_value(data, key).represents_boolean_true())
+    return lhs ? lhs->eval_value(data, key) : Eval_Value();
+  return rhs ? rhs->eval_value(data, key) : Eval_Value();
+}
+
+
+Eval_Value Ternary_Eval_Task::eval_value(uint pos, const Element_With_Context< Way_Skeleton >& data, const std::string* key) const
+{
+  if (!condition)
+    return Eval_Value::of_bool(false);
+  if (condition->eval_value(pos, data, key).represents_boolean_true())
+    return lhs ? lhs->eval_value(pos, data, key) : Eval_Value();
+  return rhs ? rhs->eval_value(pos, data, key) : Eval_Value();
+}
+
+
+Eval_Value Ternary_Eval_Task::eval_value(uint pos, const Element_With_Context< Attic< Way_Skeleton > >& data, const std::string* key) const
+{
+  if (!condition)
+    return Eval_Value::of_bool(false);
+  if (condition->eval_value(pos, data, key).represents_boolean_true())
+    return lhs ? lhs->eval_value(pos, data, key) : Eval_Value();
+  return rhs ? rhs->eval_value(pos, data, key) : Eval_Value();
+}
+
+
+Eval_Value Ternary_Eval_Task::eval_value(uint pos, const Element_With_Context< Relation_Skeleton >& data, const std::string* key) const
+{
+  if (!condition)
+    return Eval_Value::of_bool(false);
+  if (condition->eval_value(pos, data, key).represents_boolean_true())
+    return lhs ? lhs->eval_value(pos, data, key) : Eval_Value();
+  return rhs ? rhs->eval_value(pos, data, key) : Eval_Value();
+}
+
+
+Eval_Value Ternary_Eval_Task::eval_value(uint pos, const Element_With_Context< Attic< Relation_Skeleton > >& data, const std::string* key) const
 {
   if (!condition)
-    return "0";
-  if (string_represents_boolean_true(condition->eval(pos, data, key)))
-    return lhs ? lhs->eval(pos, data, key) : "";
-  return rhs ? rhs->eval(pos, data, key) : "";
+    return Eval_Value::of_bool(false);
+  if (condition->eval_value(pos, data, key).represents_boolean_true())
+    return lhs ? lhs->eval_value(pos, data, key) : Eval_Value();
+  return rhs ? rhs->eval_value(pos, data, key) : Eval_Value();
 }
 
 
@@ -250,7 +328,7 @@ Opaque_Geometry* Ternary_Eval_Geometry_Task::eval() const
 {
   if (!condition)
     return 0;
-  if (string_represents_boolean_true(condition->eval(0)))
+  if (condition->eval_value(0).represents_boolean_true())
     return lhs ? lhs->eval() : 0;
   return rhs ? rhs->eval() : 0;
 }
@@ -260,7 +338,7 @@ Opaque_Geometry* Ternary_Eval_Geometry_Task::eval(const Element_With_Context< No
 {
   if (!condition)
     return 0;
-  if (string_represents_boolean_true(condition->eval(data, 0)))
+  if (condition->eval_value(data, 0).represents_boolean_true())
     return lhs ? lhs->eval(data) : 0;
   return rhs ? rhs->eval(data) : 0;
 }
@@ -270,7 +348,7 @@ Opaque_Geometry* Ternary_Eval_Geometry_Task::eval(const Element_With_Context< At
 {
   if (!condition)
     return 0;
-  if (string_represents_boolean_true(condition->eval(data, 0)))
+  if (condition->eval_value(data, 0).represents_boolean_true())
     return lhs ? lhs->eval(data) : 0;
   return rhs ? rhs->eval(data) : 0;
 }
@@ -280,7 +358,7 @@ Opaque_Geometry* Ternary_Eval_Geometry_Task::eval(const Element_With_Context< Wa
 {
   if (!condition)
     return 0;
-  if (string_represents_boolean_true(condition->eval(data, 0)))
+  if (condition->eval_value(data, 0).represents_boolean_true())
     return lhs ? lhs->eval(data) : 0;
   return rhs ? rhs->eval(data) : 0;
 }
@@ -290,7 +368,7 @@ Opaque_Geometry* Ternary_Eval_Geometry_Task::eval(const Element_With_Context< At
 {
   if (!condition)
     return 0;
-  if (string_represents_boolean_true(condition->eval(data, 0)))
+  if (condition->eval_value(data, 0).represents_boolean_true())
     return lhs ? lhs->eval(data) : 0;
   return rhs ? rhs->eval(data) : 0;
 }
@@ -300,7 +378,7 @@ Opaque_Geometry* Ternary_Eval_Geometry_Task::eval(const Element_With_Context< Re
 {
   if (!condition)
     return 0;
-  if (string_represents_boolean_true(condition->eval(data, 0)))
+  if (condition->eval_value(data, 0).represents_boolean_true())
     return lhs ? lhs->eval(data) : 0;
   return rhs ? rhs->eval(data) : 0;
 }
@@ -310,7 +388,7 @@ Opaque_Geometry* Ternary_Eval_Geometry_Task::eval(const Element_With_Context< At
 {
   if (!condition)
     return 0;
-  if (string_represents_boolean_true(condition->eval(data, 0)))
+  if (condition->eval_value(data, 0).represents_boolean_true())
     return lhs ? lhs->eval(data) : 0;
   return rhs ? rhs->eval(data) : 0;
 }
@@ -320,7 +398,7 @@ Opaque_Geometry* Ternary_Eval_Geometry_Task::eval(const Element_With_Context< Ar
 {
   if (!condition)
     return 0;
-  if (string_represents_boolean_true(condition->eval(data, 0)))
+  if (condition->eval_value(data, 0).represents_boolean_true())
     return lhs ? lhs->eval(data) : 0;
   return rhs ? rhs->eval(data) : 0;
 }
@@ -330,7 +408,7 @@ Opaque_Geometry* Ternary_Eval_Geometry_Task::eval(const Element_With_Context< De
 {
   if (!condition)
     return 0;
-  if (string_represents_boolean_true(condition->eval(data, 0)))
+  if (condition->eval_value(data, 0).represents_boolean_true())
     return lhs ? lhs->eval(data) : 0;
   return rhs ? rhs->eval(data) : 0;
 }
@@ -51,79 +51,157 @@ Requested_Context Evaluator_Unary_Function::request_context() const
 
 std::string Unary_Eval_Task::eval(const std::string* key) const
 {
-  return evaluator->process(rhs ? rhs->eval(key) : "");
+  return eval_value(key).release_str();
 }
 
 
 std::string Unary_Eval_Task::eval(const Element_With_Context< Node_Skeleton >& data, const std::string* key) const
 {
-  return evaluator->process(rhs ? rhs->eval(data, key) : "");
+  return eval_value(data, key).release_str();
 }
 
 
 std::string Unary_Eval_Task::eval(const Element_With_Context< Attic< Node_Skeleton > >& data, const std::string* key) const
 {
-  return evaluator->process(rhs ? rhs->eval(data, key) : "");
+  return eval_value(data, key).release_str();
 }
 
 
 std::string Unary_Eval_Task::eval(const Element_With_Context< Way_Skeleton >& data, const std::string* key) const
 {
-  return evaluator->process(rhs ? rhs->eval(data, key) : "");
+  return eval_value(data, key).release_str();
 }
 
 
 std::string Unary_Eval_Task::eval(const Element_With_Context< Attic< Way_Skeleton > >& data, const std::string* key) const
 {
-  return evaluator->process(rhs ? rhs->eval(data, key) : "");
+  return eval_value(data, key).release_str();
 }
 
 
 std::string Unary_Eval_Task::eval(const Element_With_Context< Relation_Skeleton >& data, const std::string* key) const
 {
-  return evaluator->process(rhs ? rhs->eval(data, key) : "");
+  return eval_value(data, key).release_str();
 }
 
 
 std::string Unary_Eval_Task::eval(const Element_With_Context< Attic< Relation_Skeleton > >& data, const std::string* key) const
 {
-  return evaluator->process(rhs ? rhs->eval(data, key) : "");
+  return eval_value(data, key).release_str();
 }
 
 
 std::string Unary_Eval_Task::eval(const Element_With_Context< Area_Skeleton >& data, const std::string* key) const
 {
-  return evaluator->process(rhs ? rhs->eval(data, key) : "");
+  return eval_value(data, key).release_str();
 }
 
 
 std::string Unary_Eval_Task::eval(const Element_With_Context< Derived_Skeleton >& data, const std::string* key) const
 {
-  return evaluator->process(rhs ? rhs->eval(data, key) : "");
+  return eval_value(data, key).release_str();
 }
 
 
 std::string Unary_Eval_Task::eval(uint pos, const Element_With_Context< Way_Skeleton >& data, const std::string* key) const
 {
-  return evaluator->process(rhs ? rhs->eval(pos, data, key) : "");
+  return eval_value(pos, data, key).release_str();
 }
 
 
 std::string Unary_Eval_Task::eval(uint pos, const Element_With_Context< Attic< Way_Skeleton > >& data, const std::string* key) const
 {
-  return evaluator->process(rhs ? rhs->eval(pos, data, key) : "");
+  return eval_value(pos, data, key).release_str();
 }
 
 
 std::string Unary_Eval_Task::eval(uint pos, const Element_With_Context< Relation_Skeleton >& data, const std::string* key) const
 {
-  return evaluator->process(rhs ? rhs->eval(pos, data, key) : "");
+  return eval_value(pos, data, key).release_str();
 }
 
 
 std::string Unary_Eval_Task::eval(uint pos, const Element_With_Context< Attic< Relation_Skeleton > >& data, const std::string* key) const
 {
-  return evaluator->process(rhs ? rhs->eval(pos, data, key) : "");
+  return eval_value(pos, data, key).release_str();
+}
+
+
+Eval_Value Unary_Eval_Task::eval_value(const std::string* key) const
+{
+  return evaluator->process_value(rhs ? rhs->eval_value(key) : Eval_Value());
+}
+
+
+Eval_Value Unary_Eval_Task::eval_value(const Element_With_Context< Node_Skeleton >& data, const std::string* key) const
+{
+  return evaluator->process_value(rhs ? rhs->eval_value(data, key) : Eval_Value());
+}
+
+
+Eval_Value Unary_Eval_Task::eval_value(const Element_With_Context< Attic< Node_Skeleton > >& data, const std::string* key) const
+{
+  return evaluator->process_value(rhs ? rhs->eval_value(data, key) : Eval_Value());
+}
+
+
+Eval_Value Unary_Eval_Task::eval_value(const Element_With_Context< Way_Skeleton >& data, const std::string* key) const
+{
+  return evaluator->process_value(rhs ? rhs->eval_value(data, key) : Eval_Value());
+}
+
+
+Eval_Value Unary_Eval_Task::eval_value(const Element_With_Context< Attic< Way_Skeleton > >& data, const std::string* key) const
+{
+  return evaluator->process_value(rhs ? rhs->eval_value(data, key) : Eval_Value());
+}
+
+
+Eval_Value Unary_Eval_Task::eval_value(const Element_With_Context< Relation_Skeleton >& data, const std::string* key) const
+{
+  return evaluator->process_value(rhs ? rhs->eval_value(data, key) : Eval_Value());
+}
+
+
+Eval_Value Unary_Eval_Task::eval_value(const Element_With_Context< Attic< Relation_Skeleton > >& data, const std::string* key) const
+{
+  return evaluator->process_value(rhs ? rhs->eval_value(data, key) : Eval_Value());
+}
+
+
+Eval_Value Unary_Eval_Task::eval_value(const Element_With_Context< Area_Skeleton >& data, const std::string* key) const
+{
+  return evaluator->process_value(rhs ? rhs->eval_value(data, key) : Eval_Value());
+}
+
+
+Eval_Value Unary_Eval_Task::eval_value(const Element_With_Context< Derived_Skeleton >& data, const std::string* key) const
+{
+  return evaluator->process_value(rhs ? rhs->eval_value(data, key) : Eval_Value());
+}
+
+
+Eval_Value Unary_Eval_Task::eval_value(uint pos, const Element_With_Context< Way_Skeleton >& data, const std::string* key) const
+{
+  return evaluator->process_value(rhs ? rhs->eval_value(pos, data, key) : Eval_Value());
+}
+
+
+Eval_Value Unary_Eval_Task::eval_value(uint pos, const Element_With_Context< Attic< Way_Skeleton > >& data, const std::string* key) const
+{
+  return evaluator->process_value(rhs ? rhs->eval_value(pos, data, key) : Eval_Value());
+}
+
+
+Eval_Value Unary_Eval_Task::eval_value(uint pos, const Element_With_Context< Relation_Skeleton >& data, const std::string* key) const
+{
+  return evaluator->process_value(rhs ? rhs->eval_value(pos, data, key) : Eval_Value());
+}
+
+
+Eval_Value Unary_Eval_Task::eval_value(uint pos, const Element_With_Context< Attic< Relation_Skeleton > >& data, const std::string* key) const
+{
+  return evaluator->process_value(rhs ? rhs->eval_value(pos, data, key) : Eval_Value());
 }
 
 
@@ -51,7 +51,13 @@ Operator_Eval_Maker< Evaluator_Not > Evaluator_Not::evaluator_maker;
 
 std::string Evaluator_Not::process(const std::string& rhs_s) const
 {
-  return string_represents_boolean_true(rhs_s) ? "0" : "1";
+  return process_value(Eval_Value(rhs_s)).release_str();
+}
+
+
+Eval_Value Evaluator_Not::process_value(const Eval_Value& rhs_v) const
+{
+  return Eval_Value::of_bool(!rhs_v.represents_boolean_true());
 }
 
 
@@ -63,14 +69,20 @@ Operator_Eval_Maker< Evaluator_Negate > Evaluator_Negate::evaluator_maker;
 
 
 std::string Evaluator_Negate::process(const std::string& rhs_s) const
+{
+  return process_value(Eval_Value(rhs_s)).release_str();
+}
+
+
+Eval_Value Evaluator_Negate::process_value(const Eval_Value& rhs_v) const
 {
   int64 rhs_l = 0;
-  if (try_int64(rhs_s, rhs_l))
-    return to_string(-rhs_l);
+  if (rhs_v.try_int64(rhs_l))
+    return Eval_Value::of_int64(-rhs_l);
 
   double rhs_d = 0;
-  if (try_double(rhs_s, rhs_d))
-    return to_string(-rhs_d);
+  if (rhs_v.try_double(rhs_d))
+    return Eval_Value::of_double(-rhs_d);
 
-  return "NaN";
+  return Eval_Value(std::string("NaN"));
 }
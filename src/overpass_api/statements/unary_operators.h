@@ -128,6 +128,7 @@ public:
       : Evaluator_Prefix_Operator_Syntax< Evaluator_Not >(line_number_, input_attributes) {}
 
   virtual std::string process(const std::string& rhs_result) const;
+  virtual Eval_Value process_value(const Eval_Value& rhs_result) const;
 };
 
 
@@ -156,6 +157,7 @@ public:
       : Evaluator_Prefix_Operator_Syntax< Evaluator_Negate >(line_number_, input_attributes) {}
 
   virtual std::string process(const std::string& rhs_result) const;
+  virtual Eval_Value process_value(const Eval_Value& rhs_result) const;
 };
 
 
@@ -138,3 +138,10 @@ void Union_Statement::execute(Resource_Manager& rman)
 
   rman.health_check(*this);
 }
+
+
+bool Union_Statement::prepare_batch(Resource_Manager& rman, const std::string& loop_set_name, const Set& loop_set,
+    std::vector< Statement* >& prepared)
+{
+  return prepare_batches(substatements, rman, loop_set_name, loop_set, prepared);
+}
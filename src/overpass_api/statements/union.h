@@ -34,6 +34,8 @@ class Union_Statement final : public Output_Statement
     virtual void add_statement(Statement* statement, std::string text);
     virtual std::string get_name() const { return "union"; }
     virtual void execute(Resource_Manager& rman);
+    virtual bool prepare_batch(Resource_Manager& rman, const std::string& loop_set_name, const Set& loop_set,
+        std::vector< Statement* >& prepared);
     virtual ~Union_Statement() {}
 
     static Generic_Statement_Maker< Union_Statement > statement_maker;
@@ -384,6 +384,39 @@ struct Block_Backend_Flat_Iterator final
 //-----------------------------------------------------------------------------
 
 
+/* Keeps the kernel busy with loading the next blocks while the current block is processed.
+ * The ahead iterator runs up to PREFETCH_DEPTH blocks in front of the iterator that is read. */
+template< typename File_Blocks, typename File_Iterator >
+struct Block_Prefetch_Window
+{
+  static const uint32 PREFETCH_DEPTH = 8;
+
+  Block_Prefetch_Window(const File_Iterator& begin, const File_Iterator& end)
+      : ahead(begin), ahead_end(end), distance(0) {}
+
+  // Must be called before the block at the current position is read.
+  void before_read(const File_Blocks& file_blocks)
+  {
+    while (distance < PREFETCH_DEPTH && !(ahead == ahead_end))
+    {
+      file_blocks.prefetch_block(ahead);
+      ++ahead;
+      ++distance;
+    }
+    if (distance > 0)
+      --distance;
+  }
+
+private:
+  File_Iterator ahead;
+  File_Iterator ahead_end;
+  uint32 distance;
+};
+
+
+//-----------------------------------------------------------------------------
+
+
 template< typename Index, typename Iterator >
 struct Discrete_Idx_Assessor
 {
@@ -408,12 +441,14 @@ template< typename File_Blocks, typename File_Iterator >
 struct Discrete_File_Handle
 {
   Discrete_File_Handle(File_Blocks& file_blocks_, const File_Iterator& file_it_)
-      : file_blocks(&file_blocks_), file_it(file_it_), file_end(file_blocks_.discrete_end()) {}
+      : file_blocks(&file_blocks_), file_it(file_it_), file_end(file_blocks_.discrete_end()),
+      prefetch(file_it_, file_end) {}
 
   bool next(uint64* ptr, bool check_idx = true)
   {
     if (file_it == file_end)
       return false;
+    prefetch.before_read(*file_blocks);
     file_blocks->read_block(file_it, ptr, check_idx);
     ++file_it;
     return true;
@@ -428,6 +463,7 @@ private:
   const File_Blocks* file_blocks;
   File_Iterator file_it;
   File_Iterator file_end;
+  Block_Prefetch_Window< File_Blocks, File_Iterator > prefetch;
 };
 
 
@@ -486,12 +522,14 @@ template< typename File_Blocks, typename File_Iterator >
 struct Range_File_Handle
 {
   Range_File_Handle(File_Blocks& file_blocks_, const File_Iterator& file_it_)
-      : file_blocks(&file_blocks_), file_it(file_it_), file_end(file_blocks_.range_end()) {}
+      : file_blocks(&file_blocks_), file_it(file_it_), file_end(file_blocks_.range_end()),
+      prefetch(file_it_, file_end) {}
 
   bool next(uint64* ptr, bool check_idx = true)
   {
     if (file_it == file_end)
       return false;
+    prefetch.before_read(*file_blocks);
     file_blocks->read_block(file_it, ptr, check_idx);
     ++file_it;
     return true;
@@ -506,6 +544,7 @@ private:
   const File_Blocks* file_blocks;
   File_Iterator file_it;
   File_Iterator file_end;
+  Block_Prefetch_Window< File_Blocks, File_Iterator > prefetch;
 };
 
 
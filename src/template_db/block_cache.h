@@ -0,0 +1,246 @@
+/** Copyright 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018 Roland Olbricht et al.
+ *
+ * This file is part of Overpass_API.
+ *
+ * Overpass_API is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Overpass_API is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Overpass_API.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DE__OSM3S___TEMPLATE_DB__BLOCK_CACHE_H
+#define DE__OSM3S___TEMPLATE_DB__BLOCK_CACHE_H
+
+#include "types.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+
+/** Cache of decompressed data blocks in a shared memory segment.
+ *
+ * The segment is created by the dispatcher and attached by every reading process.
+ * Entries are keyed by the data file, the block position and the commit generation
+ * of the dispatcher (see Dispatcher::OFFSET_COMMIT_GENERATION). Because blocks on disk
+ * are never overwritten while a reader of the same generation may refer to them,
+ * an entry stays valid for all readers that have pinned the same generation.
+ *
+ * Each slot is guarded by a sequence counter: an odd value means that a process is writing
+ * to the slot. Readers copy the payload and discard it if the counter has changed meanwhile.
+ * No process ever waits on another process. */
+class Shared_Block_Cache
+{
+  Shared_Block_Cache(const Shared_Block_Cache&);
+  Shared_Block_Cache& operator=(const Shared_Block_Cache&);
+
+public:
+  static const uint32 MAGIC = 0x4b4c4243;
+  static const uint32 DEFAULT_SLOT_SIZE = 512*1024;
+
+  // Creates the shared memory segment. Only the dispatcher calls this.
+  Shared_Block_Cache(const std::string& shm_name, uint64 total_size, uint32 slot_size = DEFAULT_SLOT_SIZE);
+
+  // Attaches to an existing shared memory segment.
+  explicit Shared_Block_Cache(const std::string& shm_name);
+
+  ~Shared_Block_Cache();
+
+  uint32 get_slot_size() const { return header()->slot_size; }
+  uint32 get_slot_count() const { return header()->slot_count; }
+
+  // Copies the block into buf if it is present and returns true.
+  bool get(uint64 file_key, uint32 pos, uint32 generation, void* buf, uint32 size) const;
+
+  // Stores a copy of the block. Silently does nothing if the block is too large
+  // or the chosen slot is just written by another process.
+  void put(uint64 file_key, uint32 pos, uint32 generation, const void* buf, uint32 size);
+
+  static uint64 file_key(const std::string& file_name);
+
+private:
+  struct Header
+  {
+    uint32 magic;
+    uint32 slot_size;
+    uint32 slot_count;
+  };
+
+  struct Slot_Header
+  {
+    std::atomic< uint32 > sequence;
+    uint32 generation;
+    uint32 pos;
+    uint32 size;
+    uint64 file_key;
+  };
+
+  std::string shm_name;
+  bool is_owner;
+  int shm_fd;
+  uint64 shm_size;
+  uint8* shm_ptr;
+
+  Header* header() const { return (Header*)shm_ptr; }
+  Slot_Header* slot(uint32 i) const
+  { return (Slot_Header*)(shm_ptr + sizeof(uint64)*4 + (uint64)i*(sizeof(Slot_Header) + header()->slot_size)); }
+  uint8* payload(Slot_Header* slot) const { return ((uint8*)slot) + sizeof(Slot_Header); }
+  uint32 slot_of(uint64 file_key, uint32 pos) const;
+};
+
+
+//-----------------------------------------------------------------------------
+
+
+inline Shared_Block_Cache::Shared_Block_Cache(const std::string& shm_name_, uint64 total_size, uint32 slot_size)
+  : shm_name(shm_name_), is_owner(true), shm_fd(-1), shm_size(0), shm_ptr(0)
+{
+  uint32 slot_count = total_size / (sizeof(Slot_Header) + slot_size);
+  if (slot_count < 2)
+    throw File_Error(0, shm_name, "Shared_Block_Cache: cache size too small");
+  slot_count &= ~1u;
+  shm_size = sizeof(uint64)*4 + (uint64)slot_count*(sizeof(Slot_Header) + slot_size);
+
+  shm_fd = shm_open(shm_name.c_str(), O_RDWR|O_CREAT|O_TRUNC, S_644);
+  if (shm_fd < 0)
+    throw File_Error(errno, shm_name, "Shared_Block_Cache::1");
+  fchmod(shm_fd, S_644);
+  if (ftruncate(shm_fd, shm_size) != 0)
+    throw File_Error(errno, shm_name, "Shared_Block_Cache::2");
+  shm_ptr = (uint8*)mmap(0, shm_size, PROT_READ|PROT_WRITE, MAP_SHARED, shm_fd, 0);
+  if (shm_ptr == MAP_FAILED)
+    throw File_Error(errno, shm_name, "Shared_Block_Cache::3");
+
+  // ftruncate has zeroed the segment, hence all slots are empty with an even sequence counter.
+  header()->magic = MAGIC;
+  header()->slot_size = slot_size;
+  header()->slot_count = slot_count;
+}
+
+
+inline Shared_Block_Cache::Shared_Block_Cache(const std::string& shm_name_)
+  : shm_name(shm_name_), is_owner(false), shm_fd(-1), shm_size(0), shm_ptr(0)
+{
+  shm_fd = shm_open(shm_name.c_str(), O_RDWR, S_644);
+  if (shm_fd < 0)
+    throw File_Error(errno, shm_name, "Shared_Block_Cache::4");
+  struct stat stat_buf;
+  if (fstat(shm_fd, &stat_buf) != 0 || (uint64)stat_buf.st_size < sizeof(uint64)*4)
+  {
+    close(shm_fd);
+    throw File_Error(errno, shm_name, "Shared_Block_Cache::5");
+  }
+  shm_size = stat_buf.st_size;
+  shm_ptr = (uint8*)mmap(0, shm_size, PROT_READ|PROT_WRITE, MAP_SHARED, shm_fd, 0);
+  if (shm_ptr == MAP_FAILED)
+  {
+    close(shm_fd);
+    throw File_Error(errno, shm_name, "Shared_Block_Cache::6");
+  }
+  if (header()->magic != MAGIC
+      || shm_size < sizeof(uint64)*4 + (uint64)header()->slot_count*(sizeof(Slot_Header) + header()->slot_size))
+  {
+    munmap(shm_ptr, shm_size);
+    close(shm_fd);
+    throw File_Error(0, shm_name, "Shared_Block_Cache: segment has an unexpected layout");
+  }
+}
+
+
+inline Shared_Block_Cache::~Shared_Block_Cache()
+{
+  munmap(shm_ptr, shm_size);
+  close(shm_fd);
+  if (is_owner)
+    shm_unlink(shm_name.c_str());
+}
+
+
+inline uint64 Shared_Block_Cache::file_key(const std::string& file_name)
+{
+  // FNV-1a
+  uint64 result = 14695981039346656037ull;
+  for (std::string::size_type i = 0; i < file_name.size(); ++i)
+  {
+    result ^= (uint8)file_name[i];
+    result *= 1099511628211ull;
+  }
+  return result;
+}
+
+
+inline uint32 Shared_Block_Cache::slot_of(uint64 file_key, uint32 pos) const
+{
+  uint64 hash = (file_key ^ ((uint64)pos * 0x9e3779b97f4a7c15ull));
+  hash ^= hash>>29;
+  // Slots are organized in pairs, and a block may reside in either slot of its pair.
+  return (hash % (header()->slot_count/2))*2;
+}
+
+
+inline bool Shared_Block_Cache::get(
+    uint64 file_key, uint32 pos, uint32 generation, void* buf, uint32 size) const
+{
+  if (size > header()->slot_size)
+    return false;
+
+  uint32 first = slot_of(file_key, pos);
+  for (uint32 i = first; i < first + 2; ++i)
+  {
+    Slot_Header* cur = slot(i);
+    uint32 seq_before = cur->sequence.load(std::memory_order_acquire);
+    if (seq_before & 1)
+      continue;
+    if (cur->file_key != file_key || cur->pos != pos || cur->generation != generation || cur->size != size)
+      continue;
+
+    memcpy(buf, payload(cur), size);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (cur->sequence.load(std::memory_order_relaxed) == seq_before)
+      return true;
+  }
+  return false;
+}
+
+
+inline void Shared_Block_Cache::put(
+    uint64 file_key, uint32 pos, uint32 generation, const void* buf, uint32 size)
+{
+  if (size > header()->slot_size)
+    return;
+
+  // Prefer the first slot of the pair unless it already holds a block of the current generation.
+  uint32 first = slot_of(file_key, pos);
+  Slot_Header* cur = slot(first);
+  if (cur->generation == generation)
+    cur = slot(first + 1);
+
+  uint32 seq = cur->sequence.load(std::memory_order_relaxed);
+  if ((seq & 1) || !cur->sequence.compare_exchange_strong(seq, seq + 1, std::memory_order_acquire))
+    return;
+
+  cur->file_key = file_key;
+  cur->pos = pos;
+  cur->generation = generation;
+  cur->size = size;
+  memcpy(payload(cur), buf, size);
+
+  cur->sequence.store(seq + 2, std::memory_order_release);
+}
+
+
+#endif
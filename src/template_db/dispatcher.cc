@@ -526,7 +526,8 @@ Dispatcher::Dispatcher
       pending_commit(false),
       requests_started_counter(0),
       requests_finished_counter(0),
-      global_resource_planner(total_available_time_units_, total_available_space_, 0)
+      global_resource_planner(total_available_time_units_, total_available_space_, 0),
+      block_cache(0)
 {
   signal(SIGPIPE, SIG_IGN);
 
@@ -566,6 +567,7 @@ Dispatcher::Dispatcher
 
   // Set command state to zero.
   *(uint32*)dispatcher_shm_ptr = 0;
+  *(uint32*)(dispatcher_shm_ptr + OFFSET_COMMIT_GENERATION) = time(0);
 
   if (file_exists(shadow_name))
   {
@@ -580,6 +582,7 @@ Dispatcher::Dispatcher
 
 Dispatcher::~Dispatcher()
 {
+  delete block_cache;
   munmap((void*)dispatcher_shm_ptr, SHM_SIZE + transaction_insulator.db_dir().size() + shadow_name.size());
   shm_unlink(dispatcher_share_name.c_str());
 }
@@ -657,6 +660,10 @@ void Dispatcher::write_commit(pid_t pid)
     return;
   }
 
+  // Readers that start from now on see the new indexes and must not get blocks cached before.
+  // The block cache keys its entries by this generation, hence this also invalidates them.
+  ++*(volatile uint32*)(dispatcher_shm_ptr + OFFSET_COMMIT_GENERATION);
+
   remove(shadow_name.c_str());
   transaction_insulator.remove_shadows();
   remove((shadow_name + ".lock").c_str());
@@ -664,6 +671,21 @@ void Dispatcher::write_commit(pid_t pid)
 }
 
 
+void Dispatcher::enable_block_cache(uint64 size)
+{
+  delete block_cache;
+  block_cache = 0;
+  block_cache = new Shared_Block_Cache(dispatcher_share_name + "_block_cache", size);
+}
+
+
+void Dispatcher::set_use_mmap(bool use_mmap)
+{
+  uint32* flags = (uint32*)(dispatcher_shm_ptr + OFFSET_READ_FLAGS);
+  *flags = use_mmap ? (*flags | READ_FLAG_MMAP) : (*flags & ~READ_FLAG_MMAP);
+}
+
+
 void Dispatcher::request_read_and_idx(pid_t pid, uint32 max_allowed_time, uint64 max_allowed_space,
 				      uint32 client_token)
 {
@@ -19,6 +19,7 @@
 #ifndef DE__OSM3S___TEMPLATE_DB__DISPATCHER_H
 #define DE__OSM3S___TEMPLATE_DB__DISPATCHER_H
 
+#include "block_cache.h"
 #include "file_tools.h"
 #include "types.h"
 #include "transaction_insulator.h"
@@ -188,6 +189,14 @@ class Dispatcher
     static const int OFFSET_DB_1 = OFFSET_BACK+12;
     static const int OFFSET_DB_2 = OFFSET_DB_1+(256+4);
 
+    // The second word of the share holds flags that tell the reading processes how to access the files.
+    static const int OFFSET_READ_FLAGS = sizeof(uint32);
+    static const uint32 READ_FLAG_MMAP = 1;
+    // The third word changes on every commit. It is seeded from the clock on startup
+    // such that a restarted dispatcher never repeats the value of a previous run.
+    // The shared block cache keys its entries by this value.
+    static const int OFFSET_COMMIT_GENERATION = 2*sizeof(uint32);
+
     static const uint32 TERMINATE = 1;
     static const uint32 OUTPUT_STATUS = 2;
     static const uint32 HANGUP = 3;
@@ -276,6 +285,13 @@ class Dispatcher
     /** Set the limit of simultaneous queries from a single IP address. */
     void set_rate_limit(uint rate_limit) { global_resource_planner.set_rate_limit(rate_limit); }
 
+    /** Creates a cache of decompressed blocks of the given size in bytes
+        that all reading processes share. */
+    void enable_block_cache(uint64 size);
+
+    /** Tells the reading processes to map the data files into memory instead of reading them. */
+    void set_use_mmap(bool use_mmap);
+
   private:
     Dispatcher_Socket socket;
     Connection_Per_Pid_Map connection_per_pid;
@@ -291,6 +307,7 @@ class Dispatcher
     uint32 requests_started_counter;
     uint32 requests_finished_counter;
     Global_Resource_Planner global_resource_planner;
+    Shared_Block_Cache* block_cache;
 
     uint64 total_claimed_space() const;
     uint64 total_claimed_time_units() const;
@@ -1072,6 +1072,7 @@ int main(int argc, char* args[])
 	    <<shadow_name<<" already exists.\n";
 	return 0;
       }
+      uint32 commit_generation = dispatcher_client.get_commit_generation();
       dispatcher_client.write_start();
       if (!file_exists(dispatcher_client.get_shadow_name() + ".lock"))
       {
@@ -1095,6 +1096,11 @@ int main(int argc, char* args[])
 	std::cout<<"Failed after write_commit().\n";
 	return 0;
       }
+      if (dispatcher_client.get_commit_generation() == commit_generation)
+      {
+	std::cout<<"Commit generation unchanged after write_commit().\n";
+	return 0;
+      }
 
       std::cout<<"Writing successfully done.\n";
       Nonsynced_Transaction transaction
@@ -35,7 +35,8 @@
 
 Dispatcher_Client::Dispatcher_Client
     (const std::string& dispatcher_share_name_)
-    : dispatcher_share_name(dispatcher_share_name_), socket("")
+    : dispatcher_share_name(dispatcher_share_name_), socket(""),
+      block_cache(0), block_cache_generation(0)
 {
   signal(SIGPIPE, SIG_IGN);
 
@@ -62,6 +63,13 @@ Dispatcher_Client::Dispatcher_Client
   socket.open(db_dir + dispatcher_share_name_);
   std::string socket_name = db_dir + dispatcher_share_name_;
 
+  // The block cache is optional
+  try
+  {
+    block_cache = new Shared_Block_Cache(dispatcher_share_name + "_block_cache");
+  }
+  catch (const File_Error& e) {}
+
 // TODO: No need to send PID anymore
 //  pid_t pid = getpid();
 //  if (send(socket.descriptor(), &pid, sizeof(pid_t), 0) == -1)
@@ -79,6 +87,7 @@ bool file_present(const std::string& full_path)
 
 Dispatcher_Client::~Dispatcher_Client()
 {
+  delete block_cache;
   munmap((void*)dispatcher_shm_ptr,
 	 Dispatcher::SHM_SIZE + db_dir.size() + shadow_name.size());
   close(dispatcher_shm_fd);
@@ -225,7 +234,11 @@ void Dispatcher_Client::request_read_and_idx(uint32 max_allowed_time, uint64 max
     
     ack = ack_arrived();
     if (ack == Dispatcher::REQUEST_READ_AND_IDX)
+    {
+      // No commit can happen before read_idx_finished(), hence the generation matches the index files.
+      block_cache_generation = get_commit_generation();
       return;
+    }
 
     millisleep(300);
   }
@@ -387,6 +400,18 @@ void Dispatcher_Client::ping()
 }
 
 
+bool Dispatcher_Client::get_use_mmap() const
+{
+  return *(volatile uint32*)(dispatcher_shm_ptr + Dispatcher::OFFSET_READ_FLAGS) & Dispatcher::READ_FLAG_MMAP;
+}
+
+
+uint32 Dispatcher_Client::get_commit_generation() const
+{
+  return *(volatile uint32*)(dispatcher_shm_ptr + Dispatcher::OFFSET_COMMIT_GENERATION);
+}
+
+
 void Dispatcher_Client::terminate()
 {
   while (true)
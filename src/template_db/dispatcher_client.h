@@ -19,6 +19,7 @@
 #ifndef DE__OSM3S___TEMPLATE_DB__DISPATCHER_CLIENT_H
 #define DE__OSM3S___TEMPLATE_DB__DISPATCHER_CLIENT_H
 
+#include "block_cache.h"
 #include "types.h"
 
 #include <vector>
@@ -100,12 +101,26 @@ class Dispatcher_Client
     const std::string& get_db_dir() { return db_dir; }
     const std::string& get_shadow_name() { return shadow_name; }
 
+    /** The block cache of the dispatcher or null if it runs without one.
+        Its generation is the commit generation pinned by request_read_and_idx(). */
+    Shared_Block_Cache* get_block_cache() { return block_cache; }
+    uint32 get_block_cache_generation() const { return block_cache_generation; }
+
+    /** Whether the dispatcher asks the reading processes to map the data files into memory. */
+    bool get_use_mmap() const;
+
+    /** Changes whenever the dispatcher has committed a write transaction.
+        Processes that keep indexes across requests must drop them when this value changes. */
+    uint32 get_commit_generation() const;
+
   private:
     std::string dispatcher_share_name;
     int dispatcher_shm_fd;
     volatile uint8* dispatcher_shm_ptr;
     std::string db_dir, shadow_name;
     Unix_Socket socket;
+    Shared_Block_Cache* block_cache;
+    uint32 block_cache_generation;
 
     uint32 ack_arrived();
 
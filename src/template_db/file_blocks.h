@@ -19,6 +19,7 @@
 #ifndef DE__OSM3S___TEMPLATE_DB__FILE_BLOCKS_H
 #define DE__OSM3S___TEMPLATE_DB__FILE_BLOCKS_H
 
+#include "block_cache.h"
 #include "file_blocks_index.h"
 #include "types.h"
 #include "lz4_wrapper.h"
@@ -240,7 +241,7 @@ private:
 
 public:
   File_Blocks(File_Blocks_Index_Base* index);
-  ~File_Blocks() {}
+  ~File_Blocks() { delete data_map; }
 
   Flat_Iterator flat_begin();
   Flat_Iterator flat_end();
@@ -271,6 +272,9 @@ public:
   uint read_count() const { return read_count_; }
   void reset_read_count() { read_count_ = 0; }
 
+  // Asks the kernel to load the block in the background. This never blocks.
+  void prefetch_block(const File_Blocks_Basic_Iterator< TIndex >& it) const;
+
   Write_Iterator insert_block(const Write_Iterator& it, uint64* buf, uint32 max_keysize);
   Write_Iterator insert_block(
       const Write_Iterator& it, uint64* buf, uint32 payload_size, uint32 max_keysize, const TIndex& block_idx);
@@ -292,8 +296,13 @@ private:
   mutable uint read_count_;
 
   Raw_File data_file;
+  Mapped_File* data_map;
   Void64_Pointer< uint64 > buffer;
 
+  Shared_Block_Cache* block_cache;
+  uint32 block_cache_generation;
+  uint64 block_cache_file_key;
+
   template< typename File_Blocks_Iterator >
   uint64* read_block(
       const File_Blocks_Iterator& it, uint64* temp_buffer, uint64* buffer_, bool check_idx) const;
@@ -786,7 +795,14 @@ File_Blocks< TIndex, TIterator, TRangeIterator >::File_Blocks
      data_file(index->get_data_file_name(),
 	       writeable ? O_RDWR|O_CREAT : O_RDONLY,
 	       S_666, "File_Blocks::File_Blocks::1"),
-     buffer(index->get_block_size() * index->get_compression_factor() * 2)      // increased buffer size for lz4
+     data_map(!writeable && index->get_use_mmap()
+         ? Mapped_File::map_if_affordable(data_file, index->get_data_file_name(), "File_Blocks::File_Blocks::2") : 0),
+     buffer(index->get_block_size() * index->get_compression_factor() * 2),      // increased buffer size for lz4
+     // Only decompressed blocks are worth sharing, and writers must always see the file itself.
+     block_cache(writeable || compression_method == File_Blocks_Index< TIndex >::NO_COMPRESSION
+         ? 0 : index->get_block_cache()),
+     block_cache_generation(index->get_block_cache_generation()),
+     block_cache_file_key(block_cache ? Shared_Block_Cache::file_key(index->get_data_file_name()) : 0)
 {}
 
 
@@ -794,6 +810,8 @@ template< typename TIndex, typename TIterator, typename TRangeIterator >
 typename File_Blocks< TIndex, TIterator, TRangeIterator >::Flat_Iterator
     File_Blocks< TIndex, TIterator, TRangeIterator >::flat_begin()
 {
+  if (data_map)
+    data_map->advise(MADV_SEQUENTIAL);
   return Flat_Iterator(index->get_blocks().begin(), index->get_blocks().end());
 }
 
@@ -811,6 +829,8 @@ typename File_Blocks< TIndex, TIterator, TRangeIterator >::Discrete_Iterator
     File_Blocks< TIndex, TIterator, TRangeIterator >::discrete_begin
     (const TIterator& begin, const TIterator& end)
 {
+  if (data_map)
+    data_map->advise(MADV_NORMAL);
   return File_Blocks_Discrete_Iterator< TIndex, TIterator >
       (begin, end, index->get_blocks().begin(), index->get_blocks().end());
 }
@@ -828,6 +848,8 @@ template< typename TIndex, typename TIterator, typename TRangeIterator >
 typename File_Blocks< TIndex, TIterator, TRangeIterator >::Range_Iterator
 File_Blocks< TIndex, TIterator, TRangeIterator >::range_begin(const TRangeIterator& begin, const TRangeIterator& end)
 {
+  if (data_map)
+    data_map->advise(MADV_SEQUENTIAL);
   return File_Blocks_Range_Iterator< TIndex, TRangeIterator >
       (index->get_blocks().begin(), index->get_blocks().end(), begin, end);
 }
@@ -859,50 +881,89 @@ typename File_Blocks< TIndex, TIterator, TRangeIterator >::Write_Iterator
 }
 
 
+template< typename TIndex, typename TIterator, typename TRangeIterator >
+void File_Blocks< TIndex, TIterator, TRangeIterator >::prefetch_block
+    (const File_Blocks_Basic_Iterator< TIndex >& it) const
+{
+  uint64 pos = (uint64)(it.block().pos) * block_size;
+  uint64 size = (uint64)(it.block().size) * block_size;
+  if (data_map)
+    data_map->advise(pos, size, MADV_WILLNEED);
+  else
+    posix_fadvise(data_file.fd(), pos, size, POSIX_FADV_WILLNEED);
+}
+
+
 template< typename TIndex, typename TIterator, typename TRangeIterator >
 template< typename File_Blocks_Iterator >
 uint64* File_Blocks< TIndex, TIterator, TRangeIterator >::read_block
     (const File_Blocks_Iterator& it, uint64* temp_buffer, uint64* buffer_, bool check_idx) const
 {
-  data_file.seek((int64)(it.block().pos) * block_size, "File_Blocks::read_block::1");
-
-  if (compression_method == File_Blocks_Index< TIndex >::NO_COMPRESSION)
-    data_file.read((uint8*)buffer_, block_size * it.block().size, "File_Blocks::read_block::2");
-  else if (compression_method == File_Blocks_Index< TIndex >::ZLIB_COMPRESSION)
+  if (block_cache && block_cache->get(
+      block_cache_file_key, it.block().pos, block_cache_generation, buffer_, block_size * compression_factor))
+    ++read_count_;
+  else
   {
-    data_file.read((uint8*)temp_buffer, block_size * it.block().size, "File_Blocks::read_block::3");
-    try
+    // With a mapped file, the compressed data is taken directly from the mapping.
+    const void* source = temp_buffer;
+    if (data_map)
     {
-      Zlib_Inflate().decompress(
-          temp_buffer, block_size * it.block().size, buffer_, block_size * compression_factor);
+      if ((uint64)(it.block().pos + it.block().size) * block_size > data_map->size())
+        throw File_Error(0, index->get_data_file_name(), "File_Blocks::read_block::5");
+      source = data_map->ptr() + (uint64)(it.block().pos) * block_size;
     }
-    catch (const Zlib_Inflate::Error& e)
+    else
+      data_file.seek((int64)(it.block().pos) * block_size, "File_Blocks::read_block::1");
+
+    if (compression_method == File_Blocks_Index< TIndex >::NO_COMPRESSION)
     {
-      std::ostringstream out;
-      out<<"File_Blocks::read_block: Zlib_Inflate::Error "<<e.error_code
-          <<" at offset "<<((int64)(it.block().pos) * block_size + 8)<<"; "
-          <<" in_size: "<<(block_size * it.block().size)<<", "
-          <<" out_size: "<<(block_size * compression_factor);
-      throw File_Error(it.block().pos, index->get_data_file_name(), out.str());
+      if (data_map)
+        memcpy(buffer_, source, block_size * it.block().size);
+      else
+        data_file.read((uint8*)buffer_, block_size * it.block().size, "File_Blocks::read_block::2");
     }
-  }
-  else if (compression_method == File_Blocks_Index< TIndex >::LZ4_COMPRESSION)
-  {
-    data_file.read((uint8*)temp_buffer, block_size * it.block().size, "File_Blocks::read_block::4");
-    try
+    else if (compression_method == File_Blocks_Index< TIndex >::ZLIB_COMPRESSION)
     {
-      LZ4_Inflate().decompress(
-          temp_buffer, block_size * it.block().size, buffer_, block_size * compression_factor);
+      if (!data_map)
+        data_file.read((uint8*)temp_buffer, block_size * it.block().size, "File_Blocks::read_block::3");
+      try
+      {
+        Zlib_Inflate().decompress(
+            source, block_size * it.block().size, buffer_, block_size * compression_factor);
+      }
+      catch (const Zlib_Inflate::Error& e)
+      {
+        std::ostringstream out;
+        out<<"File_Blocks::read_block: Zlib_Inflate::Error "<<e.error_code
+            <<" at offset "<<((int64)(it.block().pos) * block_size + 8)<<"; "
+            <<" in_size: "<<(block_size * it.block().size)<<", "
+            <<" out_size: "<<(block_size * compression_factor);
+        throw File_Error(it.block().pos, index->get_data_file_name(), out.str());
+      }
     }
-    catch (const LZ4_Inflate::Error& e)
+    else if (compression_method == File_Blocks_Index< TIndex >::LZ4_COMPRESSION)
     {
-      std::ostringstream out;
-      out<<"File_Blocks::read_block: LZ4_Inflate::Error "<<e.error_code
-          <<" at offset "<<((int64)(it.block().pos) * block_size + 8)<<"; "
-          <<" in_size: "<<(block_size * it.block().size)<<", "
-          <<" out_size: "<<(block_size * compression_factor);
-      throw File_Error(it.block().pos, index->get_data_file_name(), out.str());
+      if (!data_map)
+        data_file.read((uint8*)temp_buffer, block_size * it.block().size, "File_Blocks::read_block::4");
+      try
+      {
+        LZ4_Inflate().decompress(
+            source, block_size * it.block().size, buffer_, block_size * compression_factor);
+      }
+      catch (const LZ4_Inflate::Error& e)
+      {
+        std::ostringstream out;
+        out<<"File_Blocks::read_block: LZ4_Inflate::Error "<<e.error_code
+            <<" at offset "<<((int64)(it.block().pos) * block_size + 8)<<"; "
+            <<" in_size: "<<(block_size * it.block().size)<<", "
+            <<" out_size: "<<(block_size * compression_factor);
+        throw File_Error(it.block().pos, index->get_data_file_name(), out.str());
+      }
     }
+
+    if (block_cache)
+      block_cache->put(
+          block_cache_file_key, it.block().pos, block_cache_generation, buffer_, block_size * compression_factor);
   }
 
   if (check_idx && !(it.block().index ==
@@ -685,12 +685,16 @@ void variable_block_read_test()
 }
 
 
-void compressed_read_test()
+void compressed_read_test(Shared_Block_Cache* block_cache = 0, bool use_mmap = false)
 {
   try
   {
     std::cout<<"Compressed Read test\n";
     Nonsynced_Transaction transaction(false, false, BASE_DIRECTORY, "");
+    if (block_cache)
+      // Both runs use the same generation, hence the second run can be served from the cache.
+      transaction.set_block_cache(block_cache, 1);
+    transaction.set_use_mmap(use_mmap);
     Compressed_Test_File tf;
     File_Blocks< IntIndex, IntIterator, IntRangeIterator > blocks
         (transaction.data_index(&tf));
@@ -1851,6 +1855,42 @@ int main(int argc, char* args[])
   if ((test_to_execute == "") || (test_to_execute == "28"))
     variable_block_read_test();
 
+  if ((test_to_execute == "") || (test_to_execute == "33"))
+  {
+    std::cout<<"** Test the estimated read volume for index ranges\n";
+    try
+    {
+      Nonsynced_Transaction transaction(false, false, BASE_DIRECTORY, "");
+      Variable_Block_Test_File tf;
+      File_Blocks_Index< IntIndex >& index
+          = *(File_Blocks_Index< IntIndex >*)transaction.data_index(&tf);
+
+      std::cout<<"Whole file: "<<estimate_read_volume(index)<<'\n';
+
+      const int bounds[][4] = {
+          { 0, 1000, 0, 0 }, { 25, 26, 0, 0 }, { 30, 40, 0, 0 }, { 30, 40, 39, 58 },
+          { 0, 20, 0, 0 }, { 100, 200, 0, 0 } };
+      for (uint i = 0; i < sizeof(bounds)/sizeof(bounds[0]); ++i)
+      {
+        std::list< std::pair< IntIndex, IntIndex > > ranges;
+        ranges.push_back(std::make_pair(IntIndex(bounds[i][0]), IntIndex(bounds[i][1])));
+        std::cout<<"Ranges ["<<bounds[i][0]<<", "<<bounds[i][1]<<")";
+        if (bounds[i][2] < bounds[i][3])
+        {
+          ranges.push_back(std::make_pair(IntIndex(bounds[i][2]), IntIndex(bounds[i][3])));
+          std::cout<<" ["<<bounds[i][2]<<", "<<bounds[i][3]<<")";
+        }
+        std::cout<<": "<<estimate_read_volume(index, ranges.begin(), ranges.end())<<'\n';
+      }
+    }
+    catch (File_Error e)
+    {
+      std::cout<<"File error catched: "
+          <<e.error_number<<' '<<e.filename<<' '<<e.origin<<'\n';
+      std::cout<<"(This is unexpected)\n";
+    }
+  }
+
   remove((BASE_DIRECTORY
       + Variable_Block_Test_File().get_file_name_trunk() + Variable_Block_Test_File().get_data_suffix()
       + Variable_Block_Test_File().get_index_suffix()).c_str());
@@ -1921,6 +1961,73 @@ int main(int argc, char* args[])
   if ((test_to_execute == "") || (test_to_execute == "30"))
     compressed_read_test();
 
+  // Test 31 destroys the data file, hence these tests must run before it.
+  if ((test_to_execute == "") || (test_to_execute == "32"))
+  {
+    std::cout<<"** Test a compressed file through a memory mapping\n";
+    compressed_read_test(0, true);
+  }
+
+  if ((test_to_execute == "") || (test_to_execute == "34"))
+  {
+    std::cout<<"** Test memory mappings under a low address space limit\n";
+    rlimit old_limit;
+    getrlimit(RLIMIT_AS, &old_limit);
+    rlimit limit = old_limit;
+    limit.rlim_cur = 512ull*1024*1024;
+    setrlimit(RLIMIT_AS, &limit);
+
+    compressed_read_test(0, true);
+
+    try
+    {
+      // A sparse file larger than the limit: it cannot be mapped as a whole
+      std::string file_name = BASE_DIRECTORY + "mapped_file_test";
+      Raw_File file(file_name, O_RDWR|O_CREAT|O_TRUNC, S_666, "file_blocks.test:34");
+      file.resize(1024ull*1024*1024, "file_blocks.test:34");
+      Mapped_File* mapped = Mapped_File::map_if_affordable(file, file_name, "file_blocks.test:34");
+      std::cout<<"File larger than the limit is "<<(mapped ? "mapped" : "read without mapping")<<".\n";
+      delete mapped;
+      remove(file_name.c_str());
+    }
+    catch (File_Error e)
+    {
+      std::cout<<"File error catched: "
+          <<e.error_number<<' '<<e.filename<<' '<<e.origin<<'\n';
+    }
+
+    setrlimit(RLIMIT_AS, &old_limit);
+  }
+
+  if ((test_to_execute == "") || (test_to_execute == "31"))
+  {
+    std::cout<<"** Test a compressed file through a block cache\n";
+    try
+    {
+      Shared_Block_Cache block_cache("/osm3s_file_blocks_test_block_cache", 4*1024*1024, 64*1024);
+      compressed_read_test(&block_cache);
+
+      // Blank the data file while keeping its size:
+      // the second run must then be served from the cache alone.
+      data_fd = open64
+          ((BASE_DIRECTORY
+            + Compressed_Test_File().get_file_name_trunk()
+            + Compressed_Test_File().get_data_suffix()).c_str(),
+           O_RDWR);
+      off64_t data_size = lseek64(data_fd, 0, SEEK_END);
+      if (ftruncate64(data_fd, 0) != 0 || ftruncate64(data_fd, data_size) != 0)
+        std::cout<<"Failed to blank the data file.\n";
+      close(data_fd);
+      compressed_read_test(&block_cache);
+    }
+    catch (File_Error e)
+    {
+      std::cout<<"File error catched: "
+          <<e.error_number<<' '<<e.filename<<' '<<e.origin<<'\n';
+      std::cout<<"(This is unexpected)\n";
+    }
+  }
+
   remove((BASE_DIRECTORY
       + Compressed_Test_File().get_file_name_trunk() + Compressed_Test_File().get_data_suffix()
       + Compressed_Test_File().get_index_suffix()).c_str());
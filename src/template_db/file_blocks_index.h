@@ -59,6 +59,8 @@ public:
 	      bool writeable, bool use_shadow,
 	      const std::string& db_dir, const std::string& file_name_extension,
               int compression_method_ = USE_DEFAULT);
+  // A view of the given loaded read-only index
+  explicit File_Blocks_Index(const File_Blocks_Index* shared);
   virtual ~File_Blocks_Index();
   bool writeable() const { return (empty_index_file_name != ""); }
   const std::string& file_name_extension() const { return file_name_extension_; }
@@ -68,6 +70,8 @@ public:
   uint32 get_compression_factor() const { return compression_factor; }
   uint32 get_compression_method() const { return compression_method; }
   virtual bool empty() const { return file_size == 0; }
+  virtual void load_blocks() { if (!writeable()) get_blocks(); }
+  virtual File_Blocks_Index_Base* new_view() const { return new File_Blocks_Index(this); }
 
   std::list< File_Block_Index_Entry< TIndex > >& get_block_list()
   {
@@ -79,6 +83,8 @@ public:
   }
   const std::vector< File_Block_Index_Entry< TIndex > >& get_blocks()
   {
+    if (shared_blocks)
+      return *shared_blocks;
     if (index_buf.ptr)
       init_blocks();
     if (block_array.empty() && !block_list.empty())
@@ -112,6 +118,7 @@ private:
   uint64 file_size;
   uint32 index_size;
   std::vector< File_Block_Index_Entry< TIndex > > block_array;
+  const std::vector< File_Block_Index_Entry< TIndex > >* shared_blocks;
   std::list< File_Block_Index_Entry< TIndex > > block_list;
   std::vector< std::pair< uint32, uint32 > > void_blocks;
   bool void_blocks_initialized;
@@ -133,6 +140,17 @@ template< class TIndex >
 std::vector< bool > get_data_index_footprint(const File_Properties& file_prop,
 					std::string db_dir);
 
+/* Estimates from the index alone how many bytes a range query reads from the data file:
+ * the total size of all blocks that may contain an index of one of the ranges.
+ * The ranges are pairs of lower and upper bound, upper bound exclusive, in ascending order. */
+template< class TIndex, class TRangeIterator >
+uint64 estimate_read_volume(File_Blocks_Index< TIndex >& index,
+    TRangeIterator ranges_begin, TRangeIterator ranges_end);
+
+// The size of all blocks of the data file
+template< class TIndex >
+uint64 estimate_read_volume(File_Blocks_Index< TIndex >& index);
+
 /** Implementation File_Blocks_Index: ---------------------------------------*/
 
 template< class TIndex >
@@ -150,7 +168,7 @@ File_Blocks_Index< TIndex >::File_Blocks_Index
      data_file_name(db_dir + file_prop.get_file_name_trunk()
          + file_name_extension + file_prop.get_data_suffix()),
      file_name_extension_(file_name_extension),
-     index_buf(0), file_size(0), index_size(0),
+     index_buf(0), file_size(0), index_size(0), shared_blocks(0),
      void_blocks_initialized(false),
      block_size_(file_prop.get_block_size()), // can be overwritten by index file
      compression_factor(file_prop.get_compression_factor()), // can be overwritten by index file
@@ -193,6 +211,21 @@ File_Blocks_Index< TIndex >::File_Blocks_Index
 }
 
 
+template< class TIndex >
+File_Blocks_Index< TIndex >::File_Blocks_Index(const File_Blocks_Index* shared) :
+     index_file_name(shared->index_file_name),
+     data_file_name(shared->data_file_name),
+     file_name_extension_(shared->file_name_extension_),
+     index_buf(0), file_size(shared->file_size), index_size(shared->index_size),
+     shared_blocks(&shared->block_array),
+     void_blocks_initialized(false),
+     block_size_(shared->block_size_),
+     compression_factor(shared->compression_factor),
+     compression_method(shared->compression_method),
+     block_count(shared->block_count)
+{}
+
+
 template< class TIndex >
 void File_Blocks_Index< TIndex >::init_structure_params()
 {
@@ -407,4 +440,46 @@ std::vector< bool > get_data_index_footprint
   return result;
 }
 
+
+template< class TIndex, class TRangeIterator >
+uint64 estimate_read_volume(File_Blocks_Index< TIndex >& index,
+    TRangeIterator ranges_begin, TRangeIterator ranges_end)
+{
+  const std::vector< File_Block_Index_Entry< TIndex > >& blocks = index.get_blocks();
+  uint64 block_count = 0;
+  typename std::vector< File_Block_Index_Entry< TIndex > >::size_type next_block = 0;
+
+  for (TRangeIterator it = ranges_begin; it != ranges_end; ++it)
+  {
+    // Like the range iterator of File_Blocks, start with the last block that begins before
+    // the lower bound unless a block begins exactly at the lower bound
+    typename std::vector< File_Block_Index_Entry< TIndex > >::const_iterator lower = std::lower_bound(
+        blocks.begin(), blocks.end(), File_Block_Index_Entry< TIndex >(it->first, 0, 0, 0),
+        [](const File_Block_Index_Entry< TIndex >& lhs, const File_Block_Index_Entry< TIndex >& rhs)
+        { return lhs.index < rhs.index; });
+    if (lower != blocks.begin() && (lower == blocks.end() || !(lower->index == it->first)))
+      --lower;
+
+    typename std::vector< File_Block_Index_Entry< TIndex > >::size_type i
+        = std::max(next_block, (typename std::vector< File_Block_Index_Entry< TIndex > >::size_type)
+            std::distance(blocks.begin(), lower));
+    for (; i < blocks.size() && blocks[i].index < it->second; ++i)
+      block_count += blocks[i].size;
+    next_block = i;
+  }
+
+  return block_count * index.get_block_size();
+}
+
+
+template< class TIndex >
+uint64 estimate_read_volume(File_Blocks_Index< TIndex >& index)
+{
+  uint64 block_count = 0;
+  for (typename std::vector< File_Block_Index_Entry< TIndex > >::const_iterator it = index.get_blocks().begin();
+      it != index.get_blocks().end(); ++it)
+    block_count += it->size;
+  return block_count * index.get_block_size();
+}
+
 #endif
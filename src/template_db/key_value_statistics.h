@@ -0,0 +1,316 @@
+/** Copyright 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018 Roland Olbricht et al.
+ *
+ * This file is part of Overpass_API.
+ *
+ * Overpass_API is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Overpass_API is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Overpass_API.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DE__OSM3S___TEMPLATE_DB__KEY_VALUE_STATISTICS_H
+#define DE__OSM3S___TEMPLATE_DB__KEY_VALUE_STATISTICS_H
+
+#include "types.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+
+/* Frequency statistics for the keys and values of a tag file.
+ *
+ * For each key, the number of tags with that key is counted, in total and per tile.
+ * The tiles are chosen by the caller. For the values, only the most frequent values
+ * of each key are kept when the statistics are written. The tags with all other values
+ * are summed up per key. Hence the counts for the values are estimates.
+ * As long as that sum is nonzero, a value that is not kept may be one that has been dropped.
+ * Tags with such a value are then added to the sum, such that the kept counts stay exact.
+ *
+ * The statistics are maintained incrementally: read the file, add the changes, write the file.
+ * Writing replaces the file atomically, so readers always see a complete version. */
+class Key_Value_Statistics
+{
+  public:
+    Key_Value_Statistics(uint32 max_values_per_key_ = 64)
+        : max_values_per_key(max_values_per_key_), total(0) {}
+
+    // A missing file yields empty statistics
+    void read(const std::string& file_name);
+    void write(const std::string& file_name);
+
+    // Counts delta tags with the given key and value in the given tile. Negative deltas remove tags.
+    void add(const std::string& key, const std::string& value, uint32 tile, int64 delta);
+
+    uint64 total_count() const { return total; }
+    uint64 key_count(const std::string& key) const;
+    uint64 key_count(const std::string& key, uint32 tile) const;
+    // Exact for the kept values, otherwise an upper bound
+    uint64 value_count(const std::string& key, const std::string& value) const;
+
+    uint32 get_max_values_per_key() const { return max_values_per_key; }
+    uint32 key_total() const { return keys.size(); }
+
+  private:
+    struct Key_Entry
+    {
+      Key_Entry() : count(0), other_values_count(0) {}
+
+      uint64 count;
+      uint64 other_values_count;
+      std::map< uint32, uint64 > tile_counts;
+      std::map< std::string, uint64 > value_counts;
+    };
+
+    const static uint32 FILE_FORMAT_VERSION = 1;
+
+    uint32 max_values_per_key;
+    uint64 total;
+    std::map< std::string, Key_Entry > keys;
+
+    static void add_clamped(uint64& count, int64 delta)
+    {
+      if (delta < 0 && count < uint64(-delta))
+        count = 0;
+      else
+        count += delta;
+    }
+
+    void truncate_values(Key_Entry& entry) const;
+
+    template< typename T >
+    static void append_raw(std::string& buf, T value)
+    {
+      buf.append((const char*)&value, sizeof(T));
+    }
+
+    template< typename T >
+    static T read_raw(const std::vector< char >& buf, uint64& pos, const std::string& file_name)
+    {
+      if (pos + sizeof(T) > buf.size())
+        throw File_Error(0, file_name, "Key_Value_Statistics: truncated file");
+      T value;
+      memcpy(&value, &buf[pos], sizeof(T));
+      pos += sizeof(T);
+      return value;
+    }
+
+    static std::string read_string(const std::vector< char >& buf, uint64& pos, const std::string& file_name)
+    {
+      uint16 size = read_raw< uint16 >(buf, pos, file_name);
+      if (pos + size > buf.size())
+        throw File_Error(0, file_name, "Key_Value_Statistics: truncated file");
+      std::string result(&buf[pos], size);
+      pos += size;
+      return result;
+    }
+};
+
+
+/** Implementation --------------------------------------------------------*/
+
+inline void Key_Value_Statistics::read(const std::string& file_name)
+{
+  keys.clear();
+  total = 0;
+
+  std::vector< char > buf;
+  try
+  {
+    Raw_File source_file(file_name, O_RDONLY, S_666, "Key_Value_Statistics::read::1");
+    buf.resize(source_file.size("Key_Value_Statistics::read::2"));
+    if (!buf.empty())
+      source_file.read(&buf[0], buf.size(), "Key_Value_Statistics::read::3");
+  }
+  catch (File_Error e)
+  {
+    if (e.error_number != 2)
+      throw e;
+    return;
+  }
+
+  uint64 pos = 0;
+  if (read_raw< uint32 >(buf, pos, file_name) != FILE_FORMAT_VERSION)
+    throw File_Error(0, file_name, "Key_Value_Statistics: Unsupported file format version");
+  max_values_per_key = read_raw< uint32 >(buf, pos, file_name);
+
+  while (pos < buf.size())
+  {
+    Key_Entry& entry = keys[read_string(buf, pos, file_name)];
+    entry.count = read_raw< uint64 >(buf, pos, file_name);
+    entry.other_values_count = read_raw< uint64 >(buf, pos, file_name);
+    total += entry.count;
+
+    uint32 tile_count = read_raw< uint32 >(buf, pos, file_name);
+    for (uint32 i = 0; i < tile_count; ++i)
+    {
+      uint32 tile = read_raw< uint32 >(buf, pos, file_name);
+      entry.tile_counts[tile] = read_raw< uint64 >(buf, pos, file_name);
+    }
+
+    uint32 value_count = read_raw< uint32 >(buf, pos, file_name);
+    for (uint32 i = 0; i < value_count; ++i)
+    {
+      std::string value = read_string(buf, pos, file_name);
+      entry.value_counts[value] = read_raw< uint64 >(buf, pos, file_name);
+    }
+  }
+}
+
+
+inline void Key_Value_Statistics::truncate_values(Key_Entry& entry) const
+{
+  if (entry.value_counts.size() <= max_values_per_key)
+    return;
+
+  std::vector< std::pair< uint64, std::string > > by_count;
+  for (std::map< std::string, uint64 >::const_iterator it = entry.value_counts.begin();
+      it != entry.value_counts.end(); ++it)
+    by_count.push_back(std::make_pair(it->second, it->first));
+  std::nth_element(by_count.begin(), by_count.begin() + max_values_per_key, by_count.end(),
+      std::greater< std::pair< uint64, std::string > >());
+
+  for (std::vector< std::pair< uint64, std::string > >::const_iterator it = by_count.begin() + max_values_per_key;
+      it != by_count.end(); ++it)
+  {
+    entry.other_values_count += it->first;
+    entry.value_counts.erase(it->second);
+  }
+}
+
+
+inline void Key_Value_Statistics::write(const std::string& file_name)
+{
+  std::string buf;
+  append_raw(buf, FILE_FORMAT_VERSION);
+  append_raw(buf, max_values_per_key);
+
+  for (std::map< std::string, Key_Entry >::iterator it = keys.begin(); it != keys.end(); ++it)
+  {
+    truncate_values(it->second);
+
+    append_raw(buf, uint16(it->first.size()));
+    buf.append(it->first);
+    append_raw(buf, it->second.count);
+    append_raw(buf, it->second.other_values_count);
+
+    append_raw(buf, uint32(it->second.tile_counts.size()));
+    for (std::map< uint32, uint64 >::const_iterator it2 = it->second.tile_counts.begin();
+        it2 != it->second.tile_counts.end(); ++it2)
+    {
+      append_raw(buf, it2->first);
+      append_raw(buf, it2->second);
+    }
+
+    append_raw(buf, uint32(it->second.value_counts.size()));
+    for (std::map< std::string, uint64 >::const_iterator it2 = it->second.value_counts.begin();
+        it2 != it->second.value_counts.end(); ++it2)
+    {
+      append_raw(buf, uint16(it2->first.size()));
+      buf.append(it2->first);
+      append_raw(buf, it2->second);
+    }
+  }
+
+  // Write a new file and replace the old one, such that readers never see a partial file
+  std::string temp_file_name = file_name + ".next";
+  {
+    Raw_File dest_file(temp_file_name, O_RDWR|O_CREAT|O_TRUNC, S_666, "Key_Value_Statistics::write::1");
+    dest_file.write(&buf[0], buf.size(), "Key_Value_Statistics::write::2");
+  }
+  if (rename(temp_file_name.c_str(), file_name.c_str()))
+    throw File_Error(errno, file_name, "Key_Value_Statistics::write::3");
+}
+
+
+inline void Key_Value_Statistics::add(const std::string& key, const std::string& value, uint32 tile, int64 delta)
+{
+  if (delta == 0)
+    return;
+
+  std::map< std::string, Key_Entry >::iterator it = keys.find(key);
+  if (it == keys.end())
+  {
+    if (delta < 0)
+      return;
+    it = keys.insert(std::make_pair(key, Key_Entry())).first;
+  }
+  Key_Entry& entry = it->second;
+
+  uint64 old_count = entry.count;
+  add_clamped(entry.count, delta);
+  total += entry.count;
+  total -= old_count;
+
+  std::map< uint32, uint64 >::iterator it_tile = entry.tile_counts.find(tile);
+  if (it_tile != entry.tile_counts.end())
+  {
+    add_clamped(it_tile->second, delta);
+    if (it_tile->second == 0)
+      entry.tile_counts.erase(it_tile);
+  }
+  else if (delta > 0)
+    entry.tile_counts[tile] = delta;
+
+  std::map< std::string, uint64 >::iterator it_value = entry.value_counts.find(value);
+  if (it_value != entry.value_counts.end())
+  {
+    add_clamped(it_value->second, delta);
+    if (it_value->second == 0)
+      entry.value_counts.erase(it_value);
+  }
+  else if (delta > 0 && entry.other_values_count == 0)
+    entry.value_counts[value] = delta;
+  else
+    add_clamped(entry.other_values_count, delta);
+
+  if (entry.count == 0)
+    keys.erase(it);
+}
+
+
+inline uint64 Key_Value_Statistics::key_count(const std::string& key) const
+{
+  std::map< std::string, Key_Entry >::const_iterator it = keys.find(key);
+  return it == keys.end() ? 0 : it->second.count;
+}
+
+
+inline uint64 Key_Value_Statistics::key_count(const std::string& key, uint32 tile) const
+{
+  std::map< std::string, Key_Entry >::const_iterator it = keys.find(key);
+  if (it == keys.end())
+    return 0;
+  std::map< uint32, uint64 >::const_iterator it_tile = it->second.tile_counts.find(tile);
+  return it_tile == it->second.tile_counts.end() ? 0 : it_tile->second;
+}
+
+
+inline uint64 Key_Value_Statistics::value_count(const std::string& key, const std::string& value) const
+{
+  std::map< std::string, Key_Entry >::const_iterator it = keys.find(key);
+  if (it == keys.end())
+    return 0;
+  std::map< std::string, uint64 >::const_iterator it_value = it->second.value_counts.find(value);
+  if (it_value != it->second.value_counts.end())
+    return it_value->second;
+
+  // A dropped value may have been added again since, hence it can be more frequent than kept values
+  return it->second.other_values_count;
+}
+
+
+#endif
@@ -0,0 +1,188 @@
+/** Copyright 2008, 2009, 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018 Roland Olbricht et al.
+ *
+ * This file is part of Overpass_API.
+ *
+ * Overpass_API is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * Overpass_API is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with Overpass_API.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <string>
+
+#include <stdio.h>
+
+#include "key_value_statistics.h"
+
+
+/**
+ * Tests the library key_value_statistics
+ */
+
+//-----------------------------------------------------------------------------
+
+std::string BASE_DIRECTORY("./");
+std::string FILE_NAME(BASE_DIRECTORY + "testfile.stats");
+
+
+void read_test()
+{
+  try
+  {
+    std::cout<<"Read test\n";
+
+    Key_Value_Statistics stats;
+    stats.read(FILE_NAME);
+
+    std::cout<<"Total: "<<stats.total_count()<<'\n';
+    std::cout<<"Keys: "<<stats.key_total()<<'\n';
+    std::cout<<"amenity: "<<stats.key_count("amenity")<<'\n';
+    std::cout<<"amenity in tile 1: "<<stats.key_count("amenity", 1)<<'\n';
+    std::cout<<"amenity in tile 2: "<<stats.key_count("amenity", 2)<<'\n';
+    std::cout<<"amenity=bench: "<<stats.value_count("amenity", "bench")<<'\n';
+    std::cout<<"amenity=cafe: "<<stats.value_count("amenity", "cafe")<<'\n';
+    std::cout<<"amenity=school: "<<stats.value_count("amenity", "school")<<'\n';
+    std::cout<<"amenity=pub: "<<stats.value_count("amenity", "pub")<<'\n';
+    std::cout<<"name: "<<stats.key_count("name")<<'\n';
+    std::cout<<"name in tile 1: "<<stats.key_count("name", 1)<<'\n';
+    std::cout<<"name=Bahnhof: "<<stats.value_count("name", "Bahnhof")<<'\n';
+    std::cout<<"highway: "<<stats.key_count("highway")<<'\n';
+
+    std::cout<<"This block of read tests is complete.\n";
+  }
+  catch (File_Error e)
+  {
+    std::cout<<"File error catched: "
+        <<e.error_number<<' '<<e.filename<<' '<<e.origin<<'\n';
+    std::cout<<"(This is unexpected)\n";
+  }
+}
+
+int main(int argc, char* args[])
+{
+  std::string test_to_execute;
+  if (argc > 1)
+    test_to_execute = args[1];
+
+  remove(FILE_NAME.c_str());
+
+  if ((test_to_execute == "") || (test_to_execute == "1"))
+  {
+    std::cout<<"** Test the behaviour for a missing file\n";
+    read_test();
+  }
+
+  if ((test_to_execute == "") || (test_to_execute == "2"))
+    std::cout<<"** Add some tags\n";
+  try
+  {
+    Key_Value_Statistics stats(2);
+    stats.read(FILE_NAME);
+    stats.add("amenity", "bench", 1, 10);
+    stats.add("amenity", "bench", 2, 5);
+    stats.add("amenity", "cafe", 1, 3);
+    stats.add("name", "Bahnhof", 1, 2);
+    stats.add("name", "Hauptstraße", 2, 1);
+    stats.write(FILE_NAME);
+  }
+  catch (File_Error e)
+  {
+    std::cout<<"File error catched: "
+        <<e.error_number<<' '<<e.filename<<' '<<e.origin<<'\n';
+    std::cout<<"(This is unexpected)\n";
+  }
+  if ((test_to_execute == "") || (test_to_execute == "2"))
+    read_test();
+
+  if ((test_to_execute == "") || (test_to_execute == "3"))
+    std::cout<<"** Keep only the most frequent values\n";
+  try
+  {
+    Key_Value_Statistics stats;
+    stats.read(FILE_NAME);
+    stats.add("amenity", "school", 2, 2);
+    stats.add("amenity", "pub", 1, 1);
+    stats.write(FILE_NAME);
+  }
+  catch (File_Error e)
+  {
+    std::cout<<"File error catched: "
+        <<e.error_number<<' '<<e.filename<<' '<<e.origin<<'\n';
+    std::cout<<"(This is unexpected)\n";
+  }
+  if ((test_to_execute == "") || (test_to_execute == "3"))
+    read_test();
+
+  if ((test_to_execute == "") || (test_to_execute == "4"))
+    std::cout<<"** Remove tags\n";
+  try
+  {
+    Key_Value_Statistics stats;
+    stats.read(FILE_NAME);
+    stats.add("amenity", "bench", 2, -5);
+    stats.add("amenity", "pub", 1, -1);
+    stats.add("name", "Bahnhof", 1, -2);
+    stats.add("name", "Hauptstraße", 2, -1);
+    stats.add("highway", "primary", 1, -1);
+    stats.write(FILE_NAME);
+  }
+  catch (File_Error e)
+  {
+    std::cout<<"File error catched: "
+        <<e.error_number<<' '<<e.filename<<' '<<e.origin<<'\n';
+    std::cout<<"(This is unexpected)\n";
+  }
+  if ((test_to_execute == "") || (test_to_execute == "4"))
+    read_test();
+
+  if ((test_to_execute == "") || (test_to_execute == "5"))
+    std::cout<<"** Add tags with a dropped and a new value\n";
+  try
+  {
+    Key_Value_Statistics stats;
+    stats.read(FILE_NAME);
+    stats.add("amenity", "school", 2, 3);
+    stats.add("amenity", "bar", 1, 1);
+    stats.add("name", "Bahnhof", 1, 4);
+    stats.write(FILE_NAME);
+  }
+  catch (File_Error e)
+  {
+    std::cout<<"File error catched: "
+        <<e.error_number<<' '<<e.filename<<' '<<e.origin<<'\n';
+    std::cout<<"(This is unexpected)\n";
+  }
+  if ((test_to_execute == "") || (test_to_execute == "5"))
+    read_test();
+
+  if ((test_to_execute == "") || (test_to_execute == "6"))
+    std::cout<<"** Test the behaviour for a file of a different format\n";
+  {
+    Raw_File dest_file(FILE_NAME, O_RDWR|O_CREAT|O_TRUNC, S_666, "key_value_statistics.test::1");
+    uint32 version = 0;
+    dest_file.write(&version, 4, "key_value_statistics.test::2");
+  }
+  try
+  {
+    Key_Value_Statistics stats;
+    stats.read(FILE_NAME);
+  }
+  catch (File_Error e)
+  {
+    if ((test_to_execute == "") || (test_to_execute == "6"))
+      std::cout<<"File error catched: "
+          <<e.error_number<<' '<<e.filename<<' '<<e.origin<<'\n';
+  }
+
+  remove(FILE_NAME.c_str());
+  return 0;
+}
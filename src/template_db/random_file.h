@@ -29,6 +29,8 @@
 #include <cerrno>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <iterator>
 #include <limits>
 #include <map>
 #include <vector>
@@ -45,6 +47,10 @@ public:
   ~Random_File();
 
   Value get(Key pos);
+  // Appends the values for all keys in [begin, end) to result, in the order of the keys.
+  // If the keys are sorted ascending then every block is read and decompressed only once.
+  template< typename Iterator >
+  void get(Iterator begin, Iterator end, std::vector< Value >& result);
   void put(Key pos, const Value& index);
 
 private:
@@ -53,8 +59,11 @@ private:
   uint32 compression_factor;
 
   Raw_File val_file;
+  Mapped_File* val_map;
   Random_File_Index* index;
   Void_Pointer< uint8 > cache;
+  // Points to the current block: either into cache or, for uncompressed mapped files, into the mapping.
+  const uint8* window;
   uint32 cache_pos;
   uint32 block_size;
 
@@ -75,17 +84,25 @@ Random_File< Key, Value >::Random_File(Random_File_Index* index_)
   val_file(index_->get_map_file_name(),
 	   index_->writeable() ? O_RDWR|O_CREAT : O_RDONLY,
 	   S_666, "Random_File:3"),
+  val_map(!index_->writeable() && index_->get_use_mmap()
+      ? Mapped_File::map_if_affordable(val_file, index_->get_map_file_name(), "Random_File:4") : 0),
   index(index_),
-  cache(index_->get_block_size() * index_->get_compression_factor()), cache_pos(index->npos),
+  cache(index_->get_block_size() * index_->get_compression_factor()), window(cache.ptr),
+  cache_pos(index->npos),
   block_size(index_->get_block_size()),
   buffer(index_->get_block_size() * index_->get_compression_factor() * 2)  // increased buffer size for lz4
-{}
+{
+  // Lookups by id jump around in the file, hence readahead would be wasted.
+  if (val_map)
+    val_map->advise(MADV_RANDOM);
+}
 
 
 template< typename Key, typename Value >
 Random_File< Key, Value >::~Random_File()
 {
   move_cache_window(index->npos);
+  delete val_map;
   //delete index;
 }
 
@@ -94,7 +111,27 @@ template< typename Key, typename Value >
 Value Random_File< Key, Value >::get(Key pos)
 {
   move_cache_window(pos.val() / (block_size*compression_factor /index_size));
-  return Value(cache.ptr + (pos.val() % (block_size*compression_factor/index_size))*index_size);
+  return Value((uint8*)window + (pos.val() % (block_size*compression_factor/index_size))*index_size);
+}
+
+
+template< typename Key, typename Value >
+template< typename Iterator >
+void Random_File< Key, Value >::get(Iterator begin, Iterator end, std::vector< Value >& result)
+{
+  const uint32 entries_per_block = block_size*compression_factor/index_size;
+  result.reserve(result.size() + std::distance(begin, end));
+
+  Iterator it = begin;
+  while (it != end)
+  {
+    uint32 block = Key(*it).val() / entries_per_block;
+    move_cache_window(block);
+
+    // Serve all following keys of the same block from the current window
+    for (; it != end && Key(*it).val() / entries_per_block == block; ++it)
+      result.push_back(Value((uint8*)window + (Key(*it).val() % entries_per_block)*index_size));
+  }
 }
 
 
@@ -159,12 +196,35 @@ void Random_File< Key, Value >::move_cache_window(uint32 pos)
   if (pos == index->npos)
     return;
 
+  window = cache.ptr;
   if ((index->get_blocks().size() <= pos) || (index->get_blocks()[pos].pos == index->npos))
   {
     // Reset the whole cache to zero.
     for (uint32 i = 0; i < block_size * compression_factor; ++i)
       *(cache.ptr + i) = 0;
   }
+  else if (val_map)
+  {
+    const Random_File_Index_Entry& entry = index->get_blocks()[pos];
+    if ((uint64)(entry.pos + entry.size) * block_size > val_map->size())
+      throw File_Error(0, index->get_map_file_name(), "Random_File:27");
+    const uint8* source = val_map->ptr() + (uint64)entry.pos * block_size;
+
+    if (index->get_compression_method() == File_Blocks_Index_Base::NO_COMPRESSION)
+    {
+      // A full uncompressed block can be used in place without any copy.
+      if (entry.size == compression_factor)
+        window = source;
+      else
+        memcpy(cache.ptr, source, block_size * entry.size);
+    }
+    else if (index->get_compression_method() == File_Blocks_Index_Base::ZLIB_COMPRESSION)
+      Zlib_Inflate().decompress
+          (source, block_size * entry.size, cache.ptr, block_size * index->get_compression_factor());
+    else if (index->get_compression_method() == File_Blocks_Index_Base::LZ4_COMPRESSION)
+      LZ4_Inflate().decompress
+          (source, block_size * entry.size, cache.ptr, block_size * index->get_compression_factor());
+  }
   else
   {
     val_file.seek((int64)(index->get_blocks()[pos].pos)*block_size, "Random_File:23");
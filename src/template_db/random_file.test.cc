@@ -16,6 +16,7 @@
  * along with Overpass_API.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <iostream>
 #include <list>
 
@@ -207,6 +208,51 @@ void read_test()
   }
 }
 
+void batch_read_test()
+{
+  try
+  {
+    std::cout<<"Batch read test\n";
+
+    Nonsynced_Transaction transaction(false, false, BASE_DIRECTORY, "");
+    Test_File tf;
+    Random_File< IntIndex, IntIndex > id_file(transaction.random_index(&tf));
+
+    std::vector< uint32 > ids;
+    ids.push_back(0u);
+    ids.push_back(2u);
+    ids.push_back(5u);
+    ids.push_back(16u);
+    ids.push_back(17u);
+    ids.push_back(48u);
+    ids.push_back(64u);
+    ids.push_back(80u);
+    ids.push_back(112u);
+
+    std::vector< IntIndex > result;
+    id_file.get(ids.begin(), ids.end(), result);
+    for (std::vector< IntIndex >::const_iterator it = result.begin(); it != result.end(); ++it)
+      std::cout<<it->val()<<' ';
+    std::cout<<'\n';
+
+    // Unsorted keys must give the same values, only with more block reads
+    std::reverse(ids.begin(), ids.end());
+    result.clear();
+    id_file.get(ids.begin(), ids.end(), result);
+    for (std::vector< IntIndex >::const_iterator it = result.begin(); it != result.end(); ++it)
+      std::cout<<it->val()<<' ';
+    std::cout<<'\n';
+
+    std::cout<<"This block of read tests is complete.\n";
+  }
+  catch (File_Error e)
+  {
+    std::cout<<"File error catched: "
+	<<e.error_number<<' '<<e.filename<<' '<<e.origin<<'\n';
+    std::cout<<"(This is unexpected)\n";
+  }
+}
+
 int main(int argc, char* args[])
 {
   std::string test_to_execute;
@@ -365,6 +411,12 @@ int main(int argc, char* args[])
   if ((test_to_execute == "") || (test_to_execute == "8"))
     read_test();
 
+  if ((test_to_execute == "") || (test_to_execute == "9"))
+  {
+    std::cout<<"** Read several values at once.\n";
+    batch_read_test();
+  }
+
   remove((BASE_DIRECTORY + Test_File().get_file_name_trunk()
       + Test_File().get_id_suffix()).c_str());
   remove((BASE_DIRECTORY + Test_File().get_file_name_trunk()
@@ -60,6 +60,10 @@ public:
   uint32 get_compression_factor() const { return compression_factor; }
   uint32 get_compression_method() const { return compression_method; }
 
+  // Read-only transactions may map the map file into memory instead of reading it.
+  void set_use_mmap(bool use_mmap_) { use_mmap = use_mmap_; }
+  bool get_use_mmap() const { return use_mmap; }
+
   std::vector< Random_File_Index_Entry >& get_blocks()
   {
     return blocks;
@@ -87,6 +91,7 @@ private:
   uint64 block_size_;
   uint32 compression_factor;
   int compression_method;
+  bool use_mmap;
 
   void init_void_blocks();
 
@@ -124,6 +129,7 @@ inline Random_File_Index::Random_File_Index
     compression_factor(file_prop.get_map_compression_factor()),
     compression_method(compression_method_ == File_Blocks_Index_Base::USE_DEFAULT ?
         file_prop.get_map_compression_method() : compression_method_),
+    use_mmap(false),
     block_count(0)
 {
   uint64 file_size = 0;
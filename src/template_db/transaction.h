@@ -22,37 +22,66 @@
 #include "random_file.h"
 
 #include <map>
+#include <memory>
 #include <mutex>
 #include <vector>
 
 
+/** Keeps the indexes of a database across transactions.
+ *
+ * The indexes that belong to one state of the database form a snapshot. A snapshot is never changed
+ * once an index has been put into it, apart from adding further indexes. Indexes are completely loaded
+ * before they are put into a snapshot, and each transaction reads them through views of its own that
+ * keep settings like the block cache. Transactions hold a reference to the snapshot they have started
+ * with, hence any number of transactions can share it concurrently.
+ * When a transaction asks for a different state, a new snapshot replaces the current one for all
+ * later transactions. The old snapshot is released together with the last transaction using it. */
 class Index_Cache
 {
-
 public:
-  Index_Cache() : replicate_id("") {};
-  ~Index_Cache() {
-
-    for (std::map< const File_Properties*, File_Blocks_Index_Base* >::iterator
-        it = data_files.begin(); it != data_files.end(); ++it)
-      delete it->second;
-    for (std::map< const File_Properties*, Random_File_Index* >::iterator
-        it = random_files.begin(); it != random_files.end(); ++it)
-      delete it->second;
-
-    data_files.clear();
-    random_files.clear();
+  struct Snapshot
+  {
+    Snapshot(const std::string& key_) : key(key_) {}
+    ~Snapshot()
+    {
+      for (std::map< const File_Properties*, File_Blocks_Index_Base* >::iterator
+          it = data_files.begin(); it != data_files.end(); ++it)
+        delete it->second;
+      for (std::map< const File_Properties*, Random_File_Index* >::iterator
+          it = random_files.begin(); it != random_files.end(); ++it)
+        delete it->second;
+    }
+
+    const std::string key;
+
+  private:
+    Snapshot(const Snapshot&);
+    Snapshot& operator=(const Snapshot&);
+
+    std::mutex mutex;
+    std::map< const File_Properties*, File_Blocks_Index_Base* > data_files;
+    std::map< const File_Properties*, Random_File_Index* > random_files;
+
+    friend class Nonsynced_Transaction;
+  };
+
+  Index_Cache() {}
+
+  // Returns the snapshot for the given state of the database and makes it the current one.
+  std::shared_ptr< Snapshot > acquire(const std::string& key)
+  {
+    std::lock_guard< std::mutex > guard(mutex);
+    if (!current || current->key != key)
+      current = std::make_shared< Snapshot >(key);
+    return current;
   }
 
 private:
-  std::map< const File_Properties*, File_Blocks_Index_Base* >
-    data_files;
-  std::map< const File_Properties*, Random_File_Index* >
-    random_files;
-
-  std::string replicate_id;
+  Index_Cache(const Index_Cache&);
+  Index_Cache& operator=(const Index_Cache&);
 
-  friend class Nonsynced_Transaction;
+  std::mutex mutex;
+  std::shared_ptr< Snapshot > current;
 };
 
 
@@ -64,6 +93,8 @@ class Transaction
     virtual File_Blocks_Index_Base* data_index(const File_Properties*) = 0;
     virtual Random_File_Index* random_index(const File_Properties*) = 0;
     virtual std::string get_db_dir() const = 0;
+    // Whether the index files are read and written as shadow files of an uncommitted update
+    virtual bool get_use_shadow() const = 0;
     virtual std::string get_replicate_id() const = 0;
     virtual void set_replicate_id(std::string replicate_id) = 0;
 };
@@ -87,11 +118,26 @@ class Nonsynced_Transaction : public Transaction
     Random_File_Index* random_index(const File_Properties*);
 
     void flush();
+    // Attaches the transaction to the snapshot of the Index_Cache that matches the replicate_id.
+    // A snapshot for another replicate_id is no longer handed out to later transactions.
     void flush_outdated_index_cache();
     std::string get_db_dir() const { return db_dir; }
+    bool get_use_shadow() const { return use_shadow; }
 
     std::string get_replicate_id() const { return replicate_id; }
     void set_replicate_id(std::string replicate_id_) { replicate_id = replicate_id_; };
+
+    // Only effective for read-only transactions. The generation must stay pinned
+    // for the whole lifetime of the transaction.
+    void set_block_cache(Shared_Block_Cache* block_cache_, uint32 generation)
+    {
+      block_cache = block_cache_;
+      block_cache_generation = generation;
+    }
+
+    // Only effective for read-only transactions: data files are mapped into memory
+    // instead of being read block by block.
+    void set_use_mmap(bool use_mmap_) { use_mmap = use_mmap_; }
     
   private:
     std::map< const File_Properties*, File_Blocks_Index_Base* >
@@ -102,7 +148,11 @@ class Nonsynced_Transaction : public Transaction
     std::string file_name_extension, db_dir;
     std::mutex transaction_mutex;
     Index_Cache* ic;
+    std::shared_ptr< Index_Cache::Snapshot > snapshot;
     std::string replicate_id;
+    Shared_Block_Cache* block_cache;
+    uint32 block_cache_generation;
+    bool use_mmap;
 };
 
 
@@ -117,7 +167,10 @@ inline Nonsynced_Transaction::Nonsynced_Transaction
      const std::string& db_dir_, const std::string& file_name_extension_,
      Index_Cache* ic_)
   : writeable(writeable_), use_shadow(use_shadow_),
-    file_name_extension(file_name_extension_), db_dir(db_dir_), ic(ic_), replicate_id("")
+    file_name_extension(file_name_extension_), db_dir(db_dir_),
+    // Only read-only indexes can be shared.
+    ic(writeable_ ? nullptr : ic_), replicate_id(""),
+    block_cache(nullptr), block_cache_generation(0), use_mmap(false)
 {
   if (!db_dir.empty() && db_dir[db_dir.size()-1] != '/')
     db_dir += "/";
@@ -142,6 +195,7 @@ inline void Nonsynced_Transaction::flush()
       it = random_files.begin(); it != random_files.end(); ++it)
     delete it->second;
   random_files.clear();
+  snapshot.reset();
 }
 
 
@@ -150,18 +204,8 @@ inline void Nonsynced_Transaction::flush_outdated_index_cache()
 {
   std::lock_guard<std::mutex> guard(transaction_mutex);
 
-  if (ic != nullptr && ic->replicate_id != get_replicate_id())
-  {
-    for (std::map< const File_Properties*, File_Blocks_Index_Base* >::iterator
-        it = ic->data_files.begin(); it != ic->data_files.end(); ++it)
-      delete it->second;
-    ic->data_files.clear();
-    for (std::map< const File_Properties*, Random_File_Index* >::iterator
-        it = ic->random_files.begin(); it != ic->random_files.end(); ++it)
-      delete it->second;
-    ic->random_files.clear();
-    ic->replicate_id = get_replicate_id();
-  }
+  if (ic != nullptr)
+    snapshot = ic->acquire(get_replicate_id());
 }
 
 
@@ -170,19 +214,47 @@ inline File_Blocks_Index_Base* Nonsynced_Transaction::data_index
 { 
   std::lock_guard<std::mutex> guard(transaction_mutex);
 
-  std::map< const File_Properties*, File_Blocks_Index_Base* > * df;
-
-  df = (ic != nullptr) ? &ic->data_files : &data_files;
+  if (ic != nullptr && !snapshot)
+    snapshot = ic->acquire(get_replicate_id());
 
   std::map< const File_Properties*, File_Blocks_Index_Base* >::iterator
-      it = df->find(fp);
-  if (it != df->end())
+      it = data_files.find(fp);
+  if (it != data_files.end())
     return it->second;
 
-  File_Blocks_Index_Base* data_index = fp->new_data_index
-      (writeable, use_shadow, db_dir, file_name_extension);
+  File_Blocks_Index_Base* data_index = 0;
+  if (snapshot)
+  {
+    // The snapshot keeps the block entries, the transaction its own view on them
+    // such that the block cache of one transaction is never used by another one.
+    std::lock_guard< std::mutex > snapshot_guard(snapshot->mutex);
+    File_Blocks_Index_Base*& shared = snapshot->data_files[fp];
+    if (!shared)
+    {
+      shared = fp->new_data_index(writeable, use_shadow, db_dir, file_name_extension);
+      if (shared == 0)
+      {
+        snapshot->data_files.erase(fp);
+        return 0;
+      }
+      shared->load_blocks();
+    }
+    data_index = shared->new_view();
+  }
+  else
+    data_index = fp->new_data_index(writeable, use_shadow, db_dir, file_name_extension);
+
   if (data_index != 0)
-    (*df)[fp] = data_index;
+  {
+    if (!writeable)
+    {
+      // Parallel readers of this transaction must not load the block entries concurrently
+      data_index->load_blocks();
+      data_index->set_block_cache(block_cache, block_cache_generation);
+      data_index->set_use_mmap(use_mmap);
+    }
+    data_files[fp] = data_index;
+  }
   return data_index;
 }
 
@@ -191,18 +263,27 @@ inline Random_File_Index* Nonsynced_Transaction::random_index(const File_Propert
 { 
   std::lock_guard<std::mutex> guard(transaction_mutex);
 
-  std::map< const File_Properties*, Random_File_Index* > * rf;
+  if (ic != nullptr && !snapshot)
+    snapshot = ic->acquire(get_replicate_id());
 
-  rf = (ic != nullptr) ? &ic->random_files : &random_files;
+  std::unique_lock< std::mutex > snapshot_guard;
+  std::map< const File_Properties*, Random_File_Index* > * rf = &random_files;
+  if (snapshot)
+  {
+    snapshot_guard = std::unique_lock< std::mutex >(snapshot->mutex);
+    rf = &snapshot->random_files;
+  }
 
   std::map< const File_Properties*, Random_File_Index* >::iterator
       it = rf->find(fp);
   if (it != rf->end())
     return it->second;
   
-  (*rf)[fp] = new Random_File_Index(*fp, writeable, use_shadow, db_dir, file_name_extension);
-  return (*rf)[fp];
-
+  Random_File_Index* random_index = new Random_File_Index(*fp, writeable, use_shadow, db_dir, file_name_extension);
+  if (!writeable)
+    random_index->set_use_mmap(use_mmap);
+  (*rf)[fp] = random_index;
+  return random_index;
 }
 
 #endif
@@ -125,6 +125,11 @@ void Transaction_Insulator::copy_shadows_to_mains()
                 + (*it)->get_index_suffix() + (*it)->get_shadow_suffix(),
 		db_dir() + (*it)->get_file_name_trunk() + (*it)->get_id_suffix()
 		+ (*it)->get_index_suffix());
+      // Readers open the statistics file without the dispatcher, hence it is replaced atomically
+      if (!(*it)->get_statistics_suffix().empty())
+        rename((db_dir() + (*it)->get_file_name_trunk() + (*it)->get_statistics_suffix()
+                + (*it)->get_shadow_suffix()).c_str(),
+            (db_dir() + (*it)->get_file_name_trunk() + (*it)->get_statistics_suffix()).c_str());
   }
 }
 
@@ -142,6 +147,10 @@ void Transaction_Insulator::copy_mains_to_shadows()
                 + (*it)->get_index_suffix(),
 		db_dir() + (*it)->get_file_name_trunk() + (*it)->get_id_suffix()
 		+ (*it)->get_index_suffix() + (*it)->get_shadow_suffix());
+      if (!(*it)->get_statistics_suffix().empty())
+        copy_file(db_dir() + (*it)->get_file_name_trunk() + (*it)->get_statistics_suffix(),
+            db_dir() + (*it)->get_file_name_trunk() + (*it)->get_statistics_suffix()
+            + (*it)->get_shadow_suffix());
   }
 }
 
@@ -159,6 +168,9 @@ void Transaction_Insulator::remove_shadows()
             + (*it)->get_shadow_suffix()).c_str());
     remove((db_dir() + (*it)->get_file_name_trunk() + (*it)->get_id_suffix()
             + (*it)->get_shadow_suffix()).c_str());
+    if (!(*it)->get_statistics_suffix().empty())
+      remove((db_dir() + (*it)->get_file_name_trunk() + (*it)->get_statistics_suffix()
+              + (*it)->get_shadow_suffix()).c_str());
   }
 }
 
@@ -20,10 +20,13 @@
 #define DE__OSM3S___TEMPLATE_DB__TYPES_H
 
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cerrno>
 #include <cstdlib>
 #include <string>
@@ -74,15 +77,44 @@ struct File_Properties_Exception
 };
 
 
+class Shared_Block_Cache;
+
+
 struct File_Blocks_Index_Base
 {
+  File_Blocks_Index_Base() : block_cache(0), block_cache_generation(0), use_mmap(false) {}
   virtual bool empty() const = 0;
   virtual ~File_Blocks_Index_Base() {}
 
+  // Reads the block entries of a read-only index. Afterwards, the index is no longer changed
+  // by reading it, hence it can be used by concurrent readers.
+  virtual void load_blocks() = 0;
+  // Returns a read-only index with its own settings that uses the block entries of this index.
+  // This index must be loaded and must outlive the returned one.
+  virtual File_Blocks_Index_Base* new_view() const = 0;
+
+  // Read-only transactions may route block reads through a cache shared between processes.
+  void set_block_cache(Shared_Block_Cache* block_cache_, uint32 generation)
+  {
+    block_cache = block_cache_;
+    block_cache_generation = generation;
+  }
+  Shared_Block_Cache* get_block_cache() const { return block_cache; }
+  uint32 get_block_cache_generation() const { return block_cache_generation; }
+
+  // Read-only transactions may map the data file into memory instead of reading it.
+  void set_use_mmap(bool use_mmap_) { use_mmap = use_mmap_; }
+  bool get_use_mmap() const { return use_mmap; }
+
   static const int USE_DEFAULT = -1;
   static const int NO_COMPRESSION = 0;
   static const int ZLIB_COMPRESSION = 1;
   static const int LZ4_COMPRESSION = 2;
+
+private:
+  Shared_Block_Cache* block_cache;
+  uint32 block_cache_generation;
+  bool use_mmap;
 };
 
 
@@ -103,6 +135,10 @@ struct File_Properties
   virtual std::vector< bool > get_map_footprint(const std::string& db_dir) const = 0;
   virtual uint32 id_max_size_of() const = 0;
 
+  // Suffix of a statistics file beside the data file, empty if there is none.
+  // The statistics file is shadowed and committed together with the index files.
+  virtual std::string get_statistics_suffix() const { return ""; }
+
   // The returned object is of type File_Blocks_Index< .. >*
   // and goes into the ownership of the caller.
   virtual File_Blocks_Index_Base* new_data_index
@@ -133,6 +169,30 @@ class Raw_File
 };
 
 
+/** Simple RAII class to keep a read-only memory mapping of a whole file. */
+class Mapped_File
+{
+  Mapped_File(const Mapped_File&);
+  Mapped_File& operator=(const Mapped_File&);
+
+  public:
+    Mapped_File(const Raw_File& file, const std::string& name, const char* caller_id);
+    // Returns a mapping of the file or 0 if the file should rather be read by read calls.
+    // The mapping counts against the address space limit, hence large files are not mapped.
+    static Mapped_File* map_if_affordable(const Raw_File& file, const std::string& name, const char* caller_id);
+    ~Mapped_File() { if (ptr_) munmap(ptr_, size_); }
+    const uint8* ptr() const { return ptr_; }
+    uint64 size() const { return size_; }
+    // Passes a hint like MADV_SEQUENTIAL or MADV_RANDOM to the kernel.
+    void advise(int advice) const { if (ptr_) madvise(ptr_, size_, advice); }
+    void advise(uint64 pos, uint64 size, int advice) const;
+
+  private:
+    uint8* ptr_;
+    uint64 size_;
+};
+
+
 /** Simple RAII class to keep a pointer to some memory on the heap. */
 template < class T >
 class Void_Pointer
@@ -276,6 +336,49 @@ inline void Raw_File::seek(uint64 pos, const char* caller_id) const
     throw File_Error(errno, name, caller_id);
 }
 
+inline Mapped_File::Mapped_File(const Raw_File& file, const std::string& name, const char* caller_id)
+  : ptr_(0), size_(file.size(caller_id))
+{
+  // An empty file cannot be mapped, but then there is also nothing to read.
+  if (size_ == 0)
+    return;
+  void* result = mmap(0, size_, PROT_READ, MAP_SHARED, file.fd(), 0);
+  if (result == MAP_FAILED)
+    throw File_Error(errno, name, caller_id);
+  ptr_ = (uint8*)result;
+}
+
+inline Mapped_File* Mapped_File::map_if_affordable
+    (const Raw_File& file, const std::string& name, const char* caller_id)
+{
+  // The memory of the query itself must fit into the same limit.
+  rlimit limit;
+  if (getrlimit(RLIMIT_AS, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY
+      && file.size(caller_id) > limit.rlim_cur / 4)
+    return 0;
+
+  try
+  {
+    return new Mapped_File(file, name, caller_id);
+  }
+  catch (const File_Error& e)
+  {
+    if (e.error_number == ENOMEM)
+      return 0;
+    throw;
+  }
+}
+
+inline void Mapped_File::advise(uint64 pos, uint64 size, int advice) const
+{
+  if (!ptr_ || pos >= size_)
+    return;
+  // madvise requires a page aligned start address.
+  uint64 page_size = sysconf(_SC_PAGESIZE);
+  uint64 start = pos / page_size * page_size;
+  madvise(ptr_ + start, std::min(pos + size, size_) - start, advice);
+}
+
 //-----------------------------------------------------------------------------
 
 
@@ -39,7 +39,7 @@ node_compare_test()
 {
   $TEST_BIN_DIR/node_updater
   $TEST_BIN_DIR/compare_osm_base_maps --db-dir=./
-  rm *.bin *.map *.idx
+  rm *.bin *.map *.idx *.stats
   compare_files coord_source.csv coord_db.csv
   rm coord_source.csv coord_db.csv
   compare_files tags_source.csv tags_local.csv
@@ -51,7 +51,7 @@ way_compare_test()
 {
   $TEST_BIN_DIR/way_updater
   $TEST_BIN_DIR/compare_osm_base_maps --db-dir=./
-  rm *.bin *.map *.idx
+  rm *.bin *.map *.idx *.stats
   compare_files member_source.csv member_db.csv
   rm member_source.csv member_db.csv
   compare_files tags_source.csv tags_local.csv
@@ -63,7 +63,7 @@ relation_compare_test()
 {
   $TEST_BIN_DIR/relation_updater
   $TEST_BIN_DIR/compare_osm_base_maps --db-dir=./
-  rm *.bin *.map *.idx
+  rm *.bin *.map *.idx *.stats
   compare_files member_source.csv member_db.csv
   rm member_source.csv member_db.csv
   compare_files tags_source.csv tags_local.csv
@@ -171,11 +171,13 @@ dispatcher_two_clients()
 date +%T
 $BASEDIR/test-bin/file_blocks info
 date +%T
-perform_test_loop file_blocks 30
+perform_test_loop file_blocks 34
 date +%T
 perform_test_loop block_backend 20
 date +%T
-perform_test_loop random_file 8
+perform_test_loop random_file 9
+date +%T
+perform_test_loop key_value_statistics 6
 date +%T
 perform_test_loop test_dispatcher 20
 
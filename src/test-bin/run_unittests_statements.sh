@@ -174,20 +174,29 @@ prepare_test_loop bbox_query 8 $DATA_SIZE
 date +%T
 perform_test_loop bbox_query 8 "$DATA_SIZE ../../input/update_database/"
 
+# Test the area block evaluation of the coord_query statement
+date +%T
+perform_test_loop coord_query 2 ""
+
 # Test the bbox_query statement
 prepare_test_loop around 19 $DATA_SIZE
 date +%T
 perform_test_loop around 19 "$DATA_SIZE ../../input/update_database/ $NODE_OFFSET"
 
 # Test the query statement
-prepare_test_loop query 174 $DATA_SIZE
+prepare_test_loop query 175 $DATA_SIZE
 date +%T
-perform_test_loop query 174 "$DATA_SIZE ../../input/update_database/ $NODE_OFFSET"
+perform_test_loop query 175 "$DATA_SIZE ../../input/update_database/ $NODE_OFFSET"
 
 # Test the foreach statement
 prepare_test_loop foreach 4 $DATA_SIZE
 date +%T
 perform_test_loop foreach 4 "$DATA_SIZE ../../input/update_database/ $NODE_OFFSET"
+# Recursions batched by the loop must give the same results as without loop
+mkdir -p expected/foreach_5/
+$BASEDIR/test-bin/foreach 6 $DATA_SIZE input/update_database/ $NODE_OFFSET >expected/foreach_5/stdout.log
+touch expected/foreach_5/stderr.log
+perform_serial_test foreach 5 "$DATA_SIZE ../../input/update_database/ $NODE_OFFSET"
 
 # Test the union statement
 prepare_test_loop union 6 $DATA_SIZE
@@ -224,4 +233,7 @@ prepare_test_loop if 6 $DATA_SIZE
 date +%T
 perform_test_loop if 6 "../../input/update_database/ $NODE_OFFSET"
 
+date +%T
+perform_test_loop query_plan_cache 3 "../../input/update_database/ $NODE_OFFSET"
+
 rm -f input/update_database/*